@@ -16,16 +16,17 @@ constructors, destructor, and Node_Set_Up */
 
 bool Element::Static_Members_Set  = false;
 Matrix<int> * Element::ID;
-Matrix<double> * Element::K;
+Sparse_Matrix * Element::K;
 double * Element::F;
 Node * Element::Global_Node_Array;
 
-Matrix<double> Element::Na        {8, 8, Memory::COLUMN_MAJOR};
-Matrix<double> Element::Na_Xi     {8, 8, Memory::COLUMN_MAJOR};
-Matrix<double> Element::Na_Eta    {8, 8, Memory::COLUMN_MAJOR};
-Matrix<double> Element::Na_Zeta   {8, 8, Memory::COLUMN_MAJOR};
+Fixed_Matrix<8, 8, Memory::COLUMN_MAJOR> Element::Na;
+Fixed_Matrix<8, 8, Memory::COLUMN_MAJOR> Element::Na_Xi;
+Fixed_Matrix<8, 8, Memory::COLUMN_MAJOR> Element::Na_Eta;
+Fixed_Matrix<8, 8, Memory::COLUMN_MAJOR> Element::Na_Zeta;
+Fixed_Matrix<8, 8, Memory::COLUMN_MAJOR> Element::Extrapolate;
 
-Matrix<double> Element::D         {6, 6, Memory::ROW_MAJOR};
+Fixed_Matrix<6, 6, Memory::ROW_MAJOR> Element::D;
 bool Element::Material_Set        = false;
 
 
@@ -34,6 +35,7 @@ bool Element::Material_Set        = false;
 // Destructor
 
 Element::~Element(void) {
+  if(Owns_Ke_Storage == true) { Free_Ke_Slab(Ke_Storage); }
 } // Element::~Element(void) {
 
 
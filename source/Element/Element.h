@@ -5,10 +5,29 @@
 #include "Errors.h"
 #include "Array.h"
 #include "Matrix.h"
+#include "Fixed_Matrix.h"
+#include "Sparse/Sparse_Matrix.h"
 
 // Element type enumerator.
 enum class Element_Types { BRICK, WEDGE };
 
+/* Packed element stiffness matrices.
+Ke is symmetric, so we only store its upper triangle (300 of its 576
+components). Row i of the upper triangle, Ke(i,i), Ke(i,i+1), ... , Ke(i,23),
+is stored contiguously, starting at Ke_Index(i,i). Each Ke lives in a slot of
+KE_SLOT_SIZE doubles (KE_PACKED_SIZE rounded up to a 64 byte cache line), and
+slots are allocated on a cache line boundary (see Allocate_Ke_Slab). Thus,
+when several Ke's are stored back to back, every one of them starts on a new
+cache line. */
+const unsigned KE_PACKED_SIZE = 300;
+const unsigned KE_SLOT_SIZE = 304;
+
+/* Position of Ke(i,j) in a packed Ke (Ke(i,j) and Ke(j,i) are stored in the
+same place). */
+inline unsigned Ke_Index(const unsigned i, const unsigned j) {
+  return (i <= j) ? (i*(47 - i))/2 + j : (j*(47 - j))/2 + i;
+} // inline unsigned Ke_Index(const unsigned i, const unsigned j) {
+
 class Element {
 private:
   //////////////////////////////////////////////////////////////////////////////
@@ -16,17 +35,18 @@ private:
 
   static bool Static_Members_Set;                // True if the static members have been set
   static Matrix<int> * ID;                       // Points to the ID Matrix
-  static Matrix<double> * K;                     // Points to the global stiffness matrix
+  static Sparse_Matrix * K;                      // Points to the global stiffness matrix
   static double * F;                             // Points to the global force vector.
   static Node * Global_Node_Array;               // Points to the array of nodes.
 
-  static Matrix<double> Na;                      // Value of each shape function at each integrating point
-  static Matrix<double> Na_Xi;                   // Zeta-partial of each shape function at each integrating point
-  static Matrix<double> Na_Eta;                  // Eta-partial of each shape function at each integrating point
-  static Matrix<double> Na_Zeta;                 // Zeta-partial of each shape function at each integrating point
+  static Fixed_Matrix<8, 8, Memory::COLUMN_MAJOR> Na;       // Value of each shape function at each integrating point
+  static Fixed_Matrix<8, 8, Memory::COLUMN_MAJOR> Na_Xi;    // Zeta-partial of each shape function at each integrating point
+  static Fixed_Matrix<8, 8, Memory::COLUMN_MAJOR> Na_Eta;   // Eta-partial of each shape function at each integrating point
+  static Fixed_Matrix<8, 8, Memory::COLUMN_MAJOR> Na_Zeta;  // Zeta-partial of each shape function at each integrating point
+  static Fixed_Matrix<8, 8, Memory::COLUMN_MAJOR> Extrapolate; // Extrapolates integration point values to the nodes (see Find_Nodal_Stresses)
 
-  static bool Material_Set;                      // True if the material parameter have been set (D is set up)
-  static Matrix<double> D;                       // Voigt notation elasticity tensor.
+  static bool Material_Set;                                 // True if the material parameter have been set (D is set up)
+  static Fixed_Matrix<6, 6, Memory::ROW_MAJOR> D;           // Voigt notation elasticity tensor.
 
   const static unsigned FIXED_COMPONENT = -1;    // Used to indicate that a particular component of a node's displacement is fixed
 
@@ -73,10 +93,22 @@ private:
   Array<double, 24> Prescribed_Displacements;
 
 
-  // Local element stiffness matrix, Force Vector
-  Matrix<double> Ke{24, 24, Memory::COLUMN_MAJOR};
+  /* Local element stiffness matrix, Force Vector
+  Ke points to this element's packed stiffness matrix (see Ke_Index). Ke is
+  written to Ke_Storage. Usually, Ke_Storage is a slot in a slab that holds
+  the Ke's of every element (see Ke_Cache.h). If the element isn't given a
+  slot, then Allocate_Ke allocates one for it (and the element owns it).
+  Congruent elements can also share one Ke. In that case, Ke points into the
+  cache and Ke_Storage is never used. */
+  double * Ke_Storage = nullptr;
+  bool Owns_Ke_Storage = false;
+  const double * Ke = nullptr;
   Array<double, 24> Fe;
 
+  /* Allocate Ke_Storage (if it hasn't been set), point Ke to it, and return
+  it. */
+  double * Allocate_Ke(void);
+
 
   /* Calculate Coefficient matrix, Determinant.
   This method is kept private because the only time that it should be called is
@@ -85,8 +117,8 @@ private:
   This method calculates Coeff + J, allowing us to compute Na_x, Na_y, and Na_z
   at each integration point in the Element. */
   void Calculate_Coefficient_Matrix(const unsigned Integration_Point_Index,    // Intent: Read
-                                    Matrix<double> & Coeff,                    // Intent: Write
-                                    double & J);                               // Intent: Write
+                                    Fixed_Matrix<3, 3, Memory::ROW_MAJOR> & Coeff, // Intent: Write
+                                    double & J) const;                         // Intent: Write
 
 
   /* Calculate Ba and move it into B.
@@ -97,9 +129,22 @@ private:
   uses them to construct Ba, and them moves Ba into B. */
   void Add_Ba_To_B(const unsigned Node,                                        // Intent: Read
                    const unsigned Integration_Point,                           // Intent: Read
-                   const Matrix<double> & Coeff,                               // Intent: Read
+                   const Fixed_Matrix<3, 3, Memory::ROW_MAJOR> & Coeff,        // Intent: Read
                    const double J,                                             // Intent: Read
-                   Matrix<double> & B);                                        // Intent: Write
+                   Fixed_Matrix<6, 24, Memory::COLUMN_MAJOR> & B) const;       // Intent: Write
+
+
+  /* Find the strain, B*Ue, at each integration point, using the displacements
+  of the element's nodes (Nodes is the global node array). The strain at
+  Point starts at Strain[6*Point]. */
+  void Find_Integration_Point_Strains(const Node * Nodes,                      // Intent: Read
+                                      double * Strain) const;                  // Intent: Write
+
+
+  /* Compute Ke and store it in Ke_Out (one 3x3 nodal block at a time).
+  Populate_Ke uses this to compute Ke. The matrix-free Element_Operator uses it
+  to recompute Ke when it isn't stored. */
+  void Compute_Ke(Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> & Ke_Out) const;  // Intent: Write
 
 
 
@@ -118,6 +163,11 @@ public:
   void Populate_Ke(void);
   void Fill_Ke_With_1s(void);                                                  // this function is to test the assembly procedure
 
+  /* Compute Ke (and store it in Ke_Out) by building B and multiplying out
+  B^T*D*B. This gives the same Ke as Populate_Ke, only slower (see Compute_Ke).
+  This function is to test the Ke kernel. */
+  void Compute_Ke_Dense(Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> & Ke_Out) const; // Intent: Write
+
   /* Populate Fe */
   void Populate_Fe(void);
 
@@ -127,6 +177,36 @@ public:
   /* Move Fe into F */
   void Move_Fe_To_F(void) const;
 
+  /* Move the force due to a set of prescribed displacements into F_Case.
+  This does the same thing as Populate_Fe followed by Move_Fe_To_F, except that
+  the prescribed displacements are read from U (U[3*Node + Component] is the
+  prescribed displacement of that component of that node) instead of the
+  element's nodes, and the result is added to F_Case instead of F. This allows
+  us to assemble F for several load cases (with the same fixed components)
+  without re-building the elements. If Ke hasn't been populated, it's computed
+  (and thrown away). */
+  void Move_Prescribed_Force_To_F(const double * U,                            // Intent: Read
+                                  double * F_Case) const;                      // Intent: Write
+
+  /* Find the strain and stress in this element from the displacements of its
+  nodes (Nodes is the global node array). We find the strain, B*Ue, at each of
+  the 8 integration points and average them; the stress is D times the average
+  strain. Both are in Voigt order (xx, yy, zz, yz, xz, xy), which is the order
+  of the rows of B. The strain's shear components are engineering shear
+  strains (twice the tensor components). */
+  void Find_Strain_Stress(const Node * Nodes,                                  // Intent: Read
+                          Array<double, 6> & Strain,                           // Intent: Write
+                          Array<double, 6> & Stress) const;                    // Intent: Write
+
+  /* Find the stress at each of the element's 8 nodes (Voigt order, the stress
+  at local node a starts at Stress[6*a]). We find the stress, D*B*Ue, at each
+  integration point and then extrapolate it to the nodes: the integration
+  points form a small brick (1/sqrt(3) the size of the master element), and
+  we evaluate the trilinear function that interpolates their stresses at the
+  nodes. Thus, a linear stress field is recovered exactly. */
+  void Find_Nodal_Stresses(const Node * Nodes,                                 // Intent: Read
+                           double * Stress) const;                             // Intent: Write
+
 
   //////////////////////////////////////////////////////////////////////////////
   // Disable Implicit methods
@@ -155,6 +235,10 @@ public:
 
   Element_Types Get_Element_Type() const;
 
+  /* Get Ke (Populate_Ke must run first). This unpacks Ke into a full 24x24
+  matrix. */
+  Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> Get_Ke(void) const;
+
 
   /* Set nodes.
   Brick variant (8 nodal positions): This function sets Num_Local_Eq,
@@ -182,27 +266,100 @@ public:
 
   /* Friend setters. */
   friend void Set_Element_Static_Members(Matrix<int> * ID_Ptr,                 // Intent: Read
-                                         Matrix<double> * K_Ptr,               // Intend: Read
+                                         Sparse_Matrix * K_Ptr,                // Intend: Read
                                          double * F_Ptr,                       // Intent: Read
                                          Node * Node_Array_Ptr);               // Intent: Read
 
   friend void Set_Element_Material(const double E,                             // Intent : Read
                                    const double v);                            // Intent : Read
 
+  friend void Set_K_Sparsity_Pattern(const Element * Elements,                 // Intent: Read
+                                     const unsigned Num_Elements,              // Intent: Read
+                                     const unsigned Num_Global_Eq);            // Intent: Read
+
+  /* The batched Ke kernel reads several elements' nodes and writes their Ke's. */
+  friend void Populate_Ke_Batch(Element* Elements,                             // Intent: Read/Write
+                                const unsigned Num_Elements);                  // Intent: Read
+
+  /* The matrix-free operator applies each element's Ke directly, so it needs
+  to read Ke and Local_Eq_Num_To_Global_Eq_Num. */
+  friend class Element_Operator;
+
+  /* The Ke cache reads each element's nodes and points its Ke into the cache. */
+  friend class Ke_Cache;
+
 
 }; // class Element {
 
 void Set_Element_Static_Members(Matrix<int> * ID_Ptr,                          // Intent: Read
-                                Matrix<double> * K_Ptr,                        // Intent: Read
+                                Sparse_Matrix * K_Ptr,                         // Intent: Read
                                 double * F_Ptr,                                // Intent: Read
                                 Node * Node_Array_Ptr);                        // Intent: Read
 
 void Set_Element_Material(const double E,                                      // Intent : Read
                           const double v);                                     // Intent : Read
 
+/* Set up K's sparsity pattern.
+Every element couples each of its (free) global equations to every other one.
+This function uses this information to set the sparsity pattern of K. It must
+be called after every element's nodes have been set and before any element's Ke
+is moved into K. */
+void Set_K_Sparsity_Pattern(const Element * Elements,                          // Intent: Read
+                            const unsigned Num_Elements,                       // Intent: Read
+                            const unsigned Num_Global_Eq);                     // Intent: Read
+
+/* Allocate (and free) room for Num_Ke packed Ke's. Slot k starts at
+Slab + k*KE_SLOT_SIZE. The slab starts on a 64 byte boundary. */
+double * Allocate_Ke_Slab(const unsigned Num_Ke);                              // Intent: Read
+void Free_Ke_Slab(double * Slab);                                              // Intent: Write
+
+/* Pack the upper triangle of a (symmetric) Ke into Ke_Packed. */
+void Pack_Ke(const Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> & Ke_Full,      // Intent: Read
+             double * Ke_Packed);                                              // Intent: Write
+
+/* Populate Ke for a contiguous group of elements.
+This does the same thing as calling Populate_Ke on each element, but it
+processes Ke_Batch_Width() elements at a time using a vectorized kernel (see
+Ke_Batch.cc). */
+void Populate_Ke_Batch(Element* Elements,                                      // Intent: Read/Write
+                       const unsigned Num_Elements);                           // Intent: Read
+
+/* Number of elements that Populate_Ke_Batch processes at once (one SIMD lane
+per element). This depends on the instruction sets that the CPU supports (it's
+picked at run time, see Ke_Batch.cc). */
+unsigned Ke_Batch_Width(void);
+
+/* Find the strain, stress, and von Mises stress of every element (in
+parallel, see Element::Find_Strain_Stress). Strain and Stress get 6 components
+per element (element i's start at 6*i), Von_Mises gets one. */
+void Find_Element_Stresses(const Node * Nodes,                                 // Intent: Read
+                           const Element * Elements,                           // Intent: Read
+                           const unsigned Num_Elements,                        // Intent: Read
+                           double * Strain,                                    // Intent: Write
+                           double * Stress,                                    // Intent: Write
+                           double * Von_Mises);                                // Intent: Write
+
+/* The von Mises stress of a stress (in Voigt order). */
+double Von_Mises_Stress(const double * Stress);                                // Intent: Read
+
 // Print out a matrix of doubles. (used for debugging/testing/monitors)
 void Print_Matrix_Of_Doubles(const Matrix<double> & M,                         // Intent: Read
                              unsigned width = 8,                               // Intent: Read
                              unsigned precision = 1);                          // Intent: Read
 
+template <unsigned Rows, unsigned Cols, Memory Layout>
+void Print_Matrix_Of_Doubles(const Fixed_Matrix<Rows, Cols, Layout> & M,       // Intent: Read
+                             unsigned width = 8,                               // Intent: Read
+                             unsigned precision = 1) {                         // Intent: Read
+  // Same as above (see Core.cc).
+  char Format_Buffer[20];
+  sprintf(Format_Buffer, "%%%d.%de ", width, precision);
+
+  for(unsigned i = 0; i < Rows; i++) {
+    printf("| ");
+    for(unsigned j = 0; j < Cols; j++) { printf(Format_Buffer, M(i,j)); }
+    printf("|\n");
+  } // for(unsigned i = 0; i < Rows; i++) {
+} // void Print_Matrix_Of_Doubles(const Fixed_Matrix<Rows, Cols, Layout> & M, unsigned width, unsigned precision) {
+
 #endif
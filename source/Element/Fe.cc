@@ -52,7 +52,7 @@ void Element::Populate_Fe(void) {
     Note: Fe[i] = Sum(over equations corresponding to prescribed positions of -Ke[i,j]*Prescribed_Displacements[j]) */
     for(int j = 0; j < 24; j++) {
       if(Local_Eq_Num_To_Global_Eq_Num[j] == FIXED_COMPONENT) {
-        Fe[i] -= Ke(i,j)*Prescribed_Displacements[j];
+        Fe[i] -= Ke[Ke_Index(i,j)]*Prescribed_Displacements[j];
       } // if(Local_Eq_Num_To_Global_Eq_Num[j] == FIXED_COMPONENT) {
     } // for(int j = 0; j < 24; j++) {
   } // for(int i = 0; i < 24; i++) {
@@ -104,4 +104,67 @@ void Element::Move_Fe_To_F(void) const {
 } // void Element::Move_Fe_To_F(void) const {
 
 
+
+
+void Element::Move_Prescribed_Force_To_F(const double * U, double * F_Case) const {
+  /* Function description:
+  This function computes the local force vector due to the prescribed
+  displacements in U and then adds it to F_Case. If Ke isn't stored (see
+  Settings::Recompute_Ke), we compute it here, but only if the element has a
+  fixed component. */
+
+  /* Assumption 1:
+  This function assumes that Ke has been computed, or that we can compute it
+  (the element's nodes and the material are set). */
+  if(Ke_Set_Up == false && (Element_Set_Up == false || Material_Set == false)) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Element Not Set Up Exception: Thrown by Element::Move_Prescribed_Force_To_F\n"
+            "Ke must be computed (or the element's nodes and material must be set)\n"
+            "before we can find the force due to the prescribed displacements.\n");
+    throw Element_Not_Set_Up(Error_Message_Buffer);
+  } // if(Ke_Set_Up == false && (Element_Set_Up == false || Material_Set == false)) {
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* First, get the prescribed displacement of each fixed local equation (local
+  equation 3*a + Comp corresponds to component Comp of the element's ath
+  node) */
+  double Local_U[24];
+  bool Has_Fixed_Component = false;
+  for(int a = 0; a < 8; a++) {
+    for(int Comp = 0; Comp < 3; Comp++) {
+      const int j = 3*a + Comp;
+      if(Local_Eq_Num_To_Global_Eq_Num[j] == FIXED_COMPONENT) {
+        Local_U[j] = U[3*Element_Nodes[a].ID + Comp];
+        Has_Fixed_Component = true;
+      } // if(Local_Eq_Num_To_Global_Eq_Num[j] == FIXED_COMPONENT) {
+      else { Local_U[j] = 0; }
+    } // for(int Comp = 0; Comp < 3; Comp++) {
+  } // for(int a = 0; a < 8; a++) {
+
+  // If none of this element's components are fixed, there's nothing to add.
+  if(Has_Fixed_Component == false) { return; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Now, add -Ke*Local_U to F_Case (see Populate_Fe). */
+  const double * Ke_Packed = Ke;
+  alignas(64) double Ke_Buffer[KE_SLOT_SIZE];
+  if(Ke_Set_Up == false) {
+    Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> Ke_Full;
+    Compute_Ke(Ke_Full);
+    Pack_Ke(Ke_Full, Ke_Buffer);
+    Ke_Packed = Ke_Buffer;
+  } // if(Ke_Set_Up == false) {
+
+  for(int i = 0; i < 24; i++) {
+    const unsigned I = Local_Eq_Num_To_Global_Eq_Num[i];
+    if(I == FIXED_COMPONENT) { continue; }
+
+    double Fe_i = 0;
+    for(int j = 0; j < 24; j++) { Fe_i -= Ke_Packed[Ke_Index(i,j)]*Local_U[j]; }
+    F_Case[I] += Fe_i;
+  } // for(int i = 0; i < 24; i++) {
+} // void Element::Move_Prescribed_Force_To_F(const double * U, double * F_Case) const {
+
+
 #endif
@@ -8,9 +8,11 @@ the functions requried to move Ke to K. */
 
 #include "Element.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <new>
 //#define COEFFICIENT_MATRIX_MONITOR     // Prints Coeff, J, and Xi, Eta, Zeta partials of x,y,z
 //#define BA_MONITOR                     // Prints each Ba (used to construct B)
-//#define POPULATE_KE_MONITOR            // Prints JD, B, JD*B and B^T*JD*B
+//#define POPULATE_KE_MONITOR            // Prints JD, B, and JD*B (in Compute_Ke_Dense)
 //#define KE_MONITOR                     // Prints Ke
 
 
@@ -68,16 +70,150 @@ void Element::Populate_Ke(void) {
 
 
   //////////////////////////////////////////////////////////////////////////////
+  // Compute Ke, then pack it.
+  Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> Ke_Full;
+  Compute_Ke(Ke_Full);
+  Pack_Ke(Ke_Full, Allocate_Ke());
+
+  // Ke has now been set
+  Ke_Set_Up = true;
+
+  #if defined(KE_MONITOR)
+    printf("Element stiffness matrix:\n");
+    Print_Matrix_Of_Doubles(Get_Ke());
+  #endif
+} // void Element::Populate_Ke(void) {
+
+
+
+void Element::Compute_Ke(Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> & Ke_Out) const {
+  /* Function description:
+  This method does the actual work of computing the element stiffness matrix.
+  It stores the result in Ke_Out rather than in Ke. This lets us recompute Ke
+  whenever we need it (see Element_Operator) without storing it. Populate_Ke
+  checks this method's assumptions.
+
+  Rather than building B and multiplying out B^T*D*B (see Compute_Ke_Dense),
+  we compute Ke one 3x3 nodal block at a time. Node a's block of B, Ba, only
+  holds the 3 components of node a's shape function gradient, Ga (9 of its 18
+  components are zero, see Add_Ba_To_B). Further, the material is isotropic
+  (see Set_Element_Material), so D only depends on the Lame parameters
+  (Lambda = D(0,1), Mu = D(3,3)). Multiplying out Ba^T*D*Bb then gives
+      Kab(i,k) = sum over points of J*(Lambda*Ga_i*Gb_k + Mu*Ga_k*Gb_i + Mu*delta_ik*(Ga.Gb))
+  Ke is symmetric, so we only compute the upper
+  triangle (the blocks with a <= b) and then copy it to the lower triangle.
+
+  Flops per integration point (multiplies + adds):
+                                        Dense   Nodal block
+    Coefficient matrix, J                 176           176
+    Shape function gradients              152           145
+    J*D, J*Lambda*Ga, J*Mu*Ga              36            50
+    J*D*B                                1728             -
+    Upper triangle of B^T*J*D*B          3600          1488
+    Add to Ke                             576      (included)
+    Total                               ~6300         ~1900 */
+
+  // First, zero out KE
+  Ke_Out.Fill(0);
+
+  // D is isotropic, so it's determined by the two Lame parameters.
+  const double Lambda = D(0,1);
+  const double Mu = D(3,3);
+
+  /* Declare J, Coeff, and the shape function gradients at the current point.
+  Grad[a][i] is the i partial of node a's shape function. Lambda_Grad and
+  Mu_Grad are Grad times J*Lambda and J*Mu. */
+  double J;
+  Fixed_Matrix<3, 3, Memory::ROW_MAJOR> Coeff;
+  double Grad[8][3];
+  double Lambda_Grad[8][3];
+  double Mu_Grad[8][3];
+
+  // Now, cycle through the 8 Integration points
+  for(int Point = 0; Point < 8; Point++) {
+    // Find coefficient matrix, J.
+    Calculate_Coefficient_Matrix(Point, Coeff, J);
+
+    // Make sure that J is not zero. If it is then throw an exception.
+    if(J <= 0) {
+      char Error_Message_Buffer[500];
+      sprintf(Error_Message_Buffer,
+              "Element Bad Determinant Exception: Thrown in Element::Populate_Ke\n"
+              "The Jacobian determinant, J, must be a strictly positive quantity. However,\n"
+              "when calculating J for integration point %d, we got J = %lf.\n",
+              Point, J);
+      throw Element_Bad_Determinant(Error_Message_Buffer);
+    } // if(J == 0) {
+
+    /* Find the shape function gradients. This is done using the equations on
+    page 150 of Hughes' book (see Add_Ba_To_B) */
+    const double Recip_J = 1./J;
+    const double J_Lambda = J*Lambda;
+    const double J_Mu = J*Mu;
+    for(int a = 0; a < 8; a++) {
+      for(int i = 0; i < 3; i++) {
+        Grad[a][i] = (Na_Xi(a, Point)*Coeff(i,0) + Na_Eta(a, Point)*Coeff(i,1) + Na_Zeta(a, Point)*Coeff(i,2))*Recip_J;
+        Lambda_Grad[a][i] = J_Lambda*Grad[a][i];
+        Mu_Grad[a][i] = J_Mu*Grad[a][i];
+      } // for(int i = 0; i < 3; i++) {
+    } // for(int a = 0; a < 8; a++) {
+
+    /* Now add each block of the upper triangle to Ke. In the diagional blocks
+    (a == b), we only need the components with i <= k. */
+    for(int b = 0; b < 8; b++) {
+      for(int a = 0; a <= b; a++) {
+        const double Mu_Dot = Mu_Grad[a][0]*Grad[b][0] + Mu_Grad[a][1]*Grad[b][1] + Mu_Grad[a][2]*Grad[b][2];
+
+        for(int k = 0; k < 3; k++) {
+          const int i_End = (a == b) ? k + 1 : 3;
+          for(int i = 0; i < i_End; i++) {
+            double Kab_ik = Lambda_Grad[a][i]*Grad[b][k] + Mu_Grad[a][k]*Grad[b][i];
+            if(i == k) { Kab_ik += Mu_Dot; }
+
+            Ke_Out(3*a + i, 3*b + k) += Kab_ik;
+          } // for(int i = 0; i < i_End; i++) {
+        } // for(int k = 0; k < 3; k++) {
+      } // for(int a = 0; a <= b; a++) {
+    } // for(int b = 0; b < 8; b++) {
+  } // for(int Point = 0; Point < 8; Point++) {
+
+  // Finally, copy the upper triangle to the lower triangle.
+  for(int j = 0; j < 24; j++)
+    for(int i = j+1; i < 24; i++)
+      Ke_Out(i,j) = Ke_Out(j,i);
+} // void Element::Compute_Ke(Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> & Ke_Out) const {
+
+
+
+void Element::Compute_Ke_Dense(Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> & Ke_Out) const {
+  /* Function description:
+  This method computes the element stiffness matrix the direct way: it builds
+  B at each integration point and then adds B^T*(J*D)*B to Ke_Out. Compute_Ke
+  does the same thing much faster; this method is used to test it. */
+
+  /* Assumption 1:
+  This function assumes that the element's nodes and the material have been
+  set (Calculate_Coefficient_Matrix checks the nodes). */
+  if(Material_Set == false) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Element Not Set Up Exception: Thrown by Element::Compute_Ke_Dense\n"
+            "Ke depends on D. Thus, the element material must be set before\n"
+            "calculating Ke.\n");
+    throw Element_Not_Set_Up(Error_Message_Buffer);
+  } // if(Material_Set == false) {
+
   // First, zero out KE
-  Ke.Fill(0);
+  Ke_Out.Fill(0);
 
   // Now, cycle through the 8 Integration points
 
-  // First, declare J, Coeff, JD, and JD_B (which will store (jD)*B)
+  // First, declare J, Coeff, B, JD, and JD_B (which will store (jD)*B)
   double J;
-  class Matrix<double> Coeff{3, 3, Memory::ROW_MAJOR};
-  class Matrix<double> JD{6, 6, Memory::ROW_MAJOR};
-  class Matrix<double> JD_B{6, 24, Memory::COLUMN_MAJOR};
+  Fixed_Matrix<3, 3, Memory::ROW_MAJOR> Coeff;
+  Fixed_Matrix<6, 24, Memory::COLUMN_MAJOR> B;
+  Fixed_Matrix<6, 6, Memory::ROW_MAJOR> JD;
+  Fixed_Matrix<6, 24, Memory::COLUMN_MAJOR> JD_B;
 
   for(int Point = 0; Point < 8; Point++) {
     // Find coefficient matrix, J.
@@ -94,8 +230,7 @@ void Element::Populate_Ke(void) {
       throw Element_Bad_Determinant(Error_Message_Buffer);
     } // if(J == 0) {
 
-    // Declare, Construct B
-    class Matrix<double> B{6, 24, Memory::COLUMN_MAJOR};
+    // Construct B (Add_Ba_To_B sets every component of the Node's 3 columns)
     for(int Node = 0; Node < 8; Node++)
       Add_Ba_To_B(Node, Point, Coeff, J, B);
 
@@ -106,39 +241,35 @@ void Element::Populate_Ke(void) {
     JD = J*D;
     JD_B = JD*B;
 
-    /* Now compute B^T*JD*B (this will be added into Ke).
+    /* Now add B^T*JD*B to Ke.
     We expect this matrix to be symmetric. Therefore to minimize computations,
-    we first populate the main diagional of BT_JD_B, and then the off diagional
-    parts (by computing the (i,j) cell of BT_JD_B and then moving it into
-    the (j,i) cell. */
-    class Matrix<double> BT_JD_B{24, 24, Memory::COLUMN_MAJOR};
+    we first add in its main diagional, and then its off diagional parts (by
+    computing the (i,j) cell of B^T*JD*B and then adding it to both the (i,j)
+    and (j,i) cells of Ke). */
 
-    // Populate diagional cells of BT_JD_B
+    // Add in the diagional cells of BT_JD_B
     for(int j = 0; j < 24; j++) {
-      BT_JD_B(j,j) = 0;
+      double BT_JD_B_jj = 0;
       for(int k = 0; k < 6; k++)
-        BT_JD_B(j,j) += B(k,j)*JD_B(k,j);
+        BT_JD_B_jj += B(k,j)*JD_B(k,j);
+
+      Ke_Out(j,j) += BT_JD_B_jj;
     } // for(int j = 0; j < 24; j++) {
 
-    // Populate the off diagional cells of BT_JD_B (accounting for symmetry)
+    // Add in the off diagional cells of BT_JD_B (accounting for symmetry)
     for(int j = 0; j < 24; j++) {
       for(int i = j+1; i < 24; i++) {
         // Calculate the i,j cell.
-        BT_JD_B(i,j) = 0;
+        double BT_JD_B_ij = 0;
         for(int k = 0; k < 6; k++)
-          BT_JD_B(i,j) += B(k,i)*JD_B(k,j);
+          BT_JD_B_ij += B(k,i)*JD_B(k,j);
 
-        // Now set (j,i) cell using symmetry
-        BT_JD_B(j,i) = BT_JD_B(i,j);
+        // Now add it to the (i,j) and (j,i) cells
+        Ke_Out(i,j) += BT_JD_B_ij;
+        Ke_Out(j,i) += BT_JD_B_ij;
       } // for(int i = 0; i < 24; i++) {
     } // for(int j = 0; j < 6; j++) {
 
-    // Now add BT_JD_B to KE.
-    Ke += BT_JD_B;
-
-    // Ke has now been set
-    Ke_Set_Up = true;
-
 
   #if defined(POPULATE_KE_MONITOR)
       printf("JD:\n");
@@ -149,21 +280,13 @@ void Element::Populate_Ke(void) {
 
       printf("JD_B:\n");
       Print_Matrix_Of_Doubles(JD_B);
-
-      printf("BT_JD_B:\n");
-      Print_Matrix_Of_Doubles(BT_JD_B);
     #endif
   } // for(int Point = 0; Point < 8; Point++) {
+} // void Element::Compute_Ke_Dense(Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> & Ke_Out) const {
 
-  #if defined(KE_MONITOR)
-    printf("Element stiffness matrix:\n");
-    Print_Matrix_Of_Doubles(Ke);
-  #endif
-} // void Element::Populate_Ke(void) {
 
 
-
-void Element::Calculate_Coefficient_Matrix(const unsigned Point, Matrix<double> & Coeff, double & J) {
+void Element::Calculate_Coefficient_Matrix(const unsigned Point, Fixed_Matrix<3, 3, Memory::ROW_MAJOR> & Coeff, double & J) const {
   /* Function description:
     This function calculates the coefficient matrix and jacobian determinant
     for a specific integration point. */
@@ -266,11 +389,11 @@ void Element::Calculate_Coefficient_Matrix(const unsigned Point, Matrix<double>
 
     printf("J = %10.3e\n\n", J);
   #endif
-} // void Element::Calculate_Coefficient_Matrix(const unsigned Point, Matrix<double> & Coeff, double & J) {
+} // void Element::Calculate_Coefficient_Matrix(const unsigned Point, Fixed_Matrix<3, 3, Memory::ROW_MAJOR> & Coeff, double & J) const {
 
 
 
-void Element::Add_Ba_To_B(const unsigned Node, const unsigned Integration_Point, const Matrix<double> & Coeff, const double J, Matrix<double> & B) {
+void Element::Add_Ba_To_B(const unsigned Node, const unsigned Integration_Point, const Fixed_Matrix<3, 3, Memory::ROW_MAJOR> & Coeff, const double J, Fixed_Matrix<6, 24, Memory::COLUMN_MAJOR> & B) const {
   /* Function descrpition.
   This function is used to calculate Ba and move Ba into B. This is done using
   the equations on page 150 of Hughes' book and the definition of B, Ba on page
@@ -293,9 +416,9 @@ void Element::Add_Ba_To_B(const unsigned Node, const unsigned Integration_Point,
 
 
   /* Assumption 2:
-  This function assumes that B has been set up (right dimensions and such) and
-  that the Coefficient matrix has been populated (by the
-  Calculate_Coefficient_Matrix method).
+  This function assumes that the Coefficient matrix has been populated (by the
+  Calculate_Coefficient_Matrix method). B's dimensions are part of its type, so
+  they must be right.
 
   We have no way of testing this assumption. However, since this private method
   is only called by the Populate_Ke method, and that method only calls this
@@ -357,7 +480,7 @@ void Element::Add_Ba_To_B(const unsigned Node, const unsigned Integration_Point,
       printf("|\n");
     } // for(int i = 0; i < 3; i++) {
   #endif
-} // void Element::Add_Ba_To_B(const unsigned Node, const unsigned Integration_Point, const Matrix<double> & Coeff, const double J, Matrix<double> & B) {
+} // void Element::Add_Ba_To_B(const unsigned Node, const unsigned Integration_Point, const Fixed_Matrix<3, 3, Memory::ROW_MAJOR> & Coeff, const double J, Fixed_Matrix<6, 24, Memory::COLUMN_MAJOR> & B) const {
 
 
 
@@ -395,8 +518,9 @@ void Element::Fill_Ke_With_1s(void) {
 
 
   //////////////////////////////////////////////////////////////////////////////
-  // Fill Ke's with 1's (note: Ke is column major)
-  Ke.Fill(1);
+  // Fill Ke's with 1's (note: Ke is packed)
+  double * Ke_Packed = Allocate_Ke();
+  for(unsigned k = 0; k < KE_PACKED_SIZE; k++) { Ke_Packed[k] = 1; }
 
   // Ke has now been set
   Ke_Set_Up = true;
@@ -404,7 +528,7 @@ void Element::Fill_Ke_With_1s(void) {
 
   #if defined(KE_MONITOR)
     printf("Element stiffness matrix:\n");
-    Print_Matrix_Of_Doubles(Ke);
+    Print_Matrix_Of_Doubles(Get_Ke());
   #endif
 } // void Element::Fill_Ke_With_1s(void) {
 
@@ -446,14 +570,25 @@ void Element::Move_Ke_To_K(void) const {
     if(I == FIXED_COMPONENT)
       continue;
     else
-      (*K)(I, I) += Ke(i,i);
+      K->Add_To(I, I, Ke[Ke_Index(i,i)]);
   } // for(int i = 0; i < 24; i++) {
 
   /* Now, move the off-diagional cells of Ke to K. Again, We only move the
-  components that correspond to a global equation (see previous comment) */
+  components that correspond to a global equation (see previous comment).
+
+  K is symmetric and only stores its upper triangle. Thus, adding Ke(Row, Col)
+  to the (I,J) component of K also adds it to the (J,I) component. There is one
+  subtlety, however. In wedge elements, two local nodes are the same global
+  node. In this case, two different local equations map to the same global
+  equation (I == J). Ke(Row, Col) and Ke(Col, Row) then both belong to the
+  (I,I) component, so we have to add Ke(Row, Col) twice.
+
+  Ke(Row, Col) = Ke(Col, Row), and row Col of the packed upper triangle is
+  stored contiguously (see Ke_Index), so we read Ke_Col[Row - Col]. */
   for(int Col = 0; Col < 24; Col++) {
     // Get Global column number, J, associated with the local column number "Col"
     const unsigned J = Local_Eq_Num_To_Global_Eq_Num[Col];
+    const double * Ke_Col = Ke + Ke_Index(Col, Col);
 
     // Check if J corresponds to a fixed component
     if(J == FIXED_COMPONENT)
@@ -468,11 +603,83 @@ void Element::Move_Ke_To_K(void) const {
           continue;
 
         // If not, move Ke(Row, Col) to the corresponding position in K.
-        const double Ke_Row_Col = Ke(Row, Col);
-        (*K)(I,J) += Ke_Row_Col;
-        (*K)(J,I) += Ke_Row_Col;
+        const double Ke_Row_Col = Ke_Col[Row - Col];
+        if(I == J) { K->Add_To(I, J, 2*Ke_Row_Col); }
+        else { K->Add_To(I, J, Ke_Row_Col); }
       } // for(int Row = Col+1; Row < 24; Row++) {
   } // for(int Col = 0; Col < 24; Col++) {
 } // void Element::Move_Ke_To_K(void) const {
 
+
+
+Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> Element::Get_Ke(void) const {
+  /* Assumption 1:
+  This function assumes that Ke has been set. */
+  if(Ke_Set_Up == false) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Element Not Set Up Exception: Thrown by Element::Get_Ke\n"
+            "Ke has not been computed. Populate_Ke must be run BEFORE Get_Ke\n");
+    throw Element_Not_Set_Up(Error_Message_Buffer);
+  } // if(Ke_Set_Up == false) {
+
+  Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> Ke_Full;
+  for(unsigned j = 0; j < 24; j++) {
+    for(unsigned i = 0; i < 24; i++) { Ke_Full(i,j) = Ke[Ke_Index(i,j)]; }
+  } // for(unsigned j = 0; j < 24; j++) {
+
+  return Ke_Full;
+} // Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> Element::Get_Ke(void) const {
+
+
+
+double * Element::Allocate_Ke(void) {
+  /* Function description:
+  This function returns the slot that this element's Ke is written to (and
+  points Ke to it). If the element wasn't given a slot in a slab (see
+  Ke_Cache.h), then we allocate one for it. */
+  if(Ke_Storage == nullptr) {
+    Ke_Storage = Allocate_Ke_Slab(1);
+    Owns_Ke_Storage = true;
+  } // if(Ke_Storage == nullptr) {
+  Ke = Ke_Storage;
+
+  return Ke_Storage;
+} // double * Element::Allocate_Ke(void) {
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Packed Ke functions
+
+double * Allocate_Ke_Slab(const unsigned Num_Ke) {
+  /* Function description:
+  This function allocates room for Num_Ke packed Ke's. The slab starts on a
+  64 byte (cache line) boundary, and each slot is a whole number of cache
+  lines, so every slot starts on a cache line. */
+  void * Slab = nullptr;
+  const size_t Num_Bytes = (size_t)KE_SLOT_SIZE*(size_t)((Num_Ke > 0) ? Num_Ke : 1)*sizeof(double);
+  if(posix_memalign(&Slab, 64, Num_Bytes) != 0) { throw std::bad_alloc(); }
+
+  return (double*)Slab;
+} // double * Allocate_Ke_Slab(const unsigned Num_Ke) {
+
+
+
+void Free_Ke_Slab(double * Slab) { free(Slab); }
+
+
+
+void Pack_Ke(const Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> & Ke_Full, double * Ke_Packed) {
+  /* Function description:
+  This function copies the upper triangle of Ke_Full, one row at a time, into
+  Ke_Packed (see Ke_Index). */
+  unsigned k = 0;
+  for(unsigned i = 0; i < 24; i++) {
+    for(unsigned j = i; j < 24; j++) { Ke_Packed[k++] = Ke_Full(i,j); }
+  } // for(unsigned i = 0; i < 24; i++) {
+} // void Pack_Ke(const Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> & Ke_Full, double * Ke_Packed) {
+
 #endif
@@ -0,0 +1,385 @@
+#if !defined(ELEMENT_KE_BATCH)
+#define ELEMENT_KE_BATCH
+
+/* File description:
+This file holds the batched element stiffness matrix kernel, Populate_Ke_Batch.
+Element::Compute_Ke works on one element at a time, so the compiler can't
+vectorize across elements.
+
+Populate_Ke_Batch instead computes Ke for W elements at once. Every quantity
+(node coordinates, Jacobian, shape function gradients, D*B, Ke) is stored in
+structure-of-arrays form: the last index of each array is the element's lane
+in the batch. Every element in a batch does exactly the same operations, so
+the innermost (lane) loops map directly onto SIMD registers.
+
+The kernel (Ke_Batch_Kernel) is compiled once for each instruction set that
+we support: AVX-512 (W = 8), AVX2 + FMA (W = 4), and the baseline (W = 2 with
+SSE2, 1 otherwise). The first time that Populate_Ke_Batch runs, we pick the
+widest one that the CPU supports (see Select_Ke_Batch_Kernel). Thus, the
+binary runs on any x86-64 CPU, and nothing outside of this file depends on
+the width (see Ke_Batch_Width). Define KE_BATCH_SCALAR to always use the
+baseline kernel.
+
+We also exploit the structure of B. Column i of node a's block of B, Ba, has
+exactly three non-zero components (see Add_Ba_To_B): Ba(BA_ROW[i][t], i) is
+the BA_GRAD[i][t] component of node a's shape function gradient. Thus,
+    (J*D*Bb)(r,k)  = J * sum over t of D(r, BA_ROW[k][t]) * Nb_(BA_GRAD[k][t])
+    (Ba^T J D Bb)(i,k) = sum over t of Na_(BA_GRAD[i][t]) * (J*D*Bb)(BA_ROW[i][t], k)
+Ke is symmetric, so we only compute the 3x3 blocks (a,b) with a <= b. */
+
+#include "Element.h"
+#include <stdio.h>
+
+//#define KE_BATCH_SCALAR
+
+#if !defined(KE_BATCH_SCALAR) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define KE_BATCH_DISPATCH
+#endif
+
+#if defined(__SSE2__)
+  static const unsigned BASELINE_WIDTH = 2;
+#else
+  static const unsigned BASELINE_WIDTH = 1;
+#endif
+
+// Widest batch that any kernel uses (the gather/scatter buffers are this wide).
+static const unsigned MAX_WIDTH = 8;
+
+static const unsigned BA_ROW[3][3]  = {{0, 4, 5}, {1, 3, 5}, {2, 3, 4}};
+static const unsigned BA_GRAD[3][3] = {{0, 2, 1}, {1, 2, 0}, {2, 1, 0}};
+
+
+
+/* Where (and why) a kernel found a non-positive Jacobian determinant. */
+struct Bad_Determinant {
+  unsigned Point;
+  unsigned Lane;
+  double J;
+}; // struct Bad_Determinant {
+
+/* A batch kernel computes the upper triangle blocks of Ke for one batch (see
+Ke_Batch_Kernel). It returns false if one of the first Count lanes has a
+non-positive Jacobian determinant. */
+typedef bool (*Ke_Batch_Kernel_Type)(const double (&D)[6][6],
+                                     const double (&dN)[3][8][8],
+                                     const double * X_In,
+                                     double * Ke_Out,
+                                     const unsigned Count,
+                                     Bad_Determinant & Bad);
+
+
+
+template <unsigned W>
+static inline __attribute__((always_inline))
+bool Ke_Batch_Kernel(const double (&D)[6][6], const double (&dN)[3][8][8], const double * X_In, double * Ke_Out, const unsigned Count, Bad_Determinant & Bad) {
+  /* Function description:
+  This function computes the (a,b) blocks (a <= b) of Ke for a batch of W
+  elements. X_In holds the node coordinates: X_In[(8*c + a)*W + l] is
+  coordinate c of node a of the element in lane l. Ke_Out[(9*Block + 3*i + k)*W + l]
+  gets component (i,k) of the Block'th (a,b) block of the element in lane l.
+  dN[d][a][p] is the Xi (d = 0), Eta (d = 1), or Zeta (d = 2) partial of
+  shape function a at integration point p.
+
+  This is always inlined into the per instruction set wrappers below, so that
+  each copy is compiled for that wrapper's target. */
+
+  const double (*X)[8][W] = reinterpret_cast<const double (*)[8][W]>(X_In);
+  double (*Ke_Blocks)[9][W] = reinterpret_cast<double (*)[9][W]>(Ke_Out);
+
+  for(unsigned Block = 0; Block < 36; Block++) {
+    for(unsigned ik = 0; ik < 9; ik++) {
+      #pragma omp simd
+      for(unsigned l = 0; l < W; l++) { Ke_Blocks[Block][ik][l] = 0; }
+    } // for(unsigned ik = 0; ik < 9; ik++) {
+  } // for(unsigned Block = 0; Block < 36; Block++) {
+
+  for(unsigned Point = 0; Point < 8; Point++) {
+    ////////////////////////////////////////////////////////////////////////
+    /* Jacobian: x_d[c][l] is the partial of coordinate c with respect to
+    master coordinate d. Then, the coefficient matrix and J (see
+    Calculate_Coefficient_Matrix). */
+    alignas(64) double x_d[3][3][W];
+    for(unsigned c = 0; c < 3; c++) {
+      for(unsigned d = 0; d < 3; d++) {
+        #pragma omp simd
+        for(unsigned l = 0; l < W; l++) {
+          double Sum = 0;
+          for(unsigned a = 0; a < 8; a++) { Sum += dN[d][a][Point]*X[c][a][l]; }
+          x_d[c][d][l] = Sum;
+        } // for(unsigned l = 0; l < W; l++) {
+      } // for(unsigned d = 0; d < 3; d++) {
+    } // for(unsigned c = 0; c < 3; c++) {
+
+    alignas(64) double Coeff[3][3][W];
+    alignas(64) double J[W];
+    alignas(64) double Recip_J[W];
+    #pragma omp simd
+    for(unsigned l = 0; l < W; l++) {
+      Coeff[0][0][l] = x_d[1][1][l]*x_d[2][2][l] - x_d[1][2][l]*x_d[2][1][l];
+      Coeff[0][1][l] = x_d[1][2][l]*x_d[2][0][l] - x_d[1][0][l]*x_d[2][2][l];
+      Coeff[0][2][l] = x_d[1][0][l]*x_d[2][1][l] - x_d[1][1][l]*x_d[2][0][l];
+
+      Coeff[1][0][l] = x_d[2][1][l]*x_d[0][2][l] - x_d[2][2][l]*x_d[0][1][l];
+      Coeff[1][1][l] = x_d[0][0][l]*x_d[2][2][l] - x_d[0][2][l]*x_d[2][0][l];
+      Coeff[1][2][l] = x_d[2][0][l]*x_d[0][1][l] - x_d[2][1][l]*x_d[0][0][l];
+
+      Coeff[2][0][l] = x_d[0][1][l]*x_d[1][2][l] - x_d[0][2][l]*x_d[1][1][l];
+      Coeff[2][1][l] = x_d[0][2][l]*x_d[1][0][l] - x_d[0][0][l]*x_d[1][2][l];
+      Coeff[2][2][l] = x_d[0][0][l]*x_d[1][1][l] - x_d[0][1][l]*x_d[1][0][l];
+
+      J[l] = x_d[0][0][l]*Coeff[0][0][l] + x_d[0][1][l]*Coeff[0][1][l] + x_d[0][2][l]*Coeff[0][2][l];
+      Recip_J[l] = 1./J[l];
+    } // for(unsigned l = 0; l < W; l++) {
+
+    // Make sure that J is positive (for the real lanes).
+    for(unsigned l = 0; l < Count; l++) {
+      if(J[l] <= 0) {
+        Bad.Point = Point;
+        Bad.Lane = l;
+        Bad.J = J[l];
+        return false;
+      } // if(J[l] <= 0) {
+    } // for(unsigned l = 0; l < Count; l++) {
+
+
+    ////////////////////////////////////////////////////////////////////////
+    /* Shape function gradients: Grad[a][c][l] is the x (c = 0), y (c = 1),
+    or z (c = 2) partial of shape function a (see Add_Ba_To_B). */
+    alignas(64) double Grad[8][3][W];
+    for(unsigned a = 0; a < 8; a++) {
+      for(unsigned c = 0; c < 3; c++) {
+        #pragma omp simd
+        for(unsigned l = 0; l < W; l++) {
+          Grad[a][c][l] = (dN[0][a][Point]*Coeff[c][0][l] +
+                           dN[1][a][Point]*Coeff[c][1][l] +
+                           dN[2][a][Point]*Coeff[c][2][l])*Recip_J[l];
+        } // for(unsigned l = 0; l < W; l++) {
+      } // for(unsigned c = 0; c < 3; c++) {
+    } // for(unsigned a = 0; a < 8; a++) {
+
+    /* JDB[b][r][k][l] = (J*D*Bb)(r,k). */
+    alignas(64) double JDB[8][6][3][W];
+    for(unsigned b = 0; b < 8; b++) {
+      for(unsigned r = 0; r < 6; r++) {
+        for(unsigned k = 0; k < 3; k++) {
+          const double D0 = D[r][BA_ROW[k][0]], D1 = D[r][BA_ROW[k][1]], D2 = D[r][BA_ROW[k][2]];
+          const double* G0 = Grad[b][BA_GRAD[k][0]];
+          const double* G1 = Grad[b][BA_GRAD[k][1]];
+          const double* G2 = Grad[b][BA_GRAD[k][2]];
+
+          #pragma omp simd
+          for(unsigned l = 0; l < W; l++) { JDB[b][r][k][l] = J[l]*(D0*G0[l] + D1*G1[l] + D2*G2[l]); }
+        } // for(unsigned k = 0; k < 3; k++) {
+      } // for(unsigned r = 0; r < 6; r++) {
+    } // for(unsigned b = 0; b < 8; b++) {
+
+
+    ////////////////////////////////////////////////////////////////////////
+    // Add Ba^T (J D Bb) to the (a,b) block of Ke (for a <= b).
+    unsigned Block = 0;
+    for(unsigned a = 0; a < 8; a++) {
+      for(unsigned b = a; b < 8; b++) {
+        for(unsigned i = 0; i < 3; i++) {
+          const double* Ga0 = Grad[a][BA_GRAD[i][0]];
+          const double* Ga1 = Grad[a][BA_GRAD[i][1]];
+          const double* Ga2 = Grad[a][BA_GRAD[i][2]];
+
+          for(unsigned k = 0; k < 3; k++) {
+            const double* JDB0 = JDB[b][BA_ROW[i][0]][k];
+            const double* JDB1 = JDB[b][BA_ROW[i][1]][k];
+            const double* JDB2 = JDB[b][BA_ROW[i][2]][k];
+            double* Ke_ik = Ke_Blocks[Block][3*i + k];
+
+            #pragma omp simd
+            for(unsigned l = 0; l < W; l++) { Ke_ik[l] += Ga0[l]*JDB0[l] + Ga1[l]*JDB1[l] + Ga2[l]*JDB2[l]; }
+          } // for(unsigned k = 0; k < 3; k++) {
+        } // for(unsigned i = 0; i < 3; i++) {
+
+        Block++;
+      } // for(unsigned b = a; b < 8; b++) {
+    } // for(unsigned a = 0; a < 8; a++) {
+  } // for(unsigned Point = 0; Point < 8; Point++) {
+
+  return true;
+} // bool Ke_Batch_Kernel(const double (&D)[6][6], const double (&dN)[3][8][8],...
+
+
+
+/* One copy of the kernel for each instruction set. */
+static bool Ke_Batch_Baseline(const double (&D)[6][6], const double (&dN)[3][8][8], const double * X_In, double * Ke_Out, const unsigned Count, Bad_Determinant & Bad) {
+  return Ke_Batch_Kernel<BASELINE_WIDTH>(D, dN, X_In, Ke_Out, Count, Bad);
+} // static bool Ke_Batch_Baseline(...
+
+#if defined(KE_BATCH_DISPATCH)
+  __attribute__((target("avx2,fma")))
+  static bool Ke_Batch_AVX2(const double (&D)[6][6], const double (&dN)[3][8][8], const double * X_In, double * Ke_Out, const unsigned Count, Bad_Determinant & Bad) {
+    return Ke_Batch_Kernel<4>(D, dN, X_In, Ke_Out, Count, Bad);
+  } // static bool Ke_Batch_AVX2(...
+
+  __attribute__((target("avx512f")))
+  static bool Ke_Batch_AVX512(const double (&D)[6][6], const double (&dN)[3][8][8], const double * X_In, double * Ke_Out, const unsigned Count, Bad_Determinant & Bad) {
+    return Ke_Batch_Kernel<8>(D, dN, X_In, Ke_Out, Count, Bad);
+  } // static bool Ke_Batch_AVX512(...
+#endif
+
+
+
+struct Ke_Batch_Kernel_Choice {
+  Ke_Batch_Kernel_Type Kernel;
+  unsigned Width;
+}; // struct Ke_Batch_Kernel_Choice {
+
+static const Ke_Batch_Kernel_Choice & Select_Ke_Batch_Kernel(void) {
+  /* Function description:
+  This function returns the widest kernel that this CPU can run. The choice is
+  made once (the first time that this is called). */
+  static const Ke_Batch_Kernel_Choice Choice = []() {
+    #if defined(KE_BATCH_DISPATCH)
+      __builtin_cpu_init();
+      if(__builtin_cpu_supports("avx512f")) { return Ke_Batch_Kernel_Choice{Ke_Batch_AVX512, 8}; }
+      if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) { return Ke_Batch_Kernel_Choice{Ke_Batch_AVX2, 4}; }
+    #endif
+    return Ke_Batch_Kernel_Choice{Ke_Batch_Baseline, BASELINE_WIDTH};
+  }();
+
+  return Choice;
+} // static const Ke_Batch_Kernel_Choice & Select_Ke_Batch_Kernel(void) {
+
+
+
+unsigned Ke_Batch_Width(void) { return Select_Ke_Batch_Kernel().Width; }
+
+
+
+void Populate_Ke_Batch(Element* Elements, const unsigned Num_Elements) {
+  /* Function description:
+  This function populates Ke for Elements[0], ... , Elements[Num_Elements - 1].
+  It does exactly what calling Populate_Ke on each element would (up to
+  rounding), but it processes Ke_Batch_Width() elements at a time.
+
+  Each element must satisfy the assumptions of Populate_Ke (its nodes and the
+  material must be set, and its Ke must not be set). If an element has a
+  non-positive Jacobian determinant, then this throws an
+  Element_Bad_Determinant exception; the Ke's of the batches before that
+  element are still set. */
+
+  /* Assumption 1:
+  This function assumes that the element material (D) and the static members
+  (the shape function derivatives) have been set. */
+  if(Element::Material_Set == false || Element::Static_Members_Set == false) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Element Not Set Up Exception: Thrown by Populate_Ke_Batch\n"
+            "Ke depends on D and the shape functions. Thus, the element material and\n"
+            "static members must be set before calculating Ke.\n");
+    throw Element_Not_Set_Up(Error_Message_Buffer);
+  } // if(Element::Material_Set == false || Element::Static_Members_Set == false) {
+
+  /* Assumption 2:
+  This function assumes that each element's nodes have been set and that its
+  Ke has not. */
+  for(unsigned e = 0; e < Num_Elements; e++) {
+    if(Elements[e].Element_Set_Up == false) {
+      char Error_Message_Buffer[500];
+      sprintf(Error_Message_Buffer,
+              "Element Not Set Up Exception: Thrown by Populate_Ke_Batch\n"
+              "it is impossible to calculate Ke if the element's node list has\n"
+              "not been set. Set_Nodes must be run BEFORE Populate_Ke_Batch (element %u).\n",
+              e);
+      throw Element_Not_Set_Up(Error_Message_Buffer);
+    } // if(Elements[e].Element_Set_Up == false) {
+
+    if(Elements[e].Ke_Set_Up == true) {
+      char Error_Message_Buffer[500];
+      sprintf(Error_Message_Buffer,
+              "Element Already Set Exception: Thrown by Populate_Ke_Batch\n"
+              "Once Ke has been calculated, it can not be recalculated (element %u).\n",
+              e);
+      throw Element_Already_Set_Up(Error_Message_Buffer);
+    } // if(Elements[e].Ke_Set_Up == true) {
+  } // for(unsigned e = 0; e < Num_Elements; e++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Copy D and the shape function derivatives into plain arrays (which we can
+  index with the lane loops' layout).
+  dN[d][a][p] is the Xi (d = 0), Eta (d = 1), or Zeta (d = 2) partial of shape
+  function a at integration point p. */
+  double D[6][6];
+  for(unsigned r = 0; r < 6; r++) {
+    for(unsigned c = 0; c < 6; c++) { D[r][c] = Element::D(r,c); }
+  } // for(unsigned r = 0; r < 6; r++) {
+
+  double dN[3][8][8];
+  for(unsigned a = 0; a < 8; a++) {
+    for(unsigned p = 0; p < 8; p++) {
+      dN[0][a][p] = Element::Na_Xi(a,p);
+      dN[1][a][p] = Element::Na_Eta(a,p);
+      dN[2][a][p] = Element::Na_Zeta(a,p);
+    } // for(unsigned p = 0; p < 8; p++) {
+  } // for(unsigned a = 0; a < 8; a++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Cycle through the batches.
+
+  const Ke_Batch_Kernel_Type Kernel = Select_Ke_Batch_Kernel().Kernel;
+  const unsigned W = Select_Ke_Batch_Kernel().Width;
+
+  for(unsigned Start = 0; Start < Num_Elements; Start += W) {
+    const unsigned Count = (Num_Elements - Start < W) ? (Num_Elements - Start) : W;
+
+    /* Gather the node coordinates. X[(8*c + a)*W + l] is coordinate c of node
+    a of the element in lane l. If the last batch isn't full, the unused lanes
+    repeat its last element (so that they don't divide by zero). */
+    alignas(64) double X[3*8*MAX_WIDTH];
+    for(unsigned l = 0; l < W; l++) {
+      const Element & El = Elements[Start + ((l < Count) ? l : Count - 1)];
+      for(unsigned a = 0; a < 8; a++) {
+        X[(8*0 + a)*W + l] = El.Element_Nodes[a].Xa;
+        X[(8*1 + a)*W + l] = El.Element_Nodes[a].Ya;
+        X[(8*2 + a)*W + l] = El.Element_Nodes[a].Za;
+      } // for(unsigned a = 0; a < 8; a++) {
+    } // for(unsigned l = 0; l < W; l++) {
+
+    /* Ke_Blocks[(9*Block + 3*i + k)*W + l] is component (i,k) of the (a,b)
+    block of Ke (a <= b) of the element in lane l. Block = (pair index of
+    (a,b)). */
+    alignas(64) double Ke_Blocks[36*9*MAX_WIDTH];
+    Bad_Determinant Bad;
+    if(Kernel(D, dN, X, Ke_Blocks, Count, Bad) == false) {
+      char Error_Message_Buffer[500];
+      sprintf(Error_Message_Buffer,
+              "Element Bad Determinant Exception: Thrown in Populate_Ke_Batch\n"
+              "The Jacobian determinant, J, must be a strictly positive quantity. However,\n"
+              "when calculating J for integration point %u of element %u, we got J = %lf.\n",
+              Bad.Point, Start + Bad.Lane, Bad.J);
+      throw Element_Bad_Determinant(Error_Message_Buffer);
+    } // if(Kernel(D, dN, X, Ke_Blocks, Count, Bad) == false) {
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    /* Scatter the blocks into each element's (packed) Ke. Ke only stores its
+    upper triangle, so the diagonal blocks only store their upper triangles. */
+    for(unsigned l = 0; l < Count; l++) {
+      double * Ke = Elements[Start + l].Allocate_Ke();
+
+      unsigned Block = 0;
+      for(unsigned a = 0; a < 8; a++) {
+        for(unsigned b = a; b < 8; b++) {
+          for(unsigned i = 0; i < 3; i++) {
+            for(unsigned k = (a == b) ? i : 0; k < 3; k++) {
+              Ke[Ke_Index(3*a + i, 3*b + k)] = Ke_Blocks[(9*Block + 3*i + k)*W + l];
+            } // for(unsigned k = (a == b) ? i : 0; k < 3; k++) {
+          } // for(unsigned i = 0; i < 3; i++) {
+
+          Block++;
+        } // for(unsigned b = a; b < 8; b++) {
+      } // for(unsigned a = 0; a < 8; a++) {
+
+      Elements[Start + l].Ke_Set_Up = true;
+    } // for(unsigned l = 0; l < Count; l++) {
+  } // for(unsigned Start = 0; Start < Num_Elements; Start += W) {
+} // void Populate_Ke_Batch(Element* Elements, const unsigned Num_Elements) {
+
+#endif
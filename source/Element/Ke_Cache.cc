@@ -0,0 +1,213 @@
+#if !defined(KE_CACHE_SOURCE)
+#define KE_CACHE_SOURCE
+
+/* File description:
+This file holds the implementation of the methods of the Ke_Cache class. */
+
+#include "Ke_Cache.h"
+#include <stdio.h>
+#include <math.h>
+#include <unordered_map>
+#include <vector>
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Keys
+
+bool Ke_Cache::Key::operator==(const Key & Other) const {
+  if(Exponent != Other.Exponent) { return false; }
+
+  for(unsigned i = 0; i < 21; i++) {
+    if(Coords[i] != Other.Coords[i]) { return false; }
+  } // for(unsigned i = 0; i < 21; i++) {
+
+  return true;
+} // bool Ke_Cache::Key::operator==(const Key & Other) const {
+
+
+
+size_t Ke_Cache::Key_Hash::operator()(const Key & K) const {
+  // FNV-1a style hash of the key's components.
+  unsigned long long Hash = 14695981039346656037ULL;
+  for(unsigned i = 0; i < 21; i++) { Hash = (Hash ^ (unsigned long long)K.Coords[i])*1099511628211ULL; }
+  Hash = (Hash ^ (unsigned long long)K.Exponent)*1099511628211ULL;
+
+  return (size_t)Hash;
+} // size_t Ke_Cache::Key_Hash::operator()(const Key & K) const {
+
+
+
+Ke_Cache::Key Ke_Cache::Element_Key(const Element & El) {
+  /* Function description:
+  This function finds an element's key (see Ke_Cache.h). First, find the
+  position of nodes 1-7 relative to node 0 and the element's size (the largest
+  component of any relative position). */
+  double Relative_Position[21];
+  double Size = 0;
+  for(unsigned a = 1; a < 8; a++) {
+    Relative_Position[3*(a-1) + 0] = El.Element_Nodes[a].Xa - El.Element_Nodes[0].Xa;
+    Relative_Position[3*(a-1) + 1] = El.Element_Nodes[a].Ya - El.Element_Nodes[0].Ya;
+    Relative_Position[3*(a-1) + 2] = El.Element_Nodes[a].Za - El.Element_Nodes[0].Za;
+  } // for(unsigned a = 1; a < 8; a++) {
+  for(unsigned i = 0; i < 21; i++) {
+    if(fabs(Relative_Position[i]) > Size) { Size = fabs(Relative_Position[i]); }
+  } // for(unsigned i = 0; i < 21; i++) {
+
+  /* Now, quantize. Size = m*2^Exponent, where 1/2 <= m < 1, so 2^Exponent is
+  the smallest power of 2 that's at least Size. */
+  Key K;
+  frexp(Size, &K.Exponent);
+  const double Quantum = ldexp(TOLERANCE, K.Exponent);
+
+  for(unsigned i = 0; i < 21; i++) { K.Coords[i] = llround(Relative_Position[i]/Quantum); }
+
+  return K;
+} // Ke_Cache::Key Ke_Cache::Element_Key(const Element & El) {
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Populate Ke
+
+void Ke_Cache::Populate_Ke(Element* Elements, const unsigned Num_Elements) {
+  /* Function description:
+  This function groups the elements into classes of congruent elements, finds
+  the Ke of each class (using the class's first element), and then points
+  each element's Ke at its class's Ke. If Share_Ke is false, then we instead
+  give each element slot e of the slab and populate the elements with the
+  batched kernel (see Populate_Ke_Batch). If an element throws, we rethrow it
+  once the parallel loop is done (see Parallel_Errors). */
+
+  /* Assumption 1:
+  This cache must be empty (otherwise, some elements may already point into
+  the slab, and replacing it would leave them dangling). */
+  if(Ke_Slab != nullptr) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Element Already Set Up Exception: Thrown by Ke_Cache::Populate_Ke\n"
+            "This cache already holds %u Ke's. Each cache can only be populated once.\n",
+            Num_Ke);
+    throw Element_Already_Set_Up(Error_Message_Buffer);
+  } // if(Ke_Slab != nullptr) {
+
+  /* Assumption 2:
+  The material must be set, each element's nodes must be set, and no
+  element's Ke can be set (see Element::Populate_Ke). */
+  if(Element::Material_Set == false) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Element Not Set Up Exception: Thrown by Ke_Cache::Populate_Ke\n"
+            "Ke depends on D. Thus, the element material must be set before\n"
+            "calculating Ke.\n");
+    throw Element_Not_Set_Up(Error_Message_Buffer);
+  } // if(Element::Material_Set == false) {
+
+  for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+    if(Elements[Element_Index].Element_Set_Up == false) {
+      char Error_Message_Buffer[500];
+      sprintf(Error_Message_Buffer,
+              "Element Not Set Up Exception: Thrown by Ke_Cache::Populate_Ke\n"
+              "it is impossible to calculate Ke if the element's node list has\n"
+              "not been set. Set_Nodes must be run BEFORE Populate_Ke (element %u).\n",
+              Element_Index);
+      throw Element_Not_Set_Up(Error_Message_Buffer);
+    } // if(Elements[Element_Index].Element_Set_Up == false) {
+
+    if(Elements[Element_Index].Ke_Set_Up == true) {
+      char Error_Message_Buffer[500];
+      sprintf(Error_Message_Buffer,
+              "Element Already Set Exception: Thrown by Ke_Cache::Populate_Ke\n"
+              "Once Ke has been calculated, it can not be recalculated (element %u).\n",
+              Element_Index);
+      throw Element_Already_Set_Up(Error_Message_Buffer);
+    } // if(Elements[Element_Index].Ke_Set_Up == true) {
+  } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* If we're not sharing, give each element its own slot, then populate the
+  elements in groups (in parallel). */
+  Parallel_Errors Errors;
+
+  if(Share_Ke == false) {
+    Num_Ke = Num_Elements;
+    Ke_Slab = Allocate_Ke_Slab(Num_Ke);
+    for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+      Elements[Element_Index].Ke_Storage = Ke_Slab + (size_t)Element_Index*KE_SLOT_SIZE;
+    } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+
+    const unsigned GROUP_SIZE = 16;
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(unsigned Start = 0; Start < Num_Elements; Start += GROUP_SIZE) {
+      const unsigned Count = (Start + GROUP_SIZE < Num_Elements) ? GROUP_SIZE : (Num_Elements - Start);
+      try { Populate_Ke_Batch(&Elements[Start], Count); }
+      catch (...) { Errors.Capture(); }
+    } // for(unsigned Start = 0; Start < Num_Elements; Start += GROUP_SIZE) {
+
+    Errors.Rethrow();
+
+    #if defined(KE_CACHE_MONITOR)
+      printf("Ke cache: %u elements, %u Ke's (not shared)\n", Num_Elements, Num_Ke);
+    #endif
+    return;
+  } // if(Share_Ke == false) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* First, find each element's key (in parallel). Then, give each distinct key
+  a class. Class_First_Element holds the first element of each class. */
+  std::vector<Key> Keys(Num_Elements);
+
+  #pragma omp parallel for schedule(static)
+  for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+    Keys[Element_Index] = Element_Key(Elements[Element_Index]);
+  } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+
+  std::unordered_map<Key, unsigned, Key_Hash> Key_Class;
+  Key_Class.reserve(Num_Elements);
+  std::vector<unsigned> Element_Class(Num_Elements);
+  std::vector<unsigned> Class_First_Element;
+
+  for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+    const unsigned New_Class = (unsigned)Class_First_Element.size();
+    const unsigned Class = Key_Class.emplace(Keys[Element_Index], New_Class).first->second;
+    if(Class == New_Class) { Class_First_Element.push_back(Element_Index); }
+
+    Element_Class[Element_Index] = Class;
+  } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Now, compute and pack each class's Ke (in parallel).
+  Num_Ke = (unsigned)Class_First_Element.size();
+  Ke_Slab = Allocate_Ke_Slab(Num_Ke);
+
+  #pragma omp parallel for schedule(dynamic, 16)
+  for(unsigned Class = 0; Class < Num_Ke; Class++) {
+    try {
+      Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> Ke_Full;
+      Elements[Class_First_Element[Class]].Compute_Ke(Ke_Full);
+      Pack_Ke(Ke_Full, Ke_Slab + (size_t)Class*KE_SLOT_SIZE);
+    } // try {
+    catch (...) { Errors.Capture(); }
+  } // for(unsigned Class = 0; Class < Num_Ke; Class++) {
+
+  Errors.Rethrow();
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Finally, point each element's Ke at its class's Ke.
+  for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+    Elements[Element_Index].Ke = Ke_Slab + (size_t)Element_Class[Element_Index]*KE_SLOT_SIZE;
+    Elements[Element_Index].Ke_Set_Up = true;
+  } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+
+  #if defined(KE_CACHE_MONITOR)
+    printf("Ke cache: %u elements share %u Ke's\n", Num_Elements, Num_Ke);
+  #endif
+} // void Ke_Cache::Populate_Ke(Element* Elements, const unsigned Num_Elements) {
+
+#endif
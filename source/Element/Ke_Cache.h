@@ -0,0 +1,84 @@
+#if !defined(KE_CACHE_HEADER)
+#define KE_CACHE_HEADER
+
+//#define KE_CACHE_MONITOR               // Prints the number of distinct Ke's
+
+#include "Errors.h"
+#include "Fixed_Matrix.h"
+#include "Element.h"
+
+/* Element stiffness matrix cache (and storage) class.
+An element's Ke only depends on the positions of its nodes relative to one
+another (and on the material, which is the same for every element, see
+Set_Element_Material). Thus, if one element is a translation of another (with
+its nodes in the same order), then both elements have the same Ke. Structured
+and extruded meshes are mostly made of such elements.
+
+The cache groups congruent elements into classes and computes one Ke per class.
+Every element in a class points its Ke at the class's Ke (so the class's
+elements don't store their own Ke, see Element::Ke). An element's key is made
+of its node positions relative to its first node, each rounded to a multiple of
+Quantum. Quantum is TOLERANCE times the smallest power of 2 that's at least as
+big as the element (the largest component of any relative position). Thus,
+elements whose nodes differ by less than about TOLERANCE times their size share
+a Ke, while elements of (nearly) the same size always get the same Quantum.
+Elements that land on either side of a rounding boundary just get separate
+classes.
+
+Every Ke in the cache is packed (see Ke_Index) and stored in one slab (one
+slot per Ke, see Allocate_Ke_Slab), so applying or assembling the elements'
+Ke's streams through memory. If Share_Ke is false, then elements don't share
+Ke's: element e's Ke is stored in slot e of the slab (so the Ke's are still
+stored contiguously, in element order).
+
+The cache must outlive every element that uses it. */
+class Ke_Cache {
+  private:
+    /* Key of an element: its quantized relative node positions (nodes 1-7,
+    relative to node 0) and the exponent of its Quantum. */
+    struct Key {
+      long long Coords[21];
+      int Exponent;
+
+      bool operator==(const Key & Other) const;
+    }; // struct Key {
+
+    struct Key_Hash {
+      size_t operator()(const Key & K) const;
+    }; // struct Key_Hash {
+
+    /* Find the key of an element. */
+    static Key Element_Key(const Element & El);                                // Intent: Read
+
+    /* If false, every element gets its own slot (see above). */
+    const bool Share_Ke;
+
+    /* The (packed) Ke of each class. The Ke of class k is stored at
+    Ke_Slab + k*KE_SLOT_SIZE. */
+    double * Ke_Slab = nullptr;
+    unsigned Num_Ke = 0;
+
+  public:
+    /* Relative tolerance used to compare elements. */
+    static constexpr double TOLERANCE = 1e-9;
+
+    Ke_Cache(const bool Share_Ke_In = true) : Share_Ke(Share_Ke_In) {}
+    ~Ke_Cache(void) { Free_Ke_Slab(Ke_Slab); }
+
+    /* Elements point into the slab, so the cache can't be copied. */
+    Ke_Cache(const Ke_Cache & Other) = delete;
+    Ke_Cache & operator=(const Ke_Cache & Other) = delete;
+
+    /* Group the elements into classes, compute each class's Ke, and point each
+    element's Ke at its class's Ke (if Share_Ke is false, then each element is
+    its own class). This does the same thing as running Populate_Ke on each
+    element (each element's nodes and the material must be set, and no
+    element's Ke can be set). This can only be done once per cache. */
+    void Populate_Ke(Element* Elements,                                        // Intent: Read/Write
+                     const unsigned Num_Elements);                             // Intent: Read
+
+    /* Number of distinct Ke's (classes) */
+    unsigned Get_Num_Ke(void) const { return Num_Ke; }
+}; // class Ke_Cache {
+
+#endif
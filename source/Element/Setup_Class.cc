@@ -8,11 +8,14 @@ static members. */
 
 #include "Element.h"
 #include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
 //#define SETUP_MONITOR                  // Prints Integration points, Shape function partials, D
 
 
 
-void Set_Element_Static_Members(Matrix<int> * ID_Ptr, Matrix<double> * K_Ptr, double * F_Ptr, Node * Node_Array_Ptr) {
+void Set_Element_Static_Members(Matrix<int> * ID_Ptr, Sparse_Matrix * K_Ptr, double * F_Ptr, Node * Node_Array_Ptr) {
   /* Function description:
   This function is used to set the static members for the Element class. This
   function also calculates the value of the shape functions (for the master
@@ -63,8 +66,8 @@ void Set_Element_Static_Members(Matrix<int> * ID_Ptr, Matrix<double> * K_Ptr, do
     Zeta_Int[i] = 0.57735026919*Zeta_a[i];
   } // for(int i = 0; i < 8; i++) {
 
-  /* Now, calculate Na, Na_Xi, Na_Eta, and Na_Zeta at each integration point for
-  each node */
+  /* Now, calculate Na, Na_Xi, Na_Eta, Na_Zeta, and Extrapolate at each
+  integration point for each node */
   for(int Point = 0; Point < 8; Point++) {
     for(int Node = 0; Node < 8; Node++) {
       Element::Na(Node, Point)      = (1./8.)*(1. + Xi_a[Node]*Xi_Int[Point])*
@@ -82,6 +85,14 @@ void Set_Element_Static_Members(Matrix<int> * ID_Ptr, Matrix<double> * K_Ptr, do
       Element::Na_Zeta(Node, Point) = (1./8.)*(1. + Xi_a[Node]*Xi_Int[Point])*
                                               (1. + Eta_a[Node]*Eta_Int[Point])*
                                               (Zeta_a[Node]);
+
+      /* Extrapolate(Node, Point) is the value at Node of the trilinear
+      function that is 1 at Point and 0 at the other integration points. The
+      integration points are at 1/sqrt(3) times the node positions, so this
+      is Na with the roles of the nodes and integration points swapped. */
+      Element::Extrapolate(Node, Point) = (1./8.)*(1. + sqrt(3.)*Xi_a[Node]*Xi_a[Point])*
+                                                  (1. + sqrt(3.)*Eta_a[Node]*Eta_a[Point])*
+                                                  (1. + sqrt(3.)*Zeta_a[Node]*Zeta_a[Point]);
     } // for(int Node = 0; Node < 8; Node++) {
   } // for(int Point = 0; Point < 8; Point++) {
 
@@ -131,7 +142,7 @@ void Set_Element_Static_Members(Matrix<int> * ID_Ptr, Matrix<double> * K_Ptr, do
       printf("|\n");
     } // for(int i = 0; i < 8; i++) {
   #endif
-} // void Set_Element_Static_Members(Matrix<int> * ID_Ptr, Matrix<double> * K_Ptr, double * F_Ptr, Node * Nodes_Ptr) {
+} // void Set_Element_Static_Members(Matrix<int> * ID_Ptr, Sparse_Matrix * K_Ptr, double * F_Ptr, Node * Nodes_Ptr) {
 
 
 
@@ -191,4 +202,179 @@ void Set_Element_Material(const double E, const double v) {
   #endif
 } // void Set_Element_Material(const double E, const double v) {
 
+
+
+void Set_K_Sparsity_Pattern(const Element * Elements, const unsigned Num_Elements, const unsigned Num_Global_Eq) {
+  /* Function description:
+  This function sets up the sparsity pattern of the global stiffness matrix, K.
+  The (I,J) component of K is non-zero only if global equations I and J belong
+  to nodes that share an element. Thus, K's pattern is completely determined by
+  the node-to-node adjacency of the mesh (expanded through the ID matrix).
+
+  We find this adjacency using a node-to-element map. For each node, we cycle
+  through the elements that contain it and collect their nodes. The ID matrix
+  gives each node's free components consecutive global equations (see
+  SetUp_ID_Num_Global_Eq and Simulation::Renumber_Equations), although the
+  nodes need not be numbered in order. Thus, cycling through the nodes in
+  order of their first equation generates the rows of K in order. Further, if
+  we sort each node's neighbors by their first equation, then the columns
+  within each row come out sorted. This lets us build IA and JA directly, in
+  O(number of stored components) operations (we never form a list of every
+  (I,J) pair that each element couples). */
+
+  /* Assumption 1:
+  This function assumes that the Element class static members have been set
+  (otherwise, K and ID do not point to anything). */
+  if(Element::Static_Members_Set == false) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Element Not Set Up Exception: Thrown by Set_K_Sparsity_Pattern\n"
+            "The element class static members (namely K and ID) must be set before\n"
+            "K's sparsity pattern can be set.\n");
+    throw Element_Not_Set_Up(Error_Message_Buffer);
+  } // if(Element::Static_Members_Set == false) {
+
+  const Matrix<int> & ID = *(Element::ID);
+  const unsigned Num_Nodes = ID.Get_Num_Rows();
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* First, build the node-to-element map. We store it in compressed form:
+  the elements that contain node n are
+      Node_Elements[Node_Elements_Start[n]], ... , Node_Elements[Node_Elements_Start[n+1] - 1]
+  Wedges list some nodes twice, so we skip an element's node if it already
+  appeared earlier in that element's node list. */
+  std::vector<unsigned> Node_Elements_Start(Num_Nodes + 1, 0);
+
+  for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+    const Element & El = Elements[Element_Index];
+
+    /* Assumption 2:
+    This function assumes that every element has been set up (otherwise we
+    don't know which nodes the element contains). */
+    if(El.Element_Set_Up == false) {
+      char Error_Message_Buffer[500];
+      sprintf(Error_Message_Buffer,
+              "Element Not Set Up Exception: Thrown by Set_K_Sparsity_Pattern\n"
+              "Element %u's nodes have not been set. Every element's nodes must be\n"
+              "set before K's sparsity pattern can be set.\n",
+              Element_Index);
+      throw Element_Not_Set_Up(Error_Message_Buffer);
+    } // if(El.Element_Set_Up == false) {
+
+    for(unsigned a = 0; a < 8; a++) {
+      bool Repeated = false;
+      for(unsigned b = 0; b < a; b++) {
+        if(El.Element_Nodes[b].ID == El.Element_Nodes[a].ID) { Repeated = true; break; }
+      } // for(unsigned b = 0; b < a; b++) {
+
+      if(Repeated == false) { Node_Elements_Start[El.Element_Nodes[a].ID + 1]++; }
+    } // for(unsigned a = 0; a < 8; a++) {
+  } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+
+  for(unsigned n = 0; n < Num_Nodes; n++) { Node_Elements_Start[n+1] += Node_Elements_Start[n]; }
+
+  std::vector<unsigned> Node_Elements(Node_Elements_Start[Num_Nodes]);
+  std::vector<unsigned> Next_Slot(Node_Elements_Start.begin(), Node_Elements_Start.end() - 1);
+
+  for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+    const Element & El = Elements[Element_Index];
+
+    for(unsigned a = 0; a < 8; a++) {
+      bool Repeated = false;
+      for(unsigned b = 0; b < a; b++) {
+        if(El.Element_Nodes[b].ID == El.Element_Nodes[a].ID) { Repeated = true; break; }
+      } // for(unsigned b = 0; b < a; b++) {
+
+      if(Repeated == false) {
+        const unsigned n = El.Element_Nodes[a].ID;
+        Node_Elements[Next_Slot[n]] = Element_Index;
+        Next_Slot[n]++;
+      } // if(Repeated == false) {
+    } // for(unsigned a = 0; a < 8; a++) {
+  } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Now, cycle through the nodes. For each node, collect its neighbors (every
+  node that shares an element with it, including itself). Marker[m] == n means
+  that node m has already been added to node n's neighbor list. Each free
+  component of node n is a row of K. That row's columns are the free
+  components of the neighbors whose global equation number is at least as big
+  as the row's (we only store the upper triangle). We add node n itself before
+  cycling through its elements, so every row gets its diagonal entry, even if
+  no element contains the node (a free node that's not part of the mesh). */
+  std::vector<int> IA;
+  std::vector<int> JA;
+  IA.reserve(Num_Global_Eq + 1);
+
+  /* First_Eq[n] is node n's first global equation (or -1 if all of its
+  components are fixed). Eq_Node[I] is the node whose first equation is I. */
+  std::vector<int> First_Eq(Num_Nodes, -1);
+  std::vector<unsigned> Eq_Node(Num_Global_Eq, (unsigned)-1);
+  for(unsigned n = 0; n < Num_Nodes; n++) {
+    for(unsigned Comp = 0; Comp < 3; Comp++) {
+      const int I = ID(n, Comp);
+      if(I != -1 && (First_Eq[n] == -1 || I < First_Eq[n])) { First_Eq[n] = I; }
+    } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+
+    if(First_Eq[n] != -1 && (unsigned)First_Eq[n] < Num_Global_Eq) { Eq_Node[First_Eq[n]] = n; }
+  } // for(unsigned n = 0; n < Num_Nodes; n++) {
+
+  std::vector<unsigned> Marker(Num_Nodes, (unsigned)-1);
+  std::vector<unsigned> Neighbors;
+  Neighbors.reserve(64);
+
+  for(unsigned Eq = 0; Eq < Num_Global_Eq; Eq++) {
+    const unsigned n = Eq_Node[Eq];
+    if(n == (unsigned)-1) { continue; }
+    Neighbors.clear();
+    Marker[n] = n;
+    Neighbors.push_back(n);
+
+    for(unsigned k = Node_Elements_Start[n]; k < Node_Elements_Start[n+1]; k++) {
+      const Element & El = Elements[Node_Elements[k]];
+
+      for(unsigned a = 0; a < 8; a++) {
+        const unsigned m = El.Element_Nodes[a].ID;
+        if(Marker[m] != n) {
+          Marker[m] = n;
+          Neighbors.push_back(m);
+        } // if(Marker[m] != n) {
+      } // for(unsigned a = 0; a < 8; a++) {
+    } // for(unsigned k = Node_Elements_Start[n]; k < Node_Elements_Start[n+1]; k++) {
+
+    std::sort(Neighbors.begin(), Neighbors.end(),
+              [&First_Eq](const unsigned a, const unsigned b) { return First_Eq[a] < First_Eq[b]; });
+
+    for(unsigned Comp = 0; Comp < 3; Comp++) {
+      const int I = ID(n, Comp);
+      if(I == -1) { continue; }
+
+      IA.push_back((int)JA.size());
+      for(unsigned l = 0; l < Neighbors.size(); l++) {
+        for(unsigned Comp_m = 0; Comp_m < 3; Comp_m++) {
+          const int J = ID(Neighbors[l], Comp_m);
+          if(J >= I) { JA.push_back(J); }
+        } // for(unsigned Comp_m = 0; Comp_m < 3; Comp_m++) {
+      } // for(unsigned l = 0; l < Neighbors.size(); l++) {
+    } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+  } // for(unsigned Eq = 0; Eq < Num_Global_Eq; Eq++) {
+  IA.push_back((int)JA.size());
+
+  /* Assumption 3:
+  This function assumes that Num_Global_Eq agrees with the ID matrix. */
+  if(IA.size() != Num_Global_Eq + 1) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Element Not Set Up Exception: Thrown by Set_K_Sparsity_Pattern\n"
+            "Num_Global_Eq = %u. However, the ID matrix has %u free components.\n",
+            Num_Global_Eq, (unsigned)IA.size() - 1);
+    throw Element_Not_Set_Up(Error_Message_Buffer);
+  } // if(IA.size() != Num_Global_Eq + 1) {
+
+  // Now, set K's pattern.
+  Element::K->Set_Pattern(Num_Global_Eq, IA, JA);
+} // void Set_K_Sparsity_Pattern(const Element * Elements, const unsigned Num_Elements, const unsigned Num_Global_Eq) {
+
 #endif
@@ -0,0 +1,174 @@
+#if !defined(ELEMENT_STRESS)
+#define ELEMENT_STRESS
+
+/* File description:
+This file holds the functions that recover the strain and stress in the
+elements once the displacements are known. */
+
+#include "Element.h"
+#include <stdio.h>
+#include <math.h>
+
+
+void Element::Find_Integration_Point_Strains(const Node * Nodes, double * Strain) const {
+  /* Function description:
+  This function finds the strain at each integration point using the same B
+  that Ke is built from (see Add_Ba_To_B). */
+
+  // First, collect the displacements of the element's nodes into Ue.
+  double Ue[24];
+  for(unsigned Node = 0; Node < 8; Node++) {
+    for(unsigned Comp = 0; Comp < 3; Comp++) {
+      Ue[3*Node + Comp] = Nodes[Element_Nodes[Node].ID].Get_Displacement_Component(Comp);
+    } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+  } // for(unsigned Node = 0; Node < 8; Node++) {
+
+  // Now, find B*Ue at each integration point.
+  double J;
+  Fixed_Matrix<3, 3, Memory::ROW_MAJOR> Coeff;
+  Fixed_Matrix<6, 24, Memory::COLUMN_MAJOR> B;
+
+  for(unsigned Point = 0; Point < 8; Point++) {
+    Calculate_Coefficient_Matrix(Point, Coeff, J);
+
+    if(J <= 0) {
+      char Error_Message_Buffer[500];
+      sprintf(Error_Message_Buffer,
+              "Element Bad Determinant Exception: Thrown in Element::Find_Integration_Point_Strains\n"
+              "The Jacobian determinant, J, must be a strictly positive quantity. However,\n"
+              "when calculating J for integration point %d, we got J = %lf.\n",
+              Point, J);
+      throw Element_Bad_Determinant(Error_Message_Buffer);
+    } // if(J <= 0) {
+
+    for(unsigned Node = 0; Node < 8; Node++) { Add_Ba_To_B(Node, Point, Coeff, J, B); }
+
+    // B is column major, so we add it in one column at a time.
+    double * Point_Strain = &Strain[6*Point];
+    for(unsigned i = 0; i < 6; i++) { Point_Strain[i] = 0; }
+    for(unsigned j = 0; j < 24; j++) {
+      for(unsigned i = 0; i < 6; i++) { Point_Strain[i] += B(i,j)*Ue[j]; }
+    } // for(unsigned j = 0; j < 24; j++) {
+  } // for(unsigned Point = 0; Point < 8; Point++) {
+} // void Element::Find_Integration_Point_Strains(const Node * Nodes, double * Strain) const {
+
+
+
+void Element::Find_Strain_Stress(const Node * Nodes, Array<double, 6> & Strain, Array<double, 6> & Stress) const {
+  /* Function description:
+  This function averages the strains at the 8 integration points, and then
+  finds the stress from the average strain. Stress is linear in strain, so
+  this is the same as averaging the stresses at the integration points. */
+
+  /* Assumption 1:
+  This function assumes that the material has been set (we need D). The
+  element's nodes must also be set (Calculate_Coefficient_Matrix checks
+  this). */
+  if(Material_Set == false) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Element Not Set Up Exception: Thrown by Element::Find_Strain_Stress\n"
+            "The stress depends on D. Thus, the element material must be set before\n"
+            "finding the stress.\n");
+    throw Element_Not_Set_Up(Error_Message_Buffer);
+  } // if(Material_Set == false) {
+
+  double Point_Strains[48];
+  Find_Integration_Point_Strains(Nodes, Point_Strains);
+
+  // Average the strain and find the stress.
+  for(unsigned i = 0; i < 6; i++) {
+    double Strain_Sum = 0;
+    for(unsigned Point = 0; Point < 8; Point++) { Strain_Sum += Point_Strains[6*Point + i]; }
+    Strain[i] = Strain_Sum/8.;
+  } // for(unsigned i = 0; i < 6; i++) {
+
+  for(unsigned i = 0; i < 6; i++) {
+    double Stress_i = 0;
+    for(unsigned j = 0; j < 6; j++) { Stress_i += D(i,j)*Strain[j]; }
+    Stress[i] = Stress_i;
+  } // for(unsigned i = 0; i < 6; i++) {
+} // void Element::Find_Strain_Stress(const Node * Nodes, Array<double, 6> & Strain, Array<double, 6> & Stress) const {
+
+
+
+void Element::Find_Nodal_Stresses(const Node * Nodes, double * Stress) const {
+  /* Function description:
+  This function finds the stress at each integration point, and then
+  extrapolates the stresses to the nodes (see Extrapolate). */
+
+  /* Assumption 1:
+  This function assumes that the material has been set (we need D). */
+  if(Material_Set == false) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Element Not Set Up Exception: Thrown by Element::Find_Nodal_Stresses\n"
+            "The stress depends on D. Thus, the element material must be set before\n"
+            "finding the stress.\n");
+    throw Element_Not_Set_Up(Error_Message_Buffer);
+  } // if(Material_Set == false) {
+
+  double Point_Strains[48];
+  Find_Integration_Point_Strains(Nodes, Point_Strains);
+
+  // Find the stress at each integration point.
+  double Point_Stresses[48];
+  for(unsigned Point = 0; Point < 8; Point++) {
+    for(unsigned i = 0; i < 6; i++) {
+      double Stress_i = 0;
+      for(unsigned j = 0; j < 6; j++) { Stress_i += D(i,j)*Point_Strains[6*Point + j]; }
+      Point_Stresses[6*Point + i] = Stress_i;
+    } // for(unsigned i = 0; i < 6; i++) {
+  } // for(unsigned Point = 0; Point < 8; Point++) {
+
+  // Now, extrapolate them to the nodes.
+  for(unsigned Node = 0; Node < 8; Node++) {
+    for(unsigned i = 0; i < 6; i++) {
+      double Stress_i = 0;
+      for(unsigned Point = 0; Point < 8; Point++) { Stress_i += Extrapolate(Node, Point)*Point_Stresses[6*Point + i]; }
+      Stress[6*Node + i] = Stress_i;
+    } // for(unsigned i = 0; i < 6; i++) {
+  } // for(unsigned Node = 0; Node < 8; Node++) {
+} // void Element::Find_Nodal_Stresses(const Node * Nodes, double * Stress) const {
+
+
+
+double Von_Mises_Stress(const double * Stress) {
+  const double xx_yy = Stress[0] - Stress[1];
+  const double yy_zz = Stress[1] - Stress[2];
+  const double zz_xx = Stress[2] - Stress[0];
+  const double Shear = Stress[3]*Stress[3] + Stress[4]*Stress[4] + Stress[5]*Stress[5];
+
+  return sqrt(0.5*(xx_yy*xx_yy + yy_zz*yy_zz + zz_xx*zz_xx) + 3.*Shear);
+} // double Von_Mises_Stress(const double * Stress) {
+
+
+
+void Find_Element_Stresses(const Node * Nodes, const Element * Elements, const unsigned Num_Elements, double * Strain, double * Stress, double * Von_Mises) {
+  /* Function description:
+  This function finds the strain and stress in each element. Each element
+  only reads its own nodes' displacements and writes its own part of Strain,
+  Stress, and Von_Mises, so the elements are independent. If an element
+  throws, we rethrow it once the loop is done (see Parallel_Errors). */
+
+  Parallel_Errors Errors;
+
+  #pragma omp parallel for schedule(static)
+  for(unsigned i = 0; i < Num_Elements; i++) {
+    try {
+      Array<double, 6> Element_Strain, Element_Stress;
+      Elements[i].Find_Strain_Stress(Nodes, Element_Strain, Element_Stress);
+
+      for(unsigned k = 0; k < 6; k++) {
+        Strain[6*(size_t)i + k] = Element_Strain[k];
+        Stress[6*(size_t)i + k] = Element_Stress[k];
+      } // for(unsigned k = 0; k < 6; k++) {
+      Von_Mises[i] = Von_Mises_Stress(&Stress[6*(size_t)i]);
+    } // try {
+    catch (...) { Errors.Capture(); }
+  } // for(unsigned i = 0; i < Num_Elements; i++) {
+
+  Errors.Rethrow();
+} // void Find_Element_Stresses(const Node * Nodes, const Element * Elements, const unsigned Num_Elements, double * Strain, double * Stress, double * Von_Mises) {
+
+#endif
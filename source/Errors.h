@@ -2,6 +2,7 @@
 #define ERRORS_HEADER
 
 #include <string>
+#include <exception>
 
 /* Note: The organization of my exception classes.
 I define, in this file, several different 'categories' of exceptions. There are
@@ -64,7 +65,12 @@ once. A "Node_Already_Set_Up" exception basically says "you tried to set
 something that has already been set and should not be modified".
 
 Fixed_Component: The user tried to modify a component of the Node's position
-that is fixed by a displacment BC. */
+that is fixed by a displacment BC.
+
+Free_Component: The opposite of Fixed_Component. The user tried to prescribe
+the displacement of a component that does not have a displacement BC (for
+example, in a load case). Such a component is an unknown, so its displacement
+can not be prescribed. */
 
 // Node exception base class
 class Node_Exception {
@@ -94,6 +100,12 @@ class Fixed_Component : public Node_Exception {
 }; // class Fixed_Component : public Node_Exception {
 
 
+class Free_Component : public Node_Exception {
+  public:
+    Free_Component(const char * Error_Message) : Node_Exception(Error_Message) {}
+}; // class Free_Component : public Node_Exception {
+
+
 
 
 
@@ -169,7 +181,15 @@ to another (move = operator).
 
 Matrix_Index_Out_Of_Bounds: This exception is thrown whenever the user tries to
 access a component that is outside of the matrix (requested row or column index
-is too big).*/
+is too big).
+
+Matrix_Not_Set_Up: This exception is thrown whenever the user tries to use a
+sparse matrix whose sparsity pattern has not been set (or tries to set the
+pattern of a sparse matrix a second time).
+
+Matrix_Not_In_Pattern: This exception is thrown whenever the user tries to
+write to a component of a sparse matrix that is not part of its sparsity
+pattern. Such a component is (by definition) zero and has no storage. */
 
 // Matrix Exception base class
 class Matrix_Exception {
@@ -196,6 +216,60 @@ class Matrix_Index_Out_Of_Bounds : public Matrix_Exception {
 
 
 
+class Matrix_Not_Set_Up : public Matrix_Exception {
+  public:
+    Matrix_Not_Set_Up(const char* Error_Message) : Matrix_Exception(Error_Message) {}
+}; // class Matrix_Not_Set_Up : public Matrix_Exception {
+
+
+
+class Matrix_Not_In_Pattern : public Matrix_Exception {
+  public:
+    Matrix_Not_In_Pattern(const char* Error_Message) : Matrix_Exception(Error_Message) {}
+}; // class Matrix_Not_In_Pattern : public Matrix_Exception {
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Solver Exceptions
+
+/* Here I define the Solver exception class and its children.
+________________________________________________________________________________
+              Description of the Solver Exception class children:
+Solver_Not_Set_Up: This exception is thrown whenever the user runs a solver
+method before the data it needs is ready. You can not, for example, solve
+Kx = F before K has been factored.
+
+Solver_Failed: This exception is thrown whenever the linear solver reports an
+error (Pardiso returns a non-zero error code, or PCG does not converge). The
+message includes what failed and why. */
+
+class Solver_Exception {
+  private:
+    const std::string Error_Message;
+  public:
+    Solver_Exception(const char* Error_Message) : Error_Message(Error_Message) {};
+    const char* what() const { return Error_Message.c_str(); }
+}; // class Solver_Exception {
+
+
+
+class Solver_Not_Set_Up : public Solver_Exception {
+  public:
+    Solver_Not_Set_Up(const char* Error_Message) : Solver_Exception(Error_Message) {}
+}; // class Solver_Not_Set_Up : public Solver_Exception {
+
+
+
+class Solver_Failed : public Solver_Exception {
+  public:
+    Solver_Failed(const char* Error_Message) : Solver_Exception(Error_Message) {}
+}; // class Solver_Failed : public Solver_Exception {
+
+
+
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -206,7 +280,15 @@ ________________________________________________________________________________
               Description of the IO Exception class children:
 File_Not_Found: This exception is thrown whenever the code is unable to open a
 requested file. This could be because the file does not exist or because the
-file name is erronious. */
+file name is erronious.
+
+Bad_File_Format: This exception is thrown whenever a file that we're reading
+isn't formatted the way that it should be (for example, if a node line in an
+inp file is missing a coordinate).
+
+Bad_Stream_Use: This exception is thrown whenever a streaming writer (such as
+IO::Write::vtk_Stream) is given its data out of order, is given more data than
+was declared, or is finished before all of the declared data was given. */
 
 class IO_Exception {
   private:
@@ -224,4 +306,72 @@ class Cant_Open_File : public IO_Exception {
 }; // class Cant_Open_File : public IO_Exception {
 
 
+
+class Bad_File_Format : public IO_Exception {
+  public:
+    Bad_File_Format(const char* Error_Message) : IO_Exception(Error_Message) {}
+}; // class Bad_File_Format : public IO_Exception {
+
+
+
+class Bad_Stream_Use : public IO_Exception {
+  public:
+    Bad_Stream_Use(const char* Error_Message) : IO_Exception(Error_Message) {}
+}; // class Bad_Stream_Use : public IO_Exception {
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Parallel errors
+
+/* Exceptions can't leave an OpenMP parallel region (the program is terminated
+if one does). Thus, every parallel loop whose body can throw catches
+everything in the body and hands it to a Parallel_Errors object:
+
+    Parallel_Errors Errors;
+    #pragma omp parallel for
+    for(...) {
+      try { ... }
+      catch (...) { Errors.Capture(); }
+    }
+    Errors.Rethrow();
+
+Capture keeps the first exception (later ones are dropped), and Rethrow
+rethrows it once we're back on one thread (and does nothing if nothing was
+thrown). Loops where a throw means the rest of the work is pointless can
+check Has_Error to skip it. */
+
+class Parallel_Errors {
+  private:
+    std::exception_ptr First_Error = nullptr;
+    int Error_Thrown = 0;
+
+  public:
+    /* Record the exception that is currently being handled. This must be
+    called from a catch block. */
+    void Capture(void) {
+      #pragma omp critical(Parallel_Errors_Capture)
+      {
+        if(First_Error == nullptr) { First_Error = std::current_exception(); }
+      } // #pragma omp critical(Parallel_Errors_Capture)
+
+      #pragma omp atomic write
+      Error_Thrown = 1;
+    } // void Capture(void) {
+
+    bool Has_Error(void) {
+      int Thrown;
+      #pragma omp atomic read
+      Thrown = Error_Thrown;
+      return (Thrown == 1);
+    } // bool Has_Error(void) {
+
+    /* Rethrow the first captured exception (if there is one). This must be
+    called outside of the parallel region. */
+    void Rethrow(void) const {
+      if(First_Error != nullptr) { std::rethrow_exception(First_Error); }
+    } // void Rethrow(void) const {
+}; // class Parallel_Errors {
+
 #endif
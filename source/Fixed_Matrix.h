@@ -0,0 +1,179 @@
+#if !defined(FIXED_MATRIX_HEADER)
+#define FIXED_MATRIX_HEADER
+
+#include "Matrix.h"
+#include <assert.h>
+
+/* Fixed size matrix class.
+The Matrix class allocates its array on the heap when it's constructed and
+checks every index that it's given. That's fine for big matricies that we
+build once, but the element kernels (see Ke.cc) construct and index lots of
+tiny matricies (3x3, 6x6, 6x24, 24x24) for every element. For those, the
+allocations and the checks cost more than the arithmetic does.
+
+A Fixed_Matrix's dimensions and memory layout are template parameters. Thus,
+its array lives inside the object (on the stack, or inside whatever object
+holds it), nothing is ever allocated, and the compiler knows every loop bound.
+Indices are only checked by assert (like the Array class), so the checks
+disappear when NDEBUG is defined. Mismatched dimensions are compile time
+errors, so, unlike Matrix, nothing here throws.
+
+Products and sums follow the same memory layout rules as the Matrix class (the
+product is row major only if both factors are row major). */
+
+template <unsigned Rows, unsigned Cols, Memory Layout>
+class Fixed_Matrix {
+  private:
+    // Where the matrix is actually stored.
+    double Ar[Rows*Cols];
+
+    // Position of the (i,j) component in Ar.
+    static constexpr unsigned Index(const unsigned i, const unsigned j) {
+      return (Layout == Memory::ROW_MAJOR) ? (Cols*i + j) : (i + Rows*j);
+    } // static constexpr unsigned Index(const unsigned i, const unsigned j) {
+
+    // Every Fixed_Matrix can read every other Fixed_Matrix's array.
+    template <unsigned Other_Rows, unsigned Other_Cols, Memory Other_Layout>
+    friend class Fixed_Matrix;
+
+  public:
+    //////////////////////////////////////////////////////////////////////////////
+    // Constructors
+
+    Fixed_Matrix(void) {}                                  // Do nothing default constructor
+    Fixed_Matrix(const Fixed_Matrix & Other) = default;    // Copies the array
+    Fixed_Matrix & operator=(const Fixed_Matrix & Other) = default;
+
+
+    //////////////////////////////////////////////////////////////////////////////
+    // Operator overloads
+
+    // Write to an element of the matrix
+    double & operator()(const unsigned i,                                      // Intent: Read
+                        const unsigned j) {                                    // Intent: Read
+      assert(i < Rows && j < Cols);
+      return Ar[Index(i,j)];
+    } // double & operator()(const unsigned i, const unsigned j) {
+
+    // Read an element of the matrix
+    double operator()(const unsigned i,                                        // Intent: Read
+                      const unsigned j) const {                                // Intent: Read
+      assert(i < Rows && j < Cols);
+      return Ar[Index(i,j)];
+    } // double operator()(const unsigned i, const unsigned j) const {
+
+    // Matrix-Matrix multiplication
+    template <unsigned Other_Cols, Memory Other_Layout>
+    Fixed_Matrix<Rows, Other_Cols, (Layout == Memory::ROW_MAJOR && Other_Layout == Memory::ROW_MAJOR) ? Memory::ROW_MAJOR : Memory::COLUMN_MAJOR>
+    operator*(const Fixed_Matrix<Cols, Other_Cols, Other_Layout> & Other) const;
+
+    // Scalar-Matrix multiplication
+    Fixed_Matrix operator*(const double c) const;
+
+    // Compound Matrix-Matrix addition
+    template <Memory Other_Layout>
+    Fixed_Matrix & operator+=(const Fixed_Matrix<Rows, Cols, Other_Layout> & Other);
+
+
+    //////////////////////////////////////////////////////////////////////////////
+    // Getter methods
+
+    static constexpr unsigned Get_Num_Rows(void) { return Rows; }
+    static constexpr unsigned Get_Num_Cols(void) { return Cols; }
+    static constexpr Memory Get_Memory_Layout(void) { return Layout; }
+
+
+    //////////////////////////////////////////////////////////////////////////////
+    // Other methods
+
+    void Fill(const double Val) {
+      for(unsigned k = 0; k < Rows*Cols; k++) { Ar[k] = Val; }
+    } // void Fill(const double Val) {
+}; // class Fixed_Matrix {
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Operator overloads
+
+// Matrix-Matrix multiplication
+template <unsigned Rows, unsigned Cols, Memory Layout>
+template <unsigned Other_Cols, Memory Other_Layout>
+Fixed_Matrix<Rows, Other_Cols, (Layout == Memory::ROW_MAJOR && Other_Layout == Memory::ROW_MAJOR) ? Memory::ROW_MAJOR : Memory::COLUMN_MAJOR>
+Fixed_Matrix<Rows, Cols, Layout>::operator*(const Fixed_Matrix<Cols, Other_Cols, Other_Layout> & Other) const {
+  /* Function Description:
+  This method computes the product of *this and Other. Each component of the
+  product is accumulated in a local variable over k (in order), so the product
+  is the same as the one that the Matrix class computes. Every loop bound is a
+  compile time constant, so the inner loops are fully unrolled. We loop over
+  the product in the order that it's stored. */
+  Fixed_Matrix<Rows, Other_Cols, (Layout == Memory::ROW_MAJOR && Other_Layout == Memory::ROW_MAJOR) ? Memory::ROW_MAJOR : Memory::COLUMN_MAJOR> Product;
+
+  if(Product.Get_Memory_Layout() == Memory::ROW_MAJOR) {
+    for(unsigned i = 0; i < Rows; i++) {
+      #pragma GCC unroll 24
+      for(unsigned j = 0; j < Other_Cols; j++) {
+        double Sum = 0;
+        #pragma GCC unroll 24
+        for(unsigned k = 0; k < Cols; k++) { Sum += Ar[Index(i,k)]*Other.Ar[Other.Index(k,j)]; }
+        Product.Ar[Product.Index(i,j)] = Sum;
+      } // for(unsigned j = 0; j < Other_Cols; j++) {
+    } // for(unsigned i = 0; i < Rows; i++) {
+  } // if(Product.Get_Memory_Layout() == Memory::ROW_MAJOR) {
+  else { // if(Product.Get_Memory_Layout() == Memory::COLUMN_MAJOR) {
+    for(unsigned j = 0; j < Other_Cols; j++) {
+      #pragma GCC unroll 24
+      for(unsigned i = 0; i < Rows; i++) {
+        double Sum = 0;
+        #pragma GCC unroll 24
+        for(unsigned k = 0; k < Cols; k++) { Sum += Ar[Index(i,k)]*Other.Ar[Other.Index(k,j)]; }
+        Product.Ar[Product.Index(i,j)] = Sum;
+      } // for(unsigned i = 0; i < Rows; i++) {
+    } // for(unsigned j = 0; j < Other_Cols; j++) {
+  } // else {
+
+  return Product;
+} // Fixed_Matrix<Rows, Other_Cols, ...> Fixed_Matrix<Rows, Cols, Layout>::operator*(const Fixed_Matrix<Cols, Other_Cols, Other_Layout> & Other) const {
+
+
+
+// Scalar-Matrix multiplication
+template <unsigned Rows, unsigned Cols, Memory Layout>
+Fixed_Matrix<Rows, Cols, Layout> Fixed_Matrix<Rows, Cols, Layout>::operator*(const double c) const {
+  Fixed_Matrix<Rows, Cols, Layout> Mc;
+
+  #pragma GCC unroll 24
+  for(unsigned k = 0; k < Rows*Cols; k++) { Mc.Ar[k] = c*Ar[k]; }
+
+  return Mc;
+} // Fixed_Matrix<Rows, Cols, Layout> Fixed_Matrix<Rows, Cols, Layout>::operator*(const double c) const {
+
+template <unsigned Rows, unsigned Cols, Memory Layout>
+Fixed_Matrix<Rows, Cols, Layout> operator*(const double c, const Fixed_Matrix<Rows, Cols, Layout> & M) { return M*c; }
+
+
+
+// Compound Matrix-Matrix addition
+template <unsigned Rows, unsigned Cols, Memory Layout>
+template <Memory Other_Layout>
+Fixed_Matrix<Rows, Cols, Layout> & Fixed_Matrix<Rows, Cols, Layout>::operator+=(const Fixed_Matrix<Rows, Cols, Other_Layout> & Other) {
+  /* If both matricies have the same layout, then their arrays line up.
+  Otherwise, we loop through *this in the order that it's stored. */
+  if(Layout == Other_Layout) {
+    for(unsigned k = 0; k < Rows*Cols; k++) { Ar[k] += Other.Ar[k]; }
+  } // if(Layout == Other_Layout) {
+  else if(Layout == Memory::ROW_MAJOR) {
+    for(unsigned i = 0; i < Rows; i++)
+      for(unsigned j = 0; j < Cols; j++)
+        Ar[Index(i,j)] += Other.Ar[Other.Index(i,j)];
+  } // else if(Layout == Memory::ROW_MAJOR) {
+  else { // if(Layout == Memory::COLUMN_MAJOR) {
+    for(unsigned j = 0; j < Cols; j++)
+      for(unsigned i = 0; i < Rows; i++)
+        Ar[Index(i,j)] += Other.Ar[Other.Index(i,j)];
+  } // else {
+
+  return *this;
+} // Fixed_Matrix<Rows, Cols, Layout> & Fixed_Matrix<Rows, Cols, Layout>::operator+=(const Fixed_Matrix<Rows, Cols, Other_Layout> & Other) {
+
+#endif
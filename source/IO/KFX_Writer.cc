@@ -40,6 +40,41 @@ void IO::Write::K_To_File(const Matrix<double>& K, const Printing_Mode Mode) {
 
 
 
+void IO::Write::K_To_File(const Sparse_Matrix& K, const Printing_Mode Mode) {
+  // First, open a new file
+  FILE* File = fopen("./IO/K.txt","w");
+
+  /* Check if there was a problem opening the file. If so, throw an exception. */
+  if(File == nullptr) {
+    char Buffer[500];
+    sprintf(Buffer,
+            "Can't Open File Exception: Thrown by IO::Write::K_To_File\n"
+            "For whatever reason, we couldn't open the K.txt file\n");
+    throw Cant_Open_File(Buffer);
+  } // if(File == nullptr) {
+
+  // Get the number of Rows (and columns) of K
+  const unsigned Num_Rows = K.Get_Num_Rows();
+
+  /* Print the full (dense) version of K, including the zeros and the lower
+  triangle. This is only intended for small problems (debugging) */
+  for(unsigned i = 0; i < Num_Rows; i++) {
+    fprintf(File,"| ");
+
+    for(unsigned j = 0; j < Num_Rows; j++) {
+      if(Mode == Printing_Mode::INTEGER) { fprintf(File,"%1.0lf ", K(i,j)); }
+      else { fprintf(File,"%8.1e ", K(i,j)); }
+    } // for(unsigned j = 0; j < Num_Rows; j++) {
+
+    fprintf(File,"|\n");
+  } // for(unsigned i = 0; i < Num_Rows; i++) {
+
+  // All done. Close the file
+  fclose(File);
+} // void IO::Write::K_To_File(const Sparse_Matrix& K, const Printing_Mode Mode) {
+
+
+
 void IO::Write::F_To_File(const double* F, const unsigned Num_Global_Eq) {
   // First, open a new file.
   FILE* File = fopen("./IO/F.txt","w");
@@ -4,6 +4,7 @@
 #include <stdio.h>
 #include "Errors.h"
 #include "Matrix.h"
+#include "Sparse/Sparse_Matrix.h"
 
 namespace IO {
   namespace Write {
@@ -11,6 +12,8 @@ namespace IO {
 
     void K_To_File(const Matrix<double>& K,                                    // Intent: Read
                    const Printing_Mode Mode = Printing_Mode::EXP);             // Intent: Read
+    void K_To_File(const Sparse_Matrix& K,                                     // Intent: Read
+                   const Printing_Mode Mode = Printing_Mode::EXP);             // Intent: Read
     void F_To_File(const double* F,                                            // Intent: Read
                    const unsigned Num_Global_Eq);                              // Intent: Read
     void x_To_File(const double* x,                                            // Intent: Read
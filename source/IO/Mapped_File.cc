@@ -0,0 +1,72 @@
+#if !defined(MAPPED_FILE_SOURCE)
+#define MAPPED_FILE_SOURCE
+
+#include "Mapped_File.h"
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+Mapped_File::Mapped_File(const std::string & File_Path, const char * Caller) {
+  /* Function description:
+  This constructor opens the requested file and maps it (read only). Once the
+  file is mapped, we no longer need its file descriptor (the mapping keeps the
+  file open), so we close it right away. mmap can't map an empty file, so an
+  empty file just gets Data = nullptr and Size = 0. */
+  const int File_Descriptor = open(File_Path.c_str(), O_RDONLY);
+
+  /* Check if the file could be opened. If not then throw an exception */
+  if(File_Descriptor == -1) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Can't Open File Exception: Thrown by %s\n"
+            "You tried to open the file %s.\n"
+            "However, no such file could be found.\n",
+            Caller, File_Path.c_str());
+    throw Cant_Open_File(Error_Message_Buffer);
+  } // if(File_Descriptor == -1) {
+
+  struct stat File_Status;
+  if(fstat(File_Descriptor, &File_Status) == -1 || S_ISREG(File_Status.st_mode) == false) {
+    close(File_Descriptor);
+
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Can't Open File Exception: Thrown by %s\n"
+            "You tried to open %s. However, it isn't a regular file.\n",
+            Caller, File_Path.c_str());
+    throw Cant_Open_File(Error_Message_Buffer);
+  } // if(fstat(File_Descriptor, &File_Status) == -1 || S_ISREG(File_Status.st_mode) == false) {
+
+  Size = (size_t)File_Status.st_size;
+  if(Size == 0) {
+    close(File_Descriptor);
+    return;
+  } // if(Size == 0) {
+
+  void * Map = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, File_Descriptor, 0);
+  close(File_Descriptor);
+
+  if(Map == MAP_FAILED) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Can't Open File Exception: Thrown by %s\n"
+            "You tried to open %s (%lu bytes). However, it could not be mapped.\n",
+            Caller, File_Path.c_str(), (unsigned long)Size);
+    throw Cant_Open_File(Error_Message_Buffer);
+  } // if(Map == MAP_FAILED) {
+
+  // We read the file front to back, so tell the kernel to read ahead.
+  posix_madvise(Map, Size, POSIX_MADV_SEQUENTIAL);
+
+  Data = (const char *)Map;
+} // Mapped_File::Mapped_File(const std::string & File_Path, const char * Caller) {
+
+
+
+Mapped_File::~Mapped_File(void) {
+  if(Data != nullptr) { munmap((void *)Data, Size); }
+} // Mapped_File::~Mapped_File(void) {
+
+#endif
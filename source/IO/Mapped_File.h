@@ -0,0 +1,39 @@
+#if !defined(MAPPED_FILE_HEADER)
+#define MAPPED_FILE_HEADER
+
+#include "Errors.h"
+#include <string>
+#include <stddef.h>
+
+/* Read only memory mapped file class.
+The inp reader used to read its file one line at a time (with getline) into a
+small buffer. A Mapped_File instead maps the whole file into our address space
+(with mmap), so the reader can scan the file's characters in place: nothing is
+copied, and the kernel reads ahead for us. The file is unmapped when the
+Mapped_File is destroyed.
+
+Note: The mapped characters are NOT null terminated. Every scan must stop at
+Get_End(). */
+class Mapped_File {
+  private:
+    const char * Data = nullptr;                 // First character of the file
+    size_t Size = 0;                             // Number of characters in the file
+
+  public:
+    /* Map the file at File_Path. This throws a Cant_Open_File exception if the
+    file can't be opened or mapped. Caller names the function that's opening
+    the file (for the error message). */
+    Mapped_File(const std::string & File_Path,                                 // Intent: Read
+                const char * Caller);                                          // Intent: Read
+    ~Mapped_File(void);
+
+    /* A Mapped_File owns its mapping, so it can't be copied. */
+    Mapped_File(const Mapped_File & Other) = delete;
+    Mapped_File & operator=(const Mapped_File & Other) = delete;
+
+    const char * Get_Data(void) const { return Data; }
+    const char * Get_End(void) const { return Data + Size; }
+    size_t Get_Size(void) const { return Size; }
+}; // class Mapped_File {
+
+#endif
@@ -0,0 +1,421 @@
+#if !defined(MESH_CACHE_SOURCE)
+#define MESH_CACHE_SOURCE
+
+#include "Mesh_Cache.h"
+#include "Mapped_File.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <vector>
+
+namespace {
+  /* On disk records. These only hold fixed width types, and every field is
+  naturally aligned, so there's no padding inside them (the Pad field is
+  always 0). */
+  struct Boundary_Record {
+    uint32_t Node_Number;
+    uint32_t Start_DOF;
+    uint32_t End_DOF;
+    uint32_t Pad;
+    double displacement;
+  }; // struct Boundary_Record {
+
+  struct Set_Boundary_Record {
+    uint32_t Name_Offset;                        // Index of the name's first char in the names section
+    uint32_t Name_Length;
+    uint32_t Start_DOF;
+    uint32_t End_DOF;
+    double displacement;
+  }; // struct Set_Boundary_Record {
+
+  struct Node_Set_Record {
+    uint32_t Name_Offset;
+    uint32_t Name_Length;
+    uint64_t First_Node;                         // Index of the set's first node in the node set nodes section
+    uint64_t Num_Nodes;
+  }; // struct Node_Set_Record {
+
+  static_assert(sizeof(Array<double,3>) == 3*sizeof(double), "Node positions must be 3 packed doubles");
+  static_assert(sizeof(Array<unsigned,8>) == 8*sizeof(uint32_t), "Element node lists must be 8 packed uint32's");
+  static_assert(sizeof(IO::Mesh_Cache_Header) % 8 == 0, "The header must keep the sections 8 byte aligned");
+
+  const char MAGIC[8] = "FEMMESH";
+  const unsigned NUM_SECTIONS = 8;
+  enum Section {NODES, ELEMENTS, TYPE_TAGS, BOUNDARIES, SET_BOUNDARIES, NODE_SETS, SET_NODES, NAMES};
+
+  size_t Padded(const size_t Size) { return (Size + 7) & ~(size_t)7; }
+
+  /* Find where each section starts (Offset[NUM_SECTIONS] is where the file
+  should end). This returns false if the header's counts don't fit in a file
+  of File_Size bytes (which also guards the multiplications below from
+  overflowing). */
+  bool Find_Sections(const IO::Mesh_Cache_Header & Header, const size_t File_Size, size_t Offset[NUM_SECTIONS + 1]) {
+    const uint64_t Counts[NUM_SECTIONS] = {Header.Num_Nodes, Header.Num_Elements, Header.Num_Elements, Header.Num_Boundaries,
+                                           Header.Num_Set_Boundaries, Header.Num_Node_Sets, Header.Num_Set_Nodes, Header.Names_Size};
+    const size_t Item_Size[NUM_SECTIONS] = {sizeof(Array<double,3>), sizeof(Array<unsigned,8>), sizeof(uint8_t), sizeof(Boundary_Record),
+                                            sizeof(Set_Boundary_Record), sizeof(Node_Set_Record), sizeof(uint32_t), sizeof(char)};
+
+    Offset[0] = sizeof(IO::Mesh_Cache_Header);
+    for(unsigned s = 0; s < NUM_SECTIONS; s++) {
+      if(Counts[s] > File_Size) { return false; }
+      Offset[s+1] = Offset[s] + Padded((size_t)Counts[s]*Item_Size[s]);
+      if(Offset[s+1] > File_Size) { return false; }
+    } // for(unsigned s = 0; s < NUM_SECTIONS; s++) {
+
+    return true;
+  } // bool Find_Sections(const IO::Mesh_Cache_Header & Header, const size_t File_Size, size_t Offset[NUM_SECTIONS + 1]) {
+
+
+
+  /* The checksum is the hash of the sections' hashes. That way, the writer
+  can hash each section as it writes it, and the reader can hash the sections
+  in parallel. */
+  uint64_t Combine_Section_Hashes(const uint64_t Section_Hash[NUM_SECTIONS]) {
+    return IO::Hash_Bytes((const char *)Section_Hash, NUM_SECTIONS*sizeof(uint64_t));
+  } // uint64_t Combine_Section_Hashes(const uint64_t Section_Hash[NUM_SECTIONS]) {
+
+
+
+  /* Write one (padded) section of the cache and return its hash. This
+  returns false if the write fails. */
+  bool Write_Section(FILE * File, const void * Data, const size_t Size, uint64_t & Section_Hash) {
+    static const char Zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    Section_Hash = IO::Hash_Bytes((const char *)Data, Size);
+
+    if(Size != 0 && fwrite(Data, 1, Size, File) != Size) { return false; }
+    const size_t Pad = Padded(Size) - Size;
+    if(Pad != 0 && fwrite(Zeros, 1, Pad, File) != Pad) { return false; }
+    return true;
+  } // bool Write_Section(FILE * File, const void * Data, const size_t Size, uint64_t & Section_Hash) {
+} // namespace {
+
+
+
+uint64_t IO::Hash_Bytes(const char * Data, const size_t Size) {
+  /* Function description:
+  This function hashes the bytes 8 at a time, in 4 independent lanes (so the
+  multiplies overlap). Each lane mixes in its words with an xor, a multiply
+  by an odd constant, and a shift (which moves the multiply's high bits back
+  down). The last few bytes are padded with zeros, and the size is mixed in
+  at the end (so padding doesn't collide with real zeros). */
+  const uint64_t Multiplier = 0x9E3779B97F4A7C15ULL;
+  uint64_t Lane[4] = {0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL, 0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL};
+
+  const size_t Num_Words = Size/8;
+  size_t i = 0;
+  for(; i + 4 <= Num_Words; i += 4) {
+    for(unsigned k = 0; k < 4; k++) {
+      uint64_t Word;
+      memcpy(&Word, Data + 8*(i + k), 8);
+      Lane[k] = (Lane[k] ^ Word)*Multiplier;
+      Lane[k] ^= Lane[k] >> 29;
+    } // for(unsigned k = 0; k < 4; k++) {
+  } // for(; i + 4 <= Num_Words; i += 4) {
+
+  // The words that are left over, then the bytes that are left over.
+  for(unsigned k = 0; i < Num_Words; i++, k++) {
+    uint64_t Word;
+    memcpy(&Word, Data + 8*i, 8);
+    Lane[k] = (Lane[k] ^ Word)*Multiplier;
+    Lane[k] ^= Lane[k] >> 29;
+  } // for(unsigned k = 0; i < Num_Words; i++, k++) {
+
+  if(Size % 8 != 0) {
+    uint64_t Word = 0;
+    memcpy(&Word, Data + 8*Num_Words, Size % 8);
+    Lane[3] = (Lane[3] ^ Word)*Multiplier;
+    Lane[3] ^= Lane[3] >> 29;
+  } // if(Size % 8 != 0) {
+
+  uint64_t Hash = (uint64_t)Size;
+  for(unsigned k = 0; k < 4; k++) {
+    Hash = (Hash ^ Lane[k])*Multiplier;
+    Hash ^= Hash >> 32;
+  } // for(unsigned k = 0; k < 4; k++) {
+
+  return Hash;
+} // uint64_t IO::Hash_Bytes(const char * Data, const size_t Size) {
+
+
+
+std::string IO::Mesh_Cache_Path(const std::string & File_Name) {
+  return "./IO/" + File_Name + ".cache";
+} // std::string IO::Mesh_Cache_Path(const std::string & File_Name) {
+
+
+
+bool IO::Read::mesh_cache(const std::string & File_Name, inp_mesh & Mesh) {
+  /* Function description:
+  This function maps File_Name's cache (see Mesh_Cache.h), checks that it's
+  usable, and then copies its arrays into Mesh. The cache is usable if:
+      It has the right magic, byte order, and version, and its size matches
+      its counts.
+      The inp file hasn't changed since the cache was written. If the inp
+      file's size and modification time match the ones in the header, and the
+      inp file was last modified before the cache was written, the inp file
+      hasn't changed. If its modification time doesn't match (or it was
+      modified the same second that the cache was written, which we can't
+      tell apart from a later change), we compare the inp file's hash instead.
+      The checksum matches, and every name and node set is inside the file.
+  If it isn't, we return false (reading the inp file will make a new cache). */
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* First, stat the inp file and map the cache. */
+  const std::string inp_Path = "./IO/" + File_Name;
+  struct stat inp_Status;
+  if(stat(inp_Path.c_str(), &inp_Status) == -1) { return false; }
+
+  const std::string Cache_Path = Mesh_Cache_Path(File_Name);
+  try {
+    const Mapped_File Cache{Cache_Path, "IO::Read::mesh_cache"};
+    const char * const Data = Cache.Get_Data();
+    const size_t Size = Cache.Get_Size();
+
+    Mesh_Cache_Header Header;
+    if(Size < sizeof(Header)) { return false; }
+    memcpy(&Header, Data, sizeof(Header));
+
+    if(memcmp(Header.Magic, MAGIC, sizeof(MAGIC)) != 0 || Header.Byte_Order != MESH_CACHE_BYTE_ORDER ||
+       Header.Version != MESH_CACHE_VERSION) { return false; }
+
+    size_t Offset[NUM_SECTIONS + 1];
+    if(Find_Sections(Header, Size, Offset) == false || Offset[NUM_SECTIONS] != Size) { return false; }
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    /* Next, check that the inp file hasn't changed. */
+    if(Header.inp_Size != (uint64_t)inp_Status.st_size) { return false; }
+
+    const bool Same_Time = (Header.inp_Modification_Time == (int64_t)inp_Status.st_mtime &&
+                            Header.inp_Modification_Time < Header.Write_Time);
+    if(Same_Time == false) {
+      const Mapped_File inp{inp_Path, "IO::Read::mesh_cache"};
+      if(Hash_Bytes(inp.Get_Data(), inp.Get_Size()) != Header.inp_Hash) { return false; }
+    } // if(Same_Time == false) {
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    /* Now, check the checksum (hashing the sections in parallel). */
+    uint64_t Section_Hash[NUM_SECTIONS];
+    const size_t Unpadded_Size[NUM_SECTIONS] = {(size_t)Header.Num_Nodes*sizeof(Array<double,3>),
+                                                (size_t)Header.Num_Elements*sizeof(Array<unsigned,8>),
+                                                (size_t)Header.Num_Elements*sizeof(uint8_t),
+                                                (size_t)Header.Num_Boundaries*sizeof(Boundary_Record),
+                                                (size_t)Header.Num_Set_Boundaries*sizeof(Set_Boundary_Record),
+                                                (size_t)Header.Num_Node_Sets*sizeof(Node_Set_Record),
+                                                (size_t)Header.Num_Set_Nodes*sizeof(uint32_t),
+                                                (size_t)Header.Names_Size};
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(unsigned s = 0; s < NUM_SECTIONS; s++) {
+      Section_Hash[s] = Hash_Bytes(Data + Offset[s], Unpadded_Size[s]);
+    } // for(unsigned s = 0; s < NUM_SECTIONS; s++) {
+
+    if(Combine_Section_Hashes(Section_Hash) != Header.Checksum) { return false; }
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    /* Check that every name and node set is inside the file, and that every
+    element's type tag matches its node list (wedges repeat nodes 2 and 6, see
+    the inp reader). Then, copy the sections into a new mesh. */
+    inp_mesh Cached_Mesh;
+
+    Cached_Mesh.Node_Positions.resize((size_t)Header.Num_Nodes);
+    if(Header.Num_Nodes != 0) { memcpy((void *)Cached_Mesh.Node_Positions.data(), Data + Offset[NODES], Unpadded_Size[NODES]); }
+
+    Cached_Mesh.Element_Node_Lists.resize((size_t)Header.Num_Elements);
+    if(Header.Num_Elements != 0) { memcpy((void *)Cached_Mesh.Element_Node_Lists.data(), Data + Offset[ELEMENTS], Unpadded_Size[ELEMENTS]); }
+
+    const uint8_t * Type_Tags = (const uint8_t *)(Data + Offset[TYPE_TAGS]);
+    for(size_t e = 0; e < (size_t)Header.Num_Elements; e++) {
+      const Array<unsigned,8> & List = Cached_Mesh.Element_Node_Lists[e];
+      const uint8_t Tag = (List[2] == List[3] && List[6] == List[7]) ? 1 : 0;
+      if(Type_Tags[e] > 1 || (Type_Tags[e] == 1 && Tag == 0)) { return false; }
+    } // for(size_t e = 0; e < (size_t)Header.Num_Elements; e++) {
+
+    const char * Names = Data + Offset[NAMES];
+    const Boundary_Record * Boundaries = (const Boundary_Record *)(Data + Offset[BOUNDARIES]);
+    Cached_Mesh.Boundary_List.resize((size_t)Header.Num_Boundaries);
+    for(size_t i = 0; i < (size_t)Header.Num_Boundaries; i++) {
+      Cached_Mesh.Boundary_List[i].Node_Number = Boundaries[i].Node_Number;
+      Cached_Mesh.Boundary_List[i].Start_DOF = Boundaries[i].Start_DOF;
+      Cached_Mesh.Boundary_List[i].End_DOF = Boundaries[i].End_DOF;
+      Cached_Mesh.Boundary_List[i].displacement = Boundaries[i].displacement;
+    } // for(size_t i = 0; i < (size_t)Header.Num_Boundaries; i++) {
+
+    const Set_Boundary_Record * Set_Boundaries = (const Set_Boundary_Record *)(Data + Offset[SET_BOUNDARIES]);
+    Cached_Mesh.Set_Boundary_List.resize((size_t)Header.Num_Set_Boundaries);
+    for(size_t i = 0; i < (size_t)Header.Num_Set_Boundaries; i++) {
+      const Set_Boundary_Record & Record = Set_Boundaries[i];
+      if((uint64_t)Record.Name_Offset + Record.Name_Length > Header.Names_Size) { return false; }
+
+      Cached_Mesh.Set_Boundary_List[i].Node_Set_Name.assign(Names + Record.Name_Offset, Record.Name_Length);
+      Cached_Mesh.Set_Boundary_List[i].Start_DOF = Record.Start_DOF;
+      Cached_Mesh.Set_Boundary_List[i].End_DOF = Record.End_DOF;
+      Cached_Mesh.Set_Boundary_List[i].displacement = Record.displacement;
+    } // for(size_t i = 0; i < (size_t)Header.Num_Set_Boundaries; i++) {
+
+    const Node_Set_Record * Node_Sets = (const Node_Set_Record *)(Data + Offset[NODE_SETS]);
+    const uint32_t * Set_Nodes = (const uint32_t *)(Data + Offset[SET_NODES]);
+    Cached_Mesh.Node_Sets.resize((size_t)Header.Num_Node_Sets);
+    for(size_t i = 0; i < (size_t)Header.Num_Node_Sets; i++) {
+      const Node_Set_Record & Record = Node_Sets[i];
+      if((uint64_t)Record.Name_Offset + Record.Name_Length > Header.Names_Size ||
+         Record.First_Node > Header.Num_Set_Nodes || Record.Num_Nodes > Header.Num_Set_Nodes - Record.First_Node) { return false; }
+
+      Cached_Mesh.Node_Sets[i].Name.assign(Names + Record.Name_Offset, Record.Name_Length);
+      Cached_Mesh.Node_Sets[i].Nodes.assign(Set_Nodes + Record.First_Node, Set_Nodes + Record.First_Node + Record.Num_Nodes);
+    } // for(size_t i = 0; i < (size_t)Header.Num_Node_Sets; i++) {
+
+    // All done. Hand the mesh over (swapping vectors doesn't copy them).
+    std::swap(Mesh.Node_Positions, Cached_Mesh.Node_Positions);
+    std::swap(Mesh.Element_Node_Lists, Cached_Mesh.Element_Node_Lists);
+    std::swap(Mesh.Boundary_List, Cached_Mesh.Boundary_List);
+    std::swap(Mesh.Set_Boundary_List, Cached_Mesh.Set_Boundary_List);
+    std::swap(Mesh.Node_Sets, Cached_Mesh.Node_Sets);
+  } // try {
+  catch (const Cant_Open_File &) { return false; }
+
+  return true;
+} // bool IO::Read::mesh_cache(const std::string & File_Name, inp_mesh & Mesh) {
+
+
+
+void IO::Write::mesh_cache(const std::string & File_Name, const Read::inp_mesh & Mesh) {
+  /* Function description:
+  This function writes Mesh to File_Name's cache (see Mesh_Cache.h). We write
+  the cache to a temporary file and then rename it, so a reader never maps a
+  half written cache (and a failed write leaves the old cache alone). The
+  header is written last, once we know the checksum.
+
+  Assumption 1: We can write to the IO directory. */
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* First, fill in the header. We hash the inp file (see Hash_Bytes). */
+  const std::string inp_Path = "./IO/" + File_Name;
+  Mesh_Cache_Header Header;
+  memset(&Header, 0, sizeof(Header));
+  memcpy(Header.Magic, MAGIC, sizeof(MAGIC));
+  Header.Byte_Order = MESH_CACHE_BYTE_ORDER;
+  Header.Version = MESH_CACHE_VERSION;
+
+  {
+    const Mapped_File inp{inp_Path, "IO::Write::mesh_cache"};
+    struct stat inp_Status;
+    if(stat(inp_Path.c_str(), &inp_Status) == -1) {
+      char Error_Message_Buffer[500];
+      sprintf(Error_Message_Buffer,
+              "Can't Open File Exception: Thrown by IO::Write::mesh_cache\n"
+              "Could not stat %s\n",
+              inp_Path.c_str());
+      throw Cant_Open_File(Error_Message_Buffer);
+    } // if(stat(inp_Path.c_str(), &inp_Status) == -1) {
+
+    Header.inp_Size = (uint64_t)inp.Get_Size();
+    Header.inp_Modification_Time = (int64_t)inp_Status.st_mtime;
+    Header.inp_Hash = Hash_Bytes(inp.Get_Data(), inp.Get_Size());
+  } // {
+  Header.Write_Time = (int64_t)time(nullptr);
+
+  Header.Num_Nodes = Mesh.Node_Positions.size();
+  Header.Num_Elements = Mesh.Element_Node_Lists.size();
+  Header.Num_Boundaries = Mesh.Boundary_List.size();
+  Header.Num_Set_Boundaries = Mesh.Set_Boundary_List.size();
+  Header.Num_Node_Sets = Mesh.Node_Sets.size();
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Next, convert the small sections (everything but the nodes and elements)
+  into their on disk records. */
+  std::vector<uint8_t> Type_Tags(Mesh.Element_Node_Lists.size());
+  for(size_t e = 0; e < Mesh.Element_Node_Lists.size(); e++) {
+    const Array<unsigned,8> & List = Mesh.Element_Node_Lists[e];
+    Type_Tags[e] = (List[2] == List[3] && List[6] == List[7]) ? 1 : 0;
+  } // for(size_t e = 0; e < Mesh.Element_Node_Lists.size(); e++) {
+
+  std::vector<Boundary_Record> Boundaries(Mesh.Boundary_List.size());
+  for(size_t i = 0; i < Mesh.Boundary_List.size(); i++) {
+    Boundaries[i].Node_Number = Mesh.Boundary_List[i].Node_Number;
+    Boundaries[i].Start_DOF = Mesh.Boundary_List[i].Start_DOF;
+    Boundaries[i].End_DOF = Mesh.Boundary_List[i].End_DOF;
+    Boundaries[i].Pad = 0;
+    Boundaries[i].displacement = Mesh.Boundary_List[i].displacement;
+  } // for(size_t i = 0; i < Mesh.Boundary_List.size(); i++) {
+
+  std::string Names;
+  std::vector<Set_Boundary_Record> Set_Boundaries(Mesh.Set_Boundary_List.size());
+  for(size_t i = 0; i < Mesh.Set_Boundary_List.size(); i++) {
+    Set_Boundaries[i].Name_Offset = (uint32_t)Names.size();
+    Set_Boundaries[i].Name_Length = (uint32_t)Mesh.Set_Boundary_List[i].Node_Set_Name.size();
+    Set_Boundaries[i].Start_DOF = Mesh.Set_Boundary_List[i].Start_DOF;
+    Set_Boundaries[i].End_DOF = Mesh.Set_Boundary_List[i].End_DOF;
+    Set_Boundaries[i].displacement = Mesh.Set_Boundary_List[i].displacement;
+    Names += Mesh.Set_Boundary_List[i].Node_Set_Name;
+  } // for(size_t i = 0; i < Mesh.Set_Boundary_List.size(); i++) {
+
+  std::vector<Node_Set_Record> Node_Sets(Mesh.Node_Sets.size());
+  std::vector<uint32_t> Set_Nodes;
+  for(size_t i = 0; i < Mesh.Node_Sets.size(); i++) {
+    Node_Sets[i].Name_Offset = (uint32_t)Names.size();
+    Node_Sets[i].Name_Length = (uint32_t)Mesh.Node_Sets[i].Name.size();
+    Node_Sets[i].First_Node = Set_Nodes.size();
+    Node_Sets[i].Num_Nodes = Mesh.Node_Sets[i].Nodes.size();
+    Names += Mesh.Node_Sets[i].Name;
+    Set_Nodes.insert(Set_Nodes.end(), Mesh.Node_Sets[i].Nodes.begin(), Mesh.Node_Sets[i].Nodes.end());
+  } // for(size_t i = 0; i < Mesh.Node_Sets.size(); i++) {
+
+  Header.Num_Set_Nodes = Set_Nodes.size();
+  Header.Names_Size = Names.size();
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Now, write the sections (after a blank header), then the header. */
+  const std::string Cache_Path = Mesh_Cache_Path(File_Name);
+  const std::string Temp_Path = Cache_Path + ".tmp";
+  FILE * File = fopen(Temp_Path.c_str(), "wb");
+
+  /* Assumption 1 */
+  if(File == nullptr) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Can't Open File Exception: Thrown by IO::Write::mesh_cache\n"
+            "Could not create %s\n",
+            Temp_Path.c_str());
+    throw Cant_Open_File(Error_Message_Buffer);
+  } // if(File == nullptr) {
+
+  const Mesh_Cache_Header Blank_Header = Header;
+  uint64_t Section_Hash[NUM_SECTIONS];
+  bool Written = (fwrite(&Blank_Header, sizeof(Blank_Header), 1, File) == 1);
+  Written = Written && Write_Section(File, Mesh.Node_Positions.data(), Mesh.Node_Positions.size()*sizeof(Array<double,3>), Section_Hash[NODES]);
+  Written = Written && Write_Section(File, Mesh.Element_Node_Lists.data(), Mesh.Element_Node_Lists.size()*sizeof(Array<unsigned,8>), Section_Hash[ELEMENTS]);
+  Written = Written && Write_Section(File, Type_Tags.data(), Type_Tags.size()*sizeof(uint8_t), Section_Hash[TYPE_TAGS]);
+  Written = Written && Write_Section(File, Boundaries.data(), Boundaries.size()*sizeof(Boundary_Record), Section_Hash[BOUNDARIES]);
+  Written = Written && Write_Section(File, Set_Boundaries.data(), Set_Boundaries.size()*sizeof(Set_Boundary_Record), Section_Hash[SET_BOUNDARIES]);
+  Written = Written && Write_Section(File, Node_Sets.data(), Node_Sets.size()*sizeof(Node_Set_Record), Section_Hash[NODE_SETS]);
+  Written = Written && Write_Section(File, Set_Nodes.data(), Set_Nodes.size()*sizeof(uint32_t), Section_Hash[SET_NODES]);
+  Written = Written && Write_Section(File, Names.data(), Names.size(), Section_Hash[NAMES]);
+
+  if(Written == true) {
+    Header.Checksum = Combine_Section_Hashes(Section_Hash);
+    Written = (fseek(File, 0, SEEK_SET) == 0 && fwrite(&Header, sizeof(Header), 1, File) == 1);
+  } // if(Written == true) {
+
+  Written = (fclose(File) == 0) && Written;
+  Written = Written && (rename(Temp_Path.c_str(), Cache_Path.c_str()) == 0);
+
+  /* Assumption 1 */
+  if(Written == false) {
+    remove(Temp_Path.c_str());
+
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Can't Open File Exception: Thrown by IO::Write::mesh_cache\n"
+            "Could not write %s\n",
+            Cache_Path.c_str());
+    throw Cant_Open_File(Error_Message_Buffer);
+  } // if(Written == false) {
+} // void IO::Write::mesh_cache(const std::string & File_Name, const Read::inp_mesh & Mesh) {
+
+#endif
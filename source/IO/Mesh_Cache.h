@@ -0,0 +1,88 @@
+#if !defined(MESH_CACHE_HEADER)
+#define MESH_CACHE_HEADER
+
+#include "Errors.h"
+#include "IO/inp_Reader.h"
+#include <string>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Binary mesh cache.
+Reading a big inp file means scanning (and converting) every character of it.
+Once we've read an inp file, we can save the mesh (an inp_mesh) in a binary
+cache file next to it (./IO/<inp file name>.cache). The next time we need the
+mesh, we just map the cache and copy its arrays, which is about as fast as the
+disk (or page cache) can go.
+
+A cache file is:
+    A header (Mesh_Cache_Header, below)
+    Node positions             3*Num_Nodes doubles (x, y, z of each node)
+    Element node lists         8*Num_Elements uint32's (0 indexed)
+    Element type tags          Num_Elements uint8's (0 = brick, 1 = wedge)
+    Boundary data              Num_Boundaries Boundary_Records
+    Set boundary data          Num_Set_Boundaries Set_Boundary_Records
+    Node sets                  Num_Node_Sets Node_Set_Records
+    Node set nodes             Num_Set_Nodes uint32's (every node set's nodes, in order)
+    Names                      Names_Size chars (node set names, not null terminated)
+Each section starts on an 8 byte boundary (we pad with zeros). Everything is
+stored in the byte order of the machine that wrote the file.
+
+The header records the size, modification time, and a hash of the inp file
+that the cache was made from. A cache is only used if the inp file has the
+same size and modification time or, if its modification time changed (it was
+copied or touched, for example), the same hash. The header also has a
+checksum of everything after it, so a truncated or corrupted cache is never
+used. */
+
+namespace IO {
+  struct Mesh_Cache_Header {
+    char Magic[8];                               // "FEMMESH" (null terminated)
+    uint32_t Byte_Order;                         // MESH_CACHE_BYTE_ORDER, as written by the writer
+    uint32_t Version;                            // MESH_CACHE_VERSION
+
+    uint64_t inp_Size;                           // Size of the inp file (in bytes)
+    int64_t inp_Modification_Time;               // Seconds since the epoch
+    int64_t Write_Time;                          // When the cache was written (seconds since the epoch)
+    uint64_t inp_Hash;                           // Hash_Bytes of the inp file
+
+    uint64_t Num_Nodes;
+    uint64_t Num_Elements;
+    uint64_t Num_Boundaries;
+    uint64_t Num_Set_Boundaries;
+    uint64_t Num_Node_Sets;
+    uint64_t Num_Set_Nodes;
+    uint64_t Names_Size;
+
+    uint64_t Checksum;                           // Hash_Bytes of everything after the header
+  }; // struct Mesh_Cache_Header {
+
+  const uint32_t MESH_CACHE_BYTE_ORDER = 0x01020304;
+  const uint32_t MESH_CACHE_VERSION = 1;
+
+  /* A 64 bit hash of Size bytes. This isn't cryptographic; it's just meant to
+  catch changes (and corruption), and to run at memory speed. */
+  uint64_t Hash_Bytes(const char * Data,                                       // Intent: Read
+                      const size_t Size);                                      // Intent: Read
+
+  /* The path of the cache for the inp file File_Name (in the IO directory). */
+  std::string Mesh_Cache_Path(const std::string & File_Name);                 // Intent: Read
+
+  namespace Read {
+    /* Load the mesh of the inp file File_Name from its cache. If there's no
+    cache, or it's out of date (or otherwise unusable), this returns false and
+    leaves Mesh alone. Otherwise, this replaces Mesh's contents with the cached
+    mesh and returns true. */
+    bool mesh_cache(const std::string & File_Name,                             // Intent: Read
+                    inp_mesh & Mesh);                                          // Intent: Write
+  } // namespace Read {
+
+  namespace Write {
+    /* Save Mesh (which should have been read from the inp file File_Name) to
+    File_Name's cache. This throws a Cant_Open_File exception if the inp file
+    can't be opened or the cache can't be written. */
+    void mesh_cache(const std::string & File_Name,                             // Intent: Read
+                    const Read::inp_mesh & Mesh);                              // Intent: Read
+  } // namespace Write {
+} // namespace IO {
+
+#endif
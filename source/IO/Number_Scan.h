@@ -0,0 +1,177 @@
+#if !defined(NUMBER_SCAN_HEADER)
+#define NUMBER_SCAN_HEADER
+
+#include <string.h>
+#include <stdlib.h>
+#include <string>
+
+/* Number scanning functions.
+These functions read numbers out of a character range (such as a Mapped_File)
+that is NOT null terminated, so every function takes the end of the range.
+Each one skips any separators (spaces, tabs, commas, and carriage returns) in
+front of the number, reads the number, and then moves the position past it.
+None of them moves past the end of the current line.
+
+sscanf has to parse its format string, check the locale, and null terminate
+its input every time it's called. The inp reader scans millions of numbers, so
+we scan them by hand instead. Scan_Double reads most numbers exactly (and
+quickly) on its own: if the number has at most 15 significant digits and a
+(decimal) exponent of at most 22 in magnitude, then both the digits and the
+power of 10 are exact doubles, so one multiplication or division (which IEEE
+arithmetic correctly rounds) gives the correctly rounded result. Every other
+number is handed to strtod. Either way, Scan_Double returns exactly what
+strtod would. */
+
+namespace IO {
+  namespace Scan {
+    inline bool Is_Separator(const char c) { return (c == ' ' || c == ',' || c == '\t' || c == '\r'); }
+    inline bool Is_Digit(const char c) { return (c >= '0' && c <= '9'); }
+
+    // Move p past any separators.
+    inline const char * Skip_Separators(const char * p,                        // Intent: Read
+                                        const char * End) {                    // Intent: Read
+      while(p < End && Is_Separator(*p)) { p++; }
+      return p;
+    } // inline const char * Skip_Separators(const char * p, const char * End) {
+
+    // Find the start of the line after the one that contains p (or End).
+    inline const char * Next_Line(const char * p,                              // Intent: Read
+                                  const char * End) {                          // Intent: Read
+      const void * Newline = memchr(p, '\n', (size_t)(End - p));
+      return (Newline == nullptr) ? End : ((const char *)Newline + 1);
+    } // inline const char * Next_Line(const char * p, const char * End) {
+
+    // Is there anything but separators between p and the end of the line?
+    inline bool Line_Is_Blank(const char * p,                                  // Intent: Read
+                              const char * End) {                              // Intent: Read
+      p = Skip_Separators(p, End);
+      return (p == End || *p == '\n');
+    } // inline bool Line_Is_Blank(const char * p, const char * End) {
+
+
+    /* Read an unsigned integer. This returns false (and doesn't move p) if the
+    next non-separator character isn't a digit. */
+    inline bool Scan_Unsigned(const char * & p,                                // Intent: Read/Write
+                              const char * End,                                // Intent: Read
+                              unsigned & Value) {                              // Intent: Write
+      const char * q = Skip_Separators(p, End);
+      if(q == End || Is_Digit(*q) == false) { return false; }
+
+      unsigned Sum = 0;
+      while(q < End && Is_Digit(*q)) {
+        Sum = 10*Sum + (unsigned)(*q - '0');
+        q++;
+      } // while(q < End && Is_Digit(*q)) {
+
+      Value = Sum;
+      p = q;
+      return true;
+    } // inline bool Scan_Unsigned(const char * & p, const char * End, unsigned & Value) {
+
+
+    /* Read a double (in any form that strtod accepts, other than hex, inf,
+    and nan). This returns false (and doesn't move p) if there's no number
+    before the next separator. */
+    inline bool Scan_Double(const char * & p,                                  // Intent: Read/Write
+                            const char * End,                                  // Intent: Read
+                            double & Value) {                                  // Intent: Write
+      static const double Powers_Of_10[23] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                              1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                              1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+      const char * Start = Skip_Separators(p, End);
+      const char * q = Start;
+
+      bool Negative = false;
+      if(q < End && (*q == '-' || *q == '+')) {
+        Negative = (*q == '-');
+        q++;
+      } // if(q < End && (*q == '-' || *q == '+')) {
+
+      /* Read the digits (before and after the decimal point) into Mantissa.
+      Leading zeros aren't significant. If there are more than 19 significant
+      digits, Mantissa would overflow, so we stop adding them (the number then
+      goes to strtod). Exponent is the power of 10 that Mantissa is scaled by. */
+      unsigned long long Mantissa = 0;
+      unsigned Num_Digits = 0;                   // Number of significant digits in Mantissa
+      bool Truncated = false;
+      bool Has_Digits = false;
+      int Exponent = 0;
+
+      while(q < End && Is_Digit(*q)) {
+        Has_Digits = true;
+        if(Num_Digits < 19) {
+          Mantissa = 10*Mantissa + (unsigned long long)(*q - '0');
+          if(Mantissa != 0) { Num_Digits++; }
+        } // if(Num_Digits < 19) {
+        else { Exponent++; Truncated = true; }
+        q++;
+      } // while(q < End && Is_Digit(*q)) {
+
+      if(q < End && *q == '.') {
+        q++;
+        while(q < End && Is_Digit(*q)) {
+          Has_Digits = true;
+          if(Num_Digits < 19) {
+            Mantissa = 10*Mantissa + (unsigned long long)(*q - '0');
+            if(Mantissa != 0) { Num_Digits++; }
+            Exponent--;
+          } // if(Num_Digits < 19) {
+          else { Truncated = true; }
+          q++;
+        } // while(q < End && Is_Digit(*q)) {
+      } // if(q < End && *q == '.') {
+
+      if(Has_Digits == false) { return false; }
+
+      // Read the exponent (if there is one; "1e" is just 1 followed by an e).
+      if(q < End && (*q == 'e' || *q == 'E')) {
+        const char * e = q + 1;
+        bool Negative_Exponent = false;
+        if(e < End && (*e == '-' || *e == '+')) {
+          Negative_Exponent = (*e == '-');
+          e++;
+        } // if(e < End && (*e == '-' || *e == '+')) {
+
+        if(e < End && Is_Digit(*e)) {
+          int Written_Exponent = 0;
+          while(e < End && Is_Digit(*e)) {
+            if(Written_Exponent < 100000) { Written_Exponent = 10*Written_Exponent + (*e - '0'); }
+            e++;
+          } // while(e < End && Is_Digit(*e)) {
+
+          Exponent += Negative_Exponent ? -Written_Exponent : Written_Exponent;
+          q = e;
+        } // if(e < End && Is_Digit(*e)) {
+      } // if(q < End && (*q == 'e' || *q == 'E')) {
+
+
+      // Fast path (see above).
+      if(Mantissa == 0) {
+        Value = Negative ? -0.0 : 0.0;
+        p = q;
+        return true;
+      } // if(Mantissa == 0) {
+
+      if(Truncated == false && Num_Digits <= 15 && Exponent >= -22 && Exponent <= 22) {
+        double Magnitude = (double)Mantissa;
+        if(Exponent < 0) { Magnitude /= Powers_Of_10[-Exponent]; }
+        else             { Magnitude *= Powers_Of_10[Exponent]; }
+
+        Value = Negative ? -Magnitude : Magnitude;
+        p = q;
+        return true;
+      } // if(Truncated == false && Num_Digits <= 15 && Exponent >= -22 && Exponent <= 22) {
+
+
+      /* Slow path: strtod needs a null terminated string, so copy the number
+      out of the file first. */
+      const std::string Number(Start, (size_t)(q - Start));
+      Value = strtod(Number.c_str(), nullptr);
+      p = q;
+      return true;
+    } // inline bool Scan_Double(const char * & p, const char * End, double & Value) {
+  } // namespace Scan {
+} // namespace IO {
+
+#endif
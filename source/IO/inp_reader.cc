@@ -2,169 +2,676 @@
 #define INP_READER_SOURCE
 
 #include "inp_Reader.h"
+#include "Mapped_File.h"
+#include "Number_Scan.h"
+#include <ctype.h>
 
-void IO::Read::inp(const std::string & File_Name, class std::list<Array<double, 3>> & Node_Positions, class std::list<Array<unsigned,8>> & Element_Node_Lists, class std::list<inp_boundary_data> & Boundary_List) {
+/* File description:
+The inp readers map the inp file (see Mapped_File.h) and scan it in place. An
+inp file is a sequence of sections. Each section starts with a keyword line (a
+line that starts with a single '*', such as "*Node" or "*Nset, nset=Top,
+generate"), and is followed by that section's data lines. Lines that start
+with "**" are comments.
+
+Before we read a section, we find its end (the next keyword line) and count
+its data lines, so we can size the arrays once. We then read each data line
+with the scanners in Number_Scan.h. IO::Read::inp finds every section of the
+file up front, which lets it read the node and element sections in parallel
+(see Find_Sections). */
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Keyword line functions
+
+namespace {
+  // Find the end of the line that contains p (the '\n', or End).
+  const char * Line_End(const char * p, const char * End) {
+    const void * Newline = memchr(p, '\n', (size_t)(End - p));
+    return (Newline == nullptr) ? End : (const char *)Newline;
+  } // const char * Line_End(const char * p, const char * End) {
+
+
+
+  // Does Line start with a single '*'?
+  bool Is_Keyword_Line(const char * Line, const char * End) {
+    return (Line < End && Line[0] == '*' && (Line + 1 == End || Line[1] != '*'));
+  } // bool Is_Keyword_Line(const char * Line, const char * End) {
+
+
+
+  /* Is [Start, Stop) the same (ignoring case, as well as any spaces on either
+  side) as Word? inp keywords and parameter names aren't case sensitive. */
+  bool Same_Word(const char * Start, const char * Stop, const char * Word) {
+    while(Start < Stop && (*Start == ' ' || *Start == '\t')) { Start++; }
+    while(Stop > Start && (Stop[-1] == ' ' || Stop[-1] == '\t' || Stop[-1] == '\r')) { Stop--; }
+
+    const size_t Length = strlen(Word);
+    if((size_t)(Stop - Start) != Length) { return false; }
+
+    for(size_t i = 0; i < Length; i++) {
+      if(tolower((unsigned char)Start[i]) != tolower((unsigned char)Word[i])) { return false; }
+    } // for(size_t i = 0; i < Length; i++) {
+
+    return true;
+  } // bool Same_Word(const char * Start, const char * Stop, const char * Word) {
+
+
+
+  /* Is the keyword of the keyword line Line (the text between the '*' and the
+  first comma) Keyword? Note that "*Node Output" is not a *Node line. */
+  bool Has_Keyword(const char * Line, const char * End, const char * Keyword) {
+    const char * Stop = Line_End(Line, End);
+    const char * Comma = (const char *)memchr(Line, ',', (size_t)(Stop - Line));
+    if(Comma != nullptr) { Stop = Comma; }
+
+    return Same_Word(Line + 1, Stop, Keyword);
+  } // bool Has_Keyword(const char * Line, const char * End, const char * Keyword) {
+
+
+
+  /* Find a parameter of a keyword line. Parameters follow the keyword and are
+  separated by commas. They are either "name=value" (such as "nset=Top") or
+  just a name (such as "generate"). If the line has the parameter, then this
+  returns true and sets Value to the parameter's value (which is empty if the
+  parameter has no value). */
+  bool Find_Parameter(const char * Line, const char * End, const char * Name, std::string & Value) {
+    const char * Stop = Line_End(Line, End);
+    const char * p = (const char *)memchr(Line, ',', (size_t)(Stop - Line));
+
+    while(p != nullptr) {
+      const char * Start = p + 1;
+      const char * Next_Comma = (const char *)memchr(Start, ',', (size_t)(Stop - Start));
+      const char * Parameter_End = (Next_Comma == nullptr) ? Stop : Next_Comma;
+      const char * Equals = (const char *)memchr(Start, '=', (size_t)(Parameter_End - Start));
+
+      if(Same_Word(Start, (Equals == nullptr) ? Parameter_End : Equals, Name)) {
+        Value.clear();
+        if(Equals != nullptr) {
+          const char * Value_Start = Equals + 1;
+          const char * Value_End = Parameter_End;
+          while(Value_Start < Value_End && (*Value_Start == ' ' || *Value_Start == '\t')) { Value_Start++; }
+          while(Value_End > Value_Start && (Value_End[-1] == ' ' || Value_End[-1] == '\t' || Value_End[-1] == '\r')) { Value_End--; }
+          Value.assign(Value_Start, (size_t)(Value_End - Value_Start));
+        } // if(Equals != nullptr) {
+
+        return true;
+      } // if(Same_Word(Start, (Equals == nullptr) ? Parameter_End : Equals, Name)) {
+
+      p = Next_Comma;
+    } // while(p != nullptr) {
+
+    return false;
+  } // bool Find_Parameter(const char * Line, const char * End, const char * Name, std::string & Value) {
+
+
+
+  // Is the line at p a data line (not a keyword line, a comment, or blank)?
+  bool Is_Data_Line(const char * p, const char * End) {
+    return (*p != '*' && IO::Scan::Line_Is_Blank(p, End) == false);
+  } // bool Is_Data_Line(const char * p, const char * End) {
+
+
+
+  /* Find the end of the section whose data lines start at p (the next keyword
+  line, or End), and count its data lines. */
+  const char * Section_End(const char * p, const char * End, size_t & Num_Data_Lines) {
+    Num_Data_Lines = 0;
+
+    while(p < End) {
+      if(Is_Keyword_Line(p, End)) { break; }
+      if(Is_Data_Line(p, End)) { Num_Data_Lines++; }
+
+      p = IO::Scan::Next_Line(p, End);
+    } // while(p < End) {
+
+    return p;
+  } // const char * Section_End(const char * p, const char * End, size_t & Num_Data_Lines) {
+
+
+
+  // Throw a Bad_File_Format exception for the data line Line.
+  void Throw_Bad_Line(const Mapped_File & File, const char * Line, const std::string & File_Name, const char * Caller, const char * Expected) {
+    // Find the line's number (this only happens once, so we can afford to count).
+    unsigned Line_Number = 1;
+    for(const char * p = File.Get_Data(); p < Line; p++) {
+      if(*p == '\n') { Line_Number++; }
+    } // for(const char * p = File.Get_Data(); p < Line; p++) {
+
+    const char * Stop = Line_End(Line, File.Get_End());
+    if(Stop - Line > 100) { Stop = Line + 100; }
+    const std::string Line_Text(Line, (size_t)(Stop - Line));
+
+    /* File_Name has no length limit, so snprintf truncates the message
+    rather than overflowing the buffer. */
+    char Error_Message_Buffer[500];
+    snprintf(Error_Message_Buffer, sizeof(Error_Message_Buffer),
+             "Bad File Format Exception: Thrown by %s\n"
+             "Line %u of %s should hold %s. However, it reads:\n"
+             "%s\n",
+             Caller, Line_Number, File_Name.c_str(), Expected, Line_Text.c_str());
+    throw Bad_File_Format(Error_Message_Buffer);
+  } // void Throw_Bad_Line(const Mapped_File & File, const char * Line, const std::string & File_Name, const char * Caller, const char * Expected) {
+
+
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Sections
+
+  /* A section of the file: its keyword line, and the range of lines that
+  hold its data. The lines before the first keyword line (if any) form a
+  section whose Keyword_Line is nullptr. */
+  struct Section {
+    const char * Keyword_Line;
+    const char * Data;
+    const char * Data_End;
+    size_t Num_Data_Lines;
+  }; // struct Section {
+
+  /* Part of a section's data that lies in one chunk of the file (see
+  Find_Sections). Offset is the number of the section's data lines that come
+  before this segment. */
+  struct Segment {
+    const char * Begin;
+    const char * Stop;
+    unsigned Section_Index;
+    size_t Offset;
+  }; // struct Segment {
+
+  // Size of the chunks that Find_Sections splits the file into.
+  const size_t CHUNK_SIZE = 4*1024*1024;
+
+
+
+  void Find_Sections(const Mapped_File & File, std::vector<Section> & Sections, std::vector<Segment> & Segments) {
+    /* Function description:
+    This function finds every section of the file (in order) and splits each
+    section's data into segments, so that the data can then be read in
+    parallel (see IO::Read::inp).
+
+    We split the file into chunks of about CHUNK_SIZE characters. Each chunk
+    starts at the start of a line (and each line belongs to the chunk that it
+    starts in). We then scan the chunks in parallel. Each chunk records the
+    keyword lines that it holds and counts the data lines before, between, and
+    after them. Finally, we stitch the chunks together (in order): the data
+    lines of a chunk that come before its first keyword line continue the
+    previous chunk's last section. Each (non-empty) run of data lines becomes
+    a segment. Since we know how many of its section's data lines come before
+    each segment, every segment knows where its data goes before anything is
+    read. */
+    const char * const Data = File.Get_Data();
+    const char * const End = File.Get_End();
+    const size_t Size = File.Get_Size();
+
+    const unsigned Num_Chunks = (Size > CHUNK_SIZE) ? (unsigned)(Size/CHUNK_SIZE) : 1;
+    std::vector<const char *> Chunk_Start(Num_Chunks + 1);
+    Chunk_Start[0] = Data;
+    Chunk_Start[Num_Chunks] = End;
+    for(unsigned c = 1; c < Num_Chunks; c++) {
+      const char * p = Data + (size_t)c*CHUNK_SIZE;
+      if(p <= Chunk_Start[c-1]) { p = Chunk_Start[c-1]; }
+      else if(p[-1] != '\n') { p = IO::Scan::Next_Line(p, End); }
+
+      Chunk_Start[c] = p;
+    } // for(unsigned c = 1; c < Num_Chunks; c++) {
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    /* Scan the chunks. Chunk_Num_Data_Lines[c][i] is the number of data lines
+    in chunk c between its (i-1)th and ith keyword lines. */
+    std::vector<std::vector<const char *>> Chunk_Keyword_Lines(Num_Chunks);
+    std::vector<std::vector<size_t>> Chunk_Num_Data_Lines(Num_Chunks);
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(unsigned c = 0; c < Num_Chunks; c++) {
+      std::vector<const char *> & Keyword_Lines = Chunk_Keyword_Lines[c];
+      std::vector<size_t> & Num_Data_Lines = Chunk_Num_Data_Lines[c];
+      Num_Data_Lines.push_back(0);
+
+      for(const char * p = Chunk_Start[c]; p < Chunk_Start[c+1]; p = IO::Scan::Next_Line(p, End)) {
+        if(Is_Keyword_Line(p, End)) {
+          Keyword_Lines.push_back(p);
+          Num_Data_Lines.push_back(0);
+        } // if(Is_Keyword_Line(p, End)) {
+        else if(Is_Data_Line(p, End)) { Num_Data_Lines.back()++; }
+      } // for(const char * p = Chunk_Start[c]; p < Chunk_Start[c+1]; p = IO::Scan::Next_Line(p, End)) {
+    } // for(unsigned c = 0; c < Num_Chunks; c++) {
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Now stitch the chunks together.
+    Sections.clear();
+    Segments.clear();
+    Sections.push_back(Section{nullptr, Data, End, 0});
+
+    for(unsigned c = 0; c < Num_Chunks; c++) {
+      const std::vector<const char *> & Keyword_Lines = Chunk_Keyword_Lines[c];
+      const std::vector<size_t> & Num_Data_Lines = Chunk_Num_Data_Lines[c];
+      const char * Begin = Chunk_Start[c];
+
+      for(unsigned i = 0; i <= Keyword_Lines.size(); i++) {
+        const char * Stop = (i < Keyword_Lines.size()) ? Keyword_Lines[i] : Chunk_Start[c+1];
+
+        Section & Current = Sections.back();
+        if(Num_Data_Lines[i] != 0) {
+          Segments.push_back(Segment{Begin, Stop, (unsigned)Sections.size() - 1, Current.Num_Data_Lines});
+          Current.Num_Data_Lines += Num_Data_Lines[i];
+        } // if(Num_Data_Lines[i] != 0) {
+
+        if(i < Keyword_Lines.size()) {
+          Current.Data_End = Keyword_Lines[i];
+          Begin = IO::Scan::Next_Line(Keyword_Lines[i], End);
+          Sections.push_back(Section{Keyword_Lines[i], Begin, End, 0});
+        } // if(i < Keyword_Lines.size()) {
+      } // for(unsigned i = 0; i <= Keyword_Lines.size(); i++) {
+    } // for(unsigned c = 0; c < Num_Chunks; c++) {
+  } // void Find_Sections(const Mapped_File & File, std::vector<Section> & Sections, std::vector<Segment> & Segments) {
+
+
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Data line readers
+
+  /* Read the node lines ("Node number, x, y, z") in [Begin, Stop) into
+  Positions (one position per data line). */
+  void Read_Node_Lines(const Mapped_File & File, const std::string & File_Name, const char * Begin, const char * Stop, Array<double,3> * Positions) {
+    const char * const End = File.Get_End();
+
+    for(const char * Line = Begin; Line < Stop; Line = IO::Scan::Next_Line(Line, End)) {
+      if(Is_Data_Line(Line, End) == false) { continue; }
+
+      const char * p = Line;
+      unsigned Node_Number;
+      Array<double,3> & Position = *Positions;
+      if(IO::Scan::Scan_Unsigned(p, End, Node_Number) == false ||
+         IO::Scan::Scan_Double(p, End, Position[0]) == false ||
+         IO::Scan::Scan_Double(p, End, Position[1]) == false ||
+         IO::Scan::Scan_Double(p, End, Position[2]) == false) {
+        Throw_Bad_Line(File, Line, File_Name, "IO::Read::inp", "a node number and three coordinates");
+      } // if(IO::Scan::Scan_Unsigned(p, End, Node_Number) == false ||...
+
+      Positions++;
+    } // for(const char * Line = Begin; Line < Stop; Line = IO::Scan::Next_Line(Line, End)) {
+  } // void Read_Node_Lines(const Mapped_File & File, const std::string & File_Name, const char * Begin, const char * Stop, Array<double,3> * Positions) {
+
+
+
+  /* Read the element lines ("Element number, node 1, node 2, ...") in
+  [Begin, Stop) into Node_Lists (one node list per data line). Node numbers are
+  converted from 1 index to 0 index. */
+  void Read_Element_Lines(const Mapped_File & File, const std::string & File_Name, const char * Begin, const char * Stop, const Element_Types Type, Array<unsigned,8> * Node_Lists) {
+    const char * const End = File.Get_End();
+    const unsigned Num_Element_Nodes = (Type == Element_Types::BRICK) ? 8 : 6;
+
+    /* Where each of the element's nodes goes in its node list. For wedges,
+    nodes 2 and 3, as well as 6 and 7, are identical. */
+    static const unsigned Brick_Slots[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    static const unsigned Wedge_Slots[6] = {0, 1, 2, 4, 5, 6};
+    const unsigned * Slots = (Type == Element_Types::BRICK) ? Brick_Slots : Wedge_Slots;
+
+    for(const char * Line = Begin; Line < Stop; Line = IO::Scan::Next_Line(Line, End)) {
+      if(Is_Data_Line(Line, End) == false) { continue; }
+
+      const char * p = Line;
+      unsigned Element_Number;
+      Array<unsigned,8> & Node_List = *Node_Lists;
+      bool Good_Line = IO::Scan::Scan_Unsigned(p, End, Element_Number);
+      for(unsigned a = 0; a < Num_Element_Nodes && Good_Line == true; a++) {
+        unsigned Node_Number;
+        Good_Line = (IO::Scan::Scan_Unsigned(p, End, Node_Number) && Node_Number != 0);
+
+        /* Convert from 1 index to 0 index */
+        Node_List[Slots[a]] = Node_Number - 1;
+      } // for(unsigned a = 0; a < Num_Element_Nodes && Good_Line == true; a++) {
+
+      if(Good_Line == false) {
+        Throw_Bad_Line(File, Line, File_Name, "IO::Read::inp",
+                       (Type == Element_Types::BRICK) ? "an element number and 8 node numbers" : "an element number and 6 node numbers");
+      } // if(Good_Line == false) {
+
+      if(Type == Element_Types::WEDGE) {
+        Node_List[3] = Node_List[2];
+        Node_List[7] = Node_List[6];
+      } // if(Type == Element_Types::WEDGE) {
+
+      Node_Lists++;
+    } // for(const char * Line = Begin; Line < Stop; Line = IO::Scan::Next_Line(Line, End)) {
+  } // void Read_Element_Lines(const Mapped_File & File, const std::string & File_Name, const char * Begin, const char * Stop, const Element_Types Type, Array<unsigned,8> * Node_Lists) {
+
+
+
+  /* Read a word (everything up to the next separator or the end of the
+  line). This returns false (and doesn't move p) if there's no word. */
+  bool Scan_Word(const char * & p, const char * End, std::string & Word) {
+    const char * Start = IO::Scan::Skip_Separators(p, End);
+    const char * q = Start;
+    while(q < End && *q != '\n' && IO::Scan::Is_Separator(*q) == false) { q++; }
+    if(q == Start) { return false; }
+
+    Word.assign(Start, (size_t)(q - Start));
+    p = q;
+    return true;
+  } // bool Scan_Word(const char * & p, const char * End, std::string & Word) {
+
+
+
+  /* Read the boundary lines in [Begin, Stop). Each line is either
+      Node number, first DOF, last DOF, displacement
+  (which goes in Boundary_List) or
+      Node set name, first DOF, last DOF, displacement
+  (which goes in Set_Boundary_List). The last DOF defaults to the first one,
+  and the displacement defaults to zero. Instead of DOFs, a line can name a
+  boundary type: ENCASTRE or PINNED (DOFs 1-3, we don't have rotational DOFs),
+  or XSYMM, YSYMM, or ZSYMM (DOF 1, 2, or 3). */
+  void Read_Boundary_Lines(const Mapped_File & File, const std::string & File_Name, const char * Begin, const char * Stop, std::vector<IO::Read::inp_boundary_data> & Boundary_List, std::vector<IO::Read::inp_set_boundary_data> & Set_Boundary_List) {
+    const char * const End = File.Get_End();
+    const char * const Expected = "a node (or node set), a first DOF, a last DOF, and a displacement";
+
+    for(const char * Line = Begin; Line < Stop; Line = IO::Scan::Next_Line(Line, End)) {
+      if(Is_Data_Line(Line, End) == false) { continue; }
+
+      // First, read the node number (or node set name).
+      const char * p = Line;
+      unsigned Node_Number = 0;
+      std::string Node_Set_Name;
+      if(IO::Scan::Scan_Unsigned(p, End, Node_Number) == false) { Scan_Word(p, End, Node_Set_Name); }
+      else if(Node_Number == 0) { Throw_Bad_Line(File, Line, File_Name, "IO::Read::inp", Expected); }
+
+      // Next, read the DOFs (or boundary type) and the displacement.
+      unsigned Start_DOF, End_DOF;
+      double Displacement = 0;
+      std::string Boundary_Type;
+      if(IO::Scan::Scan_Unsigned(p, End, Start_DOF) == true) {
+        if(IO::Scan::Scan_Unsigned(p, End, End_DOF) == false) { End_DOF = Start_DOF; }
+        if(IO::Scan::Scan_Double(p, End, Displacement) == false) { Displacement = 0; }
+      } // if(IO::Scan::Scan_Unsigned(p, End, Start_DOF) == true) {
+      else if(Scan_Word(p, End, Boundary_Type) == true) {
+        for(unsigned i = 0; i < Boundary_Type.size(); i++) { Boundary_Type[i] = (char)toupper((unsigned char)Boundary_Type[i]); }
+
+        if(Boundary_Type == "ENCASTRE" || Boundary_Type == "PINNED") { Start_DOF = 1; End_DOF = 3; }
+        else if(Boundary_Type == "XSYMM") { Start_DOF = 1; End_DOF = 1; }
+        else if(Boundary_Type == "YSYMM") { Start_DOF = 2; End_DOF = 2; }
+        else if(Boundary_Type == "ZSYMM") { Start_DOF = 3; End_DOF = 3; }
+        else { Throw_Bad_Line(File, Line, File_Name, "IO::Read::inp", Expected); }
+      } // else if(Scan_Word(p, End, Boundary_Type) == true) {
+      else { Throw_Bad_Line(File, Line, File_Name, "IO::Read::inp", Expected); }
+
+      if(Start_DOF == 0 || End_DOF < Start_DOF) { Throw_Bad_Line(File, Line, File_Name, "IO::Read::inp", Expected); }
+
+      if(Node_Number != 0) {
+        /* Convert from 1 index to 0 index */
+        Boundary_List.push_back(IO::Read::inp_boundary_data{Node_Number - 1, Start_DOF, End_DOF, Displacement});
+      } // if(Node_Number != 0) {
+      else { Set_Boundary_List.push_back(IO::Read::inp_set_boundary_data{Node_Set_Name, Start_DOF, End_DOF, Displacement}); }
+    } // for(const char * Line = Begin; Line < Stop; Line = IO::Scan::Next_Line(Line, End)) {
+  } // void Read_Boundary_Lines(const Mapped_File & File, const std::string & File_Name, const char * Begin, const char * Stop,...
+
+
+
+  /* Read the node set lines in [Begin, Stop) and append the nodes (0 index)
+  to Nodes. In inp files, node sets can be formatted in one of two ways:
+  generate form or list form.
+
+
+  Generate:
+  In generate form, the node set consists of a sequence of lines, each one
+  of which is formatted as follows:
+           N_start, N_end, Inc
+  This states that node number N_start and every Inc'th node after that
+  whose node number is less than or equal to N_End belongs to the set. In
+  other words, start by adding node N_start, repeatedly increment by Inc
+  and add the resulting node number to the set. Continue this until you
+  reach a node whose number is greater than N_end. If Inc is missing, then
+  it's 1.
+
+  Node sets that use generate form will have the keyword "generate"
+  in the node set header (the line that starts with *Nset).
+
+
+  List:
+  In list form, the nodes that belong to the node set are simply listed
+  in a comma separated list. Any node set whose header does not contain the
+  "generate" keyword is a list node set. */
+  void Read_Node_Set_Lines(const Mapped_File & File, const std::string & File_Name, const char * Begin, const char * Stop, const bool Generate, const char * Caller, std::vector<unsigned> & Nodes) {
+    const char * const End = File.Get_End();
+
+    for(const char * Line = Begin; Line < Stop; Line = IO::Scan::Next_Line(Line, End)) {
+      if(Is_Data_Line(Line, End) == false) { continue; }
+
+      const char * p = Line;
+      if(Generate == true) {
+        unsigned N_Start, N_End, Inc;
+        if(IO::Scan::Scan_Unsigned(p, End, N_Start) == false ||
+           IO::Scan::Scan_Unsigned(p, End, N_End) == false ||
+           N_Start == 0 || N_End < N_Start) {
+          Throw_Bad_Line(File, Line, File_Name, Caller, "a first node, a last node, and an increment");
+        } // if(IO::Scan::Scan_Unsigned(p, End, N_Start) == false ||...
+        if(IO::Scan::Scan_Unsigned(p, End, Inc) == false || Inc == 0) { Inc = 1; }
+
+        /* Convert from 1 index to 0 index */
+        N_Start--;
+        N_End--;
+
+        Nodes.reserve(Nodes.size() + (N_End - N_Start)/Inc + 1);
+        for(unsigned i = N_Start; i <= N_End && i >= N_Start; i += Inc) { Nodes.push_back(i); }
+      } // if(Generate == true) {
+
+      else { // list node set
+        /* Read in each node number on the line and add them to Nodes. */
+        unsigned Node_Number;
+        while(IO::Scan::Scan_Unsigned(p, End, Node_Number)) {
+          if(Node_Number == 0) { Throw_Bad_Line(File, Line, File_Name, Caller, "a list of node numbers"); }
+
+          // Convert from 1 index to 0 index
+          Nodes.push_back(Node_Number - 1);
+        } // while(IO::Scan::Scan_Unsigned(p, End, Node_Number)) {
+
+        if(IO::Scan::Line_Is_Blank(p, End) == false) {
+          Throw_Bad_Line(File, Line, File_Name, Caller, "a list of node numbers");
+        } // if(IO::Scan::Line_Is_Blank(p, End) == false) {
+      } // else {
+    } // for(const char * Line = Begin; Line < Stop; Line = IO::Scan::Next_Line(Line, End)) {
+  } // void Read_Node_Set_Lines(const Mapped_File & File, const std::string & File_Name, const char * Begin, const char * Stop,...
+} // namespace {
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// inp
+
+const IO::Read::inp_node_set * IO::Read::inp_mesh::Find_Node_Set(const std::string & Name) const {
+  for(unsigned i = 0; i < Node_Sets.size(); i++) {
+    if(Node_Sets[i].Name == Name) { return &Node_Sets[i]; }
+  } // for(unsigned i = 0; i < Node_Sets.size(); i++) {
+
+  // Try the unqualified name (see inp_reader.h).
+  const size_t Dot = Name.rfind('.');
+  if(Dot != std::string::npos) { return Find_Node_Set(Name.substr(Dot + 1)); }
+
+  return nullptr;
+} // const IO::Read::inp_node_set * IO::Read::inp_mesh::Find_Node_Set(const std::string & Name) const {
+
+
+
+
+void IO::Read::inp(const std::string & File_Name, inp_mesh & Mesh) {
   /* Function description:
-  This function is designed to read in node positions, node boundary data,
-  and element connectivity from an .inp file. This information is turn returned
-  through the Node_Positions, Element_Node_Lists, and Boundary_List lists. The
-  requested file should be in the IO directory (Note: this is not source/IO). */
+  This function is designed to read in node positions, element connectivity,
+  boundary data, and every node set from an .inp file, all in one pass. This
+  information is turn returned through Mesh. The requested file should be in
+  the IO directory (Note: this is not source/IO).
+
+  Nodes are stored in the order that they appear in the file (node numbers are
+  ignored). Node numbers in the element, boundary, and node set data are
+  converted from 1 index to 0 index.
+
+  We read the file in two passes. First, we find every section and split the
+  sections' data into segments (in parallel, see Find_Sections). Every node
+  and element data line holds exactly one node or element, so we then know
+  how many nodes and elements there are, and where each segment's nodes and
+  elements go. Thus, we can size the arrays once, and then read the segments
+  in parallel (each one writes to its own part of the arrays). If a segment
+  throws, we rethrow it once the parallel loop is done (see Parallel_Errors). */
 
   //////////////////////////////////////////////////////////////////////////////
-  /* First, we need to open the file. To do this, we first need to get the file
+  /* First, we need to map the file. To do this, we first need to get the file
   path */
-  std::string File_Path = "./IO/" + File_Name;
-  std::ifstream File{};
-  File.open(File_Path.c_str());
+  const std::string File_Path = "./IO/" + File_Name;
+  const Mapped_File File{File_Path, "IO::Read::inp"};
+  const char * const End = File.Get_End();
 
-  /* Check if the file could be opened. If not then throw an exception */
-  if(File.is_open() == false) {
-    char Error_Message_Buffer[500];
-    sprintf(Error_Message_Buffer,
-            "Can't Open File Exception: Thrown by IO::Read::inp\n"
-            "You tried to open the file %s (%s.inp).\n"
-            "However, no such file could be found in the IO directory.\n",
-            File_Name.c_str(), File_Name.c_str());
-    throw Cant_Open_File(Error_Message_Buffer);
-  } // if(File.is_open() == false) {
+  std::vector<Section> Sections;
+  std::vector<Segment> Segments;
+  Find_Sections(File, Sections, Segments);
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Next, find the Node (*Node), Element (*Element), Boundary (*Boundary),
+  and node set (*Nset) sections. Each Node and Element section's data goes in the arrays right
+  after the previous section's. */
+  enum class Section_Type { OTHER, NODE, ELEMENT, BOUNDARY, NSET };
+  const unsigned Num_Sections = (unsigned)Sections.size();
+  std::vector<Section_Type> Type(Num_Sections, Section_Type::OTHER);
+  std::vector<Element_Types> Element_Type(Num_Sections, Element_Types::BRICK);
+  std::vector<size_t> Base(Num_Sections, 0);
+  std::vector<Array<double,3>> & Node_Positions = Mesh.Node_Positions;
+  std::vector<Array<unsigned,8>> & Element_Node_Lists = Mesh.Element_Node_Lists;
+  size_t Num_Nodes = Node_Positions.size();
+  size_t Num_Elements = Element_Node_Lists.size();
+
+  for(unsigned s = 0; s < Num_Sections; s++) {
+    const char * Keyword_Line = Sections[s].Keyword_Line;
+    if(Keyword_Line == nullptr) { continue; }
+
+    if(Has_Keyword(Keyword_Line, End, "Node")) {
+      Type[s] = Section_Type::NODE;
+      Base[s] = Num_Nodes;
+      Num_Nodes += Sections[s].Num_Data_Lines;
+    } // if(Has_Keyword(Keyword_Line, End, "Node")) {
+
+    else if(Has_Keyword(Keyword_Line, End, "Element")) {
+      /* Identify which type of element we're dealing with (C3D8 and C3D8R are
+      bricks, everything else is read as a wedge). */
+      std::string Type_Name;
+      Find_Parameter(Keyword_Line, End, "type", Type_Name);
+      Element_Type[s] = (Type_Name.compare(0, 4, "C3D8") == 0) ? Element_Types::BRICK : Element_Types::WEDGE;
+
+      Type[s] = Section_Type::ELEMENT;
+      Base[s] = Num_Elements;
+      Num_Elements += Sections[s].Num_Data_Lines;
+    } // else if(Has_Keyword(Keyword_Line, End, "Element")) {
+
+    else if(Has_Keyword(Keyword_Line, End, "Boundary")) { Type[s] = Section_Type::BOUNDARY; }
+    else if(Has_Keyword(Keyword_Line, End, "Nset")) { Type[s] = Section_Type::NSET; }
+  } // for(unsigned s = 0; s < Num_Sections; s++) {
+
+  Node_Positions.resize(Num_Nodes);
+  Element_Node_Lists.resize(Num_Elements);
 
 
   //////////////////////////////////////////////////////////////////////////////
-  // Read in Node, Element, and Boundary data.
-
-  char buffer[256];                              // buffer to hold data read in from File
-  File.getline(buffer, 256);                     // Read up to 256 characters (or end of line)
-
-  /* Read in all nodes positions, element connectivity, and boundary information
-  from the file  */
-  while(File.eof() == false && File.fail() == false) {
-    /* Check if line begins with a *. If so, we may be at the start of the
-    Node (*Node), Element (*Elemnet), or Boundary (*Boundar) listing. */
-
-    if(buffer[0] == '*') {
-      /* Check if current line starts with "*Node" */
-      if(String_Ops::Contains(buffer, "*Node") ) {
-
-        /* If so then we have found the start of the node listing. Begin
-        reading them in. */
-        while(File.eof() == false && File.fail() == false) {
-          File.getline(buffer, 256);
-
-          // Check if we have reached the end of the node listings.
-          if(buffer[0] == '*') { break; }
-
-          /* Otherwise, read in node position from the buffer and push it onto
-          the Node_Positions list. */
-          Array<double,3> Position;         // Hold the current node position
-          sscanf(buffer,
-                 "%*d, %lf, %lf, %lf",
-                 &Position[0], &Position[1], &Position[2]);
-          Node_Positions.push_back(Position);
-        } // while(File.eof() == false && File.fail() == false) {
-
-        /* If we're here then we've finished reading in the nodes. We may have
-        found the start of the element listing, so we don't want to read in the next
-        line yet. Thus, continue onto the next iteration (skipping the "read in
-        next line" instruction at the end of the while loop) */
-        continue;
-      } // if(String_Ops::Contains(bufffer, "*Node") {
-
-
-      /* Check if current line starts with "*Element" */
-      if( String_Ops::Contains(buffer, "*Element") ) {
-
-        /* If so then we have found the start of the element node listings.
-        Before we can read the elements in, we need to identify which type of
-        element we're dealing with */
-        Element_Types Type;
-        if( String_Ops::Contains(buffer, "type=C3D8", 8) ) { Type = Element_Types::BRICK; }
-        else { Type = Element_Types::WEDGE; } // if( String_Ops::Contains(buffer, "type=C3D6", 8) )
-
-        while(File.eof() == false && File.fail() == false) {
-          File.getline(buffer, 256);
-
-          // Check if we have reached the end of the element listings.
-          if(buffer[0] ==  '*') { break; }
-
-          /* Otherwise, read in element node lists from the buffer and push it
-          onto the Element_Node_Lists list. */
-          Array<unsigned,8> Node_List;      // Hold the current element position
-
-          if(Type == Element_Types::BRICK) {
-            sscanf(buffer,
-                   "%*d, %u, %u, %u, %u, %u, %u, %u, %u",
-                   &Node_List[0], &Node_List[1], &Node_List[2], &Node_List[3], &Node_List[4], &Node_List[5], &Node_List[6], &Node_List[7]);
-          } // if(Type == Element_Types::BRICK) {
-          else { // if(Type == Element_Types::WEDGE)
-            sscanf(buffer,
-                   "%*d, %u, %u, %u, %u, %u, %u",
-                   &Node_List[0], &Node_List[1], &Node_List[2], &Node_List[4], &Node_List[5], &Node_List[6]);
-
-             // Nodes 2 and 3, as well as 6 and 7 are identical
-             Node_List[3] = Node_List[2];
-             Node_List[7] = Node_List[6];
-          } // else {
-
-          /* Convert from 1 index to 0 index */
-          for(unsigned i = 0; i < 8; i++) { Node_List[i]--; }
-
-          Element_Node_Lists.push_back(Node_List);
-        } // while(File.eof() == false && File.fail() == false) {
-
-        /* If we're here then we've finished reading in the elements. We may have
-        found the start of the node listing, so we don't want to read in the next
-        line yet. Thus, continue onto the next iteration (skipping the "read in
-        next line" instruction at the end of the while loop) */
-        continue;
-      }  // if( String_Ops::Contains(buffer, "*Element") ) {
-
-
-      /* Check if current line starts with "*Boundary" */
-      if( String_Ops::Contains(buffer, "*Boundary") ) {
-
-        /* If so then we have found a boundary section. Let's read in the Boundary
-        conditions. */
-        while(File.eof() == false && File.fail() == false) {
-          File.getline(buffer, 256);
-
-          /* Check if the current line begins with a *. If so, then we've reached
-          the end of the boundary section. */
-          if(buffer[0] == '*') { break; }
-
-          /* Otherwise read in the boundary information. */
-          inp_boundary_data Boundary_Data;
-          sscanf(buffer,
-                 "%*s,%d,%d,%d,%lf\n",
-                 &Boundary_Data.Node_Number, &Boundary_Data.Start_DOF, &Boundary_Data.End_DOF, &Boundary_Data.displacement);
-
-          /* Convert from 1 index to 0 index */
-          Boundary_Data.Node_Number--;
-
-          /* Now, push the boundary data onto the Boundary_Data list. */
-          Boundary_List.push_back(Boundary_Data);
-        } // while(File.eof() == false && File.fail() == false) {
-
-        /* If we're here then we've finished reading in the boundary. We may have
-        found the start of another boundary listing, a node listing, or element
-        listing. Thus, we don't want to read in the next line yet.
-        We therefore continue onto the next iteration (skipping the "read in
-        next line" instruction at the end of the while loop) */
-        continue;
-      } // if( String_Ops::Contains(buffer, "*Boundary") ) {
-    } // if(buffer[0] == '*') {
-
-    File.getline(buffer, 256);                         // Read in next line (or up to 256 characters)
-  } // while(File.eof() == false && File.fail() == false) {
+  // Now, read the node and element segments (in parallel).
+  Parallel_Errors Errors;
+
+  #pragma omp parallel for schedule(dynamic, 1)
+  for(unsigned k = 0; k < Segments.size(); k++) {
+    const Segment & Seg = Segments[k];
+    const unsigned s = Seg.Section_Index;
+
+    try {
+      if(Type[s] == Section_Type::NODE) {
+        Read_Node_Lines(File, File_Name, Seg.Begin, Seg.Stop, Node_Positions.data() + Base[s] + Seg.Offset);
+      } // if(Type[s] == Section_Type::NODE) {
+      else if(Type[s] == Section_Type::ELEMENT) {
+        Read_Element_Lines(File, File_Name, Seg.Begin, Seg.Stop, Element_Type[s], Element_Node_Lists.data() + Base[s] + Seg.Offset);
+      } // else if(Type[s] == Section_Type::ELEMENT) {
+    } // try {
+    catch (...) { Errors.Capture(); }
+  } // for(unsigned k = 0; k < Segments.size(); k++) {
+
+  Errors.Rethrow();
 
 
   //////////////////////////////////////////////////////////////////////////////
-  // All done! Close the file.
-  File.close();
+  /* Finally, read the boundary and node set sections. These are short (and
+  some node set lines expand into many nodes), so we just read them in order. */
+  for(unsigned s = 0; s < Num_Sections; s++) {
+    if(Type[s] == Section_Type::BOUNDARY) {
+      Mesh.Boundary_List.reserve(Mesh.Boundary_List.size() + Sections[s].Num_Data_Lines);
+      Read_Boundary_Lines(File, File_Name, Sections[s].Data, Sections[s].Data_End, Mesh.Boundary_List, Mesh.Set_Boundary_List);
+    } // if(Type[s] == Section_Type::BOUNDARY) {
+
+    else if(Type[s] == Section_Type::NSET) {
+      std::string Name;
+      Find_Parameter(Sections[s].Keyword_Line, End, "nset", Name);
+      std::string Unused;
+      const bool Generate = Find_Parameter(Sections[s].Keyword_Line, End, "generate", Unused);
+
+      // Add the nodes to the node set with this name (or to a new node set).
+      unsigned Set_Index = 0;
+      while(Set_Index < Mesh.Node_Sets.size() && Mesh.Node_Sets[Set_Index].Name != Name) { Set_Index++; }
+      if(Set_Index == Mesh.Node_Sets.size()) {
+        Mesh.Node_Sets.push_back(inp_node_set{});
+        Mesh.Node_Sets.back().Name = Name;
+      } // if(Set_Index == Mesh.Node_Sets.size()) {
+
+      Read_Node_Set_Lines(File, File_Name, Sections[s].Data, Sections[s].Data_End, Generate, "IO::Read::inp", Mesh.Node_Sets[Set_Index].Nodes);
+    } // else if(Type[s] == Section_Type::NSET) {
+  } // for(unsigned s = 0; s < Num_Sections; s++) {
+} // void IO::Read::inp(const std::string & File_Name, inp_mesh & Mesh) {
+
+
+
+void IO::Read::inp(const std::string & File_Name, class std::vector<Array<double, 3>> & Node_Positions, class std::vector<Array<unsigned,8>> & Element_Node_Lists, class std::vector<inp_boundary_data> & Boundary_List) {
+  /* Function description:
+  This function reads the file into a mesh (see above). The mesh appends to
+  its arrays, so we just lend it ours (swapping vectors doesn't copy them). */
+  inp_mesh Mesh;
+  Mesh.Node_Positions.swap(Node_Positions);
+  Mesh.Element_Node_Lists.swap(Element_Node_Lists);
+  Mesh.Boundary_List.swap(Boundary_List);
+
+  try { inp(File_Name, Mesh); }
+  catch (...) {
+    Node_Positions.swap(Mesh.Node_Positions);
+    Element_Node_Lists.swap(Mesh.Element_Node_Lists);
+    Boundary_List.swap(Mesh.Boundary_List);
+    throw;
+  } // catch (...) {
+
+  Node_Positions.swap(Mesh.Node_Positions);
+  Element_Node_Lists.swap(Mesh.Element_Node_Lists);
+  Boundary_List.swap(Mesh.Boundary_List);
+} // void IO::Read::inp(const std::string & File_Name, class std::vector<Array<double, 3>> & Node_Positions...
+
+
+
+void IO::Read::inp(const std::string & File_Name, class std::list<Array<double, 3>> & Node_Positions, class std::list<Array<unsigned,8>> & Element_Node_Lists, class std::list<inp_boundary_data> & Boundary_List) {
+  /* Function description:
+  This function reads the file into arrays (see above), then appends the
+  arrays to the lists. */
+  std::vector<Array<double, 3>> Node_Array;
+  std::vector<Array<unsigned, 8>> Element_Array;
+  std::vector<inp_boundary_data> Boundary_Array;
+  inp(File_Name, Node_Array, Element_Array, Boundary_Array);
+
+  Node_Positions.insert(Node_Positions.end(), Node_Array.begin(), Node_Array.end());
+  Element_Node_Lists.insert(Element_Node_Lists.end(), Element_Array.begin(), Element_Array.end());
+  Boundary_List.insert(Boundary_List.end(), Boundary_Array.begin(), Boundary_Array.end());
 } // void IO::Read::inp(const std::string & File_Name, class std::list<Array<double, 3>> & Node_Positions...
 
 
 
-void IO::Read::node_set(const std::string & File_Name, class std::list<unsigned> & Node_Set_List, const std::string & Node_Set_Name) {
+
+
+////////////////////////////////////////////////////////////////////////////////
+// node_set
+
+void IO::Read::node_set(const std::string & File_Name, class std::vector<unsigned> & Node_Set_List, const std::string & Node_Set_Name) {
   /* Function description:
   This function is designed to read in a node set from the specified file.
   The defaulted "Node_Set_Name" argument can be used to specify which node set
@@ -177,153 +684,63 @@ void IO::Read::node_set(const std::string & File_Name, class std::list<unsigned>
   node set can't be found then nothing will be appened to Node_Set_List.
 
   If no Node_Set_Name is specified, then the function will append the contents
-  of every node set that it finds in File_Name to the Node_Set_List. */
-
-  //////////////////////////////////////////////////////////////////////////////
-  /* First, we need to open the file. To do this, we first need to get the file
-  path */
-  std::string File_Path = "./IO/" + File_Name;
-  std::ifstream File{};
-  File.open(File_Path.c_str());
-
-  /* Check if the file could be opened. If not then throw an exception */
-  if(File.is_open() == false) {
-    char Error_Message_Buffer[500];
-    sprintf(Error_Message_Buffer,
-            "Can't Open File Exception: Thrown by IO::Read::node_set\n"
-            "You tried to open the file %s (%s.inp).\n"
-            "However, no such file could be found in the IO directory.\n",
-            File_Name.c_str(), File_Name.c_str());
-    throw Cant_Open_File(Error_Message_Buffer);
-  } // if(File.is_open() == false) {
+  of every node set that it finds in File_Name to the Node_Set_List.
 
+  Note: IO::Read::inp reads every node set (along with everything else) in
+  one pass. Use this function if you only need the node sets. */
 
   //////////////////////////////////////////////////////////////////////////////
-  // Read in Node Set data.
-
-  char buffer[256];                              // buffer to hold data read in from File
-  File.getline(buffer, 256);                     // Read up to 256 characters (or end of line)
+  /* First, we need to map the file. To do this, we first need to get the file
+  path */
+  const std::string File_Path = "./IO/" + File_Name;
+  const Mapped_File File{File_Path, "IO::Read::node_set"};
+  const char * const End = File.Get_End();
 
   /* First, check if the user passed a Node_Set_Name. If not, then Node_Set_Name
   will be set to the character '\0'. */
-  bool Passed_Node_Set_Name;
-  if( Node_Set_Name.c_str()[0] == '\0') { Passed_Node_Set_Name = false; }
-  else { Passed_Node_Set_Name = true; }
-
-  /* Read in the requested Node Set.  */
-  while(File.eof() == false && File.fail() == false) {
-    /* Check if the current line contains "*Nset" */
-    if( String_Ops::Contains(buffer, "*Nset") ) {
-      /* If the user passed a Node_Set_Name then check if the current Node Set's
-      name matches it. */
-      if( Passed_Node_Set_Name == true) {
-        /* in general, the node set's name may match something in the current
-        line other than the node set name. Thus, insead of just searching for
-        the Node_Set_Name, we search for "nset=Node_Set_Name". */
-        std::string Name_with_nset = "nset=" + Node_Set_Name + ",";
-
-        /* Now, check for a match */
-        if( String_Ops::Contains(buffer, Name_with_nset.c_str() ) ) {}
-        else {
-          // If no match, then we're at thw wrong node set. Read in the next line .
-          File.getline(buffer, 256);                         // Read in next line (or up to 256 characters)
-          continue;
-        } // else {
-      } // if( Passed_Node_Set_Name == true) {
-
-      /* In inp files, node sets can be formatted in one of two ways:
-      generate form or list form.
-
-
-      Generate:
-      In generate form, the node set consists of a sequence of lines, each one
-      of which is formatted as follows:
-               N_start, N_end, Inc
-      This states that node number N_start and every Inc'th node after that
-      whose node number is less than or equal to N_End belongs to the set. In
-      other words, start by adding node N_start, repeatedly increment by Inc
-      and add the resulting node number to the set. Continue this until you
-      reach a node whose number is greater than N_end.
-
-      Node sets that use generate form will have the keyword "generate"
-      in the node set header (the line that starts with *Nset).
-
-
-      List:
-      In list form, the nodes that belong to the node set are simply listed
-      in a comma separated list. Any node set whose header does not contain the
-      "generate" keyword is a list node set.
-
-
-      Because of the difference, we need to check if we're reading in a
-      generator or list type node set */
-      if( String_Ops::Contains(buffer, "generate") ) {
-        /* Read in successive lines until we reach the end of the node set. */
-        while(File.eof() == false && File.fail() == false) {
-          File.getline(buffer, 256);
-
-          /* Check if the current line begins with a *. If so, then we've reached
-          the end of the current node set section. */
-          if(buffer[0] == '*') { break; }
-
-          unsigned N_Start, N_End, Inc;
-          sscanf(buffer, "%u, %u, %u\n", &N_Start, &N_End, &Inc);
-
-          /* Convert from 1 index to 0 index */
-          N_Start--;
-          N_End--;
-
-          for(unsigned i = N_Start; i <= N_End; i += Inc) { Node_Set_List.push_back(i); }
-        } // while(File.eof() == false && File.fail() == false) {
-      } // if( String_Ops::Contains(buffer, "generate") ) {
-      else { // list node set
-        /* Read in and process successive lines until we reach the end of the
-        node set. */
-        while(File.eof() == false && File.fail() == false) {
-          File.getline(buffer, 256);
+  const bool Passed_Node_Set_Name = (Node_Set_Name.c_str()[0] != '\0');
 
-          /* Check if the current line begins with a *. If so, then we've reached
-          the end of the current node set section. */
-          if(buffer[0] == '*') { break; }
 
-          /* If not, then split the current line using ',' as the delimeter.
-          Then read in the node index from each substring and add them to the
-          Node_Set_List. */
-          std::vector<std::string> Sub_Strs = String_Ops::Split(buffer);
+  //////////////////////////////////////////////////////////////////////////////
+  // Read in Node Set data (see Read_Node_Set_Lines).
 
+  const char * Line = File.Get_Data();
+  while(Line < End) {
+    // Skip until we find a *Nset line (with the right name, if we have one).
+    if(Is_Keyword_Line(Line, End) == false || Has_Keyword(Line, End, "Nset") == false) {
+      Line = Scan::Next_Line(Line, End);
+      continue;
+    } // if(Is_Keyword_Line(Line, End) == false || Has_Keyword(Line, End, "Nset") == false) {
 
-          unsigned N_Sub_Strs = Sub_Strs.size();
-          for(unsigned i = 0; i < N_Sub_Strs; i++) {
-            // Check for empty sub string
-            if(Sub_Strs[i].size() == 0) { continue; }
+    const char * Keyword_Line = Line;
+    const char * Data = Scan::Next_Line(Line, End);
 
-            unsigned Node_Number;
-            sscanf(Sub_Strs[i].c_str(), " %u", &Node_Number);
+    size_t Num_Data_Lines;
+    const char * Data_End = Section_End(Data, End, Num_Data_Lines);
 
-            // Convert from 1 index to 0 index
-            Node_Number--;
+    std::string Name;
+    if(Passed_Node_Set_Name == false ||
+       (Find_Parameter(Keyword_Line, End, "nset", Name) == true && Name == Node_Set_Name)) {
+      std::string Unused;
+      const bool Generate = Find_Parameter(Keyword_Line, End, "generate", Unused);
+      Read_Node_Set_Lines(File, File_Name, Data, Data_End, Generate, "IO::Read::node_set", Node_Set_List);
+    } // if(Passed_Node_Set_Name == false ||...
 
-            // Add node number to list. 
-            Node_Set_List.push_back(Node_Number);
-          } // for(unsigned i = 0; i < N_Sub_Strs; i++) {
-        } // // while(File.eof() == false && File.fail() == false) {
-      } // else {
+    // We're done with this node set. Move onto the next section.
+    Line = Data_End;
+  } // while(Line < End) {
+} // void IO::Read::node_set(const std::string & File_Name, class std::vector<unsigned> & Node_Set_List, const std::string & Node_Set_Name) {
 
-      /* If we're here then we've finished reading in the node set. We may have
-      found the start of another type of listing. Thus, we don't want to read
-      in the next line yet. We therefore continue onto the next iteration
-      (skipping the "read in next line" instruction at the end of the while
-      loop) */
-      continue;
-    } // if( String_Ops::Contains(buffer, "*Nset") ) {
 
-    File.getline(buffer, 256);                         // Read in next line (or up to 256 characters)
-  } // while(File.eof() == false && File.fail() == false) {
 
+void IO::Read::node_set(const std::string & File_Name, class std::list<unsigned> & Node_Set_List, const std::string & Node_Set_Name) {
+  /* Function description:
+  This function reads the node set(s) into an array (see above), then appends
+  the array to the list. */
+  std::vector<unsigned> Node_Set_Array;
+  node_set(File_Name, Node_Set_Array, Node_Set_Name);
 
-  //////////////////////////////////////////////////////////////////////////////
-  // All done! Close the file.
-  File.close();
+  Node_Set_List.insert(Node_Set_List.end(), Node_Set_Array.begin(), Node_Set_Array.end());
 } // void IO::Read::node_set(const std::string & File_Name, class std::list<unsigned> & Node_Set_List, const std::string & Node_Set_Name) {
 
 #endif
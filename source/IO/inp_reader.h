@@ -22,6 +22,38 @@ namespace IO {
       double displacement;
     }; // struct inp_boundary_data {
 
+    /* Structure to hold the boundary information of a node set (a *Boundary
+    line whose first entry is a node set name, rather than a node number). */
+    struct inp_set_boundary_data {
+      std::string Node_Set_Name;
+      unsigned Start_DOF;
+      unsigned End_DOF;
+      double displacement;
+    }; // struct inp_set_boundary_data {
+
+    /* Structure to hold a named node set (0 indexed node numbers, in the order
+    that they appear in the file). */
+    struct inp_node_set {
+      std::string Name;
+      std::vector<unsigned> Nodes;
+    }; // struct inp_node_set {
+
+    /* Structure to hold everything that the inp reader reads from an inp file
+    (see IO::Read::inp). Node sets that share a name are merged. */
+    struct inp_mesh {
+      std::vector<Array<double,3>> Node_Positions;
+      std::vector<Array<unsigned,8>> Element_Node_Lists;
+      std::vector<inp_boundary_data> Boundary_List;
+      std::vector<inp_set_boundary_data> Set_Boundary_List;
+      std::vector<inp_node_set> Node_Sets;
+
+      /* Find the node set called Name. If there isn't one, and Name is
+      qualified by an instance name ("Part-1-1.Set-1"), then we look for the
+      unqualified name ("Set-1"). This returns nullptr if there's no such node
+      set. */
+      const inp_node_set * Find_Node_Set(const std::string & Name) const;   // Intent: Read
+    }; // struct inp_mesh {
+
     /* Class to set boundary conditions for a node set. */
     class nset_BC {
       private:
@@ -48,6 +80,24 @@ namespace IO {
         double Get_z_BC(void) const { return (*this).z_BC; }
     }; // class nset_BC {
 
+    /* Read the nodes, elements, boundary data, and node sets of an inp file
+    (in the IO directory) in one pass (see inp_reader.cc). This appends to
+    Mesh. */
+    void inp(const std::string & File_Name,                                    // Intent: Read
+             inp_mesh & Mesh);                                                 // Intent: Write
+
+    /* Read the nodes, elements, and (node number) boundary data of an inp
+    file into contiguous arrays. These append to the arrays. */
+    void inp(const std::string & File_Name,                                    // Intent: Read
+             class std::vector<Array<double,3>> & Node_Positions,              // Intent: Write
+             class std::vector<Array<unsigned,8>> & Element_Node_Lists,        // Intent: Write
+             class std::vector<inp_boundary_data> & Boundary_List);            // Intent: Write
+
+    void node_set(const std::string & File_Name,                               // Intent: Read
+                  class std::vector<unsigned> & Node_Set_List,                 // Intent: Write
+                  const std::string & Node_Set_Name = std::string("\0"));      // Intent: Read
+
+    /* Same as above, but these append to lists. */
     void inp(const std::string & File_Name,                                    // Intent: Read
              class std::list<Array<double,3>> & Node_Positions,                // Intent: Write
              class std::list<Array<unsigned,8>> & Element_Node_Lists,          // Intent: Write
@@ -3,122 +3,884 @@
 
 #include "vtk_Writer.h"
 
-void IO::Write::vtk(const Node* Nodes, const unsigned Num_Nodes, const Element* Elements, const unsigned Num_Elements) {
-  /* Function description:
-  This function prints Node and Element data to a .vtk file that can be read and
-  used by paraview. */
+namespace {
+  /* Throw a Cant_Open_File exception for File_Path. */
+  void Throw_Cant_Write(const std::string & File_Path, const char * Caller) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Can't Open File Exception: Thrown by %s\n"
+            "Could not write %s\n",
+            Caller, File_Path.c_str());
+    throw Cant_Open_File(Error_Message_Buffer);
+  } // void Throw_Cant_Write(const std::string & File_Path, const char * Caller) {
+
+
+
+  bool Is_Little_Endian(void) {
+    const uint16_t One = 1;
+    unsigned char First_Byte;
+    memcpy(&First_Byte, &One, 1);
+    return (First_Byte == 1);
+  } // bool Is_Little_Endian(void) {
+
+
+
+  /* Write Value's bytes, most significant first (whatever this machine's
+  byte order is). */
+  void Put_Big_Endian(const uint64_t Value, unsigned char * Out) {
+    for(unsigned b = 0; b < 8; b++) { Out[b] = (unsigned char)(Value >> (56 - 8*b)); }
+  } // void Put_Big_Endian(const uint64_t Value, unsigned char * Out) {
+
+  void Put_Big_Endian(const uint32_t Value, unsigned char * Out) {
+    for(unsigned b = 0; b < 4; b++) { Out[b] = (unsigned char)(Value >> (24 - 8*b)); }
+  } // void Put_Big_Endian(const uint32_t Value, unsigned char * Out) {
+
+
+
+  /* Find the deformed position (position + displacement) of every node. */
+  void Find_Points(const Node* Nodes, const unsigned Num_Nodes, std::vector<double> & Points) {
+    Points.resize(3*(size_t)Num_Nodes);
+
+    #pragma omp parallel for schedule(static)
+    for(unsigned i = 0; i < Num_Nodes; i++) {
+      for(unsigned Comp = 0; Comp < 3; Comp++) {
+        Points[3*(size_t)i + Comp] = Nodes[i].Get_Position_Component(Comp) + Nodes[i].Get_Displacement_Component(Comp);
+      } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+    } // for(unsigned i = 0; i < Num_Nodes; i++) {
+  } // void Find_Points(const Node* Nodes, const unsigned Num_Nodes, std::vector<double> & Points) {
+
+
+
+  /* Find each cell's node list (Connectivity), the index in Connectivity
+  just past the end of each cell's node list (Offsets), and each cell's VTK
+  type (12 for hexahedra, 13 for wedges). Wedges repeat nodes 2 and 6, so we
+  only list nodes 0, 1, 2 and 4, 5, 6 (see vtk_Stream::Add_Elements). */
+  void Find_Cells(const Element* Elements, const unsigned Num_Elements, std::vector<int32_t> & Connectivity, std::vector<int32_t> & Offsets, std::vector<uint8_t> & Types) {
+    static const unsigned Brick_Nodes[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    static const unsigned Wedge_Nodes[6] = {0, 1, 2, 4, 5, 6};
+
+    Offsets.resize(Num_Elements);
+    Types.resize(Num_Elements);
+    int32_t Offset = 0;
+    for(unsigned i = 0; i < Num_Elements; i++) {
+      const bool Brick = (Elements[i].Get_Element_Type() == Element_Types::BRICK);
+      Types[i] = Brick ? 12 : 13;
+      Offset += Brick ? 8 : 6;
+      Offsets[i] = Offset;
+    } // for(unsigned i = 0; i < Num_Elements; i++) {
+
+    Connectivity.resize((size_t)Offset);
+
+    #pragma omp parallel for schedule(static)
+    for(unsigned i = 0; i < Num_Elements; i++) {
+      const unsigned * Cell_Nodes = (Types[i] == 12) ? Brick_Nodes : Wedge_Nodes;
+      const unsigned Num_Cell_Nodes = (Types[i] == 12) ? 8 : 6;
+      const size_t Start = (size_t)Offsets[i] - Num_Cell_Nodes;
+      for(unsigned j = 0; j < Num_Cell_Nodes; j++) { Connectivity[Start + j] = (int32_t)Elements[i].Get_Node_ID(Cell_Nodes[j]); }
+    } // for(unsigned i = 0; i < Num_Elements; i++) {
+  } // void Find_Cells(const Element* Elements, const unsigned Num_Elements,...
+
+
+
+  /* The result fields: each node's displacement, and each element's strain,
+  stress (both as full 3x3 tensors, row by row), and von Mises stress. If the
+  nodal stresses were passed to the writer, each node's stress tensor and von
+  Mises stress too (otherwise, these are empty). */
+  struct Result_Fields {
+    std::vector<double> Displacement;            // 3 per node
+    std::vector<double> Nodal_Stress;            // 9 per node
+    std::vector<double> Nodal_Von_Mises;         // 1 per node
+    std::vector<double> Strain;                  // 9 per element
+    std::vector<double> Stress;                  // 9 per element
+    std::vector<double> Von_Mises;               // 1 per element
+  }; // struct Result_Fields {
+
+  /* VTK's tensors are 3x3 matrices (row by row), so we expand each Voigt
+  (xx, yy, zz, yz, xz, xy) strain and stress. The Voigt shear strains are
+  engineering strains, so we halve them to get the tensor components. */
+  void Voigt_To_Tensor(const double * Voigt, const bool Engineering_Shear, double * Tensor) {
+    // Voigt index of each component of a (row major) 3x3 tensor.
+    static const unsigned Voigt_Index[9] = {0, 5, 4,
+                                            5, 1, 3,
+                                            4, 3, 2};
+    for(unsigned k = 0; k < 9; k++) {
+      Tensor[k] = (Engineering_Shear == true && Voigt_Index[k] >= 3) ? 0.5*Voigt[Voigt_Index[k]] : Voigt[Voigt_Index[k]];
+    } // for(unsigned k = 0; k < 9; k++) {
+  } // void Voigt_To_Tensor(const double * Voigt, const bool Engineering_Shear, double * Tensor) {
+
+
+
+  /* Find the result fields (see Find_Element_Stresses and Voigt_To_Tensor). */
+  void Find_Fields(const Node* Nodes, const unsigned Num_Nodes, const Element* Elements, const unsigned Num_Elements, const double * Nodal_Stress, Result_Fields & Fields) {
+    Fields.Displacement.resize(3*(size_t)Num_Nodes);
+
+    #pragma omp parallel for schedule(static)
+    for(unsigned i = 0; i < Num_Nodes; i++) {
+      for(unsigned Comp = 0; Comp < 3; Comp++) { Fields.Displacement[3*(size_t)i + Comp] = Nodes[i].Get_Displacement_Component(Comp); }
+    } // for(unsigned i = 0; i < Num_Nodes; i++) {
+
+    std::vector<double> Strain(6*(size_t)Num_Elements), Stress(6*(size_t)Num_Elements);
+    Fields.Von_Mises.resize(Num_Elements);
+    Find_Element_Stresses(Nodes, Elements, Num_Elements, Strain.data(), Stress.data(), Fields.Von_Mises.data());
+
+    Fields.Strain.resize(9*(size_t)Num_Elements);
+    Fields.Stress.resize(9*(size_t)Num_Elements);
+
+    #pragma omp parallel for schedule(static)
+    for(unsigned i = 0; i < Num_Elements; i++) {
+      Voigt_To_Tensor(&Strain[6*(size_t)i], true, &Fields.Strain[9*(size_t)i]);
+      Voigt_To_Tensor(&Stress[6*(size_t)i], false, &Fields.Stress[9*(size_t)i]);
+    } // for(unsigned i = 0; i < Num_Elements; i++) {
+
+    if(Nodal_Stress == nullptr) { return; }
+
+    Fields.Nodal_Stress.resize(9*(size_t)Num_Nodes);
+    Fields.Nodal_Von_Mises.resize(Num_Nodes);
+
+    #pragma omp parallel for schedule(static)
+    for(unsigned i = 0; i < Num_Nodes; i++) {
+      Voigt_To_Tensor(&Nodal_Stress[6*(size_t)i], false, &Fields.Nodal_Stress[9*(size_t)i]);
+      Fields.Nodal_Von_Mises[i] = Von_Mises_Stress(&Nodal_Stress[6*(size_t)i]);
+    } // for(unsigned i = 0; i < Num_Nodes; i++) {
+  } // void Find_Fields(const Node* Nodes, const unsigned Num_Nodes, const Element* Elements, const unsigned Num_Elements, const double * Nodal_Stress, Result_Fields & Fields) {
+
+
+
+  /* Split Size bytes into VTU_BLOCK_SIZE byte blocks, and zlib compress each
+  one (in parallel). Header gets the vtkZLibDataCompressor header (see vtu),
+  and Body gets the compressed blocks. This returns false if zlib fails. */
+  bool Compress_Blocks(const unsigned char * Data, const size_t Size, std::vector<unsigned char> & Header, std::vector<unsigned char> & Body) {
+    const size_t Block_Size = IO::Write::VTU_BLOCK_SIZE;
+    const size_t Num_Blocks = (Size + Block_Size - 1)/Block_Size;
+    const size_t Last_Block_Size = Size % Block_Size;
+
+    std::vector<std::vector<unsigned char>> Blocks(Num_Blocks);
+    int Failed = 0;
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(size_t k = 0; k < Num_Blocks; k++) {
+      const size_t Start = k*Block_Size;
+      const size_t In_Size = (Start + Block_Size < Size) ? Block_Size : (Size - Start);
+
+      uLongf Out_Size = compressBound((uLong)In_Size);
+      Blocks[k].resize(Out_Size);
+      if(compress2(Blocks[k].data(), &Out_Size, Data + Start, (uLong)In_Size, IO::Write::VTU_COMPRESSION_LEVEL) != Z_OK) {
+        #pragma omp atomic write
+        Failed = 1;
+      } // if(compress2(Blocks[k].data(), &Out_Size, Data + Start, (uLong)In_Size, IO::Write::VTU_COMPRESSION_LEVEL) != Z_OK) {
+      Blocks[k].resize(Out_Size);
+    } // for(size_t k = 0; k < Num_Blocks; k++) {
+
+    if(Failed == 1) { return false; }
+
+    std::vector<uint64_t> Header_Words(3 + Num_Blocks);
+    Header_Words[0] = Num_Blocks;
+    Header_Words[1] = Block_Size;
+    Header_Words[2] = Last_Block_Size;
+    size_t Body_Size = 0;
+    for(size_t k = 0; k < Num_Blocks; k++) {
+      Header_Words[3 + k] = Blocks[k].size();
+      Body_Size += Blocks[k].size();
+    } // for(size_t k = 0; k < Num_Blocks; k++) {
+
+    Header.resize(8*Header_Words.size());
+    memcpy(Header.data(), Header_Words.data(), Header.size());
+
+    Body.clear();
+    Body.reserve(Body_Size);
+    for(size_t k = 0; k < Num_Blocks; k++) { Body.insert(Body.end(), Blocks[k].begin(), Blocks[k].end()); }
+
+    return true;
+  } // bool Compress_Blocks(const unsigned char * Data, const size_t Size, std::vector<unsigned char> & Header, std::vector<unsigned char> & Body) {
+
+
+
+  /* The number of bytes (chars, if Base64 is true) that Size bytes take up
+  in a vtu file's appended block. */
+  uint64_t Appended_Size(const size_t Size, const bool Base64) {
+    return Base64 ? 4*(((uint64_t)Size + 2)/3) : (uint64_t)Size;
+  } // uint64_t Appended_Size(const size_t Size, const bool Base64) {
+
+
+
+  /* Write Prefix followed by Data to a vtu file's appended block. If Base64
+  is true, the two are encoded together (as one piece), a few KB at a time, so
+  we never hold an encoded copy of Data. This returns false if the write
+  fails. */
+  bool Write_Appended(FILE * File, const unsigned char * Prefix, const size_t Prefix_Size, const unsigned char * Data, const size_t Size, const bool Base64) {
+    if(Base64 == false) {
+      if(Prefix_Size != 0 && fwrite(Prefix, 1, Prefix_Size, File) != Prefix_Size) { return false; }
+      if(Size != 0 && fwrite(Data, 1, Size, File) != Size) { return false; }
+      return true;
+    } // if(Base64 == false) {
+
+    /* Every chunk but the last is a multiple of 3 bytes long, so only the
+    last one is padded. */
+    const size_t CHUNK_SIZE = 3*16384;
+    std::vector<unsigned char> Chunk;
+    Chunk.reserve(CHUNK_SIZE);
+    std::vector<char> Encoded(4*(CHUNK_SIZE/3));
 
-  /* First, create the file to be printed to. */
-  std::string File_Path = "./IO/Out.vtk";
-  std::ofstream File{};
-  File.open(File_Path.c_str());
+    const size_t Total_Size = Prefix_Size + Size;
+    size_t Position = 0;
+    while(Position < Total_Size) {
+      const size_t Chunk_End = (Position + CHUNK_SIZE < Total_Size) ? (Position + CHUNK_SIZE) : Total_Size;
 
-  /* Now print the header to the file. */
-  vtk_header(File);
+      Chunk.clear();
+      if(Position < Prefix_Size) {
+        const size_t Prefix_End = (Chunk_End < Prefix_Size) ? Chunk_End : Prefix_Size;
+        Chunk.insert(Chunk.end(), Prefix + Position, Prefix + Prefix_End);
+      } // if(Position < Prefix_Size) {
+      if(Chunk_End > Prefix_Size) {
+        const size_t Data_Start = (Position > Prefix_Size) ? (Position - Prefix_Size) : 0;
+        Chunk.insert(Chunk.end(), Data + Data_Start, Data + (Chunk_End - Prefix_Size));
+      } // if(Chunk_End > Prefix_Size) {
 
-  /* Now print the points (Node positions) to the file */
-  vtk_points(File, Nodes, Num_Nodes);
+      const size_t Chars = 4*((Chunk.size() + 2)/3);
+      IO::Write::Encode_Base64(Chunk.data(), Chunk.size(), Encoded.data());
+      if(fwrite(Encoded.data(), 1, Chars, File) != Chars) { return false; }
 
-  /* Now print the cells (elements) to the file */
-  vtk_elements(File, Elements, Num_Elements);
+      Position = Chunk_End;
+    } // while(Position < Total_Size) {
 
-  /* All done. We can now close the file. */
-  File.close();
-} // void IO::Write::vtk(const Node* Nodes, const unsigned Num_Nodes, const Element* Elements, const unsigned Num_Elements) {
+    return true;
+  } // bool Write_Appended(FILE * File, const unsigned char * Prefix, const size_t Prefix_Size,...
 
 
 
-void IO::Write::vtk_header(std::ofstream & File) {
+  /* Throw a Bad_Stream_Use exception (see vtk_Stream). */
+  void Throw_Bad_Stream_Use(const std::string & File_Path, const char * Caller, const char * Problem) {
+    char Error_Message_Buffer[500];
+    snprintf(Error_Message_Buffer, sizeof(Error_Message_Buffer),
+             "Bad Stream Use Exception: Thrown by IO::Write::vtk_Stream::%s\n"
+             "While writing %s: %s\n",
+             Caller, File_Path.c_str(), Problem);
+    throw Bad_Stream_Use(Error_Message_Buffer);
+  } // void Throw_Bad_Stream_Use(const std::string & File_Path, const char * Caller, const char * Problem) {
+
+
+
+  /* The number of doubles in each item of an Attribute array. */
+  unsigned Num_Components(const IO::Write::VTK_Attribute Attribute) {
+    if(Attribute == IO::Write::VTK_Attribute::SCALARS) { return 1; }
+    else if(Attribute == IO::Write::VTK_Attribute::VECTORS) { return 3; }
+    else { return 9; }
+  } // unsigned Num_Components(const IO::Write::VTK_Attribute Attribute) {
+
+
+
+  /* Write the deformed mesh and the result fields (see Find_Fields) to a
+  legacy .vtk file (in binary if Binary is true, see vtk_binary) by feeding
+  them to a vtk_Stream, LEGACY_CHUNK_SIZE nodes (or elements) at a time. Every
+  array is found one chunk at a time, so we never hold a whole-mesh copy of
+  any of them. Find_Element_Stresses finds the strain, stress, and von Mises
+  stress together, but the file stores them one after the other, so we find
+  them again for each of the three cell arrays. That's cheap next to writing
+  them out. */
+  void Write_Legacy(const Node* Nodes, const unsigned Num_Nodes, const Element* Elements, const unsigned Num_Elements, const std::string & File_Path, const bool Binary, const double * Nodal_Stress) {
+    const unsigned LEGACY_CHUNK_SIZE = 4096;
+    auto Chunk_Size = [LEGACY_CHUNK_SIZE](const unsigned Start, const unsigned Num) { return (Num - Start < LEGACY_CHUNK_SIZE) ? (Num - Start) : LEGACY_CHUNK_SIZE; };
+
+    unsigned Num_Wedges = 0;
+    for(unsigned i = 0; i < Num_Elements; i++) {
+      if(Elements[i].Get_Element_Type() != Element_Types::BRICK) { Num_Wedges++; }
+    } // for(unsigned i = 0; i < Num_Elements; i++) {
+
+    IO::Write::vtk_Stream Stream{File_Path, Num_Nodes, Num_Elements, Num_Wedges, Binary};
+    std::vector<double> Values(9*(size_t)LEGACY_CHUNK_SIZE);
+
+    // Mesh
+    for(unsigned Start = 0; Start < Num_Nodes; Start += LEGACY_CHUNK_SIZE) { Stream.Add_Nodes(&Nodes[Start], Chunk_Size(Start, Num_Nodes)); }
+    for(unsigned Start = 0; Start < Num_Elements; Start += LEGACY_CHUNK_SIZE) { Stream.Add_Elements(&Elements[Start], Chunk_Size(Start, Num_Elements)); }
+
+    // Point data
+    for(unsigned Start = 0; Start < Num_Nodes; Start += LEGACY_CHUNK_SIZE) {
+      const unsigned Count = Chunk_Size(Start, Num_Nodes);
+      for(unsigned i = 0; i < Count; i++) {
+        for(unsigned Comp = 0; Comp < 3; Comp++) { Values[3*i + Comp] = Nodes[Start + i].Get_Displacement_Component(Comp); }
+      } // for(unsigned i = 0; i < Count; i++) {
+      Stream.Add_Point_Data(IO::Write::VTK_Attribute::VECTORS, "Displacement", Values.data(), Count);
+    } // for(unsigned Start = 0; Start < Num_Nodes; Start += LEGACY_CHUNK_SIZE) {
+
+    if(Nodal_Stress != nullptr) {
+      for(unsigned Start = 0; Start < Num_Nodes; Start += LEGACY_CHUNK_SIZE) {
+        const unsigned Count = Chunk_Size(Start, Num_Nodes);
+        for(unsigned i = 0; i < Count; i++) { Voigt_To_Tensor(&Nodal_Stress[6*((size_t)Start + i)], false, &Values[9*i]); }
+        Stream.Add_Point_Data(IO::Write::VTK_Attribute::TENSORS, "Nodal_Stress", Values.data(), Count);
+      } // for(unsigned Start = 0; Start < Num_Nodes; Start += LEGACY_CHUNK_SIZE) {
+
+      for(unsigned Start = 0; Start < Num_Nodes; Start += LEGACY_CHUNK_SIZE) {
+        const unsigned Count = Chunk_Size(Start, Num_Nodes);
+        for(unsigned i = 0; i < Count; i++) { Values[i] = Von_Mises_Stress(&Nodal_Stress[6*((size_t)Start + i)]); }
+        Stream.Add_Point_Data(IO::Write::VTK_Attribute::SCALARS, "Nodal_Von_Mises", Values.data(), Count);
+      } // for(unsigned Start = 0; Start < Num_Nodes; Start += LEGACY_CHUNK_SIZE) {
+    } // if(Nodal_Stress != nullptr) {
+
+    // Cell data (field 0 is the strain, 1 is the stress, and 2 is the von Mises stress)
+    std::vector<double> Strain(6*(size_t)LEGACY_CHUNK_SIZE), Stress(6*(size_t)LEGACY_CHUNK_SIZE), Von_Mises(LEGACY_CHUNK_SIZE);
+    const char * Field_Names[3] = {"Strain", "Stress", "Von_Mises"};
+    for(unsigned Field = 0; Field < 3; Field++) {
+      for(unsigned Start = 0; Start < Num_Elements; Start += LEGACY_CHUNK_SIZE) {
+        const unsigned Count = Chunk_Size(Start, Num_Elements);
+        Find_Element_Stresses(Nodes, &Elements[Start], Count, Strain.data(), Stress.data(), Von_Mises.data());
+
+        if(Field == 2) {
+          Stream.Add_Cell_Data(IO::Write::VTK_Attribute::SCALARS, Field_Names[Field], Von_Mises.data(), Count);
+          continue;
+        } // if(Field == 2) {
+
+        const std::vector<double> & Tensor = (Field == 0) ? Strain : Stress;
+        for(unsigned i = 0; i < Count; i++) { Voigt_To_Tensor(&Tensor[6*(size_t)i], Field == 0, &Values[9*i]); }
+        Stream.Add_Cell_Data(IO::Write::VTK_Attribute::TENSORS, Field_Names[Field], Values.data(), Count);
+      } // for(unsigned Start = 0; Start < Num_Elements; Start += LEGACY_CHUNK_SIZE) {
+    } // for(unsigned Field = 0; Field < 3; Field++) {
+
+    Stream.Finish();
+  } // void Write_Legacy(const Node* Nodes, const unsigned Num_Nodes, const Element* Elements, const unsigned Num_Elements,...
+} // namespace {
+
+
+
+const char * IO::Write::vtk_Extension(const VTK_Format Format) {
+  if(Format == VTK_Format::LEGACY_ASCII || Format == VTK_Format::LEGACY_BINARY) { return ".vtk"; }
+  else { return ".vtu"; }
+} // const char * IO::Write::vtk_Extension(const VTK_Format Format) {
+
+
+
+void IO::Write::vtk(const Node* Nodes, const unsigned Num_Nodes, const Element* Elements, const unsigned Num_Elements, const std::string & File_Path, const VTK_Format Format, const double * Nodal_Stress) {
   /* Function description:
-  This function is used to print the VTK file header to the passed ofstream
-  object. */
+  This function prints Node and Element data (and the result fields) to a
+  .vtk file that can be read and used by paraview. The file is written to
+  File_Path (./IO/Out.vtk by default). The legacy formats are streamed
+  through a vtk_Stream (see Write_Legacy). The XML formats are written by vtu.
 
-  File << "# vtk DataFile Version 3.0\n";
-  File << "FEM output file\n";
-  File << "ASCII\n";
-  File << "DATASET UNSTRUCTURED_GRID\n";
-} // void IO::Write::vtk_header(std::ofstream & File) {
+  Assumption 1: We can write to File_Path. */
 
+  if(Format == VTK_Format::LEGACY_BINARY) { vtk_binary(Nodes, Num_Nodes, Elements, Num_Elements, File_Path, Nodal_Stress); return; }
+  if(Format == VTK_Format::VTU_RAW)         { vtu(Nodes, Num_Nodes, Elements, Num_Elements, File_Path, false, false, Nodal_Stress); return; }
+  if(Format == VTK_Format::VTU_BASE64)      { vtu(Nodes, Num_Nodes, Elements, Num_Elements, File_Path, true, false, Nodal_Stress); return; }
+  if(Format == VTK_Format::VTU_ZLIB)        { vtu(Nodes, Num_Nodes, Elements, Num_Elements, File_Path, false, true, Nodal_Stress); return; }
+  if(Format == VTK_Format::VTU_ZLIB_BASE64) { vtu(Nodes, Num_Nodes, Elements, Num_Elements, File_Path, true, true, Nodal_Stress); return; }
 
+  Write_Legacy(Nodes, Num_Nodes, Elements, Num_Elements, File_Path, false, Nodal_Stress);
+} // void IO::Write::vtk(const Node* Nodes, const unsigned Num_Nodes, const Element* Elements, const unsigned Num_Elements, const std::string & File_Path, const VTK_Format Format, const double * Nodal_Stress) {
 
-void IO::Write::vtk_points(std::ofstream & File, const Node* Nodes, const unsigned Num_Nodes) {
+
+
+void IO::Write::vtk_binary(const Node* Nodes, const unsigned Num_Nodes, const Element* Elements, const unsigned Num_Elements, const std::string & File_Path, const double * Nodal_Stress) {
   /* Function description:
-  This function prints point data (Node positions) to the File. */
+  This function writes the same data as vtk (the deformed mesh and the result
+  fields), but the numbers are written in binary. The legacy format's
+  binary data is always big endian, so each number's bytes are written most
+  significant first (see vtk_Stream).
+
+  Assumption 1: We can write to File_Path. */
 
-  /* First, print the points header. */
-  File << "POINTS " << Num_Nodes << " double\n";
+  Write_Legacy(Nodes, Num_Nodes, Elements, Num_Elements, File_Path, true, Nodal_Stress);
+} // void IO::Write::vtk_binary(const Node* Nodes, const unsigned Num_Nodes, const Element* Elements, const unsigned Num_Elements, const std::string & File_Path, const double * Nodal_Stress) {
 
-  /* Next, print the individual points to the file. */
-  for(unsigned i = 0; i < Num_Nodes; i++) {
-    double xi = Nodes[i].Get_Position_Component(0) + Nodes[i].Get_Displacement_Component(0);
-    double yi = Nodes[i].Get_Position_Component(1) + Nodes[i].Get_Displacement_Component(1);
-    double zi = Nodes[i].Get_Position_Component(2) + Nodes[i].Get_Displacement_Component(2);
 
-    File << xi << " " << yi << " " << zi << "\n";
-  } // for(unsigned i = 0; i < Num_Nodes; i++) {
-} // void IO::Write::vtk_points(std::ofstream & File, const Node* Nodes, const unsigned Num_Nodes) {
+
+void IO::Write::Encode_Base64(const unsigned char * Data, const size_t Size, char * Out) {
+  /* Function description:
+  This function base64 encodes Data. Each 3 bytes become 4 chars, so the
+  groups are independent (and we encode them in parallel). The last group is
+  padded with '='. */
+  static const char Alphabet[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  const size_t Num_Full_Groups = Size/3;
+
+  #pragma omp parallel for schedule(static)
+  for(size_t g = 0; g < Num_Full_Groups; g++) {
+    const unsigned char * In = Data + 3*g;
+    const uint32_t Bits = ((uint32_t)In[0] << 16) | ((uint32_t)In[1] << 8) | (uint32_t)In[2];
+    char * Group_Out = Out + 4*g;
+    Group_Out[0] = Alphabet[(Bits >> 18) & 63];
+    Group_Out[1] = Alphabet[(Bits >> 12) & 63];
+    Group_Out[2] = Alphabet[(Bits >>  6) & 63];
+    Group_Out[3] = Alphabet[ Bits        & 63];
+  } // for(size_t g = 0; g < Num_Full_Groups; g++) {
+
+  const size_t Left_Over = Size - 3*Num_Full_Groups;
+  if(Left_Over != 0) {
+    const unsigned char * In = Data + 3*Num_Full_Groups;
+    const uint32_t Bits = ((uint32_t)In[0] << 16) | ((Left_Over == 2) ? ((uint32_t)In[1] << 8) : 0);
+    char * Group_Out = Out + 4*Num_Full_Groups;
+    Group_Out[0] = Alphabet[(Bits >> 18) & 63];
+    Group_Out[1] = Alphabet[(Bits >> 12) & 63];
+    Group_Out[2] = (Left_Over == 2) ? Alphabet[(Bits >> 6) & 63] : '=';
+    Group_Out[3] = '=';
+  } // if(Left_Over != 0) {
+} // void IO::Write::Encode_Base64(const unsigned char * Data, const size_t Size, char * Out) {
 
 
 
-void IO::Write::vtk_elements(std::ofstream & File, const Element* Elements, const unsigned Num_Elements) {
+void IO::Write::vtu(const Node* Nodes, const unsigned Num_Nodes, const Element* Elements, const unsigned Num_Elements, const std::string & File_Path, const bool Base64, const bool Compress, const double * Nodal_Stress) {
   /* Function description:
-  This function prints cell data (elements) to the File. */
-
-  /* First print the CELLS statement. To do that, we need to know how many Wedge
-  and Brick elements are in the Elements array.
-
-  Further, the code below accesses the element types several times. In order to
-  reduce redundant checks, we write down the element types into an Array as
-  we determine the number of brick and wedge elements. This should (in theory)
-  improve performance. */
-  Element_Types Element_Type_Array[Num_Elements];
-  unsigned Num_Brick = 0;
-  unsigned Num_Wedge = 0;
-
-  for(unsigned i = 0; i < Num_Elements; i++) {
-    if(Elements[i].Get_Element_Type() == Element_Types::BRICK) {
-      Num_Brick++;
-      Element_Type_Array[i] = Element_Types::BRICK;
-    } // if(Elements[i].Get_Element_Type() == Element_Types::BRICK) {
-    else { // if(Elements[i].Get_Element_Type() == Element_Types::WEDGE) {
-      Num_Wedge++;
-      Element_Type_Array[i] = Element_Types::WEDGE;
+  This function writes the deformed mesh and the result fields (see
+  Find_Fields) to an XML UnstructuredGrid (.vtu) file. The XML just describes the arrays; their data is in an appended
+  block at the end of the file, and each array's offset is where its data
+  starts in the appended block. Numbers are in this machine's byte order.
+
+  If Compress is false, each array's data is an 8 byte (UInt64) byte count
+  followed by the array's bytes. If Compress is true, each array is split
+  into VTU_BLOCK_SIZE byte blocks, which are zlib compressed (in parallel).
+  The array's data is then a vtkZLibDataCompressor header,
+      number of blocks, block size, size of the last block (0 if it's full),
+      the compressed size of each block
+  (all UInt64's), followed by the compressed blocks.
+
+  If Base64 is true, the data is base64 encoded, and the offsets count chars
+  of the encoded block. Uncompressed arrays are encoded in one piece (count
+  and bytes together). Compressed arrays encode their header and their
+  blocks separately (which is what VTK expects).
+
+  Assumption 1: We can write to File_Path. */
+
+  std::vector<double> Points;
+  Find_Points(Nodes, Num_Nodes, Points);
+
+  std::vector<int32_t> Connectivity, Offsets;
+  std::vector<uint8_t> Types;
+  Find_Cells(Elements, Num_Elements, Connectivity, Offsets, Types);
+
+  Result_Fields Fields;
+  Find_Fields(Nodes, Num_Nodes, Elements, Num_Elements, Nodal_Stress, Fields);
+
+  /* The arrays, in the order that they appear in the appended block. The
+  nodal stress arrays are last, and only written if we have them. */
+  const unsigned NUM_ARRAYS = 10;
+  const unsigned Num_Arrays = (Nodal_Stress == nullptr) ? 8 : 10;
+  const unsigned char * Array_Data[NUM_ARRAYS] = {(const unsigned char *)Points.data(), (const unsigned char *)Connectivity.data(),
+                                                  (const unsigned char *)Offsets.data(), (const unsigned char *)Types.data(),
+                                                  (const unsigned char *)Fields.Displacement.data(), (const unsigned char *)Fields.Strain.data(),
+                                                  (const unsigned char *)Fields.Stress.data(), (const unsigned char *)Fields.Von_Mises.data(),
+                                                  (const unsigned char *)Fields.Nodal_Stress.data(), (const unsigned char *)Fields.Nodal_Von_Mises.data()};
+  const uint64_t Array_Size[NUM_ARRAYS] = {8*Points.size(), 4*Connectivity.size(), 4*Offsets.size(), Types.size(),
+                                           8*Fields.Displacement.size(), 8*Fields.Strain.size(),
+                                           8*Fields.Stress.size(), 8*Fields.Von_Mises.size(),
+                                           8*Fields.Nodal_Stress.size(), 8*Fields.Nodal_Von_Mises.size()};
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* First, find where each array starts in the appended block (we need the
+  offsets before we can write the XML). An uncompressed array's size only
+  depends on its length, so its data is written straight from the array
+  later on. Compressed arrays have to be compressed first (Header[a] and
+  Body[a], see Compress_Blocks) to find their sizes. */
+  std::vector<unsigned char> Header[NUM_ARRAYS];
+  std::vector<unsigned char> Body[NUM_ARRAYS];
+  uint64_t Array_Offset[NUM_ARRAYS];
+  uint64_t Offset = 0;
+  for(unsigned a = 0; a < Num_Arrays; a++) {
+    Array_Offset[a] = Offset;
+
+    if(Compress == false) { Offset += Appended_Size(8 + (size_t)Array_Size[a], Base64); }
+    else {
+      if(Compress_Blocks(Array_Data[a], (size_t)Array_Size[a], Header[a], Body[a]) == false) { Throw_Cant_Write(File_Path, "IO::Write::vtu"); }
+      Offset += Appended_Size(Header[a].size(), Base64) + Appended_Size(Body[a].size(), Base64);
+    } // else {
+  } // for(unsigned a = 0; a < Num_Arrays; a++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Now, write the XML, then the appended data. */
+  FILE * File = fopen(File_Path.c_str(), "wb");
+
+  /* Assumption 1 */
+  if(File == nullptr) { Throw_Cant_Write(File_Path, "IO::Write::vtu"); }
+
+  fprintf(File,
+          "<?xml version=\"1.0\"?>\n"
+          "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"%s\" header_type=\"UInt64\"%s>\n"
+          "  <UnstructuredGrid>\n"
+          "    <Piece NumberOfPoints=\"%u\" NumberOfCells=\"%u\">\n"
+          "      <PointData Vectors=\"Displacement\">\n"
+          "        <DataArray type=\"Float64\" Name=\"Displacement\" NumberOfComponents=\"3\" format=\"appended\" offset=\"%llu\"/>\n",
+          Is_Little_Endian() ? "LittleEndian" : "BigEndian", Compress ? " compressor=\"vtkZLibDataCompressor\"" : "",
+          Num_Nodes, Num_Elements, (unsigned long long)Array_Offset[4]);
+
+  if(Nodal_Stress != nullptr) {
+    fprintf(File,
+            "        <DataArray type=\"Float64\" Name=\"Nodal_Stress\" NumberOfComponents=\"9\" format=\"appended\" offset=\"%llu\"/>\n"
+            "        <DataArray type=\"Float64\" Name=\"Nodal_Von_Mises\" format=\"appended\" offset=\"%llu\"/>\n",
+            (unsigned long long)Array_Offset[8], (unsigned long long)Array_Offset[9]);
+  } // if(Nodal_Stress != nullptr) {
+
+  fprintf(File,
+          "      </PointData>\n"
+          "      <CellData Tensors=\"Stress\" Scalars=\"Von_Mises\">\n"
+          "        <DataArray type=\"Float64\" Name=\"Strain\" NumberOfComponents=\"9\" format=\"appended\" offset=\"%llu\"/>\n"
+          "        <DataArray type=\"Float64\" Name=\"Stress\" NumberOfComponents=\"9\" format=\"appended\" offset=\"%llu\"/>\n"
+          "        <DataArray type=\"Float64\" Name=\"Von_Mises\" format=\"appended\" offset=\"%llu\"/>\n"
+          "      </CellData>\n"
+          "      <Points>\n"
+          "        <DataArray type=\"Float64\" NumberOfComponents=\"3\" format=\"appended\" offset=\"%llu\"/>\n"
+          "      </Points>\n"
+          "      <Cells>\n"
+          "        <DataArray type=\"Int32\" Name=\"connectivity\" format=\"appended\" offset=\"%llu\"/>\n"
+          "        <DataArray type=\"Int32\" Name=\"offsets\" format=\"appended\" offset=\"%llu\"/>\n"
+          "        <DataArray type=\"UInt8\" Name=\"types\" format=\"appended\" offset=\"%llu\"/>\n"
+          "      </Cells>\n"
+          "    </Piece>\n"
+          "  </UnstructuredGrid>\n"
+          "  <AppendedData encoding=\"%s\">\n"
+          "_",
+          (unsigned long long)Array_Offset[5], (unsigned long long)Array_Offset[6], (unsigned long long)Array_Offset[7],
+          (unsigned long long)Array_Offset[0],
+          (unsigned long long)Array_Offset[1], (unsigned long long)Array_Offset[2], (unsigned long long)Array_Offset[3],
+          Base64 ? "base64" : "raw");
+
+  /* Uncompressed arrays are written (and encoded) in one piece: the byte
+  count, then the array's bytes. Compressed arrays encode their header and
+  their blocks separately. */
+  bool Written = true;
+  for(unsigned a = 0; a < Num_Arrays && Written == true; a++) {
+    if(Compress == false) {
+      unsigned char Count[8];
+      memcpy(Count, &Array_Size[a], 8);
+      Written = Write_Appended(File, Count, 8, Array_Data[a], (size_t)Array_Size[a], Base64);
+    } // if(Compress == false) {
+    else {
+      Written = Write_Appended(File, Header[a].data(), Header[a].size(), nullptr, 0, Base64) &&
+                Write_Appended(File, Body[a].data(), Body[a].size(), nullptr, 0, Base64);
     } // else {
-  } // for(unsigned i = 0; i < Num_Elements; i++) {
-
-  unsigned n = (8+1)*Num_Brick + (6+1)*Num_Wedge;
-
-  File << "CELLS " << Num_Elements << " " << n << "\n";
-
-  /* Next, cycle through the Elements, printing each one's node list to the
-  file. */
-  for(unsigned i = 0; i < Num_Elements; i++) {
-    if(Element_Type_Array[i] == Element_Types::BRICK) {
-      File << "8";
-      for(unsigned j = 0; j < 8; j++) { File << " " << Elements[i].Get_Node_ID(j); }
-      File << "\n";
-    } // if(Element_Type_Array[i] == Element_Types::BRICK) {
-    else { // (Element_Type_Array[i] == Element_Types::WEDGE)
-      File << "6";
-
-      /* Nodes 2, 3 and 6, 7 are identical for wedge elements. Thus,
-      we only want to print nodes 0, 1, 2 and 4, 5, 6 to file */
-      for(unsigned j = 0; j < 3; j++) { File << " " << Elements[i].Get_Node_ID(j); }
-      for(unsigned j = 4; j < 7; j++) { File << " " << Elements[i].Get_Node_ID(j); }
-      File << "\n";
+  } // for(unsigned a = 0; a < Num_Arrays && Written == true; a++) {
+
+  fprintf(File, "\n  </AppendedData>\n</VTKFile>\n");
+  Written = (fclose(File) == 0) && Written;
+
+  /* Assumption 1 */
+  if(Written == false) { Throw_Cant_Write(File_Path, "IO::Write::vtu"); }
+} // void IO::Write::vtu(const Node* Nodes, const unsigned Num_Nodes, const Element* Elements, const unsigned Num_Elements, const std::string & File_Path, const bool Base64, const bool Compress, const double * Nodal_Stress) {
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// vtk_Stream
+
+IO::Write::vtk_Stream::vtk_Stream(const std::string & File_Path, const unsigned Num_Nodes, const unsigned Num_Elements, const unsigned Num_Wedges, const bool Binary, const size_t Buffer_Size)
+  : File_Path(File_Path), Num_Nodes(Num_Nodes), Num_Elements(Num_Elements), Num_Wedges(Num_Wedges), Binary(Binary) {
+  /* Function description:
+  This function opens the file and writes its header and the POINTS header.
+
+  Assumption 1: There can't be more wedges than elements.
+  Assumption 2: We can write to File_Path. */
+
+  /* Assumption 1 */
+  if(Num_Wedges > Num_Elements) { Throw_Bad_Stream_Use(File_Path, "vtk_Stream", "There are more wedges than elements."); }
+
+  File = fopen(File_Path.c_str(), "wb");
+
+  /* Assumption 2 */
+  if(File == nullptr) { Throw_Cant_Write(File_Path, "IO::Write::vtk_Stream::vtk_Stream"); }
+
+  Buffer.resize((Buffer_Size < VTK_STREAM_MIN_BUFFER_SIZE) ? VTK_STREAM_MIN_BUFFER_SIZE : Buffer_Size);
+  Cell_Types.reserve(Num_Elements);
+
+  char Header[200];
+  sprintf(Header, "# vtk DataFile Version 3.0\nFEM output file\n%s\nDATASET UNSTRUCTURED_GRID\nPOINTS %u double\n", Binary ? "BINARY" : "ASCII", Num_Nodes);
+  Put_Header(Header);
+} // IO::Write::vtk_Stream::vtk_Stream(const std::string & File_Path, const unsigned Num_Nodes, const unsigned Num_Elements, const unsigned Num_Wedges,...
+
+
+
+IO::Write::vtk_Stream::~vtk_Stream(void) {
+  if(File != nullptr) { fclose(File); }
+} // IO::Write::vtk_Stream::~vtk_Stream(void) {
+
+
+
+void IO::Write::vtk_Stream::Put(const char * Data, const size_t Size) {
+  /* Function description:
+  This function adds Size bytes to the buffer, writing the buffer out first
+  if they don't fit. Anything bigger than the buffer is written directly. */
+
+  if(Buffer_Used + Size > Buffer.size()) { Flush(); }
+
+  if(Size > Buffer.size()) {
+    if(fwrite(Data, 1, Size, File) != Size) { Throw_Cant_Write(File_Path, "IO::Write::vtk_Stream::Put"); }
+    return;
+  } // if(Size > Buffer.size()) {
+
+  memcpy(&Buffer[Buffer_Used], Data, Size);
+  Buffer_Used += Size;
+} // void IO::Write::vtk_Stream::Put(const char * Data, const size_t Size) {
+
+
+
+void IO::Write::vtk_Stream::Put_Header(const std::string & Header) {
+  /* Function description:
+  This function writes a section (or array) header. In binary files, the
+  data doesn't end with a newline, so a header that follows data needs one. */
+
+  if(Binary == true && Data_Since_Header == true) { Put("\n", 1); }
+  Put(Header.c_str(), Header.size());
+  Data_Since_Header = false;
+} // void IO::Write::vtk_Stream::Put_Header(const std::string & Header) {
+
+
+
+void IO::Write::vtk_Stream::Put_Value(const double Value, const bool End_Of_Line) {
+  /* Binary values are big endian (see vtk_binary). Text values are written
+  with %g (what an ofstream uses by default). */
+  if(Binary == true) {
+    uint64_t Bits;
+    memcpy(&Bits, &Value, 8);
+    unsigned char Bytes[8];
+    Put_Big_Endian(Bits, Bytes);
+    Put((const char *)Bytes, 8);
+  } // if(Binary == true) {
+  else {
+    char Text[32];
+    const int Length = snprintf(Text, sizeof(Text), End_Of_Line ? "%g\n" : "%g ", Value);
+    Put(Text, (size_t)Length);
+  } // else {
+
+  Data_Since_Header = true;
+} // void IO::Write::vtk_Stream::Put_Value(const double Value, const bool End_Of_Line) {
+
+
+
+void IO::Write::vtk_Stream::Put_Value(const unsigned Value, const bool End_Of_Line) {
+  if(Binary == true) {
+    unsigned char Bytes[4];
+    Put_Big_Endian((uint32_t)Value, Bytes);
+    Put((const char *)Bytes, 4);
+  } // if(Binary == true) {
+  else {
+    char Text[16];
+    const int Length = snprintf(Text, sizeof(Text), End_Of_Line ? "%u\n" : "%u ", Value);
+    Put(Text, (size_t)Length);
+  } // else {
+
+  Data_Since_Header = true;
+} // void IO::Write::vtk_Stream::Put_Value(const unsigned Value, const bool End_Of_Line) {
+
+
+
+void IO::Write::vtk_Stream::Flush(void) {
+  if(Buffer_Used == 0) { return; }
+
+  if(fwrite(Buffer.data(), 1, Buffer_Used, File) != Buffer_Used) { Throw_Cant_Write(File_Path, "IO::Write::vtk_Stream::Flush"); }
+  Buffer_Used = 0;
+} // void IO::Write::vtk_Stream::Flush(void) {
+
+
+
+void IO::Write::vtk_Stream::Advance_To(const Section Next, const char * Caller) {
+  /* Function description:
+  This function moves the stream forward to the Next section, checking that
+  each section it leaves is complete, and writing the headers (and cell
+  types) that go between them.
+
+  Assumption 1: We never go back to an earlier section.
+  Assumption 2: Each section we leave has all of its declared data. */
+
+  /* Assumption 1 */
+  if(Next < Current) { Throw_Bad_Stream_Use(File_Path, Caller, "That section has already been written (the data must be given in file order, see vtk_Writer.h)."); }
+
+  char Problem[200];
+  while(Current < Next) {
+    if(Current == Section::POINTS) {
+      /* Assumption 2 */
+      if(Nodes_Added != Num_Nodes) {
+        sprintf(Problem, "Only %u of the %u nodes were added.", Nodes_Added, Num_Nodes);
+        Throw_Bad_Stream_Use(File_Path, Caller, Problem);
+      } // if(Nodes_Added != Num_Nodes) {
+
+      // Each brick is its number of nodes and 8 nodes. Each wedge, 6 nodes.
+      char Header[100];
+      sprintf(Header, "CELLS %u %lu\n", Num_Elements, 9*(unsigned long)Num_Elements - 2*(unsigned long)Num_Wedges);
+      Put_Header(Header);
+      Current = Section::CELLS;
+    } // if(Current == Section::POINTS) {
+
+    else if(Current == Section::CELLS) {
+      /* Assumption 2 */
+      if(Elements_Added != Num_Elements || Wedges_Added != Num_Wedges) {
+        sprintf(Problem, "%u of the %u elements (%u of the %u wedges) were added.", Elements_Added, Num_Elements, Wedges_Added, Num_Wedges);
+        Throw_Bad_Stream_Use(File_Path, Caller, Problem);
+      } // if(Elements_Added != Num_Elements || Wedges_Added != Num_Wedges) {
+
+      char Header[100];
+      sprintf(Header, "CELL_TYPES %u\n", Num_Elements);
+      Put_Header(Header);
+      for(unsigned i = 0; i < Num_Elements; i++) { Put_Value((unsigned)Cell_Types[i], true); }
+      std::vector<uint8_t>().swap(Cell_Types);
+
+      Current = Section::POINT_DATA;
+      Section_Has_Arrays = false;
+    } // else if(Current == Section::CELLS) {
+
+    else { // POINT_DATA or CELL_DATA
+      const unsigned Num_Items = (Current == Section::POINT_DATA) ? Num_Nodes : Num_Elements;
+
+      /* Assumption 2 */
+      if(Array_Open == true && Array_Items_Added != Num_Items) {
+        sprintf(Problem, "Only %u of the %u items of %.100s were added.", Array_Items_Added, Num_Items, Array_Name.c_str());
+        Throw_Bad_Stream_Use(File_Path, Caller, Problem);
+      } // if(Array_Open == true && Array_Items_Added != Num_Items) {
+
+      Array_Open = false;
+      Current = (Current == Section::POINT_DATA) ? Section::CELL_DATA : Section::DONE;
+      Section_Has_Arrays = false;
     } // else {
-  } // for(unsigned i = 0; i < Num_Elements; i++) {
-
-  /* Now print the Cell_Type statement */
-  File << "CELL_TYPES " << Num_Elements << "\n";
-
-  /* Now print the cell types. In our case, every cell is either a hexahedral
-  or wedge element. hexahedral elements correspond to id 12. Wedge elements
-  correspond to id 13 */
-  for(unsigned i = 0; i < Num_Elements; i++) {
-    if(Element_Type_Array[i] == Element_Types::BRICK) { File << "12\n"; }
-    else { File << "13\n"; }
-  } // for(unsigned i = 0; i < Num_Elements; i++) {
-} // void IO::Write::vtk_elements(std::ofstream & File, const Element* Elements, const unsigned Num_Elements) {
+  } // while(Current < Next) {
+} // void IO::Write::vtk_Stream::Advance_To(const Section Next, const char * Caller) {
+
+
+
+void IO::Write::vtk_Stream::Add_Nodes(const Node* Nodes, const unsigned Num) {
+  /* Assumption 1: We don't get more than Num_Nodes nodes. */
+  Advance_To(Section::POINTS, "Add_Nodes");
+
+  /* Assumption 1 */
+  if(Num > Num_Nodes - Nodes_Added) { Throw_Bad_Stream_Use(File_Path, "Add_Nodes", "More nodes were added than were declared."); }
+
+  for(unsigned i = 0; i < Num; i++) {
+    for(unsigned Comp = 0; Comp < 3; Comp++) {
+      Put_Value(Nodes[i].Get_Position_Component(Comp) + Nodes[i].Get_Displacement_Component(Comp), Comp == 2);
+    } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+  } // for(unsigned i = 0; i < Num; i++) {
+
+  Nodes_Added += Num;
+} // void IO::Write::vtk_Stream::Add_Nodes(const Node* Nodes, const unsigned Num) {
+
+
+
+void IO::Write::vtk_Stream::Add_Elements(const Element* Elements, const unsigned Num) {
+  /* Function description:
+  This function writes each element's node list, and records its type.
+  Nodes 2, 3 and 6, 7 of a wedge are identical, so wedges only list nodes
+  0, 1, 2 and 4, 5, 6.
+
+  Assumption 1: We don't get more than Num_Elements elements, or more than
+  Num_Wedges wedges.
+  Assumption 2: Each element's nodes are in the mesh. */
+  static const unsigned Brick_Nodes[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+  static const unsigned Wedge_Nodes[6] = {0, 1, 2, 4, 5, 6};
+
+  Advance_To(Section::CELLS, "Add_Elements");
+
+  /* Assumption 1 */
+  if(Num > Num_Elements - Elements_Added) { Throw_Bad_Stream_Use(File_Path, "Add_Elements", "More elements were added than were declared."); }
+
+  for(unsigned i = 0; i < Num; i++) {
+    const bool Brick = (Elements[i].Get_Element_Type() == Element_Types::BRICK);
+
+    /* Assumption 1 */
+    if(Brick == false && Wedges_Added == Num_Wedges) { Throw_Bad_Stream_Use(File_Path, "Add_Elements", "More wedges were added than were declared."); }
+
+    const unsigned * Cell_Nodes = Brick ? Brick_Nodes : Wedge_Nodes;
+    const unsigned Num_Cell_Nodes = Brick ? 8 : 6;
+    Put_Value(Num_Cell_Nodes, false);
+    for(unsigned j = 0; j < Num_Cell_Nodes; j++) {
+      const unsigned Node_ID = Elements[i].Get_Node_ID(Cell_Nodes[j]);
+
+      /* Assumption 2 */
+      if(Node_ID >= Num_Nodes) { Throw_Bad_Stream_Use(File_Path, "Add_Elements", "An element has a node that isn't in the mesh."); }
+
+      Put_Value(Node_ID, j == Num_Cell_Nodes - 1);
+    } // for(unsigned j = 0; j < Num_Cell_Nodes; j++) {
+
+    Cell_Types.push_back(Brick ? 12 : 13);
+    if(Brick == false) { Wedges_Added++; }
+    Elements_Added++;
+  } // for(unsigned i = 0; i < Num; i++) {
+} // void IO::Write::vtk_Stream::Add_Elements(const Element* Elements, const unsigned Num) {
+
+
+
+void IO::Write::vtk_Stream::Add_Data(const Section Data_Section, const VTK_Attribute Attribute, const char * Name, const double * Values, const unsigned Num_Items, const char * Caller) {
+  /* Function description:
+  This function writes the next Num_Items items of a point or cell data
+  array. If there's no array in progress (or the last one is complete), this
+  starts a new one (writing POINT_DATA or CELL_DATA first if this is the
+  section's first array). Vectors are written one per line, and tensors as
+  3 rows.
+
+  Assumption 1: Name is a single word (VTK splits headers at whitespace).
+  Assumption 2: An array that's in progress is finished before the next one
+  starts.
+  Assumption 3: We don't get more items than the section has. */
+
+  Advance_To(Data_Section, Caller);
+  const unsigned Section_Items = (Data_Section == Section::POINT_DATA) ? Num_Nodes : Num_Elements;
+
+  if(Array_Open == false || Array_Items_Added == Section_Items) {
+    /* Assumption 1 */
+    if(Name == nullptr || Name[0] == '\0' || strpbrk(Name, " \t\r\n") != nullptr) { Throw_Bad_Stream_Use(File_Path, Caller, "Array names must be one (non-empty) word."); }
+
+    if(Section_Has_Arrays == false) {
+      char Header[100];
+      sprintf(Header, "%s %u\n", (Data_Section == Section::POINT_DATA) ? "POINT_DATA" : "CELL_DATA", Section_Items);
+      Put_Header(Header);
+      Section_Has_Arrays = true;
+    } // if(Section_Has_Arrays == false) {
+
+    if(Attribute == VTK_Attribute::SCALARS)      { Put_Header(std::string("SCALARS ") + Name + " double 1\nLOOKUP_TABLE default\n"); }
+    else if(Attribute == VTK_Attribute::VECTORS) { Put_Header(std::string("VECTORS ") + Name + " double\n"); }
+    else                                         { Put_Header(std::string("TENSORS ") + Name + " double\n"); }
+
+    Array_Open = true;
+    Array_Name = Name;
+    Array_Attribute = Attribute;
+    Array_Items_Added = 0;
+  } // if(Array_Open == false || Array_Items_Added == Section_Items) {
+
+  /* Assumption 2 */
+  else if(Array_Name != Name || Array_Attribute != Attribute) {
+    char Problem[300];
+    sprintf(Problem, "Only %u of the %u items of %.100s were added before %.100s was started.", Array_Items_Added, Section_Items, Array_Name.c_str(), Name);
+    Throw_Bad_Stream_Use(File_Path, Caller, Problem);
+  } // else if(Array_Name != Name || Array_Attribute != Attribute) {
+
+  /* Assumption 3 */
+  if(Num_Items > Section_Items - Array_Items_Added) { Throw_Bad_Stream_Use(File_Path, Caller, "More items were added than the section has."); }
+
+  const unsigned Components = Num_Components(Attribute);
+  const unsigned Row_Length = (Components == 1) ? 1 : 3;
+  for(size_t k = 0; k < (size_t)Components*Num_Items; k++) { Put_Value(Values[k], (k % Row_Length) == Row_Length - 1); }
+
+  Array_Items_Added += Num_Items;
+} // void IO::Write::vtk_Stream::Add_Data(const Section Data_Section, const VTK_Attribute Attribute, const char * Name, const double * Values,...
+
+
+
+void IO::Write::vtk_Stream::Add_Point_Data(const VTK_Attribute Attribute, const char * Name, const double * Values, const unsigned Num_Items) {
+  Add_Data(Section::POINT_DATA, Attribute, Name, Values, Num_Items, "Add_Point_Data");
+} // void IO::Write::vtk_Stream::Add_Point_Data(const VTK_Attribute Attribute, const char * Name, const double * Values, const unsigned Num_Items) {
+
+
+
+void IO::Write::vtk_Stream::Add_Cell_Data(const VTK_Attribute Attribute, const char * Name, const double * Values, const unsigned Num_Items) {
+  Add_Data(Section::CELL_DATA, Attribute, Name, Values, Num_Items, "Add_Cell_Data");
+} // void IO::Write::vtk_Stream::Add_Cell_Data(const VTK_Attribute Attribute, const char * Name, const double * Values, const unsigned Num_Items) {
+
+
+
+void IO::Write::vtk_Stream::Finish(void) {
+  /* Function description:
+  This function checks that every section is complete (see Advance_To),
+  writes out whatever is left in the buffer, and closes the file.
+
+  Assumption 1: Finish is only called once.
+  Assumption 2: We can write to File_Path. */
+
+  /* Assumption 1 */
+  if(File == nullptr) { Throw_Bad_Stream_Use(File_Path, "Finish", "The stream has already been finished."); }
+
+  Advance_To(Section::DONE, "Finish");
+  if(Binary == true) { Put("\n", 1); }
+  Flush();
+
+  const bool Closed = (fclose(File) == 0);
+  File = nullptr;
+
+  /* Assumption 2 */
+  if(Closed == false) { Throw_Cant_Write(File_Path, "IO::Write::vtk_Stream::Finish"); }
+} // void IO::Write::vtk_Stream::Finish(void) {
 
 #endif
@@ -1,8 +1,12 @@
 #if !defined(VTK_WRITER_HEADER)
 #define VTK_WRITER_HEADER
 
-#include <fstream>
 #include <string.h>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <stdio.h>
+#include <zlib.h>
 
 #include "Errors.h"
 #include "Node/Node.h"
@@ -10,20 +14,185 @@
 
 namespace IO {
   namespace Write {
+    /* Output formats.
+      LEGACY_ASCII: Legacy VTK, in text (the original format).
+      LEGACY_BINARY: Legacy VTK, with the points and cells in binary (big
+      endian, as the legacy format requires).
+      VTU_RAW: XML UnstructuredGrid (.vtu), with the data in one appended
+      block of raw (machine byte order) binary.
+      VTU_BASE64: Same as VTU_RAW, but the appended data is base64 encoded
+      (which keeps the file valid XML, at 4/3 the size).
+      VTU_ZLIB, VTU_ZLIB_BASE64: Same as VTU_RAW and VTU_BASE64, but each
+      array is split into VTU_BLOCK_SIZE byte blocks, which are zlib
+      compressed in parallel (see vtu).
+    The binary formats store every double exactly, and are much smaller and
+    faster to write than text.
+
+    Every format also has the results: each node's displacement (point data),
+    and each element's strain and stress tensors and von Mises stress (cell
+    data). The element's material must be set (we need D for the stress).
+    If Nodal_Stress (6 components per node, in Voigt order, see
+    Simulation::Recover_Nodal_Stresses) isn't null, each node's stress tensor
+    and von Mises stress are written as point data too. */
+    enum class VTK_Format { LEGACY_ASCII, LEGACY_BINARY, VTU_RAW, VTU_BASE64, VTU_ZLIB, VTU_ZLIB_BASE64 };
+
+    /* The uncompressed size of each compressed VTU block (VTK's default) and
+    the zlib compression level (1 is the fastest, 9 the smallest). */
+    const size_t VTU_BLOCK_SIZE = 32768;
+    const int VTU_COMPRESSION_LEVEL = 1;
+
+    /* The file extension (".vtk" or ".vtu") for Format. */
+    const char * vtk_Extension(const VTK_Format Format);                      // Intent: Read
+
     void vtk(const Node* Nodes,                                                // Intent: Read
              const unsigned Num_Nodes,                                         // Intent: Read
              const Element* Elements,                                          // Intent: Read
-             const unsigned Num_Elements);                                     // Intent: Read
+             const unsigned Num_Elements,                                      // Intent: Read
+             const std::string & File_Path = "./IO/Out.vtk",                   // Intent: Read
+             const VTK_Format Format = VTK_Format::LEGACY_ASCII,               // Intent: Read
+             const double * Nodal_Stress = nullptr);                           // Intent: Read
+
+    void vtk_binary(const Node* Nodes,                                         // Intent: Read
+                    const unsigned Num_Nodes,                                  // Intent: Read
+                    const Element* Elements,                                   // Intent: Read
+                    const unsigned Num_Elements,                               // Intent: Read
+                    const std::string & File_Path,                             // Intent: Read
+                    const double * Nodal_Stress = nullptr);                    // Intent: Read
+
+    void vtu(const Node* Nodes,                                                // Intent: Read
+             const unsigned Num_Nodes,                                         // Intent: Read
+             const Element* Elements,                                          // Intent: Read
+             const unsigned Num_Elements,                                      // Intent: Read
+             const std::string & File_Path,                                    // Intent: Read
+             const bool Base64,                                                // Intent: Read
+             const bool Compress,                                              // Intent: Read
+             const double * Nodal_Stress = nullptr);                           // Intent: Read
+
+    /* Base64 encode Size bytes into Out (which must have room for
+    4*((Size + 2)/3) chars). */
+    void Encode_Base64(const unsigned char * Data,                             // Intent: Read
+                       const size_t Size,                                      // Intent: Read
+                       char * Out);                                            // Intent: Write
+
+
+
+    /* Streaming legacy VTK writer.
+    The writers above take the whole mesh (and find all of its results) at
+    once. A vtk_Stream instead takes the mesh a chunk at a time,
+    in file order:
+        Add_Nodes                    (until all Num_Nodes nodes are added)
+        Add_Elements                 (until all Num_Elements elements are added)
+        Add_Point_Data               (any number of arrays, Num_Nodes items each)
+        Add_Cell_Data                (any number of arrays, Num_Elements items each)
+        Finish
+    Each array can also be added in chunks (keep passing the same Name until
+    it's complete). The counts (including the number of wedges, which sets the
+    size of the CELLS section) must be declared up front, since the legacy
+    format needs them in each section's header. Output goes through a fixed
+    size buffer, so the file is written as the chunks come in, and the only
+    thing we keep is each element's VTK type (1 byte per element), which goes
+    in the CELL_TYPES section after the last element.
+
+    vtk and vtk_binary write their files through a vtk_Stream (given the same
+    data, a stream writes the same file however its data is chunked). Giving the stream its data out of order, or more
+    (or less) data than was declared, throws a Bad_Stream_Use exception. */
+    enum class VTK_Attribute { SCALARS, VECTORS, TENSORS };     // 1, 3, and 9 (a 3x3 matrix, row by row) doubles per item
+
+    const size_t VTK_STREAM_BUFFER_SIZE = 1 << 20;              // Default output buffer size (in bytes)
+    const size_t VTK_STREAM_MIN_BUFFER_SIZE = 1024;             // Smaller buffers are rounded up to this
+
+    class vtk_Stream {
+      private:
+        enum class Section { POINTS, CELLS, POINT_DATA, CELL_DATA, DONE };
+
+        FILE * File = nullptr;
+        const std::string File_Path;
+        const unsigned Num_Nodes;
+        const unsigned Num_Elements;
+        const unsigned Num_Wedges;
+        const bool Binary;
+
+        std::vector<char> Buffer;
+        size_t Buffer_Used = 0;
+        bool Data_Since_Header = false;          // Binary headers that follow data start on a new line
+
+        Section Current = Section::POINTS;
+        unsigned Nodes_Added = 0;
+        unsigned Elements_Added = 0;
+        unsigned Wedges_Added = 0;
+        std::vector<uint8_t> Cell_Types;         // Freed once CELL_TYPES is written
+
+        bool Section_Has_Arrays = false;         // Have we written POINT_DATA (or CELL_DATA)?
+        bool Array_Open = false;
+        std::string Array_Name;
+        VTK_Attribute Array_Attribute = VTK_Attribute::SCALARS;
+        unsigned Array_Items_Added = 0;
+
+        void Put(const char * Data,                                            // Intent: Read
+                 const size_t Size);                                           // Intent: Read
+
+        void Put_Header(const std::string & Header);                          // Intent: Read
+
+        void Put_Value(const double Value,                                     // Intent: Read
+                       const bool End_Of_Line);                                // Intent: Read
+
+        void Put_Value(const unsigned Value,                                   // Intent: Read
+                       const bool End_Of_Line);                                // Intent: Read
+
+        void Flush(void);
+
+        void Advance_To(const Section Next,                                    // Intent: Read
+                        const char * Caller);                                  // Intent: Read
+
+        void Add_Data(const Section Data_Section,                              // Intent: Read
+                      const VTK_Attribute Attribute,                           // Intent: Read
+                      const char * Name,                                       // Intent: Read
+                      const double * Values,                                   // Intent: Read
+                      const unsigned Num_Items,                                // Intent: Read
+                      const char * Caller);                                    // Intent: Read
+
+      public:
+        /* Open File_Path and write the file's header. Num_Wedges of the
+        Num_Elements elements must be wedges. */
+        vtk_Stream(const std::string & File_Path,                              // Intent: Read
+                   const unsigned Num_Nodes,                                   // Intent: Read
+                   const unsigned Num_Elements,                                // Intent: Read
+                   const unsigned Num_Wedges = 0,                              // Intent: Read
+                   const bool Binary = true,                                   // Intent: Read
+                   const size_t Buffer_Size = VTK_STREAM_BUFFER_SIZE);         // Intent: Read
+
+        /* Closes the file if Finish wasn't called (the file is then
+        incomplete). */
+        ~vtk_Stream(void);
+
+        vtk_Stream(const vtk_Stream &) = delete;
+        vtk_Stream & operator=(const vtk_Stream &) = delete;
+
+        /* Write the deformed positions (position + displacement) of the next
+        Num nodes. */
+        void Add_Nodes(const Node* Nodes,                                      // Intent: Read
+                       const unsigned Num);                                    // Intent: Read
+
+        /* Write the node lists of the next Num elements. Node IDs refer to
+        the whole mesh (not to the chunk). */
+        void Add_Elements(const Element* Elements,                             // Intent: Read
+                          const unsigned Num);                                 // Intent: Read
 
-    void vtk_header(std::ofstream & File);                                     // Intent: Write
+        /* Write the next Num_Items items of the point (or cell) data array
+        Name. Values holds 1, 3, or 9 doubles per item (see VTK_Attribute). */
+        void Add_Point_Data(const VTK_Attribute Attribute,                     // Intent: Read
+                            const char * Name,                                 // Intent: Read
+                            const double * Values,                             // Intent: Read
+                            const unsigned Num_Items);                         // Intent: Read
 
-    void vtk_points(std::ofstream & File,                                      // Intent: Write
-                    const Node* Nodes,                                         // Intent: Read
-                    const unsigned Num_Nodes);                                 // Intent: Read
+        void Add_Cell_Data(const VTK_Attribute Attribute,                      // Intent: Read
+                           const char * Name,                                  // Intent: Read
+                           const double * Values,                              // Intent: Read
+                           const unsigned Num_Items);                          // Intent: Read
 
-    void vtk_elements(std::ofstream & File,                                    // Intent: Write
-                      const Element* Elements,                                 // Intent: Read
-                      const unsigned Num_Elements);                            // Intent: Read
+        /* Check that everything was written, and close the file. */
+        void Finish(void);
+    }; // class vtk_Stream {
   } // namespace Write {
 } // namespace IO {
 
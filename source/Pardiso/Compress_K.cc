@@ -123,6 +123,55 @@ Compressed_Matrix::Compressed_Matrix(const Matrix<double> & M) {
 } // Compressed_Matrix::Compressed_Matrix(const Matrix<T> & M) {
 
 
+Compressed_Matrix::Compressed_Matrix(const Sparse_Matrix & M) {
+  /* M is already stored in the format that Pardiso expects (upper triangle,
+  diagonal first, sorted columns). Thus, all we need to do is copy IA, JA, and
+  A out of M. */
+  const int n = (int)M.Get_Num_Rows();
+  n_IA = n + 1;
+  n_JA = (int)M.Get_Num_Non_Zero();
+
+  IA = new int[n_IA];
+  JA = new int[n_JA];
+  A = new double[n_JA];
+
+  const int* M_IA = M.Get_IA();
+  const int* M_JA = M.Get_JA();
+
+  for(int i = 0; i < n_IA; i++) { IA[i] = M_IA[i]; }
+  for(int k = 0; k < n_JA; k++) { JA[k] = M_JA[k]; }
+
+  Set_Values(M);
+
+  #if defined(COMPRESS_K_MONITOR)
+    printf("M is SPARSE\n");
+
+    printf("IA: [");
+    for(int i = 0; i < n_IA; i++) { printf(" %u", IA[i]); }
+    printf(" ]\n");
+
+    printf("JA: [");
+    for(int j = 0; j < n_JA; j++) { printf(" %d", JA[j]); }
+    printf(" ]\n");
+
+    printf("A:  [");
+    for(int j = 0; j < n_JA; j++) { printf(" %4.1lf", A[j]); }
+    printf(" ]\n");
+  #endif
+} // Compressed_Matrix::Compressed_Matrix(const Sparse_Matrix & M) {
+
+
+
+void Compressed_Matrix::Set_Values(const Sparse_Matrix & M) {
+  /* We require that M has the same pattern as the matrix that we were built
+  from (which means it must have the same number of stored components) */
+  assert(M.Get_Num_Non_Zero() == (unsigned)n_JA && M.Get_Num_Rows() + 1 == (unsigned)n_IA);
+
+  const double* M_A = M.Get_A();
+  for(int k = 0; k < n_JA; k++) { A[k] = M_A[k]; }
+} // void Compressed_Matrix::Set_Values(const Sparse_Matrix & M) {
+
+
 Compressed_Matrix::~Compressed_Matrix() {
   /* de-allocate IA, JA, and A. */
   delete [] IA;
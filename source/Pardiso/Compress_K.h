@@ -2,6 +2,7 @@
 #define COMPRESS_K_HEADER
 
 #include "Matrix.h"
+#include "Sparse/Sparse_Matrix.h"
 #include <assert.h>
 
 //#define COMPRESS_K_MONITOR
@@ -9,6 +10,12 @@
 /* Compressed matrix class.
 This class is used to convert a regular matrix into a compressed matrix that
 Pardiso can understand. Thus, it generates IA, JA, and A from M (the input).
+M can either be a regular (dense) matrix or a Sparse_Matrix. Sparse matricies
+are already stored in compressed form, so in that case we just copy IA, JA,
+and A (which only takes O(number of stored components) operations). Further,
+since a Sparse_Matrix's pattern never changes, once a Compressed_Matrix has
+been built from one, its values can be refreshed in place (using Set_Values)
+without re-building IA or JA.
 To make things easier to work with, everything in this class is public.
 
 This class really only exists for one purpose, to convert K into a format that
@@ -19,8 +26,13 @@ class Compressed_Matrix {
   public:
     // Constructor, destructor
     Compressed_Matrix(const Matrix<double> & M);
+    Compressed_Matrix(const Sparse_Matrix & M);
     ~Compressed_Matrix();
 
+    /* Copy M's values into A. M must have the same pattern as the sparse
+    matrix that this Compressed_Matrix was built from. */
+    void Set_Values(const Sparse_Matrix & M);
+
     /* IA, JA, and A (see Pardiso notes and manual). These are all ints because
     pardiso expects them to be ints */
     int* IA;
@@ -1,16 +1,42 @@
 #include "Pardiso_Solve.h"
 
 int Pardiso_Solve(const Matrix<double> & K, double* x, double* F) {
+    /* Compress K. This will allow us to get IA, JA, and A (the compressed
+    version of K) */
+    class Compressed_Matrix Compressed_K{K};
+
+    return Pardiso_Solve(Compressed_K, x, F);
+} // int Pardiso_Solve(const Matrix<double> & K, double* x, double* F) {
+
+
+
+int Pardiso_Solve(const Sparse_Matrix & K, double* x, double* F) {
+    /* K is already sparse, so we can use a Pardiso_Solver. For a single solve
+    this does the same thing as the Compressed_Matrix version below. If you
+    need to solve with K (or a matrix with the same pattern) more than once,
+    keep a Pardiso_Solver around instead of calling this function. */
+    try {
+      class Pardiso_Solver Solver{K};
+      Solver.Factor(K);
+      Solver.Solve(x, F);
+    } // try {
+    catch(const Solver_Exception & Er) {
+      printf("%s\n", Er.what());
+      return 1;
+    } // catch(const Solver_Exception & Er) {
+
+    return 0;
+} // int Pardiso_Solve(const Sparse_Matrix & K, double* x, double* F) {
+
+
+
+int Pardiso_Solve(class Compressed_Matrix & Compressed_K, double* x, double* F) {
     ////////////////////////////////////////////////////////////////////////////
-    // Compress K
+    // Get the compressed arrays
 
     /* First, let's determine the number of equations in the system. This is
-    simply the number of rows in A. */
-    int      n_eqs = K.Get_Num_Rows();
-
-    /* Next, let's compress A. This will allow us to get IA, JA, and A (the
-    compressed version of A) */
-    class Compressed_Matrix Compressed_K{K};
+    simply the number of rows in K (which is one less than the length of IA) */
+    int      n_eqs = Compressed_K.n_IA - 1;
 
     int*     IA = Compressed_K.IA;
     int*     JA = Compressed_K.JA;
@@ -152,4 +178,4 @@ int Pardiso_Solve(const Matrix<double> & K, double* x, double* F) {
              iparm, &msglvl, &ddum, &ddum, &error,  dparm);
 
     return 0;
-} // int main(void) {
+} // int Pardiso_Solve(class Compressed_Matrix & Compressed_K, double* x, double* F) {
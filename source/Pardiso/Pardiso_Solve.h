@@ -5,9 +5,18 @@
 
 #include <stdio.h>
 #include "Matrix.h"
+#include "Sparse/Sparse_Matrix.h"
 #include "Compress_K.h"
+#include "Pardiso_Solver.h"
 #include "Pardiso.h"
 
+/* Solve Kx = F. K can either be a dense matrix, a sparse matrix, or a matrix
+that has already been compressed. A dense K is compressed and then passed to
+the third version. A sparse K is solved using a Pardiso_Solver (see
+Pardiso_Solver.h). Each call factors K from scratch. If you need to solve with
+the same pattern more than once, use a Pardiso_Solver directly instead. */
 int Pardiso_Solve(const Matrix<double> & K, double* x, double* F);
+int Pardiso_Solve(const Sparse_Matrix & K, double* x, double* F);
+int Pardiso_Solve(class Compressed_Matrix & Compressed_K, double* x, double* F);
 
 #endif
@@ -0,0 +1,172 @@
+#if !defined(PARDISO_SOLVER_SOURCE)
+#define PARDISO_SOLVER_SOURCE
+
+/* File description:
+This file holds the implementation of the methods of the Pardiso_Solver
+class. */
+
+#include "Pardiso_Solver.h"
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Constructor, destructor
+
+Pardiso_Solver::Pardiso_Solver(const Sparse_Matrix & K) : Compressed_K(K) {
+  /* Assumption 1:
+  This function assumes that K's pattern has been set (otherwise, there is
+  nothing to analyze). */
+  if(K.Get_Pattern_Set() == false) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Solver Not Set Up Exception: Thrown by Pardiso_Solver::Pardiso_Solver\n"
+            "K's sparsity pattern must be set before a Pardiso_Solver can be built\n"
+            "from it.\n");
+    throw Solver_Not_Set_Up(Error_Message_Buffer);
+  } // if(K.Get_Pattern_Set() == false) {
+
+  n_eqs = Compressed_K.n_IA - 1;
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Initialize Pardiso.
+
+  int solver = 0;                                // use sparse direct solver
+  int error = 0;
+  pardisoinit(pt, &mtype, &solver, iparm, dparm, &error);
+
+  if(error != 0) {
+    Report_Pardiso_Error(error);
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Solver Failed Exception: Thrown by Pardiso_Solver::Pardiso_Solver\n"
+            "pardisoinit returned error code %d\n",
+            error);
+    throw Solver_Failed(Error_Message_Buffer);
+  } // if(error != 0) {
+
+  /* Numbers of processors, value of OMP_NUM_THREADS */
+  const char* var = getenv("OMP_NUM_THREADS");
+  int num_procs = 1;
+  if(var != NULL) { sscanf(var, "%d", &num_procs); }
+  else { printf("Couldn't find OMP_NUM_THREADS environment variable. Using 1 thread.\n"); }
+  iparm[2] = num_procs;
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Convert IA and JA from base 0 C notation to base 1 Fortran notation.
+  // (this is only done once, since the pattern never changes)
+
+  for(int i = 0; i < Compressed_K.n_IA; i++) { Compressed_K.IA[i] += 1; }
+  for(int i = 0; i < Compressed_K.n_JA; i++) { Compressed_K.JA[i] += 1; }
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Reordering and symbolic factorization. This also allocates all of the
+  memory that is needed for the factorization. Pardiso keeps the fill reducing
+  permutation (and everything else) in pt, so all later factorizations reuse
+  it. */
+
+  double ddum;
+  Run_Phase(11, &ddum, &ddum, 1, "symbolic factorization");
+
+  #if defined(PARDISO_SOLVER_MONITOR)
+    printf("Reordering completed ... \n");
+    printf("Number of nonzeros in factors  = %d\n", iparm[17]);
+    printf("Number of factorization MFLOPS = %d\n", iparm[18]);
+  #endif
+} // Pardiso_Solver::Pardiso_Solver(const Sparse_Matrix & K) : Compressed_K(K) {
+
+
+
+Pardiso_Solver::~Pardiso_Solver(void) {
+  /* Release Pardiso's internal memory. We don't throw if this fails (throwing
+  from a destructor is a bad idea). */
+  int phase = -1;
+  int nrhs = 1;
+  int error = 0;
+  int idum;
+  double ddum;
+
+  pardiso(pt, &maxfct, &mnum, &mtype, &phase,
+          &n_eqs, &ddum, Compressed_K.IA, Compressed_K.JA, &idum, &nrhs,
+          iparm, &msglvl, &ddum, &ddum, &error, dparm);
+} // Pardiso_Solver::~Pardiso_Solver(void) {
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Factor, solve
+
+void Pardiso_Solver::Factor(const Sparse_Matrix & K) {
+  /* Assumption 1:
+  This function assumes that K has the same pattern as the matrix that we
+  were built with. We can't afford to compare the patterns component by
+  component every time, so we check the number of rows and stored components. */
+  if(K.Get_Num_Rows() != (unsigned)n_eqs || K.Get_Num_Non_Zero() != (unsigned)Compressed_K.n_JA) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Solver Not Set Up Exception: Thrown by Pardiso_Solver::Factor\n"
+            "This solver was built for a matrix with %d rows and %d stored components.\n"
+            "However, K has %u rows and %u stored components.\n",
+            n_eqs, Compressed_K.n_JA, K.Get_Num_Rows(), K.Get_Num_Non_Zero());
+    throw Solver_Not_Set_Up(Error_Message_Buffer);
+  } // if(K.Get_Num_Rows() != (unsigned)n_eqs || K.Get_Num_Non_Zero() != (unsigned)Compressed_K.n_JA) {
+
+  // Copy K's values, then factor.
+  Compressed_K.Set_Values(K);
+
+  double ddum;
+  Run_Phase(22, &ddum, &ddum, 1, "numerical factorization");
+  Factored = true;
+
+  #if defined(PARDISO_SOLVER_MONITOR)
+    printf("Factorization completed ...\n");
+  #endif
+} // void Pardiso_Solver::Factor(const Sparse_Matrix & K) {
+
+
+
+void Pardiso_Solver::Solve(double* x, double* F, const unsigned Num_RHS) {
+  /* Assumption 1:
+  This function assumes that K has been factored. */
+  if(Factored == false) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Solver Not Set Up Exception: Thrown by Pardiso_Solver::Solve\n"
+            "K must be factored (using Factor) before we can solve Kx = F.\n");
+    throw Solver_Not_Set_Up(Error_Message_Buffer);
+  } // if(Factored == false) {
+
+  iparm[7] = 1;                                  // Max numbers of iterative refinement steps.
+  Run_Phase(33, F, x, (int)Num_RHS, "solution");
+
+  #if defined(PARDISO_SOLVER_MONITOR)
+    printf("Solve completed (%u right hand sides) ... \n", Num_RHS);
+  #endif
+} // void Pardiso_Solver::Solve(double* x, double* F, const unsigned Num_RHS) {
+
+
+
+void Pardiso_Solver::Run_Phase(int phase, double* b, double* x, int nrhs, const char* Phase_Name) {
+  int error = 0;
+  int idum;                                      // Passed as the PERM parameter (unused)
+
+  pardiso(pt, &maxfct, &mnum, &mtype, &phase,
+          &n_eqs, Compressed_K.A, Compressed_K.IA, Compressed_K.JA, &idum, &nrhs,
+          iparm, &msglvl, b, x, &error, dparm);
+
+  if(error != 0) {
+    Report_Pardiso_Error(error);
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Solver Failed Exception: Thrown by Pardiso_Solver::Run_Phase\n"
+            "Pardiso returned error code %d during %s (phase %d).\n",
+            error, Phase_Name, phase);
+    throw Solver_Failed(Error_Message_Buffer);
+  } // if(error != 0) {
+} // void Pardiso_Solver::Run_Phase(int phase, double* b, double* x, int nrhs, const char* Phase_Name) {
+
+#endif
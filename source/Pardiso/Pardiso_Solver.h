@@ -0,0 +1,90 @@
+#if !defined(PARDISO_SOLVER_HEADER)
+#define PARDISO_SOLVER_HEADER
+
+//#define PARDISO_SOLVER_MONITOR
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Errors.h"
+#include "Sparse/Sparse_Matrix.h"
+#include "Compress_K.h"
+#include "Pardiso.h"
+
+/* Pardiso solver class.
+Pardiso_Solve does everything from scratch each time that it's called: it
+compresses K, initializes Pardiso, reorders K and computes the symbolic
+factorization (phase 11), factors K (phase 22), solves (phase 33), and then
+releases Pardiso's memory. When we solve with the same mesh many times (with
+different loads or material constants), the pattern of K never changes. Thus,
+phase 11 (which is often the most expensive part of the solve) and the
+compression of IA/JA are repeated for no reason.
+
+This class keeps Pardiso's internal memory (pt), its parameters (iparm,
+dparm), and the (1 based) pattern of K alive between solves. The reordering
+and symbolic factorization are done once, when the solver is constructed.
+After that,
+    Factor(K) refreshes the values of K and runs phase 22 only.
+    Solve(x, F) runs phase 33 only (so, if only F changes, this is all we need).
+Pardiso's memory is released when the solver is destroyed.
+
+Every matrix that is passed to Factor must have the same sparsity pattern as
+the matrix that the solver was constructed with. */
+class Pardiso_Solver {
+  private:
+    class Compressed_Matrix Compressed_K;        // K, with 1 based IA and JA (Pardiso's format)
+    int n_eqs;                                   // Number of equations (rows of K)
+
+    void* pt[64];                                // Internal solver memory pointer
+    int iparm[64];                               // Pardiso integer parameters
+    double dparm[64];                            // Pardiso double parameters
+
+    int mtype = 2;                               // K is real, symmetric, positive definite
+    int maxfct = 1;                              // Maximum number of numerical factorizations
+    int mnum = 1;                                // Which factorization to use
+    int msglvl = 0;                              // Don't print statistical information
+    bool Factored = false;                       // True once phase 22 has run
+
+    /* Run one phase of Pardiso. b and x are the right hand side(s) and
+    solution(s) (only used in phase 33). If Pardiso reports an error, then a
+    Solver_Failed exception is thrown. */
+    void Run_Phase(int phase,                                                  // Intent: Read
+                   double* b,                                                  // Intent: Read
+                   double* x,                                                  // Intent: Write
+                   int nrhs,                                                   // Intent: Read
+                   const char* Phase_Name);                                    // Intent: Read
+
+  public:
+    //////////////////////////////////////////////////////////////////////////////
+    // Constructor, destructor
+
+    /* Initialize Pardiso and run phase 11 (reordering and symbolic
+    factorization) using K's pattern. K's values are not used. */
+    Pardiso_Solver(const Sparse_Matrix & K);                                   // Intent: Read
+    ~Pardiso_Solver(void);
+
+    /* The solver owns Pardiso's internal memory, so copying it would lead to
+    disaster. */
+    Pardiso_Solver(const Pardiso_Solver & Other) = delete;
+    Pardiso_Solver & operator=(const Pardiso_Solver & Other) = delete;
+
+
+    //////////////////////////////////////////////////////////////////////////////
+    // Factor, solve
+
+    /* Copy K's values and run phase 22 (numerical factorization). K must have
+    the same pattern as the matrix that the solver was constructed with. */
+    void Factor(const Sparse_Matrix & K);                                      // Intent: Read
+
+    /* Run phase 33 (back substitution and iterative refinement) to solve
+    Kx = F using the most recent factorization. F may hold several right hand
+    sides (load cases). In this case, x and F are n by Num_RHS column major
+    blocks (the ith right hand side is F[i*n], ... , F[i*n + n - 1]) and every
+    right hand side is solved in a single call to Pardiso. */
+    void Solve(double* x,                                                      // Intent: Write
+               double* F,                                                      // Intent: Read
+               const unsigned Num_RHS = 1);                                    // Intent: Read
+
+    unsigned Get_Num_Eq(void) const { return (unsigned)n_eqs; }
+}; // class Pardiso_Solver {
+
+#endif
@@ -0,0 +1,168 @@
+#if !defined(SIMULATION_ASSEMBLY_SOURCE)
+#define SIMULATION_ASSEMBLY_SOURCE
+
+/* File description:
+This file holds the functions that move the element stiffness matrices and
+force vectors into K and F. Elements that share a node write to some of the
+same components of K and F, so we can't just assemble every element at once.
+Instead, we color the elements so that no two elements of the same color share
+a node. The elements of each color can then be assembled in parallel, one color
+after another. */
+
+#include "Simulation.h"
+//#define COLORING_MONITOR               // Prints the number of elements of each color
+
+
+
+void Simulation::Color_Elements(const class Element* Elements, const unsigned Num_Elements, const unsigned Num_Nodes, Element_Coloring & Coloring) {
+  /* Function description:
+  This function colors the elements using a greedy algorithm. We cycle through
+  the elements in order. For each one, we find the colors of the (already
+  colored) elements that share one of its nodes and then give it the smallest
+  color that is not one of those.
+
+  To find the elements that share a node with an element, we first build a
+  node-to-element map (stored in compressed form, see Set_K_Sparsity_Pattern).
+  Wedges list some nodes twice, which just means that an element shows up
+  twice in that node's list (which doesn't hurt anything). */
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Build the node-to-element map.
+
+  std::vector<unsigned> Node_Elements_Start(Num_Nodes + 1, 0);
+  for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+    for(unsigned a = 0; a < 8; a++) { Node_Elements_Start[Elements[Element_Index].Get_Node_ID(a) + 1]++; }
+  } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+
+  for(unsigned n = 0; n < Num_Nodes; n++) { Node_Elements_Start[n+1] += Node_Elements_Start[n]; }
+
+  std::vector<unsigned> Node_Elements(Node_Elements_Start[Num_Nodes]);
+  std::vector<unsigned> Next_Slot(Node_Elements_Start.begin(), Node_Elements_Start.end() - 1);
+  for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+    for(unsigned a = 0; a < 8; a++) {
+      const unsigned n = Elements[Element_Index].Get_Node_ID(a);
+      Node_Elements[Next_Slot[n]] = Element_Index;
+      Next_Slot[n]++;
+    } // for(unsigned a = 0; a < 8; a++) {
+  } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Now, color the elements. Color_Used_By[c] == e means that color c is used
+  by an element that shares a node with element e. */
+
+  const unsigned NO_COLOR = (unsigned)-1;
+  std::vector<unsigned> Element_Color(Num_Elements, NO_COLOR);
+  std::vector<unsigned> Color_Used_By;
+  unsigned Num_Colors = 0;
+
+  for(unsigned e = 0; e < Num_Elements; e++) {
+    for(unsigned a = 0; a < 8; a++) {
+      const unsigned n = Elements[e].Get_Node_ID(a);
+
+      for(unsigned k = Node_Elements_Start[n]; k < Node_Elements_Start[n+1]; k++) {
+        const unsigned Color = Element_Color[Node_Elements[k]];
+        if(Color != NO_COLOR) { Color_Used_By[Color] = e; }
+      } // for(unsigned k = Node_Elements_Start[n]; k < Node_Elements_Start[n+1]; k++) {
+    } // for(unsigned a = 0; a < 8; a++) {
+
+    unsigned Color = 0;
+    while(Color < Num_Colors && Color_Used_By[Color] == e) { Color++; }
+
+    // If every existing color is used by a neighbor, make a new one.
+    if(Color == Num_Colors) {
+      Num_Colors++;
+      Color_Used_By.push_back(NO_COLOR);
+    } // if(Color == Num_Colors) {
+
+    Element_Color[e] = Color;
+  } // for(unsigned e = 0; e < Num_Elements; e++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Finally, group the elements by color.
+
+  Coloring.Num_Colors = Num_Colors;
+  Coloring.Color_Start.assign(Num_Colors + 1, 0);
+  for(unsigned e = 0; e < Num_Elements; e++) { Coloring.Color_Start[Element_Color[e] + 1]++; }
+  for(unsigned c = 0; c < Num_Colors; c++) { Coloring.Color_Start[c+1] += Coloring.Color_Start[c]; }
+
+  Coloring.Elements.resize(Num_Elements);
+  std::vector<unsigned> Next_Color_Slot(Coloring.Color_Start.begin(), Coloring.Color_Start.end() - 1);
+  for(unsigned e = 0; e < Num_Elements; e++) {
+    Coloring.Elements[Next_Color_Slot[Element_Color[e]]] = e;
+    Next_Color_Slot[Element_Color[e]]++;
+  } // for(unsigned e = 0; e < Num_Elements; e++) {
+
+
+  #if defined(COLORING_MONITOR)
+    printf("Colored %u elements with %u colors:\n", Num_Elements, Num_Colors);
+    for(unsigned c = 0; c < Num_Colors; c++) {
+      printf("Color %2u: %u elements\n", c, Coloring.Color_Start[c+1] - Coloring.Color_Start[c]);
+    } // for(unsigned c = 0; c < Num_Colors; c++) {
+  #endif
+} // void Simulation::Color_Elements(const class Element* Elements, const unsigned Num_Elements, const unsigned Num_Nodes, Element_Coloring & Coloring) {
+
+
+
+void Simulation::Assemble_K(const class Element* Elements, const unsigned Num_Elements, const Element_Coloring & Coloring, const Settings & Sim_Settings) {
+  /* Function description:
+  This function moves every element's Ke into K. In SERIAL mode, we do this
+  one element at a time. In COLORED mode, we assemble the elements of each
+  color in parallel. If an element throws, we rethrow it once the current
+  color is done (see Parallel_Errors). */
+
+  if(Sim_Settings.Assembly == Assembly_Mode::SERIAL) {
+    for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+      Elements[Element_Index].Move_Ke_To_K();
+    } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+
+    return;
+  } // if(Sim_Settings.Assembly == Assembly_Mode::SERIAL) {
+
+  Parallel_Errors Errors;
+  for(unsigned c = 0; c < Coloring.Num_Colors; c++) {
+    const unsigned Start = Coloring.Color_Start[c];
+    const unsigned End = Coloring.Color_Start[c+1];
+
+    #pragma omp parallel for schedule(static)
+    for(unsigned k = Start; k < End; k++) {
+      try { Elements[Coloring.Elements[k]].Move_Ke_To_K(); }
+      catch (...) { Errors.Capture(); }
+    } // for(unsigned k = Start; k < End; k++) {
+
+    Errors.Rethrow();
+  } // for(unsigned c = 0; c < Coloring.Num_Colors; c++) {
+} // void Simulation::Assemble_K(const class Element* Elements, const unsigned Num_Elements, const Element_Coloring & Coloring, const Settings & Sim_Settings) {
+
+
+
+void Simulation::Assemble_Prescribed_Force(const class Element* Elements, const unsigned Num_Elements, const Element_Coloring & Coloring, const Settings & Sim_Settings, const double * U, double * F_Case) {
+  /* Function description:
+  This function adds each element's force due to the prescribed displacements
+  U to F_Case. It works just like Assemble_K. */
+
+  if(Sim_Settings.Assembly == Assembly_Mode::SERIAL) {
+    for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+      Elements[Element_Index].Move_Prescribed_Force_To_F(U, F_Case);
+    } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+
+    return;
+  } // if(Sim_Settings.Assembly == Assembly_Mode::SERIAL) {
+
+  Parallel_Errors Errors;
+  for(unsigned c = 0; c < Coloring.Num_Colors; c++) {
+    const unsigned Start = Coloring.Color_Start[c];
+    const unsigned End = Coloring.Color_Start[c+1];
+
+    #pragma omp parallel for schedule(static)
+    for(unsigned k = Start; k < End; k++) {
+      try { Elements[Coloring.Elements[k]].Move_Prescribed_Force_To_F(U, F_Case); }
+      catch (...) { Errors.Capture(); }
+    } // for(unsigned k = Start; k < End; k++) {
+
+    Errors.Rethrow();
+  } // for(unsigned c = 0; c < Coloring.Num_Colors; c++) {
+} // void Simulation::Assemble_Prescribed_Force(const class Element* Elements, const unsigned Num_Elements, const Element_Coloring & Coloring, const Settings & Sim_Settings, const double * U, double * F_Case) {
+
+#endif
@@ -0,0 +1,232 @@
+#if !defined(ELEMENT_OPERATOR_SOURCE)
+#define ELEMENT_OPERATOR_SOURCE
+
+/* File description:
+This file holds the implementation of the methods of the Element_Operator
+class. */
+
+#include "Element_Operator.h"
+#include "Simulation.h"
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Constructor
+
+Element_Operator::Element_Operator(const Element* Elements_In, const unsigned Num_Elements_In, const unsigned Num_Global_Eq_In, const Simulation::Element_Coloring & Coloring_In, const bool Recompute_Ke_In) :
+  Elements(Elements_In),
+  Num_Elements(Num_Elements_In),
+  Num_Global_Eq(Num_Global_Eq_In),
+  Coloring(Coloring_In),
+  Recompute_Ke(Recompute_Ke_In) {
+
+  /* Assumption 1:
+  If we're reading each element's Ke, then every Ke must have been computed.
+  Otherwise, every element's nodes and the material must be set (so that we
+  can compute Ke). */
+  for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+    const Element & El = Elements[Element_Index];
+
+    if((Recompute_Ke == false && El.Ke_Set_Up == false) ||
+       (Recompute_Ke == true && (El.Element_Set_Up == false || Element::Material_Set == false))) {
+      char Error_Message_Buffer[500];
+      sprintf(Error_Message_Buffer,
+              "Element Not Set Up Exception: Thrown by Element_Operator::Element_Operator\n"
+              "Element %u is not ready. If Recompute_Ke is false, then Populate_Ke must\n"
+              "be run before building the operator. Otherwise, the element's nodes and\n"
+              "the element material must be set.\n",
+              Element_Index);
+      throw Element_Not_Set_Up(Error_Message_Buffer);
+    } // if((Recompute_Ke == false && El.Ke_Set_Up == false) ||
+  } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+} // Element_Operator::Element_Operator(const Element* Elements_In, const unsigned Num_Elements_In, const unsigned Num_Global_Eq_In, const Simulation::Element_Coloring & Coloring_In, const bool Recompute_Ke_In) :
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Private methods
+
+const double * Element_Operator::Get_Ke(const unsigned Element_Index, double * Ke_Buffer) const {
+  if(Recompute_Ke == false) { return Elements[Element_Index].Ke; }
+
+  Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> Ke_Full;
+  Elements[Element_Index].Compute_Ke(Ke_Full);
+  Pack_Ke(Ke_Full, Ke_Buffer);
+  return Ke_Buffer;
+} // const double * Element_Operator::Get_Ke(const unsigned Element_Index, double * Ke_Buffer) const {
+
+
+
+void Element_Operator::Apply_Element(const unsigned Element_Index, const double* x, double* y, double * Ke_Buffer) const {
+  /* Function description:
+  This function adds Ke*x_Local to y, where x_Local holds the element's
+  components of x. Fixed components aren't unknowns, so their components of
+  x_Local are zero (the prescribed displacements are already accounted for in
+  F, see Element::Move_Prescribed_Force_To_F) and they don't get a component
+  of y.
+
+  In wedge elements, two local equations can map to the same global equation.
+  This works out automatically: both local equations gather the same
+  component of x and both add to the same component of y (which is exactly
+  what Move_Ke_To_K does when it assembles K).
+
+  Ke is packed (only its upper triangle is stored, one row at a time, see
+  Ke_Index), so we stream through it once: Ke(i,j) (with j > i) contributes
+  to both y_Local[i] and y_Local[j]. */
+  const Array<unsigned, 24> & Local_To_Global = Elements[Element_Index].Local_Eq_Num_To_Global_Eq_Num;
+  const double * Ke = Get_Ke(Element_Index, Ke_Buffer);
+
+  double x_Local[24];
+  double y_Local[24];
+  for(int j = 0; j < 24; j++) {
+    const unsigned J = Local_To_Global[j];
+    x_Local[j] = (J == Element::FIXED_COMPONENT) ? 0 : x[J];
+    y_Local[j] = 0;
+  } // for(int j = 0; j < 24; j++) {
+
+  for(int i = 0; i < 24; i++) {
+    const double x_i = x_Local[i];
+    double y_i = Ke[0]*x_i;
+    for(int j = i + 1; j < 24; j++) {
+      y_i += Ke[j - i]*x_Local[j];
+      y_Local[j] += Ke[j - i]*x_i;
+    } // for(int j = i + 1; j < 24; j++) {
+    y_Local[i] += y_i;
+
+    Ke += 24 - i;
+  } // for(int i = 0; i < 24; i++) {
+
+  for(int i = 0; i < 24; i++) {
+    const unsigned I = Local_To_Global[i];
+    if(I != Element::FIXED_COMPONENT) { y[I] += y_Local[i]; }
+  } // for(int i = 0; i < 24; i++) {
+} // void Element_Operator::Apply_Element(const unsigned Element_Index, const double* x, double* y, double * Ke_Buffer) const {
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Linear_Operator methods
+
+void Element_Operator::Multiply(const double* x, double* y) const {
+  /* Function description:
+  This function computes y = K*x one element at a time. If we have a
+  coloring, then the elements of each color are applied in parallel. Each
+  thread gets its own Ke_Buffer (only used if Recompute_Ke is true). If an
+  element throws, we rethrow it once the parallel region is done (see
+  Parallel_Errors). */
+  for(unsigned i = 0; i < Num_Global_Eq; i++) { y[i] = 0; }
+
+  if(Coloring.Num_Colors == 0) {
+    alignas(64) double Ke_Buffer[KE_SLOT_SIZE];
+    for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+      Apply_Element(Element_Index, x, y, Ke_Buffer);
+    } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+
+    return;
+  } // if(Coloring.Num_Colors == 0) {
+
+  Parallel_Errors Errors;
+
+  #pragma omp parallel
+  {
+    alignas(64) double Ke_Buffer[KE_SLOT_SIZE];
+
+    for(unsigned c = 0; c < Coloring.Num_Colors; c++) {
+      const unsigned Start = Coloring.Color_Start[c];
+      const unsigned End = Coloring.Color_Start[c+1];
+
+      /* The implicit barrier at the end of this loop makes sure that every
+      element of this color is done before we move on to the next color. */
+      #pragma omp for schedule(static)
+      for(unsigned k = Start; k < End; k++) {
+        try { Apply_Element(Coloring.Elements[k], x, y, Ke_Buffer); }
+        catch (...) { Errors.Capture(); }
+      } // for(unsigned k = Start; k < End; k++) {
+    } // for(unsigned c = 0; c < Coloring.Num_Colors; c++) {
+  } // #pragma omp parallel
+
+  Errors.Rethrow();
+} // void Element_Operator::Multiply(const double* x, double* y) const {
+
+
+
+void Element_Operator::Get_Diagonal(double* Diagonal) const {
+  /* Function description:
+  This function finds the diagonal of K. K(I,I) is the sum of Ke(i,j) over
+  every element and every pair of local equations i, j that map to global
+  equation I (i == j, except in wedges). This is only done once per solve, so
+  we don't bother doing it in parallel. */
+  for(unsigned i = 0; i < Num_Global_Eq; i++) { Diagonal[i] = 0; }
+
+  alignas(64) double Ke_Buffer[KE_SLOT_SIZE];
+  for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+    const Array<unsigned, 24> & Local_To_Global = Elements[Element_Index].Local_Eq_Num_To_Global_Eq_Num;
+    const double * Ke = Get_Ke(Element_Index, Ke_Buffer);
+
+    for(int i = 0; i < 24; i++) {
+      const unsigned I = Local_To_Global[i];
+      if(I == Element::FIXED_COMPONENT) { continue; }
+
+      for(int j = 0; j < 24; j++) {
+        if(Local_To_Global[j] == I) { Diagonal[I] += Ke[Ke_Index(i,j)]; }
+      } // for(int j = 0; j < 24; j++) {
+    } // for(int i = 0; i < 24; i++) {
+  } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+} // void Element_Operator::Get_Diagonal(double* Diagonal) const {
+
+
+
+void Element_Operator::Get_Diagonal_Blocks(const std::vector<unsigned> & Block_Start, double* Blocks) const {
+  /* Function description:
+  This function finds the diagonal blocks of K. This works just like
+  Get_Diagonal, except that we keep every Ke(i,j) whose global equations (I
+  and J) are in the same block. */
+  const unsigned Num_Blocks = (unsigned)Block_Start.size() - 1;
+  for(unsigned k = 0; k < 9*Num_Blocks; k++) { Blocks[k] = 0; }
+
+  // Find the block that each equation belongs to.
+  std::vector<unsigned> Eq_Block(Num_Global_Eq);
+  for(unsigned Block = 0; Block < Num_Blocks; Block++) {
+    /* Assumption 1:
+    This function assumes that each block fits in its 9 doubles (at most 3
+    rows) and that every block is inside K. */
+    if(Block_Start[Block + 1] < Block_Start[Block] || Block_Start[Block + 1] - Block_Start[Block] > 3 ||
+       Block_Start[Block + 1] > Num_Global_Eq) {
+      char Error_Message_Buffer[500];
+      snprintf(Error_Message_Buffer, sizeof(Error_Message_Buffer),
+               "Matrix Dimension Mismatch Exception: Thrown by Element_Operator::Get_Diagonal_Blocks\n"
+               "Block %u starts at row %u and ends before row %u. However, each block must\n"
+               "have at most 3 rows, and K only has %u rows.\n",
+               Block, Block_Start[Block], Block_Start[Block + 1], Num_Global_Eq);
+      throw Matrix_Dimension_Mismatch(Error_Message_Buffer);
+    } // if(Block_Start[Block + 1] < Block_Start[Block] || Block_Start[Block + 1] - Block_Start[Block] > 3 ||
+
+    for(unsigned I = Block_Start[Block]; I < Block_Start[Block + 1]; I++) { Eq_Block[I] = Block; }
+  } // for(unsigned Block = 0; Block < Num_Blocks; Block++) {
+
+  alignas(64) double Ke_Buffer[KE_SLOT_SIZE];
+  for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+    const Array<unsigned, 24> & Local_To_Global = Elements[Element_Index].Local_Eq_Num_To_Global_Eq_Num;
+    const double * Ke = Get_Ke(Element_Index, Ke_Buffer);
+
+    for(int i = 0; i < 24; i++) {
+      const unsigned I = Local_To_Global[i];
+      if(I == Element::FIXED_COMPONENT) { continue; }
+      const unsigned Block = Eq_Block[I];
+      const unsigned Start = Block_Start[Block];
+
+      for(int j = 0; j < 24; j++) {
+        const unsigned J = Local_To_Global[j];
+        if(J == Element::FIXED_COMPONENT || Eq_Block[J] != Block) { continue; }
+
+        Blocks[9*Block + 3*(I - Start) + (J - Start)] += Ke[Ke_Index(i,j)];
+      } // for(int j = 0; j < 24; j++) {
+    } // for(int i = 0; i < 24; i++) {
+  } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+} // void Element_Operator::Get_Diagonal_Blocks(const std::vector<unsigned> & Block_Start, double* Blocks) const {
+
+#endif
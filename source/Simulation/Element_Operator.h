@@ -0,0 +1,79 @@
+#if !defined(ELEMENT_OPERATOR_HEADER)
+#define ELEMENT_OPERATOR_HEADER
+
+#include <vector>
+#include "Errors.h"
+#include "Fixed_Matrix.h"
+#include "Element/Element.h"
+#include "Solver/Linear_Operator.h"
+
+namespace Simulation { struct Element_Coloring; }
+
+/* Matrix-free (element by element) operator class.
+K is the sum of the element stiffness matrices, so
+    K*x = sum over elements of (Ke * (the element's components of x)).
+This class computes K*x this way: for each element, it gathers the element's
+24 components of x (using Local_Eq_Num_To_Global_Eq_Num), applies Ke, and then
+adds the result to y. K is never assembled, so we don't need the memory to
+store it. This makes it possible to solve (with PCG) problems whose K wouldn't
+fit in memory.
+
+If Recompute_Ke is true, then each element's Ke is recomputed (see
+Element::Compute_Ke) every time that it's needed instead of being read from
+the element. The elements then don't need to store their Ke's (see
+Process_Element_List), which trades (a lot of) FLOPs for the memory (and
+memory bandwidth) of every Ke.
+
+If a coloring is passed (with at least one color), then the elements of each
+color are applied in parallel (elements of the same color never write to the
+same component of y, see Simulation::Color_Elements). Otherwise, the elements
+are applied one at a time.
+
+The elements (and coloring) must stay alive as long as this operator is
+used. */
+class Element_Operator : public Linear_Operator {
+  private:
+    const Element* Elements;                     // The elements whose Ke's make up K
+    const unsigned Num_Elements;
+    const unsigned Num_Global_Eq;                // Number of rows of K
+    const Simulation::Element_Coloring & Coloring;
+    const bool Recompute_Ke;                     // If true, Ke is recomputed whenever we need it
+
+    /* Get an element's (packed, see Ke_Index) Ke. If Recompute_Ke is true,
+    then Ke is computed and packed into Ke_Buffer (which must hold
+    KE_PACKED_SIZE doubles), and Ke_Buffer is returned. */
+    const double * Get_Ke(const unsigned Element_Index,                        // Intent: Read
+                          double * Ke_Buffer) const;                           // Intent: Write
+
+    /* Add the element's contribution to y = K*x. */
+    void Apply_Element(const unsigned Element_Index,                           // Intent: Read
+                       const double* x,                                        // Intent: Read
+                       double* y,                                              // Intent: Write
+                       double * Ke_Buffer) const;                              // Intent: Write
+
+  public:
+    //////////////////////////////////////////////////////////////////////////////
+    // Constructor
+
+    Element_Operator(const Element* Elements_In,                               // Intent: Read
+                     const unsigned Num_Elements_In,                           // Intent: Read
+                     const unsigned Num_Global_Eq_In,                          // Intent: Read
+                     const Simulation::Element_Coloring & Coloring_In,         // Intent: Read
+                     const bool Recompute_Ke_In = false);                      // Intent: Read
+
+
+    //////////////////////////////////////////////////////////////////////////////
+    // Linear_Operator methods (see Linear_Operator.h)
+
+    unsigned Get_Num_Rows(void) const override { return Num_Global_Eq; }
+
+    void Multiply(const double* x,                                             // Intent: Read
+                  double* y) const override;                                   // Intent: Write
+
+    void Get_Diagonal(double* Diagonal) const override;                        // Intent: Write
+
+    void Get_Diagonal_Blocks(const std::vector<unsigned> & Block_Start,        // Intent: Read
+                             double* Blocks) const override;                   // Intent: Write
+}; // class Element_Operator : public Linear_Operator {
+
+#endif
@@ -0,0 +1,424 @@
+#if !defined(SIMULATION_RENUMBER_SOURCE)
+#define SIMULATION_RENUMBER_SOURCE
+
+/* File description:
+This file holds the functions that renumber the global equations.
+SetUp_ID_Num_Global_Eq numbers the equations in the order that the nodes
+appear in the inp file. Two nodes that share an element can be very far apart
+in that order, which spreads each row of K out (a large bandwidth). This hurts
+the cache behavior of assembly and of K*x, and (if the solver doesn't reorder
+K itself) increases the fill of a direct factorization.
+
+We renumber the nodes, not the equations. Every equation of a node stays next
+to the node's other equations, so the per node blocks used by the block Jacobi
+and AMG preconditioners are unchanged. Two nodes are neighbors (in the node
+graph) if they share an element and both have a free component. Nodes whose
+components are all fixed don't have any equations, so they're left out. */
+
+#include "Simulation.h"
+#include <algorithm>
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Node graph
+
+namespace {
+  /* The node graph, in compressed form: the neighbors of node n are
+      Adj[Adj_Start[n]], ... , Adj[Adj_Start[n+1] - 1].
+  Free[n] is true if node n has a free component (only those nodes are in the
+  graph). Part and Seen are scratch space for Level_Structure. */
+  struct Node_Graph {
+    std::vector<unsigned> Adj_Start;
+    std::vector<unsigned> Adj;
+    std::vector<bool> Free;
+
+    std::vector<int> Part;
+    std::vector<unsigned> Seen;
+    unsigned Stamp = 0;
+
+    unsigned Degree(const unsigned n) const { return Adj_Start[n+1] - Adj_Start[n]; }
+  }; // struct Node_Graph {
+} // namespace {
+
+
+
+static void Build_Node_Graph(const class Matrix<int> & ID, const unsigned Num_Nodes, const std::vector<Array<unsigned, 8>> & Element_Node_Lists, Node_Graph & Graph) {
+  /* Function description:
+  This function builds the node graph. We first list every (node, neighbor)
+  pair from every element (so a pair shows up once for each element that
+  the two nodes share), and then sort and remove the duplicates from each
+  node's list. Wedges list some nodes twice; a node is never its own
+  neighbor. */
+  Graph.Free.assign(Num_Nodes, false);
+  for(unsigned n = 0; n < Num_Nodes; n++) {
+    for(unsigned Comp = 0; Comp < 3; Comp++) {
+      if(ID(n, Comp) != -1) { Graph.Free[n] = true; }
+    } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+  } // for(unsigned n = 0; n < Num_Nodes; n++) {
+
+  // Count the pairs.
+  std::vector<unsigned> Pair_Start(Num_Nodes + 1, 0);
+  for(const Array<unsigned, 8> & Node_List : Element_Node_Lists) {
+    for(unsigned a = 0; a < 8; a++) {
+      if(Graph.Free[Node_List[a]] == false) { continue; }
+      for(unsigned b = 0; b < 8; b++) {
+        if(Node_List[b] != Node_List[a] && Graph.Free[Node_List[b]] == true) { Pair_Start[Node_List[a] + 1]++; }
+      } // for(unsigned b = 0; b < 8; b++) {
+    } // for(unsigned a = 0; a < 8; a++) {
+  } // for(const Array<unsigned, 8> & Node_List : Element_Node_Lists) {
+
+  for(unsigned n = 0; n < Num_Nodes; n++) { Pair_Start[n+1] += Pair_Start[n]; }
+
+  // Now, list them.
+  std::vector<unsigned> Pairs(Pair_Start[Num_Nodes]);
+  std::vector<unsigned> Next_Slot(Pair_Start.begin(), Pair_Start.end() - 1);
+  for(const Array<unsigned, 8> & Node_List : Element_Node_Lists) {
+    for(unsigned a = 0; a < 8; a++) {
+      if(Graph.Free[Node_List[a]] == false) { continue; }
+      for(unsigned b = 0; b < 8; b++) {
+        if(Node_List[b] != Node_List[a] && Graph.Free[Node_List[b]] == true) {
+          Pairs[Next_Slot[Node_List[a]]] = Node_List[b];
+          Next_Slot[Node_List[a]]++;
+        } // if(Node_List[b] != Node_List[a] && Graph.Free[Node_List[b]] == true) {
+      } // for(unsigned b = 0; b < 8; b++) {
+    } // for(unsigned a = 0; a < 8; a++) {
+  } // for(const Array<unsigned, 8> & Node_List : Element_Node_Lists) {
+
+  // Finally, sort each node's list and remove the duplicates.
+  Graph.Adj_Start.assign(Num_Nodes + 1, 0);
+  Graph.Adj.clear();
+  Graph.Adj.reserve(Pairs.size()/2);
+  for(unsigned n = 0; n < Num_Nodes; n++) {
+    std::sort(Pairs.begin() + Pair_Start[n], Pairs.begin() + Pair_Start[n+1]);
+    for(unsigned k = Pair_Start[n]; k < Pair_Start[n+1]; k++) {
+      if(k == Pair_Start[n] || Pairs[k] != Pairs[k-1]) { Graph.Adj.push_back(Pairs[k]); }
+    } // for(unsigned k = Pair_Start[n]; k < Pair_Start[n+1]; k++) {
+    Graph.Adj_Start[n+1] = (unsigned)Graph.Adj.size();
+  } // for(unsigned n = 0; n < Num_Nodes; n++) {
+
+  Graph.Part.assign(Num_Nodes, 0);
+  Graph.Seen.assign(Num_Nodes, 0);
+  Graph.Stamp = 0;
+} // static void Build_Node_Graph(const class Matrix<int> & ID, const unsigned Num_Nodes, const std::vector<Array<unsigned, 8>> & Element_Node_Lists, Node_Graph & Graph) {
+
+
+
+static void Level_Structure(Node_Graph & Graph, const unsigned Root, std::vector<unsigned> & Order, std::vector<unsigned> & Level_Start) {
+  /* Function description:
+  This function does a breadth first search from Root. It only visits nodes
+  in Root's part (Graph.Part[n] == Graph.Part[Root]). When it's done, Order
+  holds the visited nodes, level by level (level l is Order[Level_Start[l]],
+  ... , Order[Level_Start[l+1] - 1]). */
+  const int Label = Graph.Part[Root];
+  Graph.Stamp++;
+
+  Order.clear();
+  Level_Start.clear();
+  Order.push_back(Root);
+  Graph.Seen[Root] = Graph.Stamp;
+
+  unsigned Level_Begin = 0;
+  while(Level_Begin < Order.size()) {
+    const unsigned Level_End = (unsigned)Order.size();
+    Level_Start.push_back(Level_Begin);
+
+    for(unsigned k = Level_Begin; k < Level_End; k++) {
+      const unsigned n = Order[k];
+      for(unsigned j = Graph.Adj_Start[n]; j < Graph.Adj_Start[n+1]; j++) {
+        const unsigned m = Graph.Adj[j];
+        if(Graph.Seen[m] != Graph.Stamp && Graph.Part[m] == Label) {
+          Graph.Seen[m] = Graph.Stamp;
+          Order.push_back(m);
+        } // if(Graph.Seen[m] != Graph.Stamp && Graph.Part[m] == Label) {
+      } // for(unsigned j = Graph.Adj_Start[n]; j < Graph.Adj_Start[n+1]; j++) {
+    } // for(unsigned k = Level_Begin; k < Level_End; k++) {
+
+    Level_Begin = Level_End;
+  } // while(Level_Begin < Order.size()) {
+  Level_Start.push_back((unsigned)Order.size());
+} // static void Level_Structure(Node_Graph & Graph, const unsigned Root, std::vector<unsigned> & Order, std::vector<unsigned> & Level_Start) {
+
+
+
+static unsigned Pseudo_Peripheral_Node(Node_Graph & Graph, const unsigned Start, std::vector<unsigned> & Order, std::vector<unsigned> & Level_Start) {
+  /* Function description:
+  This function finds a node that's (nearly) as far as possible from the rest
+  of Start's part, using the George-Liu algorithm: starting from Start, we
+  keep moving to the lowest degree node in the last level of the current
+  node's level structure as long as that increases the number of levels.
+  Order and Level_Start hold the returned node's level structure. */
+  unsigned Root = Start;
+  Level_Structure(Graph, Root, Order, Level_Start);
+
+  while(true) {
+    const unsigned Num_Levels = (unsigned)Level_Start.size() - 1;
+
+    unsigned Candidate = Order[Level_Start[Num_Levels - 1]];
+    for(unsigned k = Level_Start[Num_Levels - 1]; k < Level_Start[Num_Levels]; k++) {
+      if(Graph.Degree(Order[k]) < Graph.Degree(Candidate)) { Candidate = Order[k]; }
+    } // for(unsigned k = Level_Start[Num_Levels - 1]; k < Level_Start[Num_Levels]; k++) {
+
+    std::vector<unsigned> Candidate_Order, Candidate_Level_Start;
+    Level_Structure(Graph, Candidate, Candidate_Order, Candidate_Level_Start);
+    if(Candidate_Level_Start.size() <= Level_Start.size()) { break; }
+
+    Root = Candidate;
+    Order.swap(Candidate_Order);
+    Level_Start.swap(Candidate_Level_Start);
+  } // while(true) {
+
+  return Root;
+} // static unsigned Pseudo_Peripheral_Node(Node_Graph & Graph, const unsigned Start, std::vector<unsigned> & Order, std::vector<unsigned> & Level_Start) {
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Orderings
+
+static void RCM_Order(Node_Graph & Graph, std::vector<unsigned> & Node_Order) {
+  /* Function description:
+  This function finds the reverse Cuthill-McKee ordering of the free nodes.
+  For each connected component, we start at a pseudo-peripheral node and do
+  a breadth first search, visiting each node's (unvisited) neighbors in order
+  of increasing degree. Reversing the result gives the same bandwidth, but a
+  smaller profile. */
+  const unsigned Num_Nodes = (unsigned)Graph.Free.size();
+  std::vector<bool> Visited(Num_Nodes, false);
+  std::vector<unsigned> Order, Level_Start, Neighbors;
+  Node_Order.clear();
+
+  for(unsigned Start = 0; Start < Num_Nodes; Start++) {
+    if(Graph.Free[Start] == false || Visited[Start] == true) { continue; }
+
+    const unsigned Root = Pseudo_Peripheral_Node(Graph, Start, Order, Level_Start);
+
+    unsigned Head = (unsigned)Node_Order.size();
+    Node_Order.push_back(Root);
+    Visited[Root] = true;
+
+    while(Head < Node_Order.size()) {
+      const unsigned n = Node_Order[Head];
+      Head++;
+
+      Neighbors.clear();
+      for(unsigned j = Graph.Adj_Start[n]; j < Graph.Adj_Start[n+1]; j++) {
+        if(Visited[Graph.Adj[j]] == false) {
+          Visited[Graph.Adj[j]] = true;
+          Neighbors.push_back(Graph.Adj[j]);
+        } // if(Visited[Graph.Adj[j]] == false) {
+      } // for(unsigned j = Graph.Adj_Start[n]; j < Graph.Adj_Start[n+1]; j++) {
+
+      std::stable_sort(Neighbors.begin(), Neighbors.end(),
+                       [&Graph](const unsigned a, const unsigned b) { return Graph.Degree(a) < Graph.Degree(b); });
+      Node_Order.insert(Node_Order.end(), Neighbors.begin(), Neighbors.end());
+    } // while(Head < Node_Order.size()) {
+  } // for(unsigned Start = 0; Start < Num_Nodes; Start++) {
+
+  std::reverse(Node_Order.begin(), Node_Order.end());
+} // static void RCM_Order(Node_Graph & Graph, std::vector<unsigned> & Node_Order) {
+
+
+
+static void Dissect(Node_Graph & Graph, std::vector<unsigned> & Nodes, int & Num_Labels, std::vector<unsigned> & Node_Order) {
+  /* Function description:
+  This function orders Nodes (every one of which is in the same part) by
+  nested dissection, appending them to Node_Order. We find a level structure
+  from a pseudo-peripheral node and use the level that splits the nodes in
+  half as a separator. The nodes before and after the separator don't share
+  an element, so eliminating them first (each half ordered recursively) keeps
+  their fill from spreading to the other half. The separator is numbered
+  last.
+
+  If the level structure doesn't reach every node (Nodes isn't connected),
+  then we order the nodes that it reached and the rest separately. Small
+  parts (and parts with too few levels to separate) are just numbered in
+  breadth first order. */
+  const unsigned LEAF_SIZE = 64;
+  if(Nodes.size() == 0) { return; }
+
+  std::vector<unsigned> Order, Level_Start;
+  Pseudo_Peripheral_Node(Graph, Nodes[0], Order, Level_Start);
+
+  // If we didn't reach every node, split off the ones that we did.
+  if(Order.size() < Nodes.size()) {
+    std::vector<unsigned> Rest;
+    for(unsigned n : Nodes) {
+      if(Graph.Seen[n] != Graph.Stamp) { Rest.push_back(n); }
+    } // for(unsigned n : Nodes) {
+    Nodes.clear();
+
+    const int Rest_Label = Num_Labels++;
+    for(unsigned n : Rest) { Graph.Part[n] = Rest_Label; }
+
+    Dissect(Graph, Order, Num_Labels, Node_Order);
+    Dissect(Graph, Rest, Num_Labels, Node_Order);
+    return;
+  } // if(Order.size() < Nodes.size()) {
+
+  const unsigned Num_Levels = (unsigned)Level_Start.size() - 1;
+  if(Nodes.size() <= LEAF_SIZE || Num_Levels < 3) {
+    Node_Order.insert(Node_Order.end(), Order.begin(), Order.end());
+    return;
+  } // if(Nodes.size() <= LEAF_SIZE || Num_Levels < 3) {
+
+  /* Pick the first level that reaches half of the nodes (but never the first
+  or last level, so that both halves have some nodes). */
+  unsigned Separator = 1;
+  while(Separator < Num_Levels - 2 && Level_Start[Separator + 1] < Order.size()/2) { Separator++; }
+
+  std::vector<unsigned> Before(Order.begin(), Order.begin() + Level_Start[Separator]);
+  std::vector<unsigned> After(Order.begin() + Level_Start[Separator + 1], Order.end());
+  const std::vector<unsigned> Separator_Nodes(Order.begin() + Level_Start[Separator], Order.begin() + Level_Start[Separator + 1]);
+  Nodes.clear();
+
+  const int Before_Label = Num_Labels++;
+  const int After_Label = Num_Labels++;
+  const int Separator_Label = Num_Labels++;
+  for(unsigned n : Before) { Graph.Part[n] = Before_Label; }
+  for(unsigned n : After) { Graph.Part[n] = After_Label; }
+  for(unsigned n : Separator_Nodes) { Graph.Part[n] = Separator_Label; }
+
+  Dissect(Graph, Before, Num_Labels, Node_Order);
+  Dissect(Graph, After, Num_Labels, Node_Order);
+  Node_Order.insert(Node_Order.end(), Separator_Nodes.begin(), Separator_Nodes.end());
+} // static void Dissect(Node_Graph & Graph, std::vector<unsigned> & Nodes, int & Num_Labels, std::vector<unsigned> & Node_Order) {
+
+
+
+static void Nested_Dissection_Order(Node_Graph & Graph, std::vector<unsigned> & Node_Order) {
+  /* Function description:
+  This function orders the free nodes by nested dissection (see Dissect). */
+  const unsigned Num_Nodes = (unsigned)Graph.Free.size();
+  std::vector<unsigned> Nodes;
+  for(unsigned n = 0; n < Num_Nodes; n++) {
+    if(Graph.Free[n] == true) { Nodes.push_back(n); }
+  } // for(unsigned n = 0; n < Num_Nodes; n++) {
+
+  int Num_Labels = 1;
+  Graph.Part.assign(Num_Nodes, 0);
+  Node_Order.clear();
+  Dissect(Graph, Nodes, Num_Labels, Node_Order);
+} // static void Nested_Dissection_Order(Node_Graph & Graph, std::vector<unsigned> & Node_Order) {
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Bandwidth and profile
+
+static void Graph_Bandwidth_Profile(const Node_Graph & Graph, const class Matrix<int> & ID, unsigned & Bandwidth, unsigned long long & Profile) {
+  /* Function description:
+  This function finds K's bandwidth and profile. Row I of K has non-zeros in
+  the columns of every equation of I's node and of its neighbors. Thus, the
+  first column of each of node n's rows is the smallest equation of n and its
+  neighbors. */
+  const unsigned Num_Nodes = (unsigned)Graph.Free.size();
+
+  // Find the smallest and largest equation of each node.
+  std::vector<unsigned> First_Eq(Num_Nodes, (unsigned)-1), Last_Eq(Num_Nodes, 0);
+  for(unsigned n = 0; n < Num_Nodes; n++) {
+    for(unsigned Comp = 0; Comp < 3; Comp++) {
+      const int I = ID(n, Comp);
+      if(I == -1) { continue; }
+      if((unsigned)I < First_Eq[n]) { First_Eq[n] = (unsigned)I; }
+      if((unsigned)I > Last_Eq[n]) { Last_Eq[n] = (unsigned)I; }
+    } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+  } // for(unsigned n = 0; n < Num_Nodes; n++) {
+
+  Bandwidth = 0;
+  Profile = 0;
+  for(unsigned n = 0; n < Num_Nodes; n++) {
+    if(Graph.Free[n] == false) { continue; }
+
+    unsigned Row_First = First_Eq[n];
+    for(unsigned j = Graph.Adj_Start[n]; j < Graph.Adj_Start[n+1]; j++) {
+      if(First_Eq[Graph.Adj[j]] < Row_First) { Row_First = First_Eq[Graph.Adj[j]]; }
+    } // for(unsigned j = Graph.Adj_Start[n]; j < Graph.Adj_Start[n+1]; j++) {
+
+    if(Last_Eq[n] - Row_First > Bandwidth) { Bandwidth = Last_Eq[n] - Row_First; }
+    for(unsigned Comp = 0; Comp < 3; Comp++) {
+      const int I = ID(n, Comp);
+      if(I != -1) { Profile += (unsigned)I - Row_First; }
+    } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+  } // for(unsigned n = 0; n < Num_Nodes; n++) {
+} // static void Graph_Bandwidth_Profile(const Node_Graph & Graph, const class Matrix<int> & ID, unsigned & Bandwidth, unsigned long long & Profile) {
+
+
+
+void Simulation::Bandwidth_Profile(const class Matrix<int> & ID, const unsigned Num_Nodes, const std::vector<Array<unsigned, 8>> & Element_Node_Lists, unsigned & Bandwidth, unsigned long long & Profile) {
+  Node_Graph Graph;
+  Build_Node_Graph(ID, Num_Nodes, Element_Node_Lists, Graph);
+  Graph_Bandwidth_Profile(Graph, ID, Bandwidth, Profile);
+} // void Simulation::Bandwidth_Profile(const class Matrix<int> & ID, const unsigned Num_Nodes, const std::vector<Array<unsigned, 8>> & Element_Node_Lists, unsigned & Bandwidth, unsigned long long & Profile) {
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Renumber
+
+void Simulation::Renumber_Equations(class Matrix<int> & ID, const unsigned Num_Nodes, const std::vector<Array<unsigned, 8>> & Element_Node_Lists, const Renumbering Method) {
+  /* Function description:
+  This function orders the free nodes (using Method) and then renumbers the
+  equations: the first node in the new order gets the first equations, and
+  so on. Each node's free components still get consecutive equations (in
+  component order), and the number of equations doesn't change.
+
+  RCM is only a heuristic, and a mesh generator's numbering is often already
+  banded. Thus, if the RCM numbering has a larger bandwidth or profile than
+  the original one, we keep the original numbering. (Nested dissection is
+  meant to reduce fill, not bandwidth, so it's always used.) */
+  if(Method == Renumbering::NONE) { return; }
+
+  Node_Graph Graph;
+  Build_Node_Graph(ID, Num_Nodes, Element_Node_Lists, Graph);
+
+  unsigned Old_Bandwidth;
+  unsigned long long Old_Profile;
+  Graph_Bandwidth_Profile(Graph, ID, Old_Bandwidth, Old_Profile);
+
+  std::vector<int> Old_ID(3*Num_Nodes);
+  for(unsigned n = 0; n < Num_Nodes; n++) {
+    for(unsigned Comp = 0; Comp < 3; Comp++) { Old_ID[3*n + Comp] = ID(n, Comp); }
+  } // for(unsigned n = 0; n < Num_Nodes; n++) {
+
+  std::vector<unsigned> Node_Order;
+  if(Method == Renumbering::RCM) { RCM_Order(Graph, Node_Order); }
+  else { Nested_Dissection_Order(Graph, Node_Order); }
+
+  unsigned Num_Global_Eq = 0;
+  for(unsigned n : Node_Order) {
+    for(unsigned Comp = 0; Comp < 3; Comp++) {
+      if(ID(n, Comp) != -1) {
+        ID(n, Comp) = (int)Num_Global_Eq;
+        Num_Global_Eq++;
+      } // if(ID(n, Comp) != -1) {
+    } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+  } // for(unsigned n : Node_Order) {
+
+  unsigned New_Bandwidth;
+  unsigned long long New_Profile;
+  Graph_Bandwidth_Profile(Graph, ID, New_Bandwidth, New_Profile);
+
+  /* If RCM made things worse, go back to the original numbering. */
+  const bool Keep_Old = (Method == Renumbering::RCM && (New_Bandwidth > Old_Bandwidth || New_Profile > Old_Profile));
+  if(Keep_Old == true) {
+    for(unsigned n = 0; n < Num_Nodes; n++) {
+      for(unsigned Comp = 0; Comp < 3; Comp++) { ID(n, Comp) = Old_ID[3*n + Comp]; }
+    } // for(unsigned n = 0; n < Num_Nodes; n++) {
+  } // if(Keep_Old == true) {
+
+  #if defined(INPUT_MONITOR)
+    printf("Renumbered equations (%s): bandwidth %u -> %u, profile %llu -> %llu%s\n",
+           (Method == Renumbering::RCM) ? "RCM" : "nested dissection",
+           Old_Bandwidth, New_Bandwidth, Old_Profile, New_Profile,
+           (Keep_Old == true) ? " (not an improvement, kept the original numbering)" : "");
+  #endif
+} // void Simulation::Renumber_Equations(class Matrix<int> & ID, const unsigned Num_Nodes, const std::vector<Array<unsigned, 8>> & Element_Node_Lists, const Renumbering Method) {
+
+#endif
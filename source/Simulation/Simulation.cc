@@ -2,39 +2,86 @@
 #define SIMULATION_SOURCE
 
 #include "Simulation.h"
+#include <math.h>
+#include <omp.h>
+#include <algorithm>
+#include <memory>
 
-void Simulation::From_File(const std::string & File_Name) {
-  /* First, read in the inp file. */
-  std::list<Array<double, 3>> Node_Positions;
-  std::list<Array<unsigned, 8>> Element_Node_Lists;
-  std::list<IO::Read::inp_boundary_data> Boundary_List;
-  std::list<unsigned> Node_Set_List;
+void Simulation::From_File(const std::string & File_Name, const Settings & Sim_Settings) {
+  /* Solve the problem exactly as it is set up in the inp file. This is just a
+  single load case that doesn't change anything. */
+  std::vector<Load_Case> Load_Cases(1);
+  Load_Cases[0].Name = "Out";
 
-  IO::Read::inp(File_Name, Node_Positions, Element_Node_Lists, Boundary_List);
-  IO::Read::node_set(File_Name, Node_Set_List);
+  From_File(File_Name, Load_Cases, Sim_Settings);
+} // void Simulation::From_File(const std::string & File_Name, const Settings & Sim_Settings) {
+
+
+
+void Simulation::From_File(const std::string & File_Name, const std::vector<Load_Case> & Load_Cases, const Settings & Sim_Settings) {
+  /* Function description:
+  This function reads in the mesh (and BC's) from the inp file, assembles K,
+  and then solves for the displacements of each load case. Every load case has
+  the same K, so K is only factored once. The load cases are assembled into an
+  n by Num_Cases block of right hand sides, F, and solved all at once.
+
+  Every array that this function allocates is owned by a std::vector or a
+  std::unique_ptr, so it's freed however we leave (including when one of the
+  catch blocks below prints an exception and rethrows it). */
+
+  const unsigned Num_Cases = (unsigned)Load_Cases.size();
+  if(Num_Cases == 0) {
+    printf("From_File: No load cases. Nothing to solve.\n");
+    return;
+  } // if(Num_Cases == 0) {
+
+  /* First, read in the inp file (nodes, elements, boundary data, and node
+  sets, all in one pass), or load its mesh from the cache if we can. A cache
+  that can't be written just means the next run reads the inp file again. */
+  IO::Read::inp_mesh Mesh;
+  if(Sim_Settings.Cache_Mesh == false || IO::Read::mesh_cache(File_Name, Mesh) == false) {
+    IO::Read::inp(File_Name, Mesh);
+
+    if(Sim_Settings.Cache_Mesh == true) {
+      try { IO::Write::mesh_cache(File_Name, Mesh); }
+      catch (const IO_Exception & Er) { printf("%s\n", Er.what()); }
+    } // if(Sim_Settings.Cache_Mesh == true) {
+  } // if(Sim_Settings.Cache_Mesh == false || IO::Read::mesh_cache(File_Name, Mesh) == false) {
+  const std::vector<Array<unsigned, 8>> & Element_Node_Lists = Mesh.Element_Node_Lists;
 
 
   #ifdef INPUT_MONITOR
-    printf("Read in %u nodes\n",    (unsigned)Node_Positions.size());
-    printf("Read in %u elements\n", (unsigned)Element_Node_Lists.size());
+    printf("Read in %u nodes\n",     (unsigned)Mesh.Node_Positions.size());
+    printf("Read in %u elements\n",  (unsigned)Element_Node_Lists.size());
+    printf("Read in %u node sets\n", (unsigned)Mesh.Node_Sets.size());
   #endif
 
   //////////////////////////////////////////////////////////////////////////////
   /* Next, let's process the Node_Positions and Boundary lists into a Nodes
   array */
-  const unsigned Num_Nodes = (unsigned)Node_Positions.size();
-  class Node* Nodes = Process_Node_Lists(Node_Positions, Boundary_List, Num_Nodes);
+  const unsigned Num_Nodes = (unsigned)Mesh.Node_Positions.size();
+  const std::unique_ptr<Node[]> Node_Array{Process_Node_Lists(Mesh.Node_Positions, Mesh.Boundary_List, Num_Nodes)};
+  class Node* Nodes = Node_Array.get();
 
 
   //////////////////////////////////////////////////////////////////////////////
-  /* Next, apply BC's to the node set (if present) */
+  /* Next, apply BC's to the node sets. If the file gives the node sets BC's
+  (*Boundary lines that name a node set), we use those. Otherwise, we fix
+  every node in every node set (files without node set BC's rely on this). */
 
-  class IO::Read::nset_BC node_set_BCs;
-  node_set_BCs.Set_x_BC(0);
-  node_set_BCs.Set_y_BC(0);
-  node_set_BCs.Set_z_BC(0);
+  if(Mesh.Set_Boundary_List.size() != 0) {
+    Set_Set_Boundary_BCs(Nodes, Num_Nodes, Mesh);
+  } // if(Mesh.Set_Boundary_List.size() != 0) {
+  else {
+    class IO::Read::nset_BC node_set_BCs;
+    node_set_BCs.Set_x_BC(0);
+    node_set_BCs.Set_y_BC(0);
+    node_set_BCs.Set_z_BC(0);
 
-  Set_nset_BCs(Nodes, Node_Set_List, node_set_BCs);
+    for(unsigned i = 0; i < Mesh.Node_Sets.size(); i++) {
+      Set_nset_BCs(Nodes, Mesh.Node_Sets[i].Nodes, node_set_BCs);
+    } // for(unsigned i = 0; i < Mesh.Node_Sets.size(); i++) {
+  } // else {
 
 
   //////////////////////////////////////////////////////////////////////////////
@@ -42,16 +89,19 @@ void Simulation::From_File(const std::string & File_Name) {
   class Matrix<int> ID{Num_Nodes, 3, Memory::ROW_MAJOR};
   unsigned Num_Global_Eq = SetUp_ID_Num_Global_Eq(ID, Nodes, Num_Nodes);
 
+  /* Renumber the equations (see Renumber.cc). This has to happen before the
+  elements are set up (each element reads its equation numbers from ID). */
+  Renumber_Equations(ID, Num_Nodes, Element_Node_Lists, Sim_Settings.Equation_Order);
 
-  //////////////////////////////////////////////////////////////////////////////
-  /* With this information, we can now allocate K F, and x */
-  class Matrix<double> K{Num_Global_Eq, Num_Global_Eq, Memory::COLUMN_MAJOR};
-  double* F = new double[Num_Global_Eq];
-  double* x = new double[Num_Global_Eq];
 
-  // Zero initialize K and F
-  K.Fill(0);
-  for(unsigned i = 0; i < Num_Global_Eq; i++) { F[i] = 0; }
+  //////////////////////////////////////////////////////////////////////////////
+  /* With this information, we can now allocate K F, and x.
+  K is sparse. Its sparsity pattern depends on the element connectivity, so we
+  can't set it up until the elements have been set up (see below).
+  F and x hold one column (of length Num_Global_Eq) per load case. */
+  class Sparse_Matrix K{};
+  std::vector<double> F((size_t)Num_Global_Eq*Num_Cases, 0);
+  std::vector<double> x((size_t)Num_Global_Eq*Num_Cases);
 
 
   //////////////////////////////////////////////////////////////////////////////
@@ -59,7 +109,7 @@ void Simulation::From_File(const std::string & File_Name) {
   members */
 
   try {
-    Set_Element_Static_Members(&ID, &K, F, Nodes);
+    Set_Element_Static_Members(&ID, &K, F.data(), Nodes);
     Set_Element_Material(Simulation::E, Simulation::v);
   } // try {
   catch (const Element_Exception & Er) {
@@ -70,60 +120,243 @@ void Simulation::From_File(const std::string & File_Name) {
 
   //////////////////////////////////////////////////////////////////////////////
   /* Allocate the elements Array.
-  Note: This will populate Ke and Fe for each element */
+  Note: This will populate Ke for each element (unless Ke is recomputed
+  whenever it's needed, see Settings). Each load case's force due to its
+  prescribed displacements is found from Ke later (see
+  Assemble_Prescribed_Force), so we don't need each element's Fe. */
 
   const unsigned Num_Elements = (unsigned)Element_Node_Lists.size();
-  class Element* Elements = Process_Element_List(Element_Node_Lists, Num_Elements);
+  const bool Store_Ke = (Sim_Settings.Matrix_Free == false || Sim_Settings.Recompute_Ke == false);
+  class Ke_Cache Cache{Sim_Settings.Cache_Ke};
+  const std::unique_ptr<Element[]> Element_Array{Process_Element_List(Element_Node_Lists, Num_Elements, &Cache, Store_Ke)};
+  class Element* Elements = Element_Array.get();
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* If we're assembling in parallel (or applying K matrix-free in parallel),
+  we need to color the elements (see Assembly.cc). */
+
+  class Element_Coloring Coloring;
+  if(Sim_Settings.Assembly == Assembly_Mode::COLORED) {
+    Color_Elements(Elements, Num_Elements, Num_Nodes, Coloring);
+  } // if(Sim_Settings.Assembly == Assembly_Mode::COLORED) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Now that the elements have been set up, we can set up K's sparsity
+  pattern (K is zero once its pattern has been set) and then find K. In
+  matrix-free mode, we skip this (K is never stored). */
+
+  if(Sim_Settings.Matrix_Free == false) {
+    try {
+      Set_K_Sparsity_Pattern(Elements, Num_Elements, Num_Global_Eq);
+      Assemble_K(Elements, Num_Elements, Coloring, Sim_Settings);
+    } // try {
+    catch (const Element_Exception & Er) {
+      printf("%s\n",Er.what());
+      throw;
+    } // catch (const Element_Exception & Er) {
+  } // if(Sim_Settings.Matrix_Free == false) {
 
 
   //////////////////////////////////////////////////////////////////////////////
-  /* Now, find F and K
-  Note: we could have done this when we processed the Element's list. I choose
-  to do it afterward becuase I think it makes more sense that way. */
+  /* Now, assemble F for each load case.
+  U holds the prescribed displacements for every load case (U[3*Num_Nodes*Case
+  + 3*Node + Comp]). Each load case starts with the prescribed displacements
+  from the inp file and then applies its own. The force due to the prescribed
+  displacements and the nodal forces are then added to that case's column
+  of F. */
+  std::vector<double> U(3*(size_t)Num_Nodes*Num_Cases);
 
   try {
-    for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
-      Elements[Element_Index].Move_Ke_To_K();
-      Elements[Element_Index].Move_Fe_To_F();
-    } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+    for(unsigned Case = 0; Case < Num_Cases; Case++) {
+      double* U_Case = U.data() + 3*(size_t)Num_Nodes*Case;
+      double* F_Case = F.data() + (size_t)Num_Global_Eq*Case;
+
+      for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+        for(unsigned Comp = 0; Comp < 3; Comp++) {
+          U_Case[3*Node_Index + Comp] = Nodes[Node_Index].Get_Displacement_Component(Comp);
+        } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+      } // for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+
+      /* Apply this case's prescribed displacements. Each one must be on a
+      fixed component (free components are unknowns). */
+      for(const Nodal_Value & Disp : Load_Cases[Case].Displacements) {
+        if(Disp.Node_Number >= Num_Nodes || Disp.Component > 2 || ID(Disp.Node_Number, Disp.Component) != -1) {
+          char Error_Message_Buffer[500];
+          sprintf(Error_Message_Buffer,
+                  "Free Component Exception: Thrown by Simulation::From_File\n"
+                  "Load case %s prescribes the displacement of component %u of node %u.\n"
+                  "However, that component is not fixed by a BC (or does not exist).\n",
+                  Load_Cases[Case].Name.c_str(), Disp.Component, Disp.Node_Number);
+          throw Free_Component(Error_Message_Buffer);
+        } // if(Disp.Node_Number >= Num_Nodes || Disp.Component > 2 || ID(Disp.Node_Number, Disp.Component) != -1) {
+
+        U_Case[3*Disp.Node_Number + Disp.Component] = Disp.Value;
+      } // for(const Nodal_Value & Disp : Load_Cases[Case].Displacements) {
+
+      Assemble_Prescribed_Force(Elements, Num_Elements, Coloring, Sim_Settings, U_Case, F_Case);
+
+      /* Apply this case's nodal forces. A force on a fixed component is
+      carried by the support (it doesn't show up in F), so we skip it. */
+      for(const Nodal_Value & Force : Load_Cases[Case].Forces) {
+        if(Force.Node_Number >= Num_Nodes || Force.Component > 2) {
+          char Error_Message_Buffer[500];
+          sprintf(Error_Message_Buffer,
+                  "Array Index Out Of Bounds Exception: Thrown by Simulation::From_File\n"
+                  "Load case %s applies a force to component %u of node %u. However,\n"
+                  "there are only %u nodes (and 3 components).\n",
+                  Load_Cases[Case].Name.c_str(), Force.Component, Force.Node_Number, Num_Nodes);
+          throw Array_Index_Out_Of_Bounds(Error_Message_Buffer);
+        } // if(Force.Node_Number >= Num_Nodes || Force.Component > 2) {
+
+        const int I = ID(Force.Node_Number, Force.Component);
+        if(I != -1) { F_Case[I] += Force.Value; }
+      } // for(const Nodal_Value & Force : Load_Cases[Case].Forces) {
+    } // for(unsigned Case = 0; Case < Num_Cases; Case++) {
   } // try {
   catch (const Element_Exception & Er) {
     printf("%s\n",Er.what());
     throw;
   } // catch (const Element_Exception & Er) {
+  catch (const Node_Exception & Er) {
+    printf("%s\n",Er.what());
+    throw;
+  } // catch (const Node_Exception & Er) {
+  catch (const Array_Exception & Er) {
+    printf("%s\n",Er.what());
+    throw;
+  } // catch (const Array_Exception & Er) {
 
-  //////////////////////////////////////////////////////////////////////////////
-  /* Solve for x in Kx = F. */
-  Pardiso_Solve(K, x, F);
 
   //////////////////////////////////////////////////////////////////////////////
-  // Assign final displacements to the Nodes.
-
-  /* Loop through the nodes. For each componet that is free (doesn't have a BC),
-  set the node's displacement to the corresponding component of the solution x. */
-  for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
-    for(unsigned Comp = 0; Comp < 3; Comp++) {
-      int I = ID(Node_Index, Comp);
+  /* Solve for x in Kx = F. With Pardiso, we factor K once and then solve for
+  every load case in a single call. PCG solves each load case separately (so
+  that we can report how each one converged). */
+  const double Solve_Start = omp_get_wtime();
+  try {
+    /* Assumption 1:
+    Pardiso needs the components of K, so it can't be used in matrix-free
+    mode. */
+    if(Sim_Settings.Matrix_Free == true && Sim_Settings.Solver != Solver_Type::PCG) {
+      char Error_Message_Buffer[500];
+      sprintf(Error_Message_Buffer,
+              "Solver Not Set Up Exception: Thrown by Simulation::From_File\n"
+              "Matrix-free mode never assembles K. It can only be used with the PCG solver.\n");
+      throw Solver_Not_Set_Up(Error_Message_Buffer);
+    } // if(Sim_Settings.Matrix_Free == true && Sim_Settings.Solver != Solver_Type::PCG) {
+
+    if(Sim_Settings.Solver == Solver_Type::PARDISO) {
+      class Pardiso_Solver Solver{K};
+      Solver.Factor(K);
+      Solver.Solve(x.data(), F.data(), Num_Cases);
+    } // if(Sim_Settings.Solver == Solver_Type::PARDISO) {
+
+    else {
+      /* The block Jacobi and AMG preconditioners use one block per node. Each block
+      holds that node's free components (which are numbered consecutively, see
+      SetUp_ID_Num_Global_Eq and Renumber_Equations). The nodes may have been
+      renumbered, so we find the blocks in equation order: Block_Size[I] is the
+      number of free components of the node whose first equation is I. */
+      std::vector<unsigned> Block_Size(Num_Global_Eq, 0);
+      for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+        int First_Eq = -1;
+        unsigned Num_Free = 0;
+        for(unsigned Comp = 0; Comp < 3; Comp++) {
+          if(ID(Node_Index, Comp) == -1) { continue; }
+          if(First_Eq == -1) { First_Eq = ID(Node_Index, Comp); }
+          Num_Free++;
+        } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+
+        if(Num_Free != 0) { Block_Size[First_Eq] = Num_Free; }
+      } // for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+
+      std::vector<unsigned> Block_Start;
+      Block_Start.push_back(0);
+      while(Block_Start.back() < Num_Global_Eq) { Block_Start.push_back(Block_Start.back() + Block_Size[Block_Start.back()]); }
+
+      /* Both multigrid preconditioners need an assembled K (otherwise, we use
+      block Jacobi). Geometric multigrid also needs a structured mesh
+      (otherwise, we use algebraic multigrid). */
+      Preconditioner Precond = Sim_Settings.PCG_Preconditioner;
+      if((Precond == Preconditioner::MULTIGRID || Precond == Preconditioner::AMG) && Sim_Settings.Matrix_Free == true) {
+        printf("PCG: Multigrid needs an assembled K. Using block Jacobi instead.\n");
+        Precond = Preconditioner::BLOCK_JACOBI;
+      } // if((Precond == Preconditioner::MULTIGRID || Precond == Preconditioner::AMG) && Sim_Settings.Matrix_Free == true) {
+
+      Structured_Grid Grid;
+      if(Precond == Preconditioner::MULTIGRID && Find_Structured_Grid(Nodes, Num_Nodes, Elements, Num_Elements, ID, Grid) == false) {
+        printf("PCG: The mesh is not a structured brick mesh. Using algebraic multigrid instead.\n");
+        Precond = Preconditioner::AMG;
+      } // if(Precond == Preconditioner::MULTIGRID && Find_Structured_Grid(Nodes, Num_Nodes, Elements, Num_Elements, ID, Grid) == false) {
+
+      std::vector<double> Near_Null_Space;
+      if(Precond == Preconditioner::AMG) { Rigid_Body_Modes(Nodes, Num_Nodes, ID, Num_Global_Eq, Near_Null_Space); }
+
+      class PCG_Solver Solver = (Precond == Preconditioner::MULTIGRID) ?
+        PCG_Solver{Precond, Sim_Settings.PCG_Tolerance, Sim_Settings.PCG_Max_Iterations, Grid} :
+        PCG_Solver{Precond, Sim_Settings.PCG_Tolerance, Sim_Settings.PCG_Max_Iterations, Block_Start, Near_Null_Space};
+      /* PCG only needs to multiply by K. In matrix-free mode, it does this
+      one element at a time. */
+      class Element_Operator K_Elements{Elements, Num_Elements, Num_Global_Eq, Coloring, Sim_Settings.Recompute_Ke};
+      if(Sim_Settings.Matrix_Free == true) { Solver.Factor(K_Elements); }
+      else { Solver.Factor(K); }
+
+      for(unsigned Case = 0; Case < Num_Cases; Case++) {
+        Solver.Solve(x.data() + (size_t)Num_Global_Eq*Case, F.data() + (size_t)Num_Global_Eq*Case);
+        printf("PCG (%s): converged in %u iterations (relative residual = %.3e)\n",
+               Load_Cases[Case].Name.c_str(),
+               Solver.Get_Iterations(),
+               Solver.Get_Relative_Residual());
+      } // for(unsigned Case = 0; Case < Num_Cases; Case++) {
+    } // else {
+  } // try {
+  catch (const Solver_Exception & Er) {
+    printf("%s\n",Er.what());
+    throw;
+  } // catch (const Solver_Exception & Er) {
 
-      /* If this Node's component was free (I != -1) then we assign this
-      componnet of this node's displacement to the corresponding component of x */
-      if(I != -1) { Nodes[Node_Index].Set_Displacement_Component(Comp, x[I]); }
-    } // for(unsigned Comp = 0; Comp < 3; Comp++) {
-  } // for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+  printf("Solve: %.3lf s\n", omp_get_wtime() - Solve_Start);
 
 
   //////////////////////////////////////////////////////////////////////////////
-  /* Output/display results. */
+  /* Assign each load case's displacements to the Nodes, recover the nodal
+  stresses (see Stress_Recovery.cc), then output the results. */
+  std::vector<double> Nodal_Stress;
+  for(unsigned Case = 0; Case < Num_Cases; Case++) {
+    const double* U_Case = U.data() + 3*(size_t)Num_Nodes*Case;
+    const double* x_Case = x.data() + (size_t)Num_Global_Eq*Case;
+
+    /* Loop through the nodes. For each componet that is free (doesn't have a
+    BC), set the node's displacement to the corresponding component of the
+    solution x. Fixed components get this case's prescribed displacement. */
+    for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+      for(unsigned Comp = 0; Comp < 3; Comp++) {
+        int I = ID(Node_Index, Comp);
+
+        if(I != -1) { Nodes[Node_Index].Set_Displacement_Component(Comp, x_Case[I]); }
+        else { Nodes[Node_Index].Set_BC_Component(Comp, U_Case[3*Node_Index + Comp]); }
+      } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+    } // for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+
+    if(Sim_Settings.Recover_Stresses == true) {
+      const double Recovery_Start = omp_get_wtime();
+      Recover_Nodal_Stresses(Nodes, Num_Nodes, Elements, Num_Elements, Coloring, Sim_Settings, Nodal_Stress);
+      printf("Stress recovery (%s): %.3lf s\n", Load_Cases[Case].Name.c_str(), omp_get_wtime() - Recovery_Start);
+    } // if(Sim_Settings.Recover_Stresses == true) {
 
-  IO::Write::vtk(Nodes, Num_Nodes, Elements, Num_Elements);
+    const IO::Write::VTK_Format Format = Sim_Settings.Output_Format;
+    IO::Write::vtk(Nodes, Num_Nodes, Elements, Num_Elements, "./IO/" + Load_Cases[Case].Name + IO::Write::vtk_Extension(Format), Format,
+                   (Sim_Settings.Recover_Stresses == true) ? Nodal_Stress.data() : nullptr);
+  } // for(unsigned Case = 0; Case < Num_Cases; Case++) {
 
 
   #if defined(SIMULATION_MONITOR)
-    // Print K, F, x to file
+    // Print K, F, x (of the last load case) to file
     try {
-      IO::Write::K_To_File(K);
-      IO::Write::F_To_File(F, Num_Global_Eq);
-      IO::Write::x_To_File(x, Num_Global_Eq);
+      if(Sim_Settings.Matrix_Free == false) { IO::Write::K_To_File(K); }
+      IO::Write::F_To_File(F.data() + (size_t)Num_Global_Eq*(Num_Cases - 1), Num_Global_Eq);
+      IO::Write::x_To_File(x.data() + (size_t)Num_Global_Eq*(Num_Cases - 1), Num_Global_Eq);
     } // try {
     catch(const Cant_Open_File & Er) { printf("%s\n",Er.what()); }
 
@@ -133,76 +366,93 @@ void Simulation::From_File(const std::string & File_Name) {
       printf("]\n");
     } // for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
   #endif
-} // void Simulation::From_File(const std::string & File_Name) {
+} // void Simulation::From_File(const std::string & File_Name, const std::vector<Load_Case> & Load_Cases, const Settings & Sim_Settings) {
 
 
 
 
 
-class Node* Simulation::Process_Node_Lists(class std::list<Array<double,3>> & Node_Positions, class std::list<IO::Read::inp_boundary_data> & Boundary_List, const unsigned Num_Nodes) {
+class Node* Simulation::Process_Node_Lists(const class std::vector<Array<double,3>> & Node_Positions, const class std::vector<IO::Read::inp_boundary_data> & Boundary_List, const unsigned Num_Nodes) {
   /* Function description:
-  This function uses the Node_Positions and Boundary_List lists to create the
-  Nodes array. */
+  This function uses the Node_Positions and Boundary_List arrays to create the
+  Nodes array.
+
+  Assumption 1: Each BC's node is one of the Num_Nodes nodes. */
 
   /* First, allocate the Nodes array */
   Node* Nodes = new Node[Num_Nodes];
 
-  /* Now, one by one, pop the positions off of the Node_List and move them into
-  the Nodes array. */
+  /* Now, use the positions to set up each Node. */
   for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
-    /* Get the front Node position. Use it to set up the current Node */
-    Array<double, 3> Current_Node_Position = Node_Positions.front();
+    const Array<double, 3> & Current_Node_Position = Node_Positions[Node_Index];
 
     Nodes[Node_Index].Set_Position_Component(0, Current_Node_Position[0]);
     Nodes[Node_Index].Set_Position_Component(1, Current_Node_Position[1]);
     Nodes[Node_Index].Set_Position_Component(2, Current_Node_Position[2]);
-
-    /* Pop the top Node Position. */
-    Node_Positions.pop_front();
   } // for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
 
 
   /* Now let's apply the BC's */
-  unsigned Num_BC = Boundary_List.size();
-  for(unsigned i = 0; i < Num_BC; i++) {
-    /* Get the front element Boundary_List, use this to implement the current BC */
-    struct IO::Read::inp_boundary_data Current_BC = Boundary_List.front();
-
-    /* Convert the Start_DOF and End_DOF from 1-index to 0-index*/
-    unsigned Start_DOF = Current_BC.Start_DOF - 1;
-    unsigned End_DOF = Current_BC.End_DOF - 1;
+  for(unsigned i = 0; i < Boundary_List.size(); i++) {
+    const struct IO::Read::inp_boundary_data & Current_BC = Boundary_List[i];
+
+    /* Assumption 1 */
+    if(Current_BC.Node_Number >= Num_Nodes) {
+      delete [] Nodes;
+
+      char Error_Message_Buffer[500];
+      sprintf(Error_Message_Buffer,
+              "Bad File Format Exception: Thrown by Simulation::Process_Node_Lists\n"
+              "A boundary condition is applied to node %u (1 index). However,\n"
+              "there are only %u nodes.\n",
+              Current_BC.Node_Number + 1, Num_Nodes);
+      throw Bad_File_Format(Error_Message_Buffer);
+    } // if(Current_BC.Node_Number >= Num_Nodes) {
+
+    /* Convert the Start_DOF and End_DOF from 1-index to 0-index. Both are
+    inclusive. Nodes only have 3 components, so we ignore any other DOF's
+    (rotations, for example). */
+    const unsigned Start_DOF = Current_BC.Start_DOF - 1;
+    const unsigned End_DOF = (Current_BC.End_DOF < 3) ? (Current_BC.End_DOF - 1) : 2;
 
     /* Set all DOF's to the specified value*/
-    for(unsigned j = Start_DOF; j < End_DOF; j++) {
+    for(unsigned j = Start_DOF; j <= End_DOF; j++) {
       Nodes[Current_BC.Node_Number].Set_BC_Component(j, Current_BC.displacement);
-    } // for(unsigned j = Start_DOF; j < End_DOF; j++) {
-
-    /* Pop the front element of the Boundary List. */
-    Boundary_List.pop_front();
-  } // for(unsigned i = 0; i < Num_BC; i++) {
+    } // for(unsigned j = Start_DOF; j <= End_DOF; j++) {
+  } // for(unsigned i = 0; i < Boundary_List.size(); i++) {
 
   return Nodes;
+} // class Node* Process_Node_Lists(const class std::vector<Array<double,3>> & Node_Positions,...
+
+
+
+class Node* Simulation::Process_Node_Lists(class std::list<Array<double,3>> & Node_Positions, class std::list<IO::Read::inp_boundary_data> & Boundary_List, const unsigned Num_Nodes) {
+  /* Function description:
+  This function moves the lists into arrays (emptying the lists), and then
+  uses them to create the Nodes array (see above). */
+  const std::vector<Array<double,3>> Position_Array(Node_Positions.begin(), Node_Positions.end());
+  const std::vector<IO::Read::inp_boundary_data> Boundary_Array(Boundary_List.begin(), Boundary_List.end());
+  Node_Positions.clear();
+  Boundary_List.clear();
+
+  return Process_Node_Lists(Position_Array, Boundary_Array, Num_Nodes);
 } // class Node* Process_Node_Lists(class std::list<Array<double,3>> & Node_Positions,...
 
 
 
 
 
-void Simulation::Set_nset_BCs(class Node* Nodes, class std::list<unsigned> & Node_Set_List, const class IO::Read::nset_BC & BC_Data) {
+void Simulation::Set_nset_BCs(class Node* Nodes, const class std::vector<unsigned> & Node_Set_List, const class IO::Read::nset_BC & BC_Data) {
   /* Function description:
   This function is designed to set the BC's of each node in the Node_Set using
   the information in the nset_BC object. The nset_BC object basically keeps
   track of which components (for the nodes in the node set) have BC's as well
-  as what the BC is.
-
-  When this function is finished, the Node_Set_List will be empty. */
+  as what the BC is. */
 
   /* Cycle through the nodes in the node set. For each one, apply the
   corresponding BC's. */
-  unsigned Num_Nset = Node_Set_List.size();
-  for(unsigned i = 0; i < Num_Nset; i++) {
-    /* Get the front element of Node_Set_List. */
-    unsigned Current_Node = Node_Set_List.front();
+  for(unsigned i = 0; i < Node_Set_List.size(); i++) {
+    const unsigned Current_Node = Node_Set_List[i];
 
     /* Now set the BC's */
     if(BC_Data.Has_x_BC() == true) {
@@ -219,15 +469,74 @@ void Simulation::Set_nset_BCs(class Node* Nodes, class std::list<unsigned> & Nod
       double z_BC = BC_Data.Get_z_BC();
       Nodes[Current_Node].Set_BC_Component(2, z_BC);
     } // if(BC_Data.Has_z_BC() == true) {
+  } // for(unsigned i = 0; i < Node_Set_List.size(); i++) {
+} // void Simulation::Set_nset_BCs(class Node* Nodes, const class std::vector<unsigned> & Node_Set_List, const class IO::Read::nset_BC & BC_Data) {
+
+
 
+void Simulation::Set_nset_BCs(class Node* Nodes, class std::list<unsigned> & Node_Set_List, const class IO::Read::nset_BC & BC_Data) {
+  /* Function description:
+  Same as above. When this function is finished, the Node_Set_List will be
+  empty. */
+  const std::vector<unsigned> Node_Set_Array(Node_Set_List.begin(), Node_Set_List.end());
+  Node_Set_List.clear();
 
-    /* Finally, Pop the front element off of the Node_Set_List */
-    Node_Set_List.pop_front();
-  } // for(unsigned i = 0; i < Num_Nset; i++) {
+  Set_nset_BCs(Nodes, Node_Set_Array, BC_Data);
 } // void Simulation::Set_nset_BCs(class Node* Nodes, class std::list<unsigned> & Node_Set_List, const class IO::Read::nset_BC & BC_Data) {
 
 
 
+void Simulation::Set_Set_Boundary_BCs(class Node* Nodes, const unsigned Num_Nodes, const IO::Read::inp_mesh & Mesh) {
+  /* Function description:
+  This function applies each of the mesh's node set boundary conditions (a
+  *Boundary line that names a node set) to every node in that node set. Each
+  one is turned into an nset_BC (DOF's past 3 are ignored, see
+  Process_Node_Lists) and then applied with Set_nset_BCs.
+
+  Assumption 1: Every named node set is in the mesh.
+  Assumption 2: Every node in those node sets is one of the Num_Nodes nodes. */
+
+  for(unsigned i = 0; i < Mesh.Set_Boundary_List.size(); i++) {
+    const IO::Read::inp_set_boundary_data & Current_BC = Mesh.Set_Boundary_List[i];
+    const IO::Read::inp_node_set * Set = Mesh.Find_Node_Set(Current_BC.Node_Set_Name);
+
+    /* Assumption 1 */
+    if(Set == nullptr) {
+      char Error_Message_Buffer[500];
+      sprintf(Error_Message_Buffer,
+              "Bad File Format Exception: Thrown by Simulation::Set_Set_Boundary_BCs\n"
+              "A boundary condition is applied to the node set \"%s\". However,\n"
+              "there's no node set with that name.\n",
+              Current_BC.Node_Set_Name.c_str());
+      throw Bad_File_Format(Error_Message_Buffer);
+    } // if(Set == nullptr) {
+
+    /* Assumption 2 */
+    for(unsigned j = 0; j < Set->Nodes.size(); j++) {
+      if(Set->Nodes[j] >= Num_Nodes) {
+        char Error_Message_Buffer[500];
+        sprintf(Error_Message_Buffer,
+                "Bad File Format Exception: Thrown by Simulation::Set_Set_Boundary_BCs\n"
+                "The node set \"%s\" contains node %u (1 index). However, there\n"
+                "are only %u nodes.\n",
+                Set->Name.c_str(), Set->Nodes[j] + 1, Num_Nodes);
+        throw Bad_File_Format(Error_Message_Buffer);
+      } // if(Set->Nodes[j] >= Num_Nodes) {
+    } // for(unsigned j = 0; j < Set->Nodes.size(); j++) {
+
+    class IO::Read::nset_BC BC_Data;
+    for(unsigned DOF = Current_BC.Start_DOF; DOF <= Current_BC.End_DOF && DOF <= 3; DOF++) {
+      if(DOF == 1)      { BC_Data.Set_x_BC(Current_BC.displacement); }
+      else if(DOF == 2) { BC_Data.Set_y_BC(Current_BC.displacement); }
+      else              { BC_Data.Set_z_BC(Current_BC.displacement); }
+    } // for(unsigned DOF = Current_BC.Start_DOF; DOF <= Current_BC.End_DOF && DOF <= 3; DOF++) {
+
+    Set_nset_BCs(Nodes, Set->Nodes, BC_Data);
+  } // for(unsigned i = 0; i < Mesh.Set_Boundary_List.size(); i++) {
+} // void Simulation::Set_Set_Boundary_BCs(class Node* Nodes, const unsigned Num_Nodes, const IO::Read::inp_mesh & Mesh) {
+
+
+
 
 
 unsigned Simulation::SetUp_ID_Num_Global_Eq(class Matrix<int> & ID, const Node* Nodes, const unsigned Num_Nodes) {
@@ -268,43 +577,262 @@ unsigned Simulation::SetUp_ID_Num_Global_Eq(class Matrix<int> & ID, const Node*
 
 
 
-class Element* Simulation::Process_Element_List(class list<Array<unsigned, 8>> & Element_Node_Lists, const unsigned Num_Elements) {
+class Element* Simulation::Process_Element_List(const class std::vector<Array<unsigned, 8>> & Node_Lists, const unsigned Num_Elements, class Ke_Cache * Cache, const bool Store_Ke) {
   /* Function description:
-  This function uses the Elemnet_Node_Lists list to create the Element array. */
+  This function uses the Node_Lists array to create the Element array.
+
+  Each element's Ke only depends on that element's nodes. Thus, we can
+  set up the elements in parallel. Some elements take longer than others (a
+  bad element throws partway through, for example), so we use dynamic
+  scheduling. If an element throws, we skip the remaining elements and
+  rethrow it once the loop is done (see Parallel_Errors).
+
+  If Cache isn't null, then Ke is populated by Cache (every Ke is stored in
+  the cache's slab, and congruent elements may share one Ke, see Ke_Cache.h).
+  Otherwise, each element allocates its own Ke. The cache must outlive the
+  elements. If Store_Ke is false, we only set the elements' nodes (Ke is
+  recomputed whenever it's needed, see Element_Operator), and Cache isn't
+  used. */
 
   /* First, allocate the Elements array */
   Element* Elements = new Element[Num_Elements];
 
-  /* Now, one by one, pop the node lists off of the Element_Node_Lists. Use
-  these lists to set each element's node list. */
-  try {
-    for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
-      /* Get the front Nodes list, use it to set up the current Element. */
-      Array<unsigned, 8> Current_Element_Node_List = Element_Node_Lists.front();
-      Elements[Element_Index].Set_Nodes(Current_Element_Node_List[0],
-                                        Current_Element_Node_List[1],
-                                        Current_Element_Node_List[2],
-                                        Current_Element_Node_List[3],
-                                        Current_Element_Node_List[4],
-                                        Current_Element_Node_List[5],
-                                        Current_Element_Node_List[6],
-                                        Current_Element_Node_List[7]);
-
-
-      // Populate Ke and Fe.
-      Elements[Element_Index].Populate_Ke();
-      Elements[Element_Index].Populate_Fe();
-
-      /* Pop the top Element Node List */
-      Element_Node_Lists.pop_front();
-    } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
-  } // try {
+  /* Now, use the node lists to set each element's node list, then populate
+  Ke. We work on groups of ELEMENT_GROUP_SIZE consecutive elements so
+  that Ke can be computed by the batched (vectorized) kernel, see
+  Populate_Ke_Batch. */
+  const unsigned ELEMENT_GROUP_SIZE = 16;
+  const unsigned Num_Groups = (Num_Elements + ELEMENT_GROUP_SIZE - 1)/ELEMENT_GROUP_SIZE;
+  Parallel_Errors Errors;
+
+  #pragma omp parallel for schedule(dynamic, 1)
+  for(unsigned Group = 0; Group < Num_Groups; Group++) {
+    if(Errors.Has_Error() == true) { continue; }
+
+    const unsigned Start = Group*ELEMENT_GROUP_SIZE;
+    const unsigned End = (Start + ELEMENT_GROUP_SIZE < Num_Elements) ? (Start + ELEMENT_GROUP_SIZE) : Num_Elements;
+
+    try {
+      for(unsigned Element_Index = Start; Element_Index < End; Element_Index++) {
+        const Array<unsigned, 8> & Current_Element_Node_List = Node_Lists[Element_Index];
+        Elements[Element_Index].Set_Nodes(Current_Element_Node_List[0],
+                                          Current_Element_Node_List[1],
+                                          Current_Element_Node_List[2],
+                                          Current_Element_Node_List[3],
+                                          Current_Element_Node_List[4],
+                                          Current_Element_Node_List[5],
+                                          Current_Element_Node_List[6],
+                                          Current_Element_Node_List[7]);
+      } // for(unsigned Element_Index = Start; Element_Index < End; Element_Index++) {
+
+      /* Populate Ke (for the whole group at once). If we're using a Ke
+      cache, we need every element's nodes before we can find the distinct
+      Ke's, so that happens after this loop (see below). */
+      if(Store_Ke == true && Cache == nullptr) { Populate_Ke_Batch(&Elements[Start], End - Start); }
+    } // try {
+    catch (...) { Errors.Capture(); }
+  } // for(unsigned Group = 0; Group < Num_Groups; Group++) {
+
+  /* If an element threw an exception, report and rethrow it. */
+  try { Errors.Rethrow(); }
   catch (const Element_Exception & Er) {
     printf("%s\n",Er.what());
+    delete [] Elements;
     throw;
   } // catch (const Element_Exception & Er) {
 
+  /* If we're using a Ke cache, let it populate Ke (see Ke_Cache.h). */
+  if(Store_Ke == true && Cache != nullptr) {
+    try { Cache->Populate_Ke(Elements, Num_Elements); }
+    catch (const Element_Exception & Er) {
+      printf("%s\n",Er.what());
+      delete [] Elements;
+      throw;
+    } // catch (const Element_Exception & Er) {
+
+    #ifdef INPUT_MONITOR
+      printf("Stored %u Ke's for %u elements\n", Cache->Get_Num_Ke(), Num_Elements);
+    #endif
+  } // if(Store_Ke == true && Cache != nullptr) {
+
   return Elements;
+} // class Element* Simulation::Process_Element_List(const class std::vector<Array<unsigned, 8>> & Node_Lists,...
+
+
+
+class Element* Simulation::Process_Element_List(class list<Array<unsigned, 8>> & Element_Node_Lists, const unsigned Num_Elements, class Ke_Cache * Cache, const bool Store_Ke) {
+  /* Function description:
+  We can't index a list (which the parallel loop needs), so this function
+  moves the node lists into a vector and then creates the Element array (see
+  above). When this function is finished, Element_Node_Lists will be empty. */
+  const std::vector<Array<unsigned, 8>> Node_Lists(Element_Node_Lists.begin(), Element_Node_Lists.end());
+  Element_Node_Lists.clear();
+
+  return Process_Element_List(Node_Lists, Num_Elements, Cache, Store_Ke);
 } // class Element* Simulation::Process_Element_List(class list<Array<unsigned, 8>> & Element_Node_Lists,...
 
+
+
+bool Simulation::Find_Structured_Grid(const class Node* Nodes, const unsigned Num_Nodes, const class Element* Elements, const unsigned Num_Elements, const class Matrix<int> & ID, Structured_Grid & Grid) {
+  /* Function description:
+  This function checks if the mesh is an Nx by Ny by Nz lattice of axis
+  aligned bricks. The lattice's x coordinates are the distinct x coordinates
+  of the nodes (and likewise for y and z). Two coordinates are the same if they
+  are within Tol of each other. The mesh is structured if
+    (1) every lattice point is a node (and no two nodes are at the same
+        lattice point), and
+    (2) every element is a brick whose nodes are the 8 corners of a lattice
+        cell (and no two elements share a cell).
+  The spacing of the lattice doesn't need to be uniform. */
+  if(Num_Nodes == 0 || Num_Elements == 0) { return false; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Find the lattice coordinates in each direction.
+
+  double Min[3], Max[3];
+  for(unsigned Comp = 0; Comp < 3; Comp++) {
+    Min[Comp] = Max[Comp] = Nodes[0].Get_Position_Component(Comp);
+  } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+  for(unsigned Node_Index = 1; Node_Index < Num_Nodes; Node_Index++) {
+    for(unsigned Comp = 0; Comp < 3; Comp++) {
+      const double X = Nodes[Node_Index].Get_Position_Component(Comp);
+      if(X < Min[Comp]) { Min[Comp] = X; }
+      if(X > Max[Comp]) { Max[Comp] = X; }
+    } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+  } // for(unsigned Node_Index = 1; Node_Index < Num_Nodes; Node_Index++) {
+
+  double Size = 0;
+  for(unsigned Comp = 0; Comp < 3; Comp++) { Size += (Max[Comp] - Min[Comp])*(Max[Comp] - Min[Comp]); }
+  const double Tol = 1e-8*sqrt(Size);
+
+  std::vector<double> Coords[3];
+  for(unsigned Comp = 0; Comp < 3; Comp++) {
+    std::vector<double> X(Num_Nodes);
+    for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) { X[Node_Index] = Nodes[Node_Index].Get_Position_Component(Comp); }
+    std::sort(X.begin(), X.end());
+
+    Coords[Comp].push_back(X[0]);
+    for(unsigned k = 1; k < Num_Nodes; k++) {
+      if(X[k] - Coords[Comp].back() > Tol) { Coords[Comp].push_back(X[k]); }
+    } // for(unsigned k = 1; k < Num_Nodes; k++) {
+  } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+
+  const unsigned Nx = (unsigned)Coords[0].size() - 1;
+  const unsigned Ny = (unsigned)Coords[1].size() - 1;
+  const unsigned Nz = (unsigned)Coords[2].size() - 1;
+  if((Nx + 1)*(Ny + 1)*(Nz + 1) != Num_Nodes || Nx*Ny*Nz != Num_Elements) { return false; }
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Find each node's lattice point.
+
+  std::vector<unsigned> Node_Point(Num_Nodes);
+  std::vector<bool> Point_Used(Num_Nodes, false);
+  for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+    unsigned Index[3];
+    for(unsigned Comp = 0; Comp < 3; Comp++) {
+      /* The first lattice coordinate that is >= X - Tol is the one that
+      matches X. */
+      const double X = Nodes[Node_Index].Get_Position_Component(Comp);
+      Index[Comp] = (unsigned)(std::lower_bound(Coords[Comp].begin(), Coords[Comp].end(), X - Tol) - Coords[Comp].begin());
+    } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+
+    const unsigned Point = (Ny + 1)*(Nz + 1)*Index[0] + (Nz + 1)*Index[1] + Index[2];
+    if(Point_Used[Point] == true) { return false; }
+    Point_Used[Point] = true;
+    Node_Point[Node_Index] = Point;
+  } // for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Check the elements. An element's lowest lattice point (the one with the
+  smallest index) is its cell's (i,j,k) corner. Every other node must be one
+  of that cell's 7 other corners, and each corner must show up exactly once. */
+
+  const unsigned Offsets[8] = {0, 1, Nz + 1, Nz + 2, (Ny + 1)*(Nz + 1), (Ny + 1)*(Nz + 1) + 1, (Ny + 2)*(Nz + 1), (Ny + 2)*(Nz + 1) + 1};
+  std::vector<bool> Cell_Used(Num_Nodes, false);
+
+  for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+    const Element & El = Elements[Element_Index];
+    if(El.Get_Element_Type() != Element_Types::BRICK) { return false; }
+
+    unsigned Corner = Node_Point[El.Get_Node_ID(0)];
+    for(unsigned a = 1; a < 8; a++) {
+      if(Node_Point[El.Get_Node_ID(a)] < Corner) { Corner = Node_Point[El.Get_Node_ID(a)]; }
+    } // for(unsigned a = 1; a < 8; a++) {
+
+    const unsigned i = Corner/((Ny + 1)*(Nz + 1));
+    const unsigned j = (Corner/(Nz + 1)) % (Ny + 1);
+    const unsigned k = Corner % (Nz + 1);
+    if(i == Nx || j == Ny || k == Nz) { return false; }
+    if(Cell_Used[Corner] == true) { return false; }
+    Cell_Used[Corner] = true;
+
+    bool Corner_Found[8] = {false, false, false, false, false, false, false, false};
+    for(unsigned a = 0; a < 8; a++) {
+      const unsigned Offset = Node_Point[El.Get_Node_ID(a)] - Corner;
+
+      unsigned b = 0;
+      while(b < 8 && Offsets[b] != Offset) { b++; }
+      if(b == 8 || Corner_Found[b] == true) { return false; }
+      Corner_Found[b] = true;
+    } // for(unsigned a = 0; a < 8; a++) {
+  } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // The mesh is structured. Set up the grid's equation numbers.
+
+  Grid.Nx = Nx;
+  Grid.Ny = Ny;
+  Grid.Nz = Nz;
+  Grid.Eq.assign(3*Num_Nodes, -1);
+  for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+    for(unsigned Comp = 0; Comp < 3; Comp++) { Grid.Eq[3*Node_Point[Node_Index] + Comp] = ID(Node_Index, Comp); }
+  } // for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+
+  return true;
+} // bool Simulation::Find_Structured_Grid(const class Node* Nodes, const unsigned Num_Nodes, const class Element* Elements, const unsigned Num_Elements, const class Matrix<int> & ID, Structured_Grid & Grid) {
+
+
+
+void Simulation::Rigid_Body_Modes(const class Node* Nodes, const unsigned Num_Nodes, const class Matrix<int> & ID, const unsigned Num_Global_Eq, std::vector<double> & Modes) {
+  /* Function description:
+  A rigid body motion of the mesh doesn't strain it, so K (without BCs) maps
+  each rigid body mode to zero. Mode c (c = 0, 1, 2) translates every node
+  one unit in the c direction. Modes 3, 4, 5 rotate the mesh (by a small
+  angle) about the x, y, and z axes through the centroid of the nodes:
+      about x: ( 0, -z,  y)
+      about y: ( z,  0, -x)
+      about z: (-y,  x,  0)
+  (x, y, and z are measured from the centroid, which keeps the rotations from
+  being nearly parallel to the translations). */
+  Modes.assign(6*(size_t)Num_Global_Eq, 0);
+
+  double Centroid[3] = {0, 0, 0};
+  for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+    for(unsigned Comp = 0; Comp < 3; Comp++) { Centroid[Comp] += Nodes[Node_Index].Get_Position_Component(Comp); }
+  } // for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+  for(unsigned Comp = 0; Comp < 3; Comp++) { Centroid[Comp] /= (double)Num_Nodes; }
+
+  for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+    double X[3];
+    for(unsigned Comp = 0; Comp < 3; Comp++) { X[Comp] = Nodes[Node_Index].Get_Position_Component(Comp) - Centroid[Comp]; }
+
+    /* Rotation[Mode][Comp] is component Comp of rotation Mode (about axis
+    Mode) at this node. */
+    const double Rotation[3][3] = {{     0, -X[2],  X[1]},
+                                   {  X[2],     0, -X[0]},
+                                   { -X[1],  X[0],     0}};
+
+    for(unsigned Comp = 0; Comp < 3; Comp++) {
+      const int I = ID(Node_Index, Comp);
+      if(I == -1) { continue; }
+
+      Modes[(size_t)Num_Global_Eq*Comp + I] = 1;
+      for(unsigned Mode = 0; Mode < 3; Mode++) { Modes[(size_t)Num_Global_Eq*(3 + Mode) + I] = Rotation[Mode][Comp]; }
+    } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+  } // for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+} // void Simulation::Rigid_Body_Modes(const class Node* Nodes, const unsigned Num_Nodes, const class Matrix<int> & ID, const unsigned Num_Global_Eq, std::vector<double> & Modes) {
+
 #endif
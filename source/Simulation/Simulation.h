@@ -4,16 +4,21 @@
 #include <string>
 #include <stdio.h>
 #include <list>
+#include <vector>
 
 #include "Errors.h"
 #include "Array.h"
 #include "Matrix.h"
 #include "Node/Node.h"
 #include "Element/Element.h"
+#include "Element/Ke_Cache.h"
 #include "IO/inp_Reader.h"
+#include "IO/Mesh_Cache.h"
 #include "IO/KFX_Writer.h"
 #include "IO/vtk_Writer.h"
 #include "Pardiso/Pardiso_Solve.h"
+#include "Solver/PCG_Solver.h"
+#include "Element_Operator.h"
 
 //#define ID_MONITOR
 #define INPUT_MONITOR
@@ -25,22 +30,251 @@ namespace Simulation {
   const double E = 100;                        // Young's modulus               : Units GPA
   const double v = .45;                        // Poisson's ratio               : Unitless
 
-  void From_File(const std::string & File_Name);                               // Intent: Read
+  /* Simulation settings.
+  These control how (not what) the simulation computes. Every setting has a
+  default, so Settings{} gives the standard behavior.
 
+  Assembly: How Ke and the element force vectors are moved into K and F.
+    SERIAL: One element at a time.
+    COLORED: The elements are colored so that no two elements of the same color
+    share a node (see Color_Elements). Elements of the same color never write
+    to the same component of K or F, so each color is assembled in parallel
+    (without locks or atomics).
+
+  Solver: How Kx = F is solved.
+    PARDISO: Pardiso's sparse direct solver (see Pardiso_Solver.h).
+    PCG: The preconditioned conjugate gradient solver (see PCG_Solver.h). This
+    uses far less memory than Pardiso. PCG_Preconditioner, PCG_Tolerance, and
+    PCG_Max_Iterations control it (they are ignored by Pardiso). The MULTIGRID
+    preconditioner only works on structured brick meshes (see
+    Find_Structured_Grid); on any other mesh, From_File uses AMG instead. Both
+    multigrid preconditioners need an assembled K, so in matrix-free mode
+    they're replaced by BLOCK_JACOBI.
+
+  Matrix_Free: If true, K is never assembled. Instead, PCG multiplies by K one
+    element at a time (see Element_Operator.h). This requires the PCG solver.
+    If Recompute_Ke is also true, then Ke is never stored: each element's Ke is
+    recomputed every time that PCG multiplies by K, and (for elements with a
+    fixed component) when the force due to the prescribed displacements is
+    found. This trades FLOPs for the memory of every Ke. Recompute_Ke is
+    ignored unless Matrix_Free is true (assembling K needs every Ke).
+
+  Cache_Ke: If true, elements that are translations of one another share one
+    Ke (see Ke_Cache.h), so each distinct Ke is computed and stored once. This
+    saves time and memory on structured and extruded meshes. Either way, the
+    Ke's are packed into one slab.
+
+  Cache_Mesh: If true, the mesh is loaded from the inp file's binary cache
+    (./IO/<inp file name>.cache, see Mesh_Cache.h) when the cache is up to
+    date. Otherwise, the inp file is read and then cached for next time (if
+    the cache can't be written, we say so and carry on). This is off by
+    default, since it leaves a file next to the results. It's worth turning on
+    when the same big inp file is solved again and again.
+
+  Equation_Order: How the global equations are numbered (see Renumber.cc).
+    NONE: In the order that the nodes appear in the inp file.
+    RCM: Reverse Cuthill-McKee, which reduces K's bandwidth (and profile).
+    This improves the cache behavior of assembly and of K*x. If the RCM
+    numbering has a larger bandwidth or profile than NONE, NONE is used.
+    NESTED_DISSECTION: Recursively numbers the nodes on either side of a
+    separator before the separator. This reduces the fill of a direct
+    factorization (Pardiso also reorders K itself, so this mostly matters
+    for other direct solvers).
+
+  Output_Format: The format of each load case's results file (see
+    vtk_Writer.h). The VTU formats write ./IO/<Name>.vtu instead of .vtk.
+
+  Recover_Stresses: If true, the stress at each node is recovered (see
+    Stress_Recovery.cc) and written to the results file too. */
+  enum class Assembly_Mode { SERIAL, COLORED };
+  enum class Solver_Type { PARDISO, PCG };
+  enum class Renumbering { NONE, RCM, NESTED_DISSECTION };
+
+  struct Settings {
+    Assembly_Mode Assembly = Assembly_Mode::COLORED;
+
+    Solver_Type Solver = Solver_Type::PARDISO;
+    Preconditioner PCG_Preconditioner = Preconditioner::BLOCK_JACOBI;
+    double PCG_Tolerance = 1e-10;                // Relative residual at which PCG stops
+    unsigned PCG_Max_Iterations = 10000;
+
+    bool Matrix_Free = false;
+    bool Recompute_Ke = false;
+
+    bool Cache_Ke = true;
+    bool Cache_Mesh = false;
+
+    Renumbering Equation_Order = Renumbering::RCM;
+
+    IO::Write::VTK_Format Output_Format = IO::Write::VTK_Format::LEGACY_ASCII;
+    bool Recover_Stresses = true;
+  }; // struct Settings {
+
+  /* Element coloring.
+  The elements of color c are
+      Elements[Color_Start[c]], ... , Elements[Color_Start[c+1] - 1]
+  (these are indicies into the Elements array). */
+  struct Element_Coloring {
+    unsigned Num_Colors = 0;
+    std::vector<unsigned> Color_Start;
+    std::vector<unsigned> Elements;
+  }; // struct Element_Coloring {
+
+  /* Load cases.
+  A load case is a set of prescribed displacements and nodal forces. Every
+  load case uses the same mesh and the same fixed components (those set by the
+  inp file and node sets), so every load case has the same stiffness matrix.
+  This lets us factor K once and then solve for every load case at the same
+  time (see From_File).
+
+  Displacements overrides the value of the prescribed displacement of some of
+  the fixed components (every other fixed component keeps the value from the
+  inp file). Each component in Displacements must be fixed. Forces adds nodal
+  forces to the free components. Component is 0 (x), 1 (y), or 2 (z). The
+  displacements for the load case are written to ./IO/<Name>.vtk (or .vtu) */
+  struct Nodal_Value {
+    unsigned Node_Number;
+    unsigned Component;
+    double Value;
+  }; // struct Nodal_Value {
+
+  struct Load_Case {
+    std::string Name;
+    std::list<Nodal_Value> Displacements;
+    std::list<Nodal_Value> Forces;
+  }; // struct Load_Case {
+
+  /* Run a simulation. The first version solves the problem set up by the inp
+  file (and writes the results to ./IO/Out.vtk, or Out.vtu, see
+  Output_Format). The second version solves each of the passed load cases
+  using a single factorization of K. */
+  void From_File(const std::string & File_Name,                                // Intent: Read
+                 const Settings & Sim_Settings = Settings{});                  // Intent: Read
+  void From_File(const std::string & File_Name,                                // Intent: Read
+                 const std::vector<Load_Case> & Load_Cases,                    // Intent: Read
+                 const Settings & Sim_Settings = Settings{});                  // Intent: Read
+
+  class Node* Process_Node_Lists(const class std::vector<Array<double,3>> & Node_Positions,            // Intent: Read
+                                 const class std::vector<IO::Read::inp_boundary_data> & Boundary_List,// Intent: Read
+                                 const unsigned Num_Nodes);                                           // Intent: Read
+
+  /* Same as above, but this empties the lists. */
   class Node* Process_Node_Lists(class list<Array<double,3>> & Node_Positions,           // Intent: Read/Write
                                  class list<IO::Read::inp_boundary_data> & Boundary_List,// Intent: Read/Write
                                  const unsigned Num_Nodes);                              // Intent: Read
 
+  void Set_nset_BCs(class Node * Nodes,                                        // Intent: Write
+                    const class std::vector<unsigned> & Node_Set_List,         // Intent: Read
+                    const class IO::Read::nset_BC & BC_data);                  // Intent: Read
+
   void Set_nset_BCs(class Node * Nodes,                                        // Intent: Write
                     class list<unsigned> & Node_Set_List,                      // Intent: Read/Write
                     const class IO::Read::nset_BC & BC_data);                  // Intent: Read
 
+  /* Apply the mesh's node set boundary data (*Boundary lines that name a node
+  set) to the nodes of the named sets. This throws a Bad_File_Format exception
+  if a named node set doesn't exist. */
+  void Set_Set_Boundary_BCs(class Node * Nodes,                                // Intent: Write
+                            const unsigned Num_Nodes,                          // Intent: Read
+                            const IO::Read::inp_mesh & Mesh);                  // Intent: Read
+
   unsigned SetUp_ID_Num_Global_Eq(class Matrix<int> & ID,                      // Intent: Write
                                   const Node * Nodes,                          // Intent: Read
                                   const unsigned Num_Nodes);                   // Intent: Read
 
+  /* Equation renumbering functions (see Renumber.cc) */
+
+  /* Renumber the global equations (in ID) using Method. Each node's free
+  components keep consecutive equations, so the per node blocks of K don't
+  change. RCM never makes the bandwidth or profile worse (if it would, ID is
+  left alone). This must happen before the elements are set up. */
+  void Renumber_Equations(class Matrix<int> & ID,                              // Intent: Read/Write
+                          const unsigned Num_Nodes,                            // Intent: Read
+                          const class std::vector<Array<unsigned, 8>> & Element_Node_Lists, // Intent: Read
+                          const Renumbering Method);                           // Intent: Read
+
+  /* Find K's bandwidth (the largest |I - J| for which K(I,J) can be non-zero)
+  and profile (the sum over the rows I of K of I minus the first column of
+  row I that can be non-zero). */
+  void Bandwidth_Profile(const class Matrix<int> & ID,                         // Intent: Read
+                         const unsigned Num_Nodes,                             // Intent: Read
+                         const class std::vector<Array<unsigned, 8>> & Element_Node_Lists, // Intent: Read
+                         unsigned & Bandwidth,                                 // Intent: Write
+                         unsigned long long & Profile);                        // Intent: Write
+
+  /* Set up the elements (and their Ke's, unless Store_Ke is false, see
+  Settings::Recompute_Ke). */
+  class Element* Process_Element_List(const class std::vector<Array<unsigned, 8>> & Element_Node_Lists, // Intent: Read
+                                      const unsigned Num_Elements,                            // Intent: Read
+                                      class Ke_Cache * Cache = nullptr,                       // Intent: Read/Write
+                                      const bool Store_Ke = true);                            // Intent: Read
+
+  /* Same as above, but this empties Element_Node_Lists. */
   class Element* Process_Element_List(class list<Array<unsigned, 8>> & Element_Node_Lists,    // Intent: Read/Write
-                                      const unsigned Num_Elements);                           // Intent: Read
+                                      const unsigned Num_Elements,                            // Intent: Read
+                                      class Ke_Cache * Cache = nullptr,                       // Intent: Read/Write
+                                      const bool Store_Ke = true);                            // Intent: Read
+
+  /* Check if the mesh is a structured (axis aligned, tensor product) brick
+  mesh. If so, this returns true and sets up Grid (see Multigrid.h). Otherwise,
+  this returns false. */
+  bool Find_Structured_Grid(const class Node* Nodes,                           // Intent: Read
+                            const unsigned Num_Nodes,                          // Intent: Read
+                            const class Element* Elements,                     // Intent: Read
+                            const unsigned Num_Elements,                       // Intent: Read
+                            const class Matrix<int> & ID,                      // Intent: Read
+                            Structured_Grid & Grid);                           // Intent: Write
+
+  /* Find the 6 rigid body modes of the mesh (restricted to the free
+  components): 3 translations and 3 rotations (about the mesh's centroid).
+  These are the near null space vectors of K for the AMG preconditioner.
+  Modes is Num_Global_Eq by 6 (column major). */
+  void Rigid_Body_Modes(const class Node* Nodes,                               // Intent: Read
+                        const unsigned Num_Nodes,                              // Intent: Read
+                        const class Matrix<int> & ID,                          // Intent: Read
+                        const unsigned Num_Global_Eq,                          // Intent: Read
+                        std::vector<double> & Modes);                          // Intent: Write
+
+
+  /* Assembly functions (see Assembly.cc) */
+
+  /* Greedy element coloring: each element gets the smallest color that isn't
+  used by an (already colored) element that shares one of its nodes. */
+  void Color_Elements(const class Element* Elements,                           // Intent: Read
+                      const unsigned Num_Elements,                             // Intent: Read
+                      const unsigned Num_Nodes,                                // Intent: Read
+                      Element_Coloring & Coloring);                            // Intent: Write
+
+  /* Move every element's Ke into K. */
+  void Assemble_K(const class Element* Elements,                               // Intent: Read
+                  const unsigned Num_Elements,                                 // Intent: Read
+                  const Element_Coloring & Coloring,                           // Intent: Read
+                  const Settings & Sim_Settings);                              // Intent: Read
+
+  /* Add the force due to the prescribed displacements U to F_Case (see
+  Element::Move_Prescribed_Force_To_F) for every element. */
+  void Assemble_Prescribed_Force(const class Element* Elements,                // Intent: Read
+                                 const unsigned Num_Elements,                  // Intent: Read
+                                 const Element_Coloring & Coloring,            // Intent: Read
+                                 const Settings & Sim_Settings,                // Intent: Read
+                                 const double * U,                             // Intent: Read
+                                 double * F_Case);                             // Intent: Write
+
+
+  /* Stress recovery (see Stress_Recovery.cc) */
+
+  /* Find the stress at each node: the average of the stresses that the
+  elements that share the node extrapolate to it (see
+  Element::Find_Nodal_Stresses). Nodal_Stress gets 6 components (Voigt order)
+  per node. The elements are processed in parallel (one color at a time) in
+  COLORED mode. */
+  void Recover_Nodal_Stresses(const class Node* Nodes,                         // Intent: Read
+                              const unsigned Num_Nodes,                        // Intent: Read
+                              const class Element* Elements,                   // Intent: Read
+                              const unsigned Num_Elements,                     // Intent: Read
+                              const Element_Coloring & Coloring,               // Intent: Read
+                              const Settings & Sim_Settings,                   // Intent: Read
+                              std::vector<double> & Nodal_Stress);             // Intent: Write
 } // namespace Simulation {
 
 #endif
@@ -0,0 +1,72 @@
+#if !defined(SIMULATION_STRESS_RECOVERY_SOURCE)
+#define SIMULATION_STRESS_RECOVERY_SOURCE
+
+/* File description:
+This file holds the function that recovers the stress at the nodes once the
+displacements are known. Each element extrapolates the stresses at its
+integration points to its nodes (see Element::Find_Nodal_Stresses). A node is
+shared by several elements, each of which gives it a different stress (the
+stress is discontinuous between elements), so we average them. Elements that
+share a node add to the same sums, so, just like assembly, we add in the
+elements of one color (see Assembly.cc) at a time. */
+
+#include "Simulation.h"
+
+
+static void Add_Nodal_Stresses(const class Node* Nodes, const class Element & El, double * Stress_Sum, unsigned * Num_Contributions) {
+  /* Add El's stress at each of its nodes to that node's sum. */
+  double Element_Stress[48];
+  El.Find_Nodal_Stresses(Nodes, Element_Stress);
+
+  for(unsigned a = 0; a < 8; a++) {
+    const unsigned Node_Index = El.Get_Node_ID(a);
+    for(unsigned i = 0; i < 6; i++) { Stress_Sum[6*(size_t)Node_Index + i] += Element_Stress[6*a + i]; }
+    Num_Contributions[Node_Index]++;
+  } // for(unsigned a = 0; a < 8; a++) {
+} // static void Add_Nodal_Stresses(const class Node* Nodes, const class Element & El, double * Stress_Sum, unsigned * Num_Contributions) {
+
+
+
+void Simulation::Recover_Nodal_Stresses(const class Node* Nodes, const unsigned Num_Nodes, const class Element* Elements, const unsigned Num_Elements, const Element_Coloring & Coloring, const Settings & Sim_Settings, std::vector<double> & Nodal_Stress) {
+  /* Function description:
+  This function finds the average (over the elements that share it) of the
+  stress at each node. In COLORED mode, the elements of each color are
+  processed in parallel. If an element throws, we rethrow it once the current
+  color is done (see Parallel_Errors). Every node's average is
+  independent, so we then find those in parallel. */
+
+  Nodal_Stress.assign(6*(size_t)Num_Nodes, 0);
+  std::vector<unsigned> Num_Contributions(Num_Nodes, 0);
+
+  if(Sim_Settings.Assembly == Assembly_Mode::SERIAL) {
+    for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+      Add_Nodal_Stresses(Nodes, Elements[Element_Index], Nodal_Stress.data(), Num_Contributions.data());
+    } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+  } // if(Sim_Settings.Assembly == Assembly_Mode::SERIAL) {
+
+  else {
+    Parallel_Errors Errors;
+    for(unsigned c = 0; c < Coloring.Num_Colors; c++) {
+      const unsigned Start = Coloring.Color_Start[c];
+      const unsigned End = Coloring.Color_Start[c+1];
+
+      #pragma omp parallel for schedule(static)
+      for(unsigned k = Start; k < End; k++) {
+        try { Add_Nodal_Stresses(Nodes, Elements[Coloring.Elements[k]], Nodal_Stress.data(), Num_Contributions.data()); }
+        catch (...) { Errors.Capture(); }
+      } // for(unsigned k = Start; k < End; k++) {
+
+      Errors.Rethrow();
+    } // for(unsigned c = 0; c < Coloring.Num_Colors; c++) {
+  } // else {
+
+  // Now, average the sums (a node that isn't in any element keeps zero stress).
+  #pragma omp parallel for schedule(static)
+  for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+    if(Num_Contributions[Node_Index] == 0) { continue; }
+
+    for(unsigned i = 0; i < 6; i++) { Nodal_Stress[6*(size_t)Node_Index + i] /= (double)Num_Contributions[Node_Index]; }
+  } // for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+} // void Simulation::Recover_Nodal_Stresses(const class Node* Nodes, const unsigned Num_Nodes, const class Element* Elements, const unsigned Num_Elements,...
+
+#endif
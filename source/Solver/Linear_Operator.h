@@ -0,0 +1,36 @@
+#if !defined(LINEAR_OPERATOR_HEADER)
+#define LINEAR_OPERATOR_HEADER
+
+#include <vector>
+
+/* Linear operator class.
+Iterative solvers (like PCG) never need to look at the components of K. They
+only need to compute y = K*x and to build a preconditioner from K's diagonal
+(or diagonal blocks). This class describes an object that can do those things.
+
+This lets the same solver work with an assembled K (Sparse_Matrix) and with a
+matrix-free operator that applies each element's Ke directly (Element_Operator)
+and never stores K at all. */
+class Linear_Operator {
+  public:
+    virtual ~Linear_Operator(void) {}
+
+    /* Number of rows (and columns) of the operator. */
+    virtual unsigned Get_Num_Rows(void) const = 0;
+
+    /* Compute y = K*x. Both x and y must have Get_Num_Rows() components. */
+    virtual void Multiply(const double* x,                                     // Intent: Read
+                          double* y) const = 0;                                // Intent: Write
+
+    /* Store the diagonal components of K in Diagonal (Get_Num_Rows() doubles). */
+    virtual void Get_Diagonal(double* Diagonal) const = 0;                     // Intent: Write
+
+    /* Store the diagonal blocks of K in Blocks. The ith block is made up of
+    rows (and columns) Block_Start[i], ... , Block_Start[i+1] - 1 (at most 3).
+    Blocks holds 9 doubles per block (row major, even if the block is smaller
+    than 3x3). */
+    virtual void Get_Diagonal_Blocks(const std::vector<unsigned> & Block_Start,// Intent: Read
+                                     double* Blocks) const = 0;                // Intent: Write
+}; // class Linear_Operator {
+
+#endif
@@ -0,0 +1,980 @@
+#if !defined(MULTIGRID_SOURCE)
+#define MULTIGRID_SOURCE
+
+/* File description:
+This file holds the implementation of the methods of the Multigrid class. */
+
+#include "Multigrid.h"
+#include <math.h>
+#include <algorithm>
+
+/* Coarsening stops once a level has this many (or fewer) equations, or once
+there are MAX_LEVELS levels. The coarsest level is solved with a dense
+Cholesky factorization if it has at most MAX_DIRECT_EQ equations (otherwise,
+we just run a few extra Gauss-Seidel sweeps on it). */
+static const unsigned MIN_COARSEN_EQ = 300;
+static const unsigned MAX_DIRECT_EQ = 3000;
+static const unsigned MAX_LEVELS = 10;
+
+/* Smoothed aggregation parameters. Blocks I and J are strongly coupled if
+    ||A_IJ||^2 > Theta^2 * ||A_II|| * ||A_JJ||    (Frobenius norms)
+where Theta = STRENGTH_THRESHOLD * (1/2)^l on level l. A level stops being
+coarsened if the next level would have more than MAX_COARSE_RATIO times as
+many equations. */
+static const double STRENGTH_THRESHOLD = 0.08;
+static const double MAX_COARSE_RATIO = 0.8;
+
+/* The V-cycle's loops on levels with fewer equations than this run on one
+thread (starting the threads would take longer than the loop itself).
+Gauss-Seidel works on chunks of GS_CHUNK_ROWS consecutive rows (see
+Color_Chunks). */
+static const unsigned MIN_PARALLEL_EQ = 2000;
+static const unsigned GS_CHUNK_ROWS = 256;
+
+/* The coarsest level's Cholesky factorization updates the rows below each
+pivot in parallel while there are at least this many of them. */
+static const unsigned MIN_PARALLEL_CHOLESKY_ROWS = 128;
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Sparse matrix helpers (CSR, same format as Level::A)
+
+static void CSR_Multiply(const unsigned Num_Rows, const unsigned Num_Cols,
+                         const std::vector<int> & A_Start, const std::vector<int> & A_Col, const std::vector<double> & A_Val,
+                         const std::vector<int> & B_Start, const std::vector<int> & B_Col, const std::vector<double> & B_Val,
+                         std::vector<int> & C_Start, std::vector<int> & C_Col, std::vector<double> & C_Val) {
+  /* Function description:
+  This function computes C = A*B (A has Num_Rows rows, B has Num_Cols
+  columns). Each row of C only depends on the same row of A, so the threads
+  split up the rows. We go through the rows twice: the first pass counts the
+  components of each row of C (which gives C_Start), and the second pass fills
+  them in. In the second pass, each row of C is accumulated in a dense array
+  (Acc). In both passes, Marker keeps track of which components of the current
+  row are non-zero. Each thread has its own Acc and Marker. The columns of each
+  row of C are sorted. */
+  C_Start.assign(Num_Rows + 1, 0);
+
+  #pragma omp parallel
+  {
+    std::vector<int> Marker(Num_Cols, -1);
+
+    #pragma omp for schedule(dynamic, 256)
+    for(unsigned i = 0; i < Num_Rows; i++) {
+      int Row_Size = 0;
+      for(int k = A_Start[i]; k < A_Start[i+1]; k++) {
+        const int m = A_Col[k];
+        for(int p = B_Start[m]; p < B_Start[m+1]; p++) {
+          const int J = B_Col[p];
+          if(Marker[J] != (int)i) {
+            Marker[J] = (int)i;
+            Row_Size++;
+          } // if(Marker[J] != (int)i) {
+        } // for(int p = B_Start[m]; p < B_Start[m+1]; p++) {
+      } // for(int k = A_Start[i]; k < A_Start[i+1]; k++) {
+      C_Start[i + 1] = Row_Size;
+    } // for(unsigned i = 0; i < Num_Rows; i++) {
+  } // #pragma omp parallel
+
+  for(unsigned i = 0; i < Num_Rows; i++) { C_Start[i + 1] += C_Start[i]; }
+  C_Col.resize(C_Start[Num_Rows]);
+  C_Val.resize(C_Start[Num_Rows]);
+
+  #pragma omp parallel
+  {
+    std::vector<double> Acc(Num_Cols, 0);
+    std::vector<int> Marker(Num_Cols, -1);
+
+    #pragma omp for schedule(dynamic, 256)
+    for(unsigned i = 0; i < Num_Rows; i++) {
+      int Next = C_Start[i];
+      for(int k = A_Start[i]; k < A_Start[i+1]; k++) {
+        const int m = A_Col[k];
+        for(int p = B_Start[m]; p < B_Start[m+1]; p++) {
+          const int J = B_Col[p];
+          if(Marker[J] != (int)i) {
+            Marker[J] = (int)i;
+            Acc[J] = 0;
+            C_Col[Next] = J;
+            Next++;
+          } // if(Marker[J] != (int)i) {
+          Acc[J] += A_Val[k]*B_Val[p];
+        } // for(int p = B_Start[m]; p < B_Start[m+1]; p++) {
+      } // for(int k = A_Start[i]; k < A_Start[i+1]; k++) {
+
+      std::sort(C_Col.begin() + C_Start[i], C_Col.begin() + C_Start[i+1]);
+      for(int q = C_Start[i]; q < C_Start[i+1]; q++) { C_Val[q] = Acc[C_Col[q]]; }
+    } // for(unsigned i = 0; i < Num_Rows; i++) {
+  } // #pragma omp parallel
+} // static void CSR_Multiply(const unsigned Num_Rows, const unsigned Num_Cols,
+
+
+
+static void CSR_Transpose(const unsigned Num_Rows, const unsigned Num_Cols,
+                          const std::vector<int> & A_Start, const std::vector<int> & A_Col, const std::vector<double> & A_Val,
+                          std::vector<int> & AT_Start, std::vector<int> & AT_Col, std::vector<double> & AT_Val) {
+  /* AT = A^T (A has Num_Rows rows and Num_Cols columns). We cycle through the
+  rows of A in order, so the columns of each row of AT are sorted. */
+  AT_Start.assign(Num_Cols + 1, 0);
+  for(unsigned p = 0; p < A_Col.size(); p++) { AT_Start[A_Col[p] + 1]++; }
+  for(unsigned J = 0; J < Num_Cols; J++) { AT_Start[J + 1] += AT_Start[J]; }
+
+  AT_Col.resize(AT_Start[Num_Cols]);
+  AT_Val.resize(AT_Start[Num_Cols]);
+  std::vector<int> Next(AT_Start.begin(), AT_Start.end() - 1);
+  for(unsigned i = 0; i < Num_Rows; i++) {
+    for(int p = A_Start[i]; p < A_Start[i+1]; p++) {
+      const int J = A_Col[p];
+      AT_Col[Next[J]] = (int)i;
+      AT_Val[Next[J]] = A_Val[p];
+      Next[J]++;
+    } // for(int p = A_Start[i]; p < A_Start[i+1]; p++) {
+  } // for(unsigned i = 0; i < Num_Rows; i++) {
+} // static void CSR_Transpose(const unsigned Num_Rows, const unsigned Num_Cols,
+
+
+
+static void Color_Chunks(const unsigned n, const std::vector<int> & A_Start, const std::vector<int> & A_Col,
+                         std::vector<unsigned> & Color_Start, std::vector<unsigned> & Color_Chunks) {
+  /* Function description:
+  This function splits the rows of A (an n by n CSR matrix with a symmetric
+  pattern) into chunks of GS_CHUNK_ROWS consecutive rows, and colors the chunks
+  so that no two chunks of the same color are coupled (no row of one has a
+  column in the other). We color the chunks greedily, in order: chunk c gets
+  the smallest color that none of its (already colored) neighbors have.
+  Forbidden[Color] == c means that one of chunk c's neighbors has that color.
+  The chunks of each color are listed in order. */
+  const unsigned Num_Chunks = (n + GS_CHUNK_ROWS - 1)/GS_CHUNK_ROWS;
+  std::vector<unsigned> Chunk_Color(Num_Chunks);
+  std::vector<unsigned> Forbidden;
+  unsigned Num_Colors = 0;
+
+  for(unsigned c = 0; c < Num_Chunks; c++) {
+    const unsigned Row_End = std::min(n, (c + 1)*GS_CHUNK_ROWS);
+    for(unsigned i = c*GS_CHUNK_ROWS; i < Row_End; i++) {
+      for(int k = A_Start[i]; k < A_Start[i+1]; k++) {
+        const unsigned Neighbor = (unsigned)A_Col[k]/GS_CHUNK_ROWS;
+        if(Neighbor < c) { Forbidden[Chunk_Color[Neighbor]] = c; }
+      } // for(int k = A_Start[i]; k < A_Start[i+1]; k++) {
+    } // for(unsigned i = c*GS_CHUNK_ROWS; i < Row_End; i++) {
+
+    unsigned Color = 0;
+    while(Color < Num_Colors && Forbidden[Color] == c) { Color++; }
+    if(Color == Num_Colors) {
+      Forbidden.push_back((unsigned)-1);
+      Num_Colors++;
+    } // if(Color == Num_Colors) {
+    Chunk_Color[c] = Color;
+  } // for(unsigned c = 0; c < Num_Chunks; c++) {
+
+  Color_Start.assign(Num_Colors + 1, 0);
+  for(unsigned c = 0; c < Num_Chunks; c++) { Color_Start[Chunk_Color[c] + 1]++; }
+  for(unsigned Color = 0; Color < Num_Colors; Color++) { Color_Start[Color + 1] += Color_Start[Color]; }
+
+  Color_Chunks.resize(Num_Chunks);
+  std::vector<unsigned> Next(Color_Start.begin(), Color_Start.end() - 1);
+  for(unsigned c = 0; c < Num_Chunks; c++) { Color_Chunks[Next[Chunk_Color[c]]++] = c; }
+} // static void Color_Chunks(const unsigned n, const std::vector<int> & A_Start, const std::vector<int> & A_Col,
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Set up, apply
+
+void Multigrid::Setup(const Sparse_Matrix & K, const Structured_Grid & Grid) {
+  /* Function description:
+  This function builds the geometric multigrid hierarchy for K. Level 0 is K
+  itself (with both triangles stored). Each coarser level is made by Coarsen
+  and Galerkin_Product. */
+
+  /* Assumption 1:
+  This function assumes that the grid has one equation slot for each
+  component of each lattice point, and that it numbers every row of K exactly
+  once. */
+  const unsigned n = K.Get_Num_Rows();
+  const unsigned Num_Points = (Grid.Nx + 1)*(Grid.Ny + 1)*(Grid.Nz + 1);
+  unsigned Num_Grid_Eq = 0;
+  for(unsigned k = 0; k < Grid.Eq.size(); k++) {
+    if(Grid.Eq[k] >= (int)n) { Num_Grid_Eq = n + 1; break; }
+    if(Grid.Eq[k] != -1) { Num_Grid_Eq++; }
+  } // for(unsigned k = 0; k < Grid.Eq.size(); k++) {
+
+  if(K.Get_Pattern_Set() == false || Grid.Eq.size() != 3*Num_Points || Num_Grid_Eq != n) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Solver Not Set Up Exception: Thrown by Multigrid::Setup\n"
+            "The %u by %u by %u grid does not match K (which has %u rows).\n",
+            Grid.Nx, Grid.Ny, Grid.Nz, n);
+    throw Solver_Not_Set_Up(Error_Message_Buffer);
+  } // if(K.Get_Pattern_Set() == false || Grid.Eq.size() != 3*Num_Points || Num_Grid_Eq != n) {
+
+  Set_Finest_Level(K);
+  Levels[0].Grid = Grid;
+
+  while(Levels.size() < MAX_LEVELS && Coarsen() == true) { Galerkin_Product(); }
+
+  Finish_Setup();
+} // void Multigrid::Setup(const Sparse_Matrix & K, const Structured_Grid & Grid) {
+
+
+
+void Multigrid::Setup(const Sparse_Matrix & K, const std::vector<unsigned> & Block_Start, const std::vector<double> & Near_Null_Space) {
+  /* Function description:
+  This function builds the smoothed aggregation hierarchy for K. Level 0 is
+  K itself (with both triangles stored). Each coarser level is made by
+  Aggregate and Galerkin_Product. */
+
+  /* Assumption 1:
+  This function assumes that the blocks cover every row of K (in order) and
+  that there is at least one near null space vector. */
+  const unsigned n = K.Get_Num_Rows();
+  const unsigned Num_Blocks = (Block_Start.size() < 2) ? 0 : (unsigned)Block_Start.size() - 1;
+  const unsigned Num_Modes = (n == 0) ? 0 : (unsigned)(Near_Null_Space.size()/n);
+
+  bool Blocks_OK = (Num_Blocks > 0 && Block_Start[0] == 0 && Block_Start[Num_Blocks] == n);
+  for(unsigned Block = 0; Blocks_OK == true && Block < Num_Blocks; Block++) {
+    if(Block_Start[Block + 1] <= Block_Start[Block]) { Blocks_OK = false; }
+  } // for(unsigned Block = 0; Blocks_OK == true && Block < Num_Blocks; Block++) {
+
+  if(K.Get_Pattern_Set() == false || Blocks_OK == false || Num_Modes == 0 || Near_Null_Space.size() != (size_t)n*Num_Modes) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Solver Not Set Up Exception: Thrown by Multigrid::Setup\n"
+            "The blocks must cover the %u rows of K (in order) and the near null space\n"
+            "must have n by Num_Modes components (it has %u).\n",
+            n, (unsigned)Near_Null_Space.size());
+    throw Solver_Not_Set_Up(Error_Message_Buffer);
+  } // if(K.Get_Pattern_Set() == false || Blocks_OK == false || Num_Modes == 0 || ...
+
+  Set_Finest_Level(K);
+
+  std::vector<unsigned> Level_Block_Start = Block_Start;
+  std::vector<double> B = Near_Null_Space;
+  while(Levels.size() < MAX_LEVELS && Aggregate(Level_Block_Start, B, Num_Modes) == true) { Galerkin_Product(); }
+
+  Finish_Setup();
+} // void Multigrid::Setup(const Sparse_Matrix & K, const std::vector<unsigned> & Block_Start, const std::vector<double> & Near_Null_Space) {
+
+
+
+void Multigrid::Set_Finest_Level(const Sparse_Matrix & K) {
+  /* Function description:
+  K only stores its upper triangle, so every off-diagonal component K(i,j)
+  goes into rows i and j of A. We cycle through the rows in order, so each row
+  of A gets its lower triangle (in order), then its diagonal, then its upper
+  triangle (in order). Thus, the columns of each row are sorted. */
+  const unsigned n = K.Get_Num_Rows();
+
+  Levels.clear();
+  Levels.emplace_back();
+  Level & Fine = Levels[0];
+  Fine.n = n;
+
+  const int* IA = K.Get_IA();
+  const int* JA = K.Get_JA();
+  const double* K_A = K.Get_A();
+
+  Fine.A_Start.assign(n + 1, 0);
+  for(unsigned i = 0; i < n; i++) {
+    for(int k = IA[i]; k < IA[i+1]; k++) {
+      Fine.A_Start[i + 1]++;
+      if((unsigned)JA[k] != i) { Fine.A_Start[JA[k] + 1]++; }
+    } // for(int k = IA[i]; k < IA[i+1]; k++) {
+  } // for(unsigned i = 0; i < n; i++) {
+  for(unsigned i = 0; i < n; i++) { Fine.A_Start[i + 1] += Fine.A_Start[i]; }
+
+  Fine.A_Col.resize(Fine.A_Start[n]);
+  Fine.A_Val.resize(Fine.A_Start[n]);
+  std::vector<int> Next(Fine.A_Start.begin(), Fine.A_Start.end() - 1);
+  for(unsigned i = 0; i < n; i++) {
+    for(int k = IA[i]; k < IA[i+1]; k++) {
+      const unsigned j = (unsigned)JA[k];
+      Fine.A_Col[Next[i]] = j;
+      Fine.A_Val[Next[i]] = K_A[k];
+      Next[i]++;
+
+      if(j != i) {
+        Fine.A_Col[Next[j]] = i;
+        Fine.A_Val[Next[j]] = K_A[k];
+        Next[j]++;
+      } // if(j != i) {
+    } // for(int k = IA[i]; k < IA[i+1]; k++) {
+  } // for(unsigned i = 0; i < n; i++) {
+
+  Fine.Diag.resize(n);
+  for(unsigned i = 0; i < n; i++) { Fine.Diag[i] = K_A[IA[i]]; }
+} // void Multigrid::Set_Finest_Level(const Sparse_Matrix & K) {
+
+
+
+void Multigrid::Finish_Setup(void) {
+  for(unsigned l = 0; l < Levels.size(); l++) {
+    Color_Chunks(Levels[l].n, Levels[l].A_Start, Levels[l].A_Col, Levels[l].Color_Start, Levels[l].Color_Chunks);
+
+    Levels[l].r.resize(Levels[l].n);
+    Levels[l].b.resize(Levels[l].n);
+    Levels[l].x.resize(Levels[l].n);
+  } // for(unsigned l = 0; l < Levels.size(); l++) {
+
+  Factor_Coarsest();
+
+  #if defined(MULTIGRID_MONITOR)
+    for(unsigned l = 0; l < Levels.size(); l++) {
+      printf("Multigrid level %u: %8u equations, %10u stored components, %3u colors\n",
+             l, Levels[l].n, (unsigned)Levels[l].A_Col.size(), (unsigned)Levels[l].Color_Start.size() - 1);
+    } // for(unsigned l = 0; l < Levels.size(); l++) {
+  #endif
+} // void Multigrid::Finish_Setup(void) {
+
+
+
+void Multigrid::Apply(const double* r, double* z) {
+  /* Assumption 1:
+  This function assumes that the hierarchy has been built. */
+  if(Levels.size() == 0) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Solver Not Set Up Exception: Thrown by Multigrid::Apply\n"
+            "Setup must be run before the multigrid preconditioner can be applied.\n");
+    throw Solver_Not_Set_Up(Error_Message_Buffer);
+  } // if(Levels.size() == 0) {
+
+  Level & Fine = Levels[0];
+  #pragma omp parallel for schedule(static) if(Fine.n >= MIN_PARALLEL_EQ)
+  for(unsigned i = 0; i < Fine.n; i++) { Fine.b[i] = r[i]; }
+
+  V_Cycle(0);
+
+  #pragma omp parallel for schedule(static) if(Fine.n >= MIN_PARALLEL_EQ)
+  for(unsigned i = 0; i < Fine.n; i++) { z[i] = Fine.x[i]; }
+} // void Multigrid::Apply(const double* r, double* z) {
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Building the hierarchy
+
+bool Multigrid::Coarsen(void) {
+  /* Function description:
+  This function builds the grid of the next coarser level and the
+  interpolation operator, P, from that level to the current coarsest level.
+
+  The coarse lattice point (I,J,K) is the fine lattice point (2I,2J,2K). A
+  component of a coarse point is free if it is free at the fine point. A fine
+  point (i,j,k) lies in the coarse brick whose lowest corner is
+  (floor(i/2), floor(j/2), floor(k/2)). Its interpolation weights are the
+  values of that brick's (trilinear) shape functions at the fine point. Each
+  coordinate of a fine point in the coarse brick's master element is -1, 0, or
+  1, so each shape function is a product of 1D weights: an even fine index i
+  gets weight 1 from coarse index i/2, while an odd one gets weight 1/2 from
+  each of (i-1)/2 and (i+1)/2. Fixed coarse components are dropped (they are
+  zero in the correction). */
+  Level & Fine = Levels.back();
+  const Structured_Grid & F = Fine.Grid;
+
+  if(F.Nx < 2 || F.Ny < 2 || F.Nz < 2) { return false; }
+  if(F.Nx % 2 != 0 || F.Ny % 2 != 0 || F.Nz % 2 != 0) { return false; }
+  if(Fine.n <= MIN_COARSEN_EQ) { return false; }
+
+  Structured_Grid C;
+  C.Nx = F.Nx/2;
+  C.Ny = F.Ny/2;
+  C.Nz = F.Nz/2;
+  C.Eq.assign(3*(C.Nx + 1)*(C.Ny + 1)*(C.Nz + 1), -1);
+
+  int n_Coarse = 0;
+  for(unsigned I = 0; I <= C.Nx; I++) {
+    for(unsigned J = 0; J <= C.Ny; J++) {
+      for(unsigned K = 0; K <= C.Nz; K++) {
+        const unsigned Coarse_Point = (C.Ny + 1)*(C.Nz + 1)*I + (C.Nz + 1)*J + K;
+        const unsigned Fine_Point = (F.Ny + 1)*(F.Nz + 1)*(2*I) + (F.Nz + 1)*(2*J) + (2*K);
+
+        for(unsigned Comp = 0; Comp < 3; Comp++) {
+          if(F.Eq[3*Fine_Point + Comp] != -1) {
+            C.Eq[3*Coarse_Point + Comp] = n_Coarse;
+            n_Coarse++;
+          } // if(F.Eq[3*Fine_Point + Comp] != -1) {
+        } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+      } // for(unsigned K = 0; K <= C.Nz; K++) {
+    } // for(unsigned J = 0; J <= C.Ny; J++) {
+  } // for(unsigned I = 0; I <= C.Nx; I++) {
+
+  if(n_Coarse == 0) { return false; }
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Build P. We visit each fine point twice: once to count the entries of
+  each row and once to fill them in. */
+  Fine.P_Start.assign(Fine.n + 1, 0);
+
+  for(unsigned Pass = 0; Pass < 2; Pass++) {
+    std::vector<int> Next;
+    if(Pass == 1) {
+      for(unsigned i = 0; i < Fine.n; i++) { Fine.P_Start[i + 1] += Fine.P_Start[i]; }
+      Fine.P_Col.resize(Fine.P_Start[Fine.n]);
+      Fine.P_Val.resize(Fine.P_Start[Fine.n]);
+      Next.assign(Fine.P_Start.begin(), Fine.P_Start.end() - 1);
+    } // if(Pass == 1) {
+
+    for(unsigned i = 0; i <= F.Nx; i++) {
+      for(unsigned j = 0; j <= F.Ny; j++) {
+        for(unsigned k = 0; k <= F.Nz; k++) {
+          const unsigned Fine_Point = (F.Ny + 1)*(F.Nz + 1)*i + (F.Nz + 1)*j + k;
+
+          /* 1D weights in each direction. (i%2 == 0) means that this fine
+          point lines up with a coarse point in the x direction. */
+          const unsigned Num_x = (i % 2 == 0) ? 1 : 2;
+          const unsigned Num_y = (j % 2 == 0) ? 1 : 2;
+          const unsigned Num_z = (k % 2 == 0) ? 1 : 2;
+          const double w_x = 1./Num_x, w_y = 1./Num_y, w_z = 1./Num_z;
+
+          for(unsigned Comp = 0; Comp < 3; Comp++) {
+            const int Row = F.Eq[3*Fine_Point + Comp];
+            if(Row == -1) { continue; }
+
+            for(unsigned a = 0; a < Num_x; a++) {
+              for(unsigned b = 0; b < Num_y; b++) {
+                for(unsigned c = 0; c < Num_z; c++) {
+                  const unsigned I = i/2 + a, J = j/2 + b, K = k/2 + c;
+                  const int Col = C.Eq[3*((C.Ny + 1)*(C.Nz + 1)*I + (C.Nz + 1)*J + K) + Comp];
+                  if(Col == -1) { continue; }
+
+                  if(Pass == 0) { Fine.P_Start[Row + 1]++; }
+                  else {
+                    Fine.P_Col[Next[Row]] = Col;
+                    Fine.P_Val[Next[Row]] = w_x*w_y*w_z;
+                    Next[Row]++;
+                  } // else {
+                } // for(unsigned c = 0; c < Num_z; c++) {
+              } // for(unsigned b = 0; b < Num_y; b++) {
+            } // for(unsigned a = 0; a < Num_x; a++) {
+          } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+        } // for(unsigned k = 0; k <= F.Nz; k++) {
+      } // for(unsigned j = 0; j <= F.Ny; j++) {
+    } // for(unsigned i = 0; i <= F.Nx; i++) {
+  } // for(unsigned Pass = 0; Pass < 2; Pass++) {
+
+  /* Note: Levels.emplace_back may move the existing levels, so we can't use
+  Fine (or F) after this. */
+  Levels.emplace_back();
+  Levels.back().Grid = C;
+  Levels.back().n = (unsigned)n_Coarse;
+
+  return true;
+} // bool Multigrid::Coarsen(void) {
+
+
+
+bool Multigrid::Aggregate(std::vector<unsigned> & Block_Start, std::vector<double> & B, const unsigned Num_Modes) {
+  /* Function description:
+  This function builds the smoothed aggregation P of Levels.back() and adds
+  the next coarser level. This happens in four steps:
+    (1) Find the strongly coupled pairs of blocks.
+    (2) Group the blocks into aggregates.
+    (3) Build the tentative P: restrict B to each aggregate and orthonormalize
+        it (B_Aggregate = Q R). Q's columns are the aggregate's columns of
+        the tentative P, and R is the aggregate's block of the coarse B.
+    (4) Smooth the tentative P: P = (I - omega D^(-1) A) P_Tentative, where
+        omega = (4/3)/rho(D^(-1) A). */
+  Level & Fine = Levels.back();
+  const unsigned n = Fine.n;
+  const unsigned Num_Blocks = (unsigned)Block_Start.size() - 1;
+
+  if(n <= MIN_COARSEN_EQ) { return false; }
+
+  std::vector<unsigned> Eq_Block(n);
+  for(unsigned Block = 0; Block < Num_Blocks; Block++) {
+    for(unsigned i = Block_Start[Block]; i < Block_Start[Block + 1]; i++) { Eq_Block[i] = Block; }
+  } // for(unsigned Block = 0; Block < Num_Blocks; Block++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* (1) Strength of connection. Block_Norm[J] (||A_IJ||^2) is accumulated
+  one block row (I) at a time. The strong neighbors of block I are
+  Strong_Col[Strong_Start[I]], ... , Strong_Col[Strong_Start[I+1] - 1].
+  The block rows are independent, so the threads split them up (each thread
+  has its own Block_Norm, Marker, and Row_Blocks). We go through the block rows
+  twice: once to count each block's strong neighbors and once to store them. */
+  const double Theta = STRENGTH_THRESHOLD*pow(0.5, (double)(Levels.size() - 1));
+
+  std::vector<double> Diag_Norm(Num_Blocks, 0);
+  #pragma omp parallel for schedule(static)
+  for(unsigned I = 0; I < Num_Blocks; I++) {
+    double Norm = 0;
+    for(unsigned i = Block_Start[I]; i < Block_Start[I + 1]; i++) {
+      for(int k = Fine.A_Start[i]; k < Fine.A_Start[i+1]; k++) {
+        if(Eq_Block[Fine.A_Col[k]] == I) { Norm += Fine.A_Val[k]*Fine.A_Val[k]; }
+      } // for(int k = Fine.A_Start[i]; k < Fine.A_Start[i+1]; k++) {
+    } // for(unsigned i = Block_Start[I]; i < Block_Start[I + 1]; i++) {
+    Diag_Norm[I] = sqrt(Norm);
+  } // for(unsigned I = 0; I < Num_Blocks; I++) {
+
+  std::vector<unsigned> Strong_Start(Num_Blocks + 1, 0);
+  std::vector<unsigned> Strong_Col;
+  std::vector<double> Strong_Val;
+
+  for(unsigned Pass = 0; Pass < 2; Pass++) {
+    if(Pass == 1) {
+      for(unsigned I = 0; I < Num_Blocks; I++) { Strong_Start[I + 1] += Strong_Start[I]; }
+      Strong_Col.resize(Strong_Start[Num_Blocks]);
+      Strong_Val.resize(Strong_Start[Num_Blocks]);
+    } // if(Pass == 1) {
+
+    #pragma omp parallel
+    {
+      std::vector<double> Block_Norm(Num_Blocks, 0);
+      std::vector<int> Marker(Num_Blocks, -1);
+      std::vector<unsigned> Row_Blocks;
+
+      #pragma omp for schedule(dynamic, 256)
+      for(unsigned I = 0; I < Num_Blocks; I++) {
+        Row_Blocks.clear();
+        for(unsigned i = Block_Start[I]; i < Block_Start[I + 1]; i++) {
+          for(int k = Fine.A_Start[i]; k < Fine.A_Start[i+1]; k++) {
+            const unsigned J = Eq_Block[Fine.A_Col[k]];
+            if(Marker[J] != (int)I) {
+              Marker[J] = (int)I;
+              Block_Norm[J] = 0;
+              Row_Blocks.push_back(J);
+            } // if(Marker[J] != (int)I) {
+            Block_Norm[J] += Fine.A_Val[k]*Fine.A_Val[k];
+          } // for(int k = Fine.A_Start[i]; k < Fine.A_Start[i+1]; k++) {
+        } // for(unsigned i = Block_Start[I]; i < Block_Start[I + 1]; i++) {
+
+        unsigned Next = (Pass == 0) ? 0 : Strong_Start[I];
+        for(unsigned J : Row_Blocks) {
+          if(J != I && Block_Norm[J] > Theta*Theta*Diag_Norm[I]*Diag_Norm[J]) {
+            if(Pass == 1) {
+              Strong_Col[Next] = J;
+              Strong_Val[Next] = Block_Norm[J];
+            } // if(Pass == 1) {
+            Next++;
+          } // if(J != I && Block_Norm[J] > Theta*Theta*Diag_Norm[I]*Diag_Norm[J]) {
+        } // for(unsigned J : Row_Blocks) {
+        if(Pass == 0) { Strong_Start[I + 1] = Next; }
+      } // for(unsigned I = 0; I < Num_Blocks; I++) {
+    } // #pragma omp parallel
+  } // for(unsigned Pass = 0; Pass < 2; Pass++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* (2) Aggregation.
+    Phase 1: If none of a block's strong neighbors have been aggregated, then
+    the block and its strong neighbors become a new aggregate.
+    Phase 2: Every remaining block joins the (phase 1) aggregate of its most
+    strongly coupled neighbor (if it has one).
+    Phase 3: Every remaining block and its remaining strong neighbors become a
+    new aggregate.
+  Phases 1 and 3 are serial: whether a block starts an aggregate depends on
+  the blocks before it. They're single passes over the strong neighbors,
+  which is cheap next to the rest of the setup. */
+  const int NO_AGGREGATE = -1;
+  std::vector<int> Block_Aggregate(Num_Blocks, NO_AGGREGATE);
+  unsigned Num_Aggregates = 0;
+
+  for(unsigned I = 0; I < Num_Blocks; I++) {
+    if(Block_Aggregate[I] != NO_AGGREGATE) { continue; }
+
+    bool Neighbor_Aggregated = false;
+    for(unsigned k = Strong_Start[I]; k < Strong_Start[I+1]; k++) {
+      if(Block_Aggregate[Strong_Col[k]] != NO_AGGREGATE) { Neighbor_Aggregated = true; break; }
+    } // for(unsigned k = Strong_Start[I]; k < Strong_Start[I+1]; k++) {
+    if(Neighbor_Aggregated == true) { continue; }
+
+    Block_Aggregate[I] = (int)Num_Aggregates;
+    for(unsigned k = Strong_Start[I]; k < Strong_Start[I+1]; k++) { Block_Aggregate[Strong_Col[k]] = (int)Num_Aggregates; }
+    Num_Aggregates++;
+  } // for(unsigned I = 0; I < Num_Blocks; I++) {
+
+  const std::vector<int> Phase_1_Aggregate = Block_Aggregate;
+  for(unsigned I = 0; I < Num_Blocks; I++) {
+    if(Block_Aggregate[I] != NO_AGGREGATE) { continue; }
+
+    double Strongest = 0;
+    for(unsigned k = Strong_Start[I]; k < Strong_Start[I+1]; k++) {
+      if(Phase_1_Aggregate[Strong_Col[k]] != NO_AGGREGATE && Strong_Val[k] > Strongest) {
+        Strongest = Strong_Val[k];
+        Block_Aggregate[I] = Phase_1_Aggregate[Strong_Col[k]];
+      } // if(Phase_1_Aggregate[Strong_Col[k]] != NO_AGGREGATE && Strong_Val[k] > Strongest) {
+    } // for(unsigned k = Strong_Start[I]; k < Strong_Start[I+1]; k++) {
+  } // for(unsigned I = 0; I < Num_Blocks; I++) {
+
+  for(unsigned I = 0; I < Num_Blocks; I++) {
+    if(Block_Aggregate[I] != NO_AGGREGATE) { continue; }
+
+    Block_Aggregate[I] = (int)Num_Aggregates;
+    for(unsigned k = Strong_Start[I]; k < Strong_Start[I+1]; k++) {
+      if(Block_Aggregate[Strong_Col[k]] == NO_AGGREGATE) { Block_Aggregate[Strong_Col[k]] = (int)Num_Aggregates; }
+    } // for(unsigned k = Strong_Start[I]; k < Strong_Start[I+1]; k++) {
+    Num_Aggregates++;
+  } // for(unsigned I = 0; I < Num_Blocks; I++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* (3) Tentative P. The equations of aggregate a are
+  Aggregate_Eq[Aggregate_Start[a]], ... , Aggregate_Eq[Aggregate_Start[a+1] - 1].
+  We orthonormalize B's columns on each aggregate using modified Gram-Schmidt.
+  A column that is (numerically) a combination of the previous ones is
+  dropped, so an aggregate with fewer equations than Num_Modes gets fewer
+  coarse equations. Q holds the orthonormal columns (n by Num_Modes, row
+  major, only the first Aggregate_Rank[a] columns of each row are used). The
+  coarse block of aggregate a is its Aggregate_Rank[a] coarse equations, and
+  row q of its R (Num_Modes by Num_Modes, row major, starting at
+  Aggregate_R[Num_Modes*Num_Modes*a]) is a row of the coarse B. The
+  aggregates don't share equations, so the threads split them up. */
+  std::vector<unsigned> Aggregate_Start(Num_Aggregates + 1, 0);
+  for(unsigned i = 0; i < n; i++) { Aggregate_Start[Block_Aggregate[Eq_Block[i]] + 1]++; }
+  for(unsigned a = 0; a < Num_Aggregates; a++) { Aggregate_Start[a + 1] += Aggregate_Start[a]; }
+
+  std::vector<unsigned> Aggregate_Eq(n);
+  {
+    std::vector<unsigned> Next(Aggregate_Start.begin(), Aggregate_Start.end() - 1);
+    for(unsigned i = 0; i < n; i++) { Aggregate_Eq[Next[Block_Aggregate[Eq_Block[i]]]++] = i; }
+  }
+
+  std::vector<double> Q((size_t)n*Num_Modes, 0);
+  std::vector<unsigned> Aggregate_Rank(Num_Aggregates, 0);
+  std::vector<double> Aggregate_R((size_t)Num_Aggregates*Num_Modes*Num_Modes, 0);
+
+  #pragma omp parallel
+  {
+    std::vector<double> R_Column(Num_Modes);
+
+    #pragma omp for schedule(dynamic, 64)
+    for(unsigned a = 0; a < Num_Aggregates; a++) {
+      double* R = &Aggregate_R[(size_t)Num_Modes*Num_Modes*a];
+      unsigned Rank = 0;
+
+      for(unsigned c = 0; c < Num_Modes; c++) {
+        // v = column c of B (on this aggregate). It's stored in column Rank of Q.
+        double Original_Norm = 0;
+        for(unsigned k = Aggregate_Start[a]; k < Aggregate_Start[a+1]; k++) {
+          const unsigned i = Aggregate_Eq[k];
+          Q[(size_t)Num_Modes*i + Rank] = B[(size_t)n*c + i];
+          Original_Norm += B[(size_t)n*c + i]*B[(size_t)n*c + i];
+        } // for(unsigned k = Aggregate_Start[a]; k < Aggregate_Start[a+1]; k++) {
+        Original_Norm = sqrt(Original_Norm);
+
+        // Remove the components of v along the previous columns of Q.
+        for(unsigned q = 0; q < Rank; q++) {
+          double R_qc = 0;
+          for(unsigned k = Aggregate_Start[a]; k < Aggregate_Start[a+1]; k++) {
+            const unsigned i = Aggregate_Eq[k];
+            R_qc += Q[(size_t)Num_Modes*i + q]*Q[(size_t)Num_Modes*i + Rank];
+          } // for(unsigned k = Aggregate_Start[a]; k < Aggregate_Start[a+1]; k++) {
+
+          for(unsigned k = Aggregate_Start[a]; k < Aggregate_Start[a+1]; k++) {
+            const unsigned i = Aggregate_Eq[k];
+            Q[(size_t)Num_Modes*i + Rank] -= R_qc*Q[(size_t)Num_Modes*i + q];
+          } // for(unsigned k = Aggregate_Start[a]; k < Aggregate_Start[a+1]; k++) {
+
+          R_Column[q] = R_qc;
+        } // for(unsigned q = 0; q < Rank; q++) {
+
+        double Norm = 0;
+        for(unsigned k = Aggregate_Start[a]; k < Aggregate_Start[a+1]; k++) {
+          const unsigned i = Aggregate_Eq[k];
+          Norm += Q[(size_t)Num_Modes*i + Rank]*Q[(size_t)Num_Modes*i + Rank];
+        } // for(unsigned k = Aggregate_Start[a]; k < Aggregate_Start[a+1]; k++) {
+        Norm = sqrt(Norm);
+
+        /* Keep v if it isn't (numerically) a combination of the previous
+        columns. Column c of R is R_Column (its rows past Rank are zero). */
+        const bool Keep = (Norm > 1e-10*Original_Norm && Norm > 0);
+        if(Keep == true) {
+          for(unsigned k = Aggregate_Start[a]; k < Aggregate_Start[a+1]; k++) { Q[(size_t)Num_Modes*Aggregate_Eq[k] + Rank] /= Norm; }
+          R_Column[Rank] = Norm;
+          Rank++;
+        } // if(Keep == true) {
+
+        for(unsigned q = 0; q < Rank; q++) { R[(size_t)Num_Modes*q + c] = R_Column[q]; }
+      } // for(unsigned c = 0; c < Num_Modes; c++) {
+
+      Aggregate_Rank[a] = Rank;
+    } // for(unsigned a = 0; a < Num_Aggregates; a++) {
+  } // #pragma omp parallel
+
+  std::vector<unsigned> Coarse_Block_Start(Num_Aggregates + 1, 0);
+  for(unsigned a = 0; a < Num_Aggregates; a++) { Coarse_Block_Start[a + 1] = Coarse_Block_Start[a] + Aggregate_Rank[a]; }
+
+  const unsigned n_Coarse = Coarse_Block_Start[Num_Aggregates];
+  if(n_Coarse == 0 || n_Coarse > MAX_COARSE_RATIO*n) { return false; }
+
+  // Row i of the tentative P has its aggregate's Aggregate_Rank[a] columns.
+  std::vector<int> PT_Start(n + 1, 0);
+  for(unsigned i = 0; i < n; i++) { PT_Start[i + 1] = PT_Start[i] + (int)Aggregate_Rank[Block_Aggregate[Eq_Block[i]]]; }
+
+  std::vector<int> PT_Col(PT_Start[n]);
+  std::vector<double> PT_Val(PT_Start[n]);
+  #pragma omp parallel for schedule(static)
+  for(unsigned i = 0; i < n; i++) {
+    const unsigned a = (unsigned)Block_Aggregate[Eq_Block[i]];
+    for(unsigned q = 0; q < Aggregate_Rank[a]; q++) {
+      PT_Col[PT_Start[i] + q] = (int)(Coarse_Block_Start[a] + q);
+      PT_Val[PT_Start[i] + q] = Q[(size_t)Num_Modes*i + q];
+    } // for(unsigned q = 0; q < Aggregate_Rank[a]; q++) {
+  } // for(unsigned i = 0; i < n; i++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* (4) Smooth the tentative P (PT above). We estimate rho(D^(-1) A) with a
+  few steps of the power method. */
+  std::vector<double> v(n), w(n);
+  for(unsigned i = 0; i < n; i++) { v[i] = 1. + sin((double)i); }
+
+  double rho = 0;
+  for(unsigned Iteration = 0; Iteration < 20; Iteration++) {
+    #pragma omp parallel for schedule(static)
+    for(unsigned i = 0; i < n; i++) {
+      double w_i = 0;
+      for(int k = Fine.A_Start[i]; k < Fine.A_Start[i+1]; k++) { w_i += Fine.A_Val[k]*v[Fine.A_Col[k]]; }
+      w[i] = w_i/Fine.Diag[i];
+    } // for(unsigned i = 0; i < n; i++) {
+
+    // The norms are summed in order so that P doesn't depend on the number of threads.
+    double v_Norm = 0, w_Norm = 0;
+    for(unsigned i = 0; i < n; i++) {
+      v_Norm += v[i]*v[i];
+      w_Norm += w[i]*w[i];
+    } // for(unsigned i = 0; i < n; i++) {
+
+    if(w_Norm == 0) { break; }
+    rho = sqrt(w_Norm/v_Norm);
+    #pragma omp parallel for schedule(static)
+    for(unsigned i = 0; i < n; i++) { v[i] = w[i]/sqrt(w_Norm); }
+  } // for(unsigned Iteration = 0; Iteration < 20; Iteration++) {
+
+  const double omega = (rho > 0) ? (4./3.)/rho : 0;
+
+  /* P = PT - omega D^(-1) (A PT). Every column of row i of PT is also a
+  column of row i of A PT (A has a diagonal), so P has the pattern of A PT. */
+  std::vector<int> APT_Start, APT_Col;
+  std::vector<double> APT_Val;
+  CSR_Multiply(n, n_Coarse, Fine.A_Start, Fine.A_Col, Fine.A_Val, PT_Start, PT_Col, PT_Val, APT_Start, APT_Col, APT_Val);
+
+  Fine.P_Start = APT_Start;
+  Fine.P_Col = APT_Col;
+  Fine.P_Val.resize(APT_Val.size());
+  #pragma omp parallel for schedule(static)
+  for(unsigned i = 0; i < n; i++) {
+    int p = PT_Start[i];
+    for(int k = APT_Start[i]; k < APT_Start[i+1]; k++) {
+      double P_ik = -omega*APT_Val[k]/Fine.Diag[i];
+      if(p < PT_Start[i+1] && PT_Col[p] == APT_Col[k]) { P_ik += PT_Val[p]; p++; }
+      Fine.P_Val[k] = P_ik;
+    } // for(int k = APT_Start[i]; k < APT_Start[i+1]; k++) {
+  } // for(unsigned i = 0; i < n; i++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Add the coarse level and move to its blocks and B. Note: emplace_back may
+  move the existing levels, so we can't use Fine after this. */
+  Levels.emplace_back();
+  Levels.back().n = n_Coarse;
+
+  Block_Start = Coarse_Block_Start;
+  B.assign((size_t)n_Coarse*Num_Modes, 0);
+  for(unsigned a = 0; a < Num_Aggregates; a++) {
+    for(unsigned q = 0; q < Aggregate_Rank[a]; q++) {
+      const unsigned I = Coarse_Block_Start[a] + q;
+      for(unsigned c = 0; c < Num_Modes; c++) { B[(size_t)n_Coarse*c + I] = Aggregate_R[(size_t)Num_Modes*Num_Modes*a + (size_t)Num_Modes*q + c]; }
+    } // for(unsigned q = 0; q < Aggregate_Rank[a]; q++) {
+  } // for(unsigned a = 0; a < Num_Aggregates; a++) {
+
+  return true;
+} // bool Multigrid::Aggregate(std::vector<unsigned> & Block_Start, std::vector<double> & B, const unsigned Num_Modes) {
+
+
+
+void Multigrid::Galerkin_Product(void) {
+  /* Function description:
+  This function computes A_Coarse = P^T (A P), where A and P belong to the
+  second to last level. We keep P^T as that level's R (for the V-cycle). */
+  Level & Fine = Levels[Levels.size() - 2];
+  Level & Coarse = Levels.back();
+
+  std::vector<int> AP_Start, AP_Col;
+  std::vector<double> AP_Val;
+  CSR_Multiply(Fine.n, Coarse.n, Fine.A_Start, Fine.A_Col, Fine.A_Val, Fine.P_Start, Fine.P_Col, Fine.P_Val, AP_Start, AP_Col, AP_Val);
+  CSR_Transpose(Fine.n, Coarse.n, Fine.P_Start, Fine.P_Col, Fine.P_Val, Fine.R_Start, Fine.R_Col, Fine.R_Val);
+  CSR_Multiply(Coarse.n, Coarse.n, Fine.R_Start, Fine.R_Col, Fine.R_Val, AP_Start, AP_Col, AP_Val, Coarse.A_Start, Coarse.A_Col, Coarse.A_Val);
+
+  Coarse.Diag.assign(Coarse.n, 0);
+  #pragma omp parallel for schedule(static)
+  for(unsigned I = 0; I < Coarse.n; I++) {
+    for(int k = Coarse.A_Start[I]; k < Coarse.A_Start[I+1]; k++) {
+      if(Coarse.A_Col[k] == (int)I) { Coarse.Diag[I] = Coarse.A_Val[k]; }
+    } // for(int k = Coarse.A_Start[I]; k < Coarse.A_Start[I+1]; k++) {
+  } // for(unsigned I = 0; I < Coarse.n; I++) {
+} // void Multigrid::Galerkin_Product(void) {
+
+
+
+void Multigrid::Factor_Coarsest(void) {
+  /* Function description:
+  This function computes the (dense) Cholesky factorization, L L^T, of the
+  coarsest A. If the coarsest level is too big, we skip this (and smooth on
+  the coarsest level instead, see V_Cycle). */
+  const Level & Coarse = Levels.back();
+  const unsigned n = Coarse.n;
+
+  Coarse_L.clear();
+  if(n > MAX_DIRECT_EQ) { return; }
+
+  Coarse_L.assign((size_t)n*n, 0);
+  for(unsigned i = 0; i < n; i++) {
+    for(int k = Coarse.A_Start[i]; k < Coarse.A_Start[i+1]; k++) {
+      const unsigned j = (unsigned)Coarse.A_Col[k];
+      if(j <= i) { Coarse_L[(size_t)n*i + j] = Coarse.A_Val[k]; }
+    } // for(int k = Coarse.A_Start[i]; k < Coarse.A_Start[i+1]; k++) {
+  } // for(unsigned i = 0; i < n; i++) {
+
+  for(unsigned j = 0; j < n; j++) {
+    double L_jj = Coarse_L[(size_t)n*j + j];
+    for(unsigned k = 0; k < j; k++) { L_jj -= Coarse_L[(size_t)n*j + k]*Coarse_L[(size_t)n*j + k]; }
+
+    if(L_jj <= 0) {
+      char Error_Message_Buffer[500];
+      sprintf(Error_Message_Buffer,
+              "Solver Failed Exception: Thrown by Multigrid::Factor_Coarsest\n"
+              "The coarsest level's matrix is not positive definite (pivot %u is %e).\n",
+              j, L_jj);
+      throw Solver_Failed(Error_Message_Buffer);
+    } // if(L_jj <= 0) {
+
+    L_jj = sqrt(L_jj);
+    Coarse_L[(size_t)n*j + j] = L_jj;
+
+    #pragma omp parallel for schedule(static) if(n - j >= MIN_PARALLEL_CHOLESKY_ROWS)
+    for(unsigned i = j + 1; i < n; i++) {
+      double L_ij = Coarse_L[(size_t)n*i + j];
+      for(unsigned k = 0; k < j; k++) { L_ij -= Coarse_L[(size_t)n*i + k]*Coarse_L[(size_t)n*j + k]; }
+      Coarse_L[(size_t)n*i + j] = L_ij/L_jj;
+    } // for(unsigned i = j + 1; i < n; i++) {
+  } // for(unsigned j = 0; j < n; j++) {
+} // void Multigrid::Factor_Coarsest(void) {
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// V-cycle
+
+void Multigrid::Solve_Coarsest(const double* b, double* x) const {
+  /* Solve L L^T x = b (forward, then backward substitution). */
+  const unsigned n = Levels.back().n;
+
+  for(unsigned i = 0; i < n; i++) {
+    double s = b[i];
+    for(unsigned k = 0; k < i; k++) { s -= Coarse_L[(size_t)n*i + k]*x[k]; }
+    x[i] = s/Coarse_L[(size_t)n*i + i];
+  } // for(unsigned i = 0; i < n; i++) {
+
+  for(unsigned ii = n; ii > 0; ii--) {
+    const unsigned i = ii - 1;
+    double s = x[i];
+    for(unsigned k = i + 1; k < n; k++) { s -= Coarse_L[(size_t)n*k + i]*x[k]; }
+    x[i] = s/Coarse_L[(size_t)n*i + i];
+  } // for(unsigned ii = n; ii > 0; ii--) {
+} // void Multigrid::Solve_Coarsest(const double* b, double* x) const {
+
+
+
+void Multigrid::Gauss_Seidel(Level & L, const bool Forward) const {
+  /* x_i = (b_i - sum over j != i of A(i,j)*x_j) / A(i,i), for each row i. We
+  visit the colors in order (and the rows of each chunk in order) if Forward
+  is true, in reverse order otherwise. The chunks of one color aren't coupled
+  (none of them reads another's x_i), so we update them all at once. Since
+  every row still sees the latest x_j of every row it's coupled to, this is
+  Gauss-Seidel with the rows in a different order (and the backward sweep
+  visits them in exactly the reverse order). */
+  const unsigned Num_Colors = (unsigned)L.Color_Start.size() - 1;
+
+  #pragma omp parallel if(L.n >= MIN_PARALLEL_EQ)
+  {
+    for(unsigned cc = 0; cc < Num_Colors; cc++) {
+      const unsigned Color = Forward ? cc : Num_Colors - 1 - cc;
+
+      #pragma omp for schedule(static)
+      for(unsigned k = L.Color_Start[Color]; k < L.Color_Start[Color+1]; k++) {
+        const unsigned Row_Begin = L.Color_Chunks[k]*GS_CHUNK_ROWS;
+        const unsigned Num_Rows = std::min(L.n - Row_Begin, GS_CHUNK_ROWS);
+
+        for(unsigned ii = 0; ii < Num_Rows; ii++) {
+          const unsigned i = Forward ? Row_Begin + ii : Row_Begin + Num_Rows - 1 - ii;
+
+          double s = L.b[i];
+          for(int p = L.A_Start[i]; p < L.A_Start[i+1]; p++) {
+            const unsigned j = (unsigned)L.A_Col[p];
+            if(j != i) { s -= L.A_Val[p]*L.x[j]; }
+          } // for(int p = L.A_Start[i]; p < L.A_Start[i+1]; p++) {
+
+          L.x[i] = s/L.Diag[i];
+        } // for(unsigned ii = 0; ii < Num_Rows; ii++) {
+      } // for(unsigned k = L.Color_Start[Color]; k < L.Color_Start[Color+1]; k++) {
+    } // for(unsigned cc = 0; cc < Num_Colors; cc++) {
+  } // #pragma omp parallel if(L.n >= MIN_PARALLEL_EQ)
+} // void Multigrid::Gauss_Seidel(Level & L, const bool Forward) const {
+
+
+
+void Multigrid::V_Cycle(const unsigned l) {
+  Level & L = Levels[l];
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Coarsest level: solve exactly (if we can). Otherwise, run some extra
+  symmetric Gauss-Seidel sweeps. */
+  if(l == Levels.size() - 1) {
+    if(Coarse_L.size() != 0) { Solve_Coarsest(L.b.data(), L.x.data()); }
+    else {
+      #pragma omp parallel for schedule(static) if(L.n >= MIN_PARALLEL_EQ)
+      for(unsigned i = 0; i < L.n; i++) { L.x[i] = 0; }
+      for(unsigned s = 0; s < 10*Num_Sweeps; s++) {
+        Gauss_Seidel(L, true);
+        Gauss_Seidel(L, false);
+      } // for(unsigned s = 0; s < 10*Num_Sweeps; s++) {
+    } // else {
+
+    return;
+  } // if(l == Levels.size() - 1) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Pre-smoothing (starting from x = 0)
+  #pragma omp parallel for schedule(static) if(L.n >= MIN_PARALLEL_EQ)
+  for(unsigned i = 0; i < L.n; i++) { L.x[i] = 0; }
+  for(unsigned s = 0; s < Num_Sweeps; s++) { Gauss_Seidel(L, true); }
+
+  // Restrict the residual: b_Coarse = R (b - A x)
+  Level & Coarse = Levels[l + 1];
+  #pragma omp parallel for schedule(static) if(L.n >= MIN_PARALLEL_EQ)
+  for(unsigned i = 0; i < L.n; i++) {
+    double r_i = L.b[i];
+    for(int k = L.A_Start[i]; k < L.A_Start[i+1]; k++) { r_i -= L.A_Val[k]*L.x[L.A_Col[k]]; }
+    L.r[i] = r_i;
+  } // for(unsigned i = 0; i < L.n; i++) {
+
+  #pragma omp parallel for schedule(static) if(L.n >= MIN_PARALLEL_EQ)
+  for(unsigned I = 0; I < Coarse.n; I++) {
+    double b_I = 0;
+    for(int p = L.R_Start[I]; p < L.R_Start[I+1]; p++) { b_I += L.R_Val[p]*L.r[L.R_Col[p]]; }
+    Coarse.b[I] = b_I;
+  } // for(unsigned I = 0; I < Coarse.n; I++) {
+
+  // Coarse correction: x += P x_Coarse
+  V_Cycle(l + 1);
+  #pragma omp parallel for schedule(static) if(L.n >= MIN_PARALLEL_EQ)
+  for(unsigned i = 0; i < L.n; i++) {
+    for(int p = L.P_Start[i]; p < L.P_Start[i+1]; p++) { L.x[i] += L.P_Val[p]*Coarse.x[L.P_Col[p]]; }
+  } // for(unsigned i = 0; i < L.n; i++) {
+
+  // Post-smoothing (backward sweeps, so that the V-cycle is symmetric)
+  for(unsigned s = 0; s < Num_Sweeps; s++) { Gauss_Seidel(L, false); }
+} // void Multigrid::V_Cycle(const unsigned l) {
+
+#endif
@@ -0,0 +1,183 @@
+#if !defined(MULTIGRID_HEADER)
+#define MULTIGRID_HEADER
+
+//#define MULTIGRID_MONITOR              // Prints the size of each level
+
+#include <stdio.h>
+#include <vector>
+#include "Errors.h"
+#include "Sparse/Sparse_Matrix.h"
+
+/* Structured grid.
+A structured (brick) mesh is an Nx by Ny by Nz lattice of bricks. Its nodes
+are the (Nx+1)*(Ny+1)*(Nz+1) lattice points. Lattice point (i,j,k) has index
+    Point = (Ny+1)*(Nz+1)*i + (Nz+1)*j + k
+and Eq[3*Point + Comp] holds the global equation number of component Comp of
+that point's displacement (or -1 if that component is fixed). */
+struct Structured_Grid {
+  unsigned Nx = 0;
+  unsigned Ny = 0;
+  unsigned Nz = 0;
+  std::vector<int> Eq;
+}; // struct Structured_Grid {
+
+
+
+/* Multigrid preconditioner class.
+Jacobi and block Jacobi preconditioned CG need more and more iterations as
+the mesh is refined (they only smooth out errors that vary from node to node,
+while smooth errors take O(N) iterations to die out). Multigrid fixes this by
+correcting the smooth part of the error on coarser levels, where it is no
+longer smooth.
+
+Each level has its own version of K, A. P interpolates from the next coarser
+level to a level, and the coarse A is P^T A P (the Galerkin product). There
+are two ways to build P:
+
+Geometric (Setup with a Structured_Grid): Each coarse grid is made by
+agglomerating 2x2x2 bricks of the next finer grid into one brick (so every
+dimension of the finer grid must be even). The coarse grid's nodes are the
+even lattice points of the finer grid. P is trilinear interpolation, which
+evaluates the brick shape functions (see Set_Element_Static_Members) of each
+coarse brick at the fine nodes inside of it. We keep coarsening until a
+dimension becomes odd, the grid has a single brick in some direction, or the
+coarse grid has very few equations.
+
+Algebraic (Setup with a near null space): This works on any mesh (smoothed
+aggregation, see Vanek, Mandel, and Brezina, "Algebraic multigrid by smoothed
+aggregation for second and fourth order elliptic problems", Computing, 1996).
+The equations are grouped into blocks (one per node on the finest level). We
+group strongly coupled blocks into aggregates; each aggregate becomes a block
+of the next coarser level. The tentative P restricts the near null space (the
+vectors that K barely changes, for elasticity the rigid body modes) to each
+aggregate and orthonormalizes it, so that the coarse level can represent the
+near null space exactly. One Jacobi step then smooths the tentative P, which
+makes the coarse correction much more accurate. We keep coarsening until a
+level has few equations or stops shrinking.
+
+Apply runs one V-cycle: forward Gauss-Seidel sweeps on the way down, an exact
+(dense Cholesky) solve on the coarsest level, and backward Gauss-Seidel sweeps
+on the way up. This makes the preconditioner symmetric (which CG needs).
+
+The V-cycle runs in parallel (it's applied once per PCG iteration, and the rest
+of PCG is parallel too). The residual, restriction, and interpolation are row
+by row products (restriction uses R = P^T, which we store), so each thread
+gets its own rows. Gauss-Seidel is multicolored: each level's rows are split
+into chunks of consecutive rows, and the chunks are colored so that no two
+chunks of the same color are coupled. The chunks of one color can then be
+swept at the same time. A forward sweep runs through the colors in order and
+a backward sweep runs through them in reverse, so the V-cycle stays
+symmetric. The result doesn't depend on the number of threads. Only the
+coarsest level's (small) dense solve is serial.
+
+Most of Setup is parallel too: the sparse products (A P and P^T (A P)), the
+strength of connection, the tentative P (one aggregate per thread), and the
+Jacobi smoothing of P. Building aggregates is serial (whether a block starts a
+new aggregate depends on the blocks before it), as are the single passes that
+transpose P, color the chunks, and copy K into the finest level. */
+class Multigrid {
+  private:
+    /* A level of the hierarchy (level 0 is the finest).
+    A is this level's version of K. Unlike Sparse_Matrix, A stores both
+    triangles of each row (Gauss-Seidel needs every component of each row).
+    P interpolates from the next coarser level to this one (it has one row per
+    equation of this level and one column per equation of the coarser level).
+    P is empty on the coarsest level, and R is P^T. The chunks of rows of
+    color c are Color_Chunks[Color_Start[c]], ... ,
+    Color_Chunks[Color_Start[c+1] - 1] (see Gauss_Seidel). Grid is only used by geometric multigrid. r, b, x are
+    scratch space for the V-cycle. */
+    struct Level {
+      Structured_Grid Grid;
+      unsigned n = 0;                            // Number of equations
+
+      std::vector<int> A_Start;                  // CSR: row i is A_Col[A_Start[i]], ... , A_Col[A_Start[i+1] - 1]
+      std::vector<int> A_Col;
+      std::vector<double> A_Val;
+      std::vector<double> Diag;                  // Diagonal of A
+
+      std::vector<int> P_Start;                  // CSR (same format as A)
+      std::vector<int> P_Col;
+      std::vector<double> P_Val;
+
+      std::vector<int> R_Start;                  // CSR (same format as A)
+      std::vector<int> R_Col;
+      std::vector<double> R_Val;
+
+      std::vector<unsigned> Color_Start;
+      std::vector<unsigned> Color_Chunks;
+
+      std::vector<double> r, b, x;
+    }; // struct Level {
+
+    const unsigned Num_Sweeps;                   // Number of Gauss-Seidel sweeps before and after each coarse correction
+    std::vector<Level> Levels;
+
+    /* Dense Cholesky factor of the coarsest A (row major, lower triangle). */
+    std::vector<double> Coarse_L;
+
+    /* Make level 0 from K (K only stores its upper triangle). */
+    void Set_Finest_Level(const Sparse_Matrix & K);                            // Intent: Read
+
+    /* Color the rows of each level, allocate the scratch vectors, and factor
+    the coarsest level. */
+    void Finish_Setup(void);
+
+    /* Geometric: make the next coarser grid of Levels.back() (and its P).
+    Returns false if it can't (or shouldn't) be coarsened. */
+    bool Coarsen(void);
+
+    /* Algebraic: aggregate the blocks of Levels.back() and build its P.
+    Block_Start and B (the near null space, n by Num_Modes, column major)
+    describe Levels.back(); if this returns true, they are replaced by those
+    of the new coarsest level. Returns false if it can't (or shouldn't) be
+    coarsened. */
+    bool Aggregate(std::vector<unsigned> & Block_Start,                        // Intent: Read/Write
+                   std::vector<double> & B,                                    // Intent: Read/Write
+                   const unsigned Num_Modes);                                  // Intent: Read
+
+    /* Compute A_Coarse = P^T A P (and R = P^T) for the last two levels. */
+    void Galerkin_Product(void);
+
+    void Factor_Coarsest(void);
+    void Solve_Coarsest(const double* b,                                       // Intent: Read
+                        double* x) const;                                      // Intent: Write
+
+    /* One multicolor Gauss-Seidel sweep on level l (Forward or backward). */
+    void Gauss_Seidel(Level & L,                                               // Intent: Read/Write
+                      const bool Forward) const;                               // Intent: Read
+
+    /* Run a V-cycle starting on level l (solves A_l x_l ~= b_l). */
+    void V_Cycle(const unsigned l);                                            // Intent: Read
+
+  public:
+    //////////////////////////////////////////////////////////////////////////////
+    // Constructor
+
+    Multigrid(const unsigned Num_Sweeps_In = 2) : Num_Sweeps(Num_Sweeps_In) {}
+
+
+    //////////////////////////////////////////////////////////////////////////////
+    // Set up, apply
+
+    /* Build a geometric hierarchy for K on the passed grid. K's rows must
+    match the equations in Grid.Eq. */
+    void Setup(const Sparse_Matrix & K,                                        // Intent: Read
+               const Structured_Grid & Grid);                                  // Intent: Read
+
+    /* Build an algebraic (smoothed aggregation) hierarchy for K. Block i holds
+    equations Block_Start[i], ... , Block_Start[i+1] - 1 (use one block per
+    node). Near_Null_Space holds the near null space vectors of K (n by
+    Num_Modes, column major), see Simulation::Rigid_Body_Modes. */
+    void Setup(const Sparse_Matrix & K,                                        // Intent: Read
+               const std::vector<unsigned> & Block_Start,                      // Intent: Read
+               const std::vector<double> & Near_Null_Space);                   // Intent: Read
+
+    /* Compute z ~= K^(-1) r using one V-cycle. */
+    void Apply(const double* r,                                                // Intent: Read
+               double* z);                                                     // Intent: Write
+
+    unsigned Get_Num_Levels(void) const { return (unsigned)Levels.size(); }
+    unsigned Get_Num_Eq(const unsigned l) const { return Levels[l].n; }
+}; // class Multigrid {
+
+#endif
@@ -0,0 +1,366 @@
+#if !defined(PCG_SOLVER_SOURCE)
+#define PCG_SOLVER_SOURCE
+
+/* File description:
+This file holds the implementation of the methods of the PCG_Solver class. */
+
+#include "PCG_Solver.h"
+#include <math.h>
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Constructor
+
+PCG_Solver::PCG_Solver(const Preconditioner Precond_In, const double Tolerance_In, const unsigned Max_Iterations_In, const std::vector<unsigned> & Block_Start_In, const std::vector<double> & Near_Null_Space_In) :
+  Precond(Precond_In),
+  Tolerance(Tolerance_In),
+  Max_Iterations(Max_Iterations_In),
+  Block_Start(Block_Start_In),
+  Near_Null_Space(Near_Null_Space_In) {
+
+  /* Assumption 1:
+  This function assumes that the tolerance is positive and that at least one
+  iteration is allowed. */
+  if(Tolerance <= 0 || Max_Iterations == 0) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Solver Not Set Up Exception: Thrown by PCG_Solver::PCG_Solver\n"
+            "The tolerance must be positive and at least one iteration must be allowed.\n"
+            "Tolerance = %e, Max_Iterations = %u\n",
+            Tolerance, Max_Iterations);
+    throw Solver_Not_Set_Up(Error_Message_Buffer);
+  } // if(Tolerance <= 0 || Max_Iterations == 0) {
+
+  /* Assumption 2:
+  If we're using block Jacobi (or AMG), then this function assumes that the
+  blocks have been specified. AMG also needs the near null space. */
+  if((Precond == Preconditioner::BLOCK_JACOBI || Precond == Preconditioner::AMG) && Block_Start.size() < 2) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Solver Not Set Up Exception: Thrown by PCG_Solver::PCG_Solver\n"
+            "The block Jacobi and AMG preconditioners need Block_Start.\n");
+    throw Solver_Not_Set_Up(Error_Message_Buffer);
+  } // if((Precond == Preconditioner::BLOCK_JACOBI || Precond == Preconditioner::AMG) && Block_Start.size() < 2) {
+
+  if(Precond == Preconditioner::AMG && Near_Null_Space.size() == 0) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Solver Not Set Up Exception: Thrown by PCG_Solver::PCG_Solver\n"
+            "The AMG preconditioner needs the near null space of K.\n");
+    throw Solver_Not_Set_Up(Error_Message_Buffer);
+  } // if(Precond == Preconditioner::AMG && Near_Null_Space.size() == 0) {
+
+  /* Assumption 3:
+  Multigrid needs a grid (use the other constructor). */
+  if(Precond == Preconditioner::MULTIGRID) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Solver Not Set Up Exception: Thrown by PCG_Solver::PCG_Solver\n"
+            "The multigrid preconditioner needs a Structured_Grid.\n");
+    throw Solver_Not_Set_Up(Error_Message_Buffer);
+  } // if(Precond == Preconditioner::MULTIGRID) {
+} // PCG_Solver::PCG_Solver(const Preconditioner Precond_In, const double Tolerance_In, const unsigned Max_Iterations_In, const std::vector<unsigned> & Block_Start_In, const std::vector<double> & Near_Null_Space_In) :
+
+
+
+PCG_Solver::PCG_Solver(const Preconditioner Precond_In, const double Tolerance_In, const unsigned Max_Iterations_In, const Structured_Grid & Grid_In) :
+  Precond(Precond_In),
+  Tolerance(Tolerance_In),
+  Max_Iterations(Max_Iterations_In),
+  Grid(Grid_In) {
+
+  /* Assumption 1:
+  This function assumes that the tolerance is positive, that at least one
+  iteration is allowed, and that we're using multigrid. */
+  if(Tolerance <= 0 || Max_Iterations == 0 || Precond != Preconditioner::MULTIGRID) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Solver Not Set Up Exception: Thrown by PCG_Solver::PCG_Solver\n"
+            "The tolerance must be positive, at least one iteration must be allowed,\n"
+            "and the preconditioner must be MULTIGRID.\n"
+            "Tolerance = %e, Max_Iterations = %u\n",
+            Tolerance, Max_Iterations);
+    throw Solver_Not_Set_Up(Error_Message_Buffer);
+  } // if(Tolerance <= 0 || Max_Iterations == 0 || Precond != Preconditioner::MULTIGRID) {
+} // PCG_Solver::PCG_Solver(const Preconditioner Precond_In, const double Tolerance_In, const unsigned Max_Iterations_In, const Structured_Grid & Grid_In) :
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Factor, solve
+
+void PCG_Solver::Factor(const Linear_Operator & K_In) {
+  /* Function description:
+  This function builds the preconditioner from K's diagonal (or diagonal
+  blocks, or the multigrid hierarchy). */
+
+  K = &K_In;
+  n_eqs = K->Get_Num_Rows();
+
+  if(Precond == Preconditioner::MULTIGRID || Precond == Preconditioner::AMG) {
+    /* Assumption 1:
+    The coarse levels are built from the components of K, so K must be
+    assembled. */
+    const Sparse_Matrix* K_Sparse = dynamic_cast<const Sparse_Matrix*>(K);
+    if(K_Sparse == nullptr) {
+      K = nullptr;
+      char Error_Message_Buffer[500];
+      sprintf(Error_Message_Buffer,
+              "Solver Not Set Up Exception: Thrown by PCG_Solver::Factor\n"
+              "The multigrid preconditioners need an assembled K (a Sparse_Matrix).\n");
+      throw Solver_Not_Set_Up(Error_Message_Buffer);
+    } // if(K_Sparse == nullptr) {
+
+    if(Precond == Preconditioner::MULTIGRID) { MG.Setup(*K_Sparse, Grid); }
+    else { MG.Setup(*K_Sparse, Block_Start, Near_Null_Space); }
+    return;
+  } // if(Precond == Preconditioner::MULTIGRID || Precond == Preconditioner::AMG) {
+
+  if(Precond == Preconditioner::JACOBI) {
+    Block_Inverse.resize(n_eqs);
+    K->Get_Diagonal(Block_Inverse.data());
+
+    for(unsigned i = 0; i < n_eqs; i++) {
+      const double K_ii = Block_Inverse[i];
+
+      if(K_ii <= 0) {
+        char Error_Message_Buffer[500];
+        sprintf(Error_Message_Buffer,
+                "Solver Failed Exception: Thrown by PCG_Solver::Factor\n"
+                "K(%u,%u) = %e. K is not positive definite.\n",
+                i, i, K_ii);
+        throw Solver_Failed(Error_Message_Buffer);
+      } // if(K_ii <= 0) {
+
+      Block_Inverse[i] = 1./K_ii;
+    } // for(unsigned i = 0; i < n_eqs; i++) {
+
+    return;
+  } // if(Precond == Preconditioner::JACOBI) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Block Jacobi.
+
+  Assumption 1:
+  The blocks must cover every equation, and each block must have 1, 2, or 3
+  equations. */
+  const unsigned Num_Blocks = (unsigned)Block_Start.size() - 1;
+  if(Block_Start[0] != 0 || Block_Start[Num_Blocks] != n_eqs) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Solver Not Set Up Exception: Thrown by PCG_Solver::Factor\n"
+            "The blocks cover equations %u to %u. However, K has %u rows.\n",
+            Block_Start[0], Block_Start[Num_Blocks], n_eqs);
+    throw Solver_Not_Set_Up(Error_Message_Buffer);
+  } // if(Block_Start[0] != 0 || Block_Start[Num_Blocks] != n_eqs) {
+
+  for(unsigned Block = 0; Block < Num_Blocks; Block++) {
+    const unsigned Size = Block_Start[Block + 1] - Block_Start[Block];
+    if(Size == 0 || Size > 3) {
+      char Error_Message_Buffer[500];
+      sprintf(Error_Message_Buffer,
+              "Solver Not Set Up Exception: Thrown by PCG_Solver::Factor\n"
+              "Block %u has %u equations. Blocks must have 1, 2, or 3 equations.\n",
+              Block, Size);
+      throw Solver_Not_Set_Up(Error_Message_Buffer);
+    } // if(Size == 0 || Size > 3) {
+  } // for(unsigned Block = 0; Block < Num_Blocks; Block++) {
+
+  /* Get the blocks of K, then invert each one (in place). */
+  Block_Inverse.assign(9*Num_Blocks, 0);
+  K->Get_Diagonal_Blocks(Block_Start, Block_Inverse.data());
+
+  for(unsigned Block = 0; Block < Num_Blocks; Block++) {
+    const unsigned Start = Block_Start[Block];
+    const unsigned Size = Block_Start[Block + 1] - Start;
+
+    /* Invert the block using Gauss-Jordan elimination. B starts as the block
+    of K and Inv starts as the identity. K is positive definite, so every
+    diagonal block is too, and we don't need to pivot. */
+    double B[9];
+    double* Inv = &Block_Inverse[9*Block];
+    for(unsigned k = 0; k < 9; k++) {
+      B[k] = Inv[k];
+      Inv[k] = (k % 4 == 0) ? 1 : 0;
+    } // for(unsigned k = 0; k < 9; k++) {
+
+    for(unsigned p = 0; p < Size; p++) {
+      const double Pivot = B[3*p + p];
+
+      if(Pivot <= 0) {
+        char Error_Message_Buffer[500];
+        sprintf(Error_Message_Buffer,
+                "Solver Failed Exception: Thrown by PCG_Solver::Factor\n"
+                "The diagonal block of K that starts at row %u is not positive definite.\n",
+                Start);
+        throw Solver_Failed(Error_Message_Buffer);
+      } // if(Pivot <= 0) {
+
+      for(unsigned b = 0; b < Size; b++) {
+        B[3*p + b] /= Pivot;
+        Inv[3*p + b] /= Pivot;
+      } // for(unsigned b = 0; b < Size; b++) {
+
+      for(unsigned a = 0; a < Size; a++) {
+        if(a == p) { continue; }
+        const double Factor = B[3*a + p];
+        for(unsigned b = 0; b < Size; b++) {
+          B[3*a + b] -= Factor*B[3*p + b];
+          Inv[3*a + b] -= Factor*Inv[3*p + b];
+        } // for(unsigned b = 0; b < Size; b++) {
+      } // for(unsigned a = 0; a < Size; a++) {
+    } // for(unsigned p = 0; p < Size; p++) {
+  } // for(unsigned Block = 0; Block < Num_Blocks; Block++) {
+} // void PCG_Solver::Factor(const Linear_Operator & K_In) {
+
+
+
+void PCG_Solver::Solve(double* x, const double* F, const unsigned Num_RHS) {
+  /* Assumption 1:
+  This function assumes that the preconditioner has been built. */
+  if(K == nullptr) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Solver Not Set Up Exception: Thrown by PCG_Solver::Solve\n"
+            "K must be factored (using Factor) before we can solve Kx = F.\n");
+    throw Solver_Not_Set_Up(Error_Message_Buffer);
+  } // if(K == nullptr) {
+
+  for(unsigned i = 0; i < n_eqs*Num_RHS; i++) { x[i] = 0; }
+
+  for(unsigned RHS = 0; RHS < Num_RHS; RHS++) {
+    Solve_One(x + n_eqs*RHS, F + n_eqs*RHS);
+
+    #if defined(PCG_SOLVER_MONITOR)
+      printf("PCG: right hand side %u converged in %u iterations (relative residual = %e)\n",
+             RHS, Iterations, Relative_Residual);
+    #endif
+  } // for(unsigned RHS = 0; RHS < Num_RHS; RHS++) {
+} // void PCG_Solver::Solve(double* x, const double* F, const unsigned Num_RHS) {
+
+
+
+void PCG_Solver::Apply_Preconditioner(const double* r, double* z) {
+  if(Precond == Preconditioner::MULTIGRID || Precond == Preconditioner::AMG) {
+    MG.Apply(r, z);
+    return;
+  } // if(Precond == Preconditioner::MULTIGRID || Precond == Preconditioner::AMG) {
+
+  if(Precond == Preconditioner::JACOBI) {
+    #pragma omp parallel for schedule(static)
+    for(unsigned i = 0; i < n_eqs; i++) { z[i] = Block_Inverse[i]*r[i]; }
+
+    return;
+  } // if(Precond == Preconditioner::JACOBI) {
+
+  const unsigned Num_Blocks = (unsigned)Block_Start.size() - 1;
+
+  #pragma omp parallel for schedule(static)
+  for(unsigned Block = 0; Block < Num_Blocks; Block++) {
+    const unsigned Start = Block_Start[Block];
+    const unsigned Size = Block_Start[Block + 1] - Start;
+    const double* Inv = &Block_Inverse[9*Block];
+
+    for(unsigned a = 0; a < Size; a++) {
+      double z_a = 0;
+      for(unsigned b = 0; b < Size; b++) { z_a += Inv[3*a + b]*r[Start + b]; }
+      z[Start + a] = z_a;
+    } // for(unsigned a = 0; a < Size; a++) {
+  } // for(unsigned Block = 0; Block < Num_Blocks; Block++) {
+} // void PCG_Solver::Apply_Preconditioner(const double* r, double* z) {
+
+
+
+void PCG_Solver::Solve_One(double* x, const double* F) {
+  /* Function description:
+  This function runs the preconditioned conjugate gradient method (see
+  Saad, Iterative Methods for Sparse Linear Systems, algorithm 9.1):
+      r = F - Kx, z = M^(-1) r, p = z
+      Repeat:
+        alpha = (r.z)/(p.Kp)
+        x += alpha*p, r -= alpha*Kp
+        Stop if ||r|| < Tolerance*||F||
+        z = M^(-1) r
+        beta = (r.z)_new/(r.z)_old
+        p = z + beta*p */
+  const unsigned n = n_eqs;
+  std::vector<double> r(n), z(n), p(n), Kp(n);
+
+  double F_Norm = 0;
+  #pragma omp parallel for schedule(static) reduction(+:F_Norm)
+  for(unsigned i = 0; i < n; i++) { F_Norm += F[i]*F[i]; }
+  F_Norm = sqrt(F_Norm);
+
+  /* If F = 0, then x = 0 is the solution. */
+  if(F_Norm == 0) {
+    for(unsigned i = 0; i < n; i++) { x[i] = 0; }
+    Iterations = 0;
+    Relative_Residual = 0;
+    return;
+  } // if(F_Norm == 0) {
+
+  K->Multiply(x, Kp.data());
+  for(unsigned i = 0; i < n; i++) { r[i] = F[i] - Kp[i]; }
+  Apply_Preconditioner(r.data(), z.data());
+
+  double r_dot_z = 0;
+  #pragma omp parallel for schedule(static) reduction(+:r_dot_z)
+  for(unsigned i = 0; i < n; i++) {
+    p[i] = z[i];
+    r_dot_z += r[i]*z[i];
+  } // for(unsigned i = 0; i < n; i++) {
+
+  for(Iterations = 1; Iterations <= Max_Iterations; Iterations++) {
+    K->Multiply(p.data(), Kp.data());
+
+    double p_dot_Kp = 0;
+    #pragma omp parallel for schedule(static) reduction(+:p_dot_Kp)
+    for(unsigned i = 0; i < n; i++) { p_dot_Kp += p[i]*Kp[i]; }
+
+    const double alpha = r_dot_z/p_dot_Kp;
+
+    double r_Norm = 0;
+    #pragma omp parallel for schedule(static) reduction(+:r_Norm)
+    for(unsigned i = 0; i < n; i++) {
+      x[i] += alpha*p[i];
+      r[i] -= alpha*Kp[i];
+      r_Norm += r[i]*r[i];
+    } // for(unsigned i = 0; i < n; i++) {
+
+    Relative_Residual = sqrt(r_Norm)/F_Norm;
+
+    #if defined(PCG_SOLVER_MONITOR)
+      if(Iterations % 100 == 0) { printf("PCG: iteration %6u, relative residual = %e\n", Iterations, Relative_Residual); }
+    #endif
+
+    if(Relative_Residual < Tolerance) { return; }
+
+    Apply_Preconditioner(r.data(), z.data());
+
+    double r_dot_z_New = 0;
+    #pragma omp parallel for schedule(static) reduction(+:r_dot_z_New)
+    for(unsigned i = 0; i < n; i++) { r_dot_z_New += r[i]*z[i]; }
+
+    const double beta = r_dot_z_New/r_dot_z;
+    r_dot_z = r_dot_z_New;
+
+    #pragma omp parallel for schedule(static)
+    for(unsigned i = 0; i < n; i++) { p[i] = z[i] + beta*p[i]; }
+  } // for(Iterations = 1; Iterations <= Max_Iterations; Iterations++) {
+
+  /* If we get here, then PCG didn't converge. */
+  Iterations = Max_Iterations;
+  char Error_Message_Buffer[500];
+  sprintf(Error_Message_Buffer,
+          "Solver Failed Exception: Thrown by PCG_Solver::Solve_One\n"
+          "PCG did not converge in %u iterations. The relative residual is %e\n"
+          "(the tolerance is %e).\n",
+          Max_Iterations, Relative_Residual, Tolerance);
+  throw Solver_Failed(Error_Message_Buffer);
+} // void PCG_Solver::Solve_One(double* x, const double* F) {
+
+#endif
@@ -0,0 +1,124 @@
+#if !defined(PCG_SOLVER_HEADER)
+#define PCG_SOLVER_HEADER
+
+//#define PCG_SOLVER_MONITOR             // Prints the residual every 100 iterations
+
+#include <stdio.h>
+#include <vector>
+#include "Errors.h"
+#include "Linear_Operator.h"
+#include "Multigrid.h"
+
+/* Preconditioners for the PCG solver.
+  JACOBI: M = diag(K).
+  BLOCK_JACOBI: M is block diagonal. Each block holds the components of K that
+  couple the free components of one node (so the blocks are at most 3x3). This
+  captures the coupling between the x, y, and z displacements of each node,
+  which Jacobi ignores.
+  MULTIGRID: M^(-1) is one geometric multigrid V-cycle (see Multigrid.h). This
+  only works for structured brick meshes and an assembled K, but (unlike the
+  other two) the number of iterations barely grows as the mesh is refined.
+  AMG: M^(-1) is one algebraic (smoothed aggregation) multigrid V-cycle (see
+  Multigrid.h). This works on any mesh (with an assembled K). It needs the
+  blocks (one per node) and the near null space of K (the rigid body modes). */
+enum class Preconditioner { JACOBI, BLOCK_JACOBI, MULTIGRID, AMG };
+
+/* Preconditioned conjugate gradient solver class.
+This is an alternative to the Pardiso_Solver. Pardiso is a direct solver: it
+factors K, and the factors can have many more non-zero components than K
+(fill-in). PCG is iterative: it only needs K, the preconditioner, and a few
+vectors, so its memory footprint is O(nnz(K)). It also doesn't need any
+external libraries.
+
+PCG only needs to multiply by K, so K can be any Linear_Operator: an
+assembled Sparse_Matrix, or a matrix-free Element_Operator (which never stores
+K).
+
+The interface mirrors the Pardiso_Solver:
+    Factor(K) stores a pointer to K and builds the preconditioner.
+    Solve(x, F) runs PCG (once for each right hand side).
+K must stay alive (and unchanged) until the last call to Solve.
+
+PCG stops once the relative residual, ||F - Kx|| / ||F||, is less than
+Tolerance. If this doesn't happen within Max_Iterations iterations, Solve
+throws a Solver_Failed exception. After each solve, Get_Iterations and
+Get_Relative_Residual report how the (last) right hand side converged. */
+class PCG_Solver {
+  private:
+    const Linear_Operator* K = nullptr;          // The operator that we're solving with (set by Factor)
+    unsigned n_eqs = 0;                          // Number of equations (rows of K)
+
+    const Preconditioner Precond;                // Which preconditioner to use
+    const double Tolerance;                      // Relative residual at which PCG stops
+    const unsigned Max_Iterations;               // Maximum number of iterations per right hand side
+
+    /* Block structure (used by BLOCK_JACOBI). The ith block holds equations
+    Block_Start[i], ... , Block_Start[i+1] - 1. Block_Inverse holds the
+    inverse of each diagonal block of K (9 doubles per block, row major, even
+    if the block is smaller than 3x3). For JACOBI, Block_Inverse holds the
+    reciprocal of each diagonal component of K. */
+    std::vector<unsigned> Block_Start;
+    std::vector<double> Block_Inverse;
+
+    /* Multigrid (used by MULTIGRID and AMG). Grid describes the structured
+    mesh that K comes from (MULTIGRID). Near_Null_Space holds the near null
+    space vectors of K (n by Num_Modes, column major, AMG). */
+    Structured_Grid Grid;
+    std::vector<double> Near_Null_Space;
+    Multigrid MG;
+
+    unsigned Iterations = 0;                     // Iterations used by the last solve
+    double Relative_Residual = 0;                // Relative residual at the end of the last solve
+
+    /* Compute z = M^(-1) r. */
+    void Apply_Preconditioner(const double* r,                                 // Intent: Read
+                              double* z);                                      // Intent: Write
+
+    /* Solve Kx = F for a single right hand side. x is used as the initial guess. */
+    void Solve_One(double* x,                                                  // Intent: Read/Write
+                   const double* F);                                           // Intent: Read
+
+  public:
+    //////////////////////////////////////////////////////////////////////////////
+    // Constructor
+
+    /* Block_Start_In describes the blocks (see above). It's only needed for
+    BLOCK_JACOBI and AMG. Near_Null_Space_In is only needed for AMG (see
+    Simulation::Rigid_Body_Modes). */
+    PCG_Solver(const Preconditioner Precond_In,                                // Intent: Read
+               const double Tolerance_In,                                      // Intent: Read
+               const unsigned Max_Iterations_In,                               // Intent: Read
+               const std::vector<unsigned> & Block_Start_In = {},              // Intent: Read
+               const std::vector<double> & Near_Null_Space_In = {});           // Intent: Read
+
+    /* Use this one for MULTIGRID. Grid_In describes the structured mesh that K
+    comes from (see Simulation::Find_Structured_Grid). */
+    PCG_Solver(const Preconditioner Precond_In,                                // Intent: Read
+               const double Tolerance_In,                                      // Intent: Read
+               const unsigned Max_Iterations_In,                               // Intent: Read
+               const Structured_Grid & Grid_In);                               // Intent: Read
+
+
+    //////////////////////////////////////////////////////////////////////////////
+    // Factor, solve
+
+    /* Build the preconditioner from K's values. K must be positive definite.
+    MULTIGRID and AMG need the components of K, so K must be a Sparse_Matrix. */
+    void Factor(const Linear_Operator & K_In);                                 // Intent: Read
+
+    /* Solve Kx = F. x and F are n by Num_RHS column major blocks (just like
+    Pardiso_Solver::Solve). Every initial guess is zero. */
+    void Solve(double* x,                                                      // Intent: Write
+               const double* F,                                                // Intent: Read
+               const unsigned Num_RHS = 1);                                    // Intent: Read
+
+
+    //////////////////////////////////////////////////////////////////////////////
+    // Getters
+
+    unsigned Get_Num_Eq(void) const { return n_eqs; }
+    unsigned Get_Iterations(void) const { return Iterations; }
+    double Get_Relative_Residual(void) const { return Relative_Residual; }
+}; // class PCG_Solver {
+
+#endif
@@ -0,0 +1,418 @@
+#if !defined(SPARSE_MATRIX_SOURCE)
+#define SPARSE_MATRIX_SOURCE
+
+/* File description:
+This file holds the implementation of the methods of the Sparse_Matrix class */
+
+#include "Sparse_Matrix.h"
+#include <algorithm>
+//#define SPARSE_MATRIX_MONITOR          // Prints IA and JA once the pattern is set
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Destructor
+
+Sparse_Matrix::~Sparse_Matrix(void) {
+  delete [] IA;
+  delete [] JA;
+  delete [] A;
+} // Sparse_Matrix::~Sparse_Matrix(void) {
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Sparsity pattern
+
+void Sparse_Matrix::Set_Pattern(const unsigned Num_Rows_In, const std::vector<std::vector<unsigned>> & Row_Columns) {
+  /* Function description:
+  This function sets IA and JA using the passed row lists. Once this has been
+  done, A is allocated and zero initialized. */
+
+  /* Assumption 1:
+  This function assumes that the pattern has not already been set. Once the
+  pattern is set, it can not be changed. */
+  if(Pattern_Set == true) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Matrix Not Set Up Exception: Thrown by Sparse_Matrix::Set_Pattern\n"
+            "The sparsity pattern of this matrix has already been set. It can not\n"
+            "be set a second time.\n");
+    throw Matrix_Not_Set_Up(Error_Message_Buffer);
+  } // if(Pattern_Set == true) {
+
+  /* Assumption 2:
+  This function assumes that there is one column list per row. */
+  if(Row_Columns.size() != Num_Rows_In) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Matrix Dimension Mismatch Exception: Thrown by Sparse_Matrix::Set_Pattern\n"
+            "There must be one column list for each row of the matrix. However,\n"
+            "Num_Rows = %u while %u column lists were passed.\n",
+            Num_Rows_In, (unsigned)Row_Columns.size());
+    throw Matrix_Dimension_Mismatch(Error_Message_Buffer);
+  } // if(Row_Columns.size() != Num_Rows_In) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* First, sort each row's column list and remove duplicates. We only keep
+  the columns that are on or above the diagonal. The diagonal is always kept
+  (and, since it's the smallest column that we keep, it is always the first
+  component of each row). */
+  Num_Rows = Num_Rows_In;
+  std::vector<std::vector<unsigned>> Upper_Columns(Num_Rows);
+
+  for(unsigned i = 0; i < Num_Rows; i++) {
+    std::vector<unsigned> & Row = Upper_Columns[i];
+    Row.reserve(Row_Columns[i].size() + 1);
+
+    Row.push_back(i);
+    for(unsigned k = 0; k < Row_Columns[i].size(); k++) {
+      const unsigned j = Row_Columns[i][k];
+      if(j >= Num_Rows) {
+        char Error_Message_Buffer[500];
+        sprintf(Error_Message_Buffer,
+                "Matrix Index Out Of Bounds Exception: Thrown by Sparse_Matrix::Set_Pattern\n"
+                "Row %u's column list contains column %u. However, this matrix only has\n"
+                "%u columns.\n",
+                i, j, Num_Rows);
+        throw Matrix_Index_Out_Of_Bounds(Error_Message_Buffer);
+      } // if(j >= Num_Rows) {
+
+      if(j > i) { Row.push_back(j); }
+    } // for(unsigned k = 0; k < Row_Columns[i].size(); k++) {
+
+    std::sort(Row.begin(), Row.end());
+    Row.erase(std::unique(Row.begin(), Row.end()), Row.end());
+
+    Num_Non_Zero += (unsigned)Row.size();
+  } // for(unsigned i = 0; i < Num_Rows; i++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Now that we know the number of stored components, allocate IA, JA, and A
+  and then populate them. */
+  IA = new int[Num_Rows + 1];
+  JA = new int[Num_Non_Zero];
+  A  = new double[Num_Non_Zero];
+
+  unsigned k = 0;
+  for(unsigned i = 0; i < Num_Rows; i++) {
+    IA[i] = (int)k;
+    for(unsigned l = 0; l < Upper_Columns[i].size(); l++) {
+      JA[k] = (int)Upper_Columns[i][l];
+      A[k] = 0;
+      k++;
+    } // for(unsigned l = 0; l < Upper_Columns[i].size(); l++) {
+  } // for(unsigned i = 0; i < Num_Rows; i++) {
+  IA[Num_Rows] = (int)k;
+
+  // The pattern is now set.
+  Pattern_Set = true;
+
+
+  #if defined(SPARSE_MATRIX_MONITOR)
+    printf("Sparse matrix: %u rows, %u stored components\n", Num_Rows, Num_Non_Zero);
+
+    printf("IA: [");
+    for(unsigned i = 0; i < Num_Rows + 1; i++) { printf(" %d", IA[i]); }
+    printf(" ]\n");
+
+    printf("JA: [");
+    for(unsigned i = 0; i < Num_Non_Zero; i++) { printf(" %d", JA[i]); }
+    printf(" ]\n");
+  #endif
+} // void Sparse_Matrix::Set_Pattern(const unsigned Num_Rows_In, const std::vector<std::vector<unsigned>> & Row_Columns) {
+
+
+
+void Sparse_Matrix::Set_Pattern(const unsigned Num_Rows_In, const std::vector<int> & IA_In, const std::vector<int> & JA_In) {
+  /* Function description:
+  This function sets IA and JA by copying the passed (already compressed)
+  pattern. Since we don't need to sort anything, this only takes
+  O(number of stored components) operations. Once this has been done, A is
+  allocated and zero initialized. */
+
+  /* Assumption 1:
+  This function assumes that the pattern has not already been set. */
+  if(Pattern_Set == true) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Matrix Not Set Up Exception: Thrown by Sparse_Matrix::Set_Pattern\n"
+            "The sparsity pattern of this matrix has already been set. It can not\n"
+            "be set a second time.\n");
+    throw Matrix_Not_Set_Up(Error_Message_Buffer);
+  } // if(Pattern_Set == true) {
+
+  /* Assumption 2:
+  This function assumes that IA has Num_Rows + 1 components and that its last
+  component is the length of JA. */
+  if(IA_In.size() != Num_Rows_In + 1 || IA_In[Num_Rows_In] != (int)JA_In.size()) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Matrix Dimension Mismatch Exception: Thrown by Sparse_Matrix::Set_Pattern\n"
+            "IA must have Num_Rows + 1 = %u components and its last component must\n"
+            "be the length of JA (%u).\n",
+            Num_Rows_In + 1, (unsigned)JA_In.size());
+    throw Matrix_Dimension_Mismatch(Error_Message_Buffer);
+  } // if(IA_In.size() != Num_Rows_In + 1 || IA_In[Num_Rows_In] != (int)JA_In.size()) {
+
+  /* Assumption 3:
+  This function assumes that each row starts with its diagonal component and
+  that the rest of its columns are strictly increasing and in bounds. */
+  for(unsigned i = 0; i < Num_Rows_In; i++) {
+    bool Valid_Row = (IA_In[i] < IA_In[i+1] && JA_In[IA_In[i]] == (int)i);
+    for(int k = IA_In[i] + 1; k < IA_In[i+1] && Valid_Row == true; k++) {
+      if(JA_In[k] <= JA_In[k-1] || JA_In[k] >= (int)Num_Rows_In) { Valid_Row = false; }
+    } // for(int k = IA_In[i] + 1; k < IA_In[i+1] && Valid_Row == true; k++) {
+
+    if(Valid_Row == false) {
+      char Error_Message_Buffer[500];
+      sprintf(Error_Message_Buffer,
+              "Matrix Index Out Of Bounds Exception: Thrown by Sparse_Matrix::Set_Pattern\n"
+              "Row %u of the passed pattern is invalid. Each row must start with its\n"
+              "diagonal component and its columns must be increasing and less than %u.\n",
+              i, Num_Rows_In);
+      throw Matrix_Index_Out_Of_Bounds(Error_Message_Buffer);
+    } // if(Valid_Row == false) {
+  } // for(unsigned i = 0; i < Num_Rows_In; i++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Copy the pattern, allocate A.
+  Num_Rows = Num_Rows_In;
+  Num_Non_Zero = (unsigned)JA_In.size();
+
+  IA = new int[Num_Rows + 1];
+  JA = new int[Num_Non_Zero];
+  A  = new double[Num_Non_Zero];
+
+  for(unsigned i = 0; i < Num_Rows + 1; i++) { IA[i] = IA_In[i]; }
+  for(unsigned k = 0; k < Num_Non_Zero; k++) {
+    JA[k] = JA_In[k];
+    A[k] = 0;
+  } // for(unsigned k = 0; k < Num_Non_Zero; k++) {
+
+  // The pattern is now set.
+  Pattern_Set = true;
+
+
+  #if defined(SPARSE_MATRIX_MONITOR)
+    printf("Sparse matrix: %u rows, %u stored components\n", Num_Rows, Num_Non_Zero);
+  #endif
+} // void Sparse_Matrix::Set_Pattern(const unsigned Num_Rows_In, const std::vector<int> & IA_In, const std::vector<int> & JA_In) {
+
+
+
+int Sparse_Matrix::Find(const unsigned i, const unsigned j) const {
+  /* Function description:
+  This function finds the index (in JA/A) of the (i,j) component. Since the
+  column numbers of each row are sorted, we can use a binary search. If (i,j)
+  is not in the pattern, then we return -1. This function assumes that i <= j
+  and that i < Num_Rows (it is private and only called by methods that check
+  these things). */
+
+  int Low = IA[i];
+  int High = IA[i+1] - 1;
+  const int Col = (int)j;
+
+  while(Low <= High) {
+    const int Mid = (Low + High)/2;
+    if(JA[Mid] == Col) { return Mid; }
+    else if(JA[Mid] < Col) { Low = Mid + 1; }
+    else { High = Mid - 1; }
+  } // while(Low <= High) {
+
+  return -1;
+} // int Sparse_Matrix::Find(const unsigned i, const unsigned j) const {
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Operator overloads
+
+double Sparse_Matrix::operator()(const unsigned i, const unsigned j) const {
+  /* Assumptions:
+  This function assumes that i and j are both less than Num_Rows (which
+  implies that the pattern has been set). If this is not the case, then an
+  exception is thrown. */
+  if(i >= Num_Rows || j >= Num_Rows) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Matrix Index-out-of-bounds Error: Thrown by Sparse_Matrix::operator()\n"
+            "You tried reading the (%u,%u) component of a sparse matrix. However,\n"
+            "this matrix only has %u rows and columns.\n",
+            i, j, Num_Rows);
+    throw Matrix_Index_Out_Of_Bounds(Error_Message_Buffer);
+  } // if(i >= Num_Rows || j >= Num_Rows) {
+
+  /* We only store the upper triangle. Thus, if i > j then we read the (j,i)
+  component instead (which is the same thing, by symmetry) */
+  int Index;
+  if(i <= j) { Index = Find(i, j); }
+  else { Index = Find(j, i); }
+
+  if(Index == -1) { return 0; }
+  else { return A[Index]; }
+} // double Sparse_Matrix::operator()(const unsigned i, const unsigned j) const {
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Other methods
+
+void Sparse_Matrix::Add_To(const unsigned i, const unsigned j, const double Value) {
+  /* Function description:
+  This function adds Value to the (i,j) component of the matrix. Since the
+  matrix is symmetric, this also adds Value to the (j,i) component. Thus,
+  Add_To(i,j,v) and Add_To(j,i,v) do the same thing. */
+
+  /* Assumption 1:
+  This function assumes that the pattern has been set */
+  if(Pattern_Set == false) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Matrix Not Set Up Exception: Thrown by Sparse_Matrix::Add_To\n"
+            "You can not add anything to a sparse matrix until its sparsity\n"
+            "pattern has been set.\n");
+    throw Matrix_Not_Set_Up(Error_Message_Buffer);
+  } // if(Pattern_Set == false) {
+
+  /* Assumption 2:
+  This function assumes that i and j are both less than Num_Rows */
+  if(i >= Num_Rows || j >= Num_Rows) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Matrix Index-out-of-bounds Error: Thrown by Sparse_Matrix::Add_To\n"
+            "You tried writing to the (%u,%u) component of a sparse matrix. However,\n"
+            "this matrix only has %u rows and columns.\n",
+            i, j, Num_Rows);
+    throw Matrix_Index_Out_Of_Bounds(Error_Message_Buffer);
+  } // if(i >= Num_Rows || j >= Num_Rows) {
+
+  // Find the (i,j) component (in the upper triangle)
+  int Index;
+  if(i <= j) { Index = Find(i, j); }
+  else { Index = Find(j, i); }
+
+  /* Assumption 3:
+  This function assumes that (i,j) is in the sparsity pattern. */
+  if(Index == -1) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Matrix Not In Pattern Exception: Thrown by Sparse_Matrix::Add_To\n"
+            "You tried writing to the (%u,%u) component of a sparse matrix. However,\n"
+            "this component is not in the matrix's sparsity pattern.\n",
+            i, j);
+    throw Matrix_Not_In_Pattern(Error_Message_Buffer);
+  } // if(Index == -1) {
+
+  A[Index] += Value;
+} // void Sparse_Matrix::Add_To(const unsigned i, const unsigned j, const double Value) {
+
+
+
+void Sparse_Matrix::Fill(const double Val) {
+  for(unsigned k = 0; k < Num_Non_Zero; k++) { A[k] = Val; }
+} // void Sparse_Matrix::Fill(const double Val) {
+
+
+
+void Sparse_Matrix::Multiply(const double* x, double* y) const {
+  /* Function description:
+  This function computes y = M*x. Since we only store the upper triangle of M,
+  each off-diagonal component M(i,j) contributes to both y[i] (through x[j])
+  and y[j] (through x[i]). */
+
+  for(unsigned i = 0; i < Num_Rows; i++) { y[i] = 0; }
+
+  for(unsigned i = 0; i < Num_Rows; i++) {
+    /* The first component of each row is the diagonal component. */
+    const int Diag_Index = IA[i];
+    double y_i = A[Diag_Index]*x[i];
+    const double x_i = x[i];
+
+    for(int k = Diag_Index + 1; k < IA[i+1]; k++) {
+      const unsigned j = (unsigned)JA[k];
+      y_i  += A[k]*x[j];
+      y[j] += A[k]*x_i;
+    } // for(int k = Diag_Index + 1; k < IA[i+1]; k++) {
+
+    y[i] += y_i;
+  } // for(unsigned i = 0; i < Num_Rows; i++) {
+} // void Sparse_Matrix::Multiply(const double* x, double* y) const {
+
+
+
+void Sparse_Matrix::Get_Diagonal(double* Diagonal) const {
+  /* Assumption 1:
+  This function assumes that the pattern has been set */
+  if(Pattern_Set == false) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Matrix Not Set Up Exception: Thrown by Sparse_Matrix::Get_Diagonal\n"
+            "A sparse matrix has no diagonal until its sparsity pattern has been set.\n");
+    throw Matrix_Not_Set_Up(Error_Message_Buffer);
+  } // if(Pattern_Set == false) {
+
+  /* The first stored component of each row is the diagonal component. */
+  for(unsigned i = 0; i < Num_Rows; i++) { Diagonal[i] = A[IA[i]]; }
+} // void Sparse_Matrix::Get_Diagonal(double* Diagonal) const {
+
+
+
+void Sparse_Matrix::Get_Diagonal_Blocks(const std::vector<unsigned> & Block_Start, double* Blocks) const {
+  /* Function description:
+  This function reads the diagonal blocks of M. Since we only store the upper
+  triangle, we read the (a,b) component of each block (a <= b) and use
+  symmetry to get the (b,a) component. */
+
+  /* Assumption 1:
+  This function assumes that the pattern has been set */
+  if(Pattern_Set == false) {
+    char Error_Message_Buffer[500];
+    sprintf(Error_Message_Buffer,
+            "Matrix Not Set Up Exception: Thrown by Sparse_Matrix::Get_Diagonal_Blocks\n"
+            "A sparse matrix has no diagonal blocks until its sparsity pattern has been set.\n");
+    throw Matrix_Not_Set_Up(Error_Message_Buffer);
+  } // if(Pattern_Set == false) {
+
+  const unsigned Num_Blocks = (unsigned)Block_Start.size() - 1;
+  for(unsigned Block = 0; Block < Num_Blocks; Block++) {
+    const unsigned Start = Block_Start[Block];
+    const unsigned Size = Block_Start[Block + 1] - Start;
+
+    /* Assumption 2:
+    This function assumes that each block fits in its 9 doubles (at most 3
+    rows) and that every block is inside M. */
+    if(Block_Start[Block + 1] < Start || Size > 3 || Block_Start[Block + 1] > Num_Rows) {
+      char Error_Message_Buffer[500];
+      snprintf(Error_Message_Buffer, sizeof(Error_Message_Buffer),
+               "Matrix Dimension Mismatch Exception: Thrown by Sparse_Matrix::Get_Diagonal_Blocks\n"
+               "Block %u starts at row %u and ends before row %u. However, each block must\n"
+               "have at most 3 rows, and M only has %u rows.\n",
+               Block, Start, Block_Start[Block + 1], Num_Rows);
+      throw Matrix_Dimension_Mismatch(Error_Message_Buffer);
+    } // if(Block_Start[Block + 1] < Start || Size > 3 || Block_Start[Block + 1] > Num_Rows) {
+    double* Block_Ptr = Blocks + 9*Block;
+
+    for(unsigned k = 0; k < 9; k++) { Block_Ptr[k] = 0; }
+
+    for(unsigned a = 0; a < Size; a++) {
+      for(unsigned b = a; b < Size; b++) {
+        const int Index = Find(Start + a, Start + b);
+        const double Value = (Index == -1) ? 0 : A[Index];
+        Block_Ptr[3*a + b] = Value;
+        Block_Ptr[3*b + a] = Value;
+      } // for(unsigned b = a; b < Size; b++) {
+    } // for(unsigned a = 0; a < Size; a++) {
+  } // for(unsigned Block = 0; Block < Num_Blocks; Block++) {
+} // void Sparse_Matrix::Get_Diagonal_Blocks(const std::vector<unsigned> & Block_Start, double* Blocks) const {
+
+#endif
@@ -0,0 +1,123 @@
+#if !defined(SPARSE_MATRIX_HEADER)
+#define SPARSE_MATRIX_HEADER
+
+#include "Errors.h"
+#include "Solver/Linear_Operator.h"
+#include <vector>
+#include <stdio.h>
+
+/* Sparse matrix class.
+This class is used to store the global stiffness matrix, K. K is symmetric and
+almost all of its components are zero (each equation only couples to the
+equations of the nodes that share an element with it). Storing K as a dense
+matrix therefore wastes an enormous amount of memory (n^2 doubles).
+
+Instead, we store K in compressed sparse row (CSR) format. Since K is
+symmetric, we only store the diagonal and upper triangular components of K.
+This is the same format that Pardiso expects for symmetric matricies (the only
+difference is that we use 0 based indexing while Pardiso uses 1 based
+indexing). IA, JA, and A are all defined as in the Pardiso manual:
+    IA[i] holds the index (in JA and A) of the first stored component of row i.
+    IA[Num_Rows] holds the total number of stored components.
+    JA[k] holds the column number of the kth stored component.
+    A[k] holds the value of the kth stored component.
+The column numbers within each row are sorted and the first stored component
+of each row is the diagonal component.
+
+The sparsity pattern (IA and JA) must be set before we can add anything to the
+matrix. Once set, the pattern can not be changed.
+
+A sparse matrix is also a Linear_Operator, so the iterative solvers can use it
+directly. */
+class Sparse_Matrix : public Linear_Operator {
+  private:
+    unsigned Num_Rows = 0;                       // Number of rows (and columns) of the matrix
+    unsigned Num_Non_Zero = 0;                   // Number of stored components (length of JA, A)
+    int* IA = nullptr;                           // Row start indicies              (Num_Rows + 1 ints)
+    int* JA = nullptr;                           // Column number of each component (Num_Non_Zero ints)
+    double* A = nullptr;                         // Value of each component         (Num_Non_Zero doubles)
+    bool Pattern_Set = false;                    // True if IA and JA have been set
+
+    /* Returns the index (in JA and A) of the (i,j) component. This function
+    assumes that i <= j. If the (i,j) component is not in the pattern then
+    -1 is returned. */
+    int Find(const unsigned i,                                                 // Intent: Read
+             const unsigned j) const;                                          // Intent: Read
+
+  public:
+    //////////////////////////////////////////////////////////////////////////////
+    // Constructor, destructor
+
+    Sparse_Matrix(void) {}                       // Default constructor (empty matrix, no pattern)
+    ~Sparse_Matrix(void);                        // Destructor
+
+    /* Sparse matricies own dynamically allocated memory. A shallow copy would
+    lead to disaster, so (like the Matrix class) we delete the copy constructor
+    and copy assignment operator. */
+    Sparse_Matrix(const Sparse_Matrix & Other) = delete;
+    Sparse_Matrix & operator=(const Sparse_Matrix & Other) = delete;
+
+
+    //////////////////////////////////////////////////////////////////////////////
+    // Sparsity pattern
+
+    /* Set the sparsity pattern.
+    Row_Columns[i] should hold the column number of every stored component of
+    the ith row. Only columns j >= i are used (the lower triangle is implied by
+    symmetry). The lists do not need to be sorted and may contain duplicates.
+    The diagonal component of every row is always added to the pattern.
+    Once the pattern is set, every value is zero. */
+    void Set_Pattern(const unsigned Num_Rows_In,                               // Intent: Read
+                     const std::vector<std::vector<unsigned>> & Row_Columns);  // Intent: Read
+
+    /* Set the sparsity pattern from IA and JA (0 based, defined as above).
+    This is for callers that can build the compressed pattern directly (e.g. the
+    element connectivity based symbolic phase). Each row's columns must be
+    strictly increasing, at least i, and must start with the diagonal. */
+    void Set_Pattern(const unsigned Num_Rows_In,                               // Intent: Read
+                     const std::vector<int> & IA_In,                           // Intent: Read
+                     const std::vector<int> & JA_In);                          // Intent: Read
+
+
+    //////////////////////////////////////////////////////////////////////////////
+    // Operator overloads
+
+    /* Read an element of the matrix. Components that are not in the pattern
+    are zero. */
+    double operator()(const unsigned i,                                        // Intent: Read
+                      const unsigned j) const;                                 // Intent: Read
+
+
+    //////////////////////////////////////////////////////////////////////////////
+    // Other methods
+
+    /* Add Value to the (i,j) (and, by symmetry, the (j,i)) component. */
+    void Add_To(const unsigned i,                                              // Intent: Read
+                const unsigned j,                                              // Intent: Read
+                const double Value);                                           // Intent: Read
+
+    /* Set every stored component to Val (the pattern is unchanged). */
+    void Fill(const double Val);                                               // Intent: Read
+
+    /* Compute y = M*x. Both x and y must have Num_Rows components. */
+    void Multiply(const double* x,                                             // Intent: Read
+                  double* y) const override;                                   // Intent: Write
+
+    /* Get the diagonal (or diagonal blocks) of M (see Linear_Operator.h). */
+    void Get_Diagonal(double* Diagonal) const override;                        // Intent: Write
+    void Get_Diagonal_Blocks(const std::vector<unsigned> & Block_Start,        // Intent: Read
+                             double* Blocks) const override;                   // Intent: Write
+
+
+    //////////////////////////////////////////////////////////////////////////////
+    // Getter methods
+
+    unsigned Get_Num_Rows(void) const override { return Num_Rows; }
+    unsigned Get_Num_Non_Zero(void) const { return Num_Non_Zero; }
+    bool Get_Pattern_Set(void) const { return Pattern_Set; }
+    const int* Get_IA(void) const { return IA; }
+    const int* Get_JA(void) const { return JA; }
+    const double* Get_A(void) const { return A; }
+}; // class Sparse_Matrix {
+
+#endif
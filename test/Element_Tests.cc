@@ -2,6 +2,8 @@
 #define ELEMENT_TESTS_SOURCE
 
 #include <stdio.h>
+#include <math.h>
+#include <omp.h>
 #include "Element_Tests.h"
 
 
@@ -100,15 +102,11 @@ void Test::Element_Error_Tests(void) {
   //////////////////////////////////////////////////////////////////////////////
   // Create K, set Element static members, Material
 
-  // Now that we know the # of Global equations, allocate K and F
-  class Matrix<double> K{Num_Global_Eq, Num_Global_Eq, Memory::COLUMN_MAJOR};
+  /* Now that we know the # of Global equations, allocate K and F (K's pattern
+  is set once the elements have been set up) */
+  class Sparse_Matrix K{};
   double * F = new double[Num_Global_Eq];
 
-  // Zero initialize K (Note: K is Column-major)
-  for(unsigned j = 0; j < Num_Global_Eq; j++)
-    for(unsigned i = 0; i < Num_Global_Eq; i++)
-      K(i,j) = 0;
-
   // zero initialize F
   for(unsigned i = 0; i < Num_Global_Eq; i++)
     F[i] = 0;
@@ -178,6 +176,14 @@ void Test::Element_Error_Tests(void) {
   try { Elements[0].Move_Ke_To_K(); }
   catch(const Element_Exception & Er) { printf("%s\n",Er.what()); }
 
+  printf("\nSetting K's sparsity pattern... ");
+  Set_K_Sparsity_Pattern(Elements, Num_Elements, Num_Global_Eq);
+  printf("Done! (%u stored components)\n", K.Get_Num_Non_Zero());
+
+  printf("Attempting to set K's sparsity pattern a second time\n");
+  try { Set_K_Sparsity_Pattern(Elements, Num_Elements, Num_Global_Eq); }
+  catch(const Matrix_Not_Set_Up & Er) { printf("%s\n",Er.what()); }
+
   printf("Attempting to move Fe to F\n");
   try { Elements[0].Move_Fe_To_F(); }
   catch(const Element_Exception & Er) { printf("%s\n",Er.what()); }
@@ -345,13 +351,12 @@ void Test::Brick_Element(void) {
   #endif
 
   //////////////////////////////////////////////////////////////////////////////
-  // Set up K, F, and x (the solution vector)
-  class Matrix<double> K{Num_Global_Eq, Num_Global_Eq, Memory::COLUMN_MAJOR};
+  // Set up K, F, and x (the solution vector). K's pattern is set below.
+  class Sparse_Matrix K{};
   double* F = new double[Num_Global_Eq];
   double* x = new double[Num_Global_Eq];
 
-  // Zero initialize K and F
-  K.Zero();
+  // Zero initialize F
   for(unsigned i = 0; i < Num_Global_Eq; i++) { F[i] = 0; }
 
 
@@ -379,8 +384,8 @@ void Test::Brick_Element(void) {
   //////////////////////////////////////////////////////////////////////////////
   // Find K, F
 
-  /* Cycle through the elements. For each element, supply the nodes, compute Ke (and Fe)
-  and then move Ke (and Fe) into K (and F). Watch for exceptions.  */
+  /* Cycle through the elements. For each element, supply the nodes and then
+  compute Ke (and Fe). Watch for exceptions.  */
   unsigned Element_Index = 0;
   try {
     for(unsigned i = 0; i < Nx-1; i++) {
@@ -417,11 +422,6 @@ void Test::Brick_Element(void) {
           Elements[Element_Index].Populate_Ke();
           Elements[Element_Index].Populate_Fe();
 
-
-          // Move Ke to K and Fe to F
-          Elements[Element_Index].Move_Ke_To_K();
-          Elements[Element_Index].Move_Fe_To_F();
-
           Element_Index++;
         } // for(unsigned k = 0; k < Nz-1; k++) {
       } // for(unsigned j = 0; j < Ny-1; j++)
@@ -432,6 +432,21 @@ void Test::Brick_Element(void) {
     return;
   } // // catch (const Element_Exception & Er) {
 
+  /* Now that every element has been set up, we can set up K's sparsity pattern
+  and then move each Ke (and Fe) into K (and F). */
+  try {
+    Set_K_Sparsity_Pattern(Elements, Num_Elements, Num_Global_Eq);
+
+    for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+      Elements[Element_Index].Move_Ke_To_K();
+      Elements[Element_Index].Move_Fe_To_F();
+    } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+  } // try {
+  catch (const Element_Exception & Er) {
+    printf("%s\n",Er.what());
+    return;
+  } // catch (const Element_Exception & Er) {
+
 
   //////////////////////////////////////////////////////////////////////////////
   /* Now, add in the point force contributions to F. */
@@ -596,13 +611,12 @@ void Test::Wedge_Element(void) {
   #endif
 
   //////////////////////////////////////////////////////////////////////////////
-  // Set up K, F, and x (the solution vector)
-  class Matrix<double> K{Num_Global_Eq, Num_Global_Eq, Memory::COLUMN_MAJOR};
+  // Set up K, F, and x (the solution vector). K's pattern is set below.
+  class Sparse_Matrix K{};
   double* F = new double[Num_Global_Eq];
   double* x = new double[Num_Global_Eq];
 
-  // Zero initialize K and F
-  K.Zero();
+  // Zero initialize F
   for(unsigned i = 0; i < Num_Global_Eq; i++) { F[i] = 0; }
 
 
@@ -630,8 +644,8 @@ void Test::Wedge_Element(void) {
   //////////////////////////////////////////////////////////////////////////////
   // Find K, F
 
-  /* Cycle through the elements. For each element, supply the nodes, compute Ke (and Fe)
-  and then move Ke (and Fe) into K (and F). Watch for exceptions.  */
+  /* Cycle through the elements. For each element, supply the nodes and then
+  compute Ke (and Fe). Watch for exceptions.  */
   unsigned Element_Index = 0;
   try {
     for(unsigned depth = 0; depth < N_Depth-1; depth++) {
@@ -703,11 +717,6 @@ void Test::Wedge_Element(void) {
           Elements[Element_Index].Populate_Ke();
           Elements[Element_Index].Populate_Fe();
 
-
-          // Move Ke to K and Fe to F
-          Elements[Element_Index].Move_Ke_To_K();
-          Elements[Element_Index].Move_Fe_To_F();
-
           Element_Index++;
         } // for(unsigned i = 0; i < 2*(N_Base-1-layer) - 1; i++) {
       } // for(unsigned layer = 0; layer < N_Base-1; layer++) {
@@ -718,6 +727,21 @@ void Test::Wedge_Element(void) {
     return;
   } // // catch (const Element_Exception & Er) {
 
+  /* Now that every element has been set up, we can set up K's sparsity pattern
+  and then move each Ke (and Fe) into K (and F). */
+  try {
+    Set_K_Sparsity_Pattern(Elements, Num_Elements, Num_Global_Eq);
+
+    for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+      Elements[Element_Index].Move_Ke_To_K();
+      Elements[Element_Index].Move_Fe_To_F();
+    } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+  } // try {
+  catch (const Element_Exception & Er) {
+    printf("%s\n",Er.what());
+    return;
+  } // catch (const Element_Exception & Er) {
+
 
   //////////////////////////////////////////////////////////////////////////////
   /* Now, add in the point force contributions to F. */
@@ -769,4 +793,124 @@ void Test::Wedge_Element(void) {
   IO::Write::vtk(Nodes, Num_Nodes, Elements, Num_Elements);
 } // void Test::Wedge_Element(void) {
 
+
+
+void Test::Ke_Kernel_Test(void) {
+  /* In this test, we check that Populate_Ke (which computes Ke one nodal block
+  at a time) gives the same Ke as the dense B^T*D*B kernel (Compute_Ke_Dense)
+  for a distorted brick and a wedge. We also time both kernels. */
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Set up a 2x1x1 grid of nodes and then distort it.
+  const unsigned Num_Nodes = 12;
+  const double INS = .1;                         // Inter-nodal spacing         Units: M
+
+  class Node Nodes[Num_Nodes];
+  class Matrix<int> ID{Num_Nodes, 3, Memory::ROW_MAJOR};
+
+  unsigned Node_Index = 0;
+  for(unsigned i = 0; i < 3; i++) {
+    for(unsigned j = 0; j < 2; j++) {
+      for(unsigned k = 0; k < 2; k++) {
+        Nodes[Node_Index].Set_Position_Component(0, INS*(i + .2*sin(1. + Node_Index)));
+        Nodes[Node_Index].Set_Position_Component(1, INS*(j + .2*sin(2. + 3*Node_Index)));
+        Nodes[Node_Index].Set_Position_Component(2, INS*(k + .2*sin(3. + 5*Node_Index)));
+
+        for(unsigned Comp = 0; Comp < 3; Comp++) { ID(Node_Index, Comp) = 3*Node_Index + Comp; }
+        Node_Index++;
+      } // for(unsigned k = 0; k < 2; k++) {
+    } // for(unsigned j = 0; j < 2; j++) {
+  } // for(unsigned i = 0; i < 3; i++) {
+
+  class Sparse_Matrix K{};
+  double F[3*Num_Nodes];
+
+  try {
+    Set_Element_Static_Members(&ID, &K, F, Nodes);
+    Set_Element_Material(10, .3);
+  } // try {
+  catch (const Element_Exception & Er) {
+    printf("%s\n",Er.what());
+    return;
+  } // catch (const Element_Exception & Er) {
+
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // Compare the two kernels (Element 0 is a brick, element 1 is a wedge).
+  const unsigned Ny = 2, Nz = 2;
+  class Element Elements[2];
+
+  try {
+    Elements[0].Set_Nodes(0,
+                          Ny*Nz,
+                          Ny*Nz + Nz,
+                          Nz,
+                          1,
+                          Ny*Nz + 1,
+                          Ny*Nz + Nz + 1,
+                          Nz + 1);
+    Elements[1].Set_Nodes(Ny*Nz,
+                          2*Ny*Nz,
+                          2*Ny*Nz + Nz,
+                          Ny*Nz + 1,
+                          2*Ny*Nz + 1,
+                          2*Ny*Nz + Nz + 1);
+
+    Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> Ke_Dense;
+    for(unsigned Element_Index = 0; Element_Index < 2; Element_Index++) {
+      Elements[Element_Index].Populate_Ke();
+      Elements[Element_Index].Compute_Ke_Dense(Ke_Dense);
+      const Fixed_Matrix<24, 24, Memory::COLUMN_MAJOR> & Ke = Elements[Element_Index].Get_Ke();
+
+      double Max_Difference = 0, Max_Ke = 0;
+      bool Symmetric = true;
+      for(unsigned i = 0; i < 24; i++) {
+        for(unsigned j = 0; j < 24; j++) {
+          if(fabs(Ke(i,j) - Ke_Dense(i,j)) > Max_Difference) { Max_Difference = fabs(Ke(i,j) - Ke_Dense(i,j)); }
+          if(fabs(Ke_Dense(i,j)) > Max_Ke) { Max_Ke = fabs(Ke_Dense(i,j)); }
+          if(Ke(i,j) != Ke(j,i)) { Symmetric = false; }
+        } // for(unsigned j = 0; j < 24; j++) {
+      } // for(unsigned i = 0; i < 24; i++) {
+
+      printf("Element %u: max |Ke - Ke_Dense| = %.3e (max |Ke| = %.3e)\n", Element_Index, Max_Difference, Max_Ke);
+      if(Max_Difference <= 1e-13*Max_Ke) { Tests_Passed++; }
+      else { Tests_Failed++; }
+
+      if(Symmetric == true) { Tests_Passed++; }
+      else { Tests_Failed++; }
+    } // for(unsigned Element_Index = 0; Element_Index < 2; Element_Index++) {
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    /* Time both kernels on copies of the brick (Ke can only be set once, so
+    every Populate_Ke needs its own element). */
+    const unsigned Num_Copies = 20000;
+    class Element* Copies = new Element[Num_Copies];
+    for(unsigned n = 0; n < Num_Copies; n++) { Copies[n].Set_Nodes(0, Ny*Nz, Ny*Nz + Nz, Nz, 1, Ny*Nz + 1, Ny*Nz + Nz + 1, Nz + 1); }
+
+    double Start = omp_get_wtime();
+    for(unsigned n = 0; n < Num_Copies; n++) { Copies[n].Populate_Ke(); }
+    const double Nodal_Block_Time = omp_get_wtime() - Start;
+
+    Start = omp_get_wtime();
+    for(unsigned n = 0; n < Num_Copies; n++) { Copies[n].Compute_Ke_Dense(Ke_Dense); }
+    const double Dense_Time = omp_get_wtime() - Start;
+
+    printf("Dense B^T*D*B: %10.0lf Ke/s\n", Num_Copies/Dense_Time);
+    printf("Nodal blocks:  %10.0lf Ke/s (%.2lfx)\n", Num_Copies/Nodal_Block_Time, Dense_Time/Nodal_Block_Time);
+
+    delete [] Copies;
+  } // try {
+  catch (const Element_Exception & Er) {
+    printf("%s\n",Er.what());
+    Tests_Failed++;
+  } // catch (const Element_Exception & Er) {
+
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+} // void Test::Ke_Kernel_Test(void) {
+
 #endif
@@ -13,6 +13,7 @@ namespace Test {
   void Element_Error_Tests(void);
   void Brick_Element(void);
   void Wedge_Element(void);
+  void Ke_Kernel_Test(void);
 } // namespace Test {
 
 #endif
@@ -1,4 +1,7 @@
 #include "IO_Tests.h"
+#include <sys/stat.h>
+#include <utime.h>
+#include <unistd.h>
 
 void Test::Contains(void) {
   /* First, create some Bufers and some words. */
@@ -94,3 +97,508 @@ void Test::Split(void) {
   for(unsigned i = 0; i < len_Sub_S2; i++) { std::cout << '\"' << Sub_S2[i] << '\"' << std::endl; }
   for(unsigned i = 0; i < len_Sub_S3; i++) { std::cout << '\"' << Sub_S3[i] << '\"' << std::endl; }
 } // void Test::Split(void) {
+
+
+
+void Test::inp_Reader_Test(void) {
+  /* In this test, we check the number scanners (see Number_Scan.h) and the
+  inp readers. First, Scan_Double should read exactly what strtod reads
+  (including numbers that take its slow path), and both scanners should stop
+  at the end of the number. */
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+  const char * Doubles[] = {"0", "-0.", "18.6183834", "  -10.1664066,", "1.5e-3", "1E+10", "7",
+                            "-2.5e", "3.14159265358979323846", "123456789012345678901234.5",
+                            "0.000000000000000000000000001234", "4.9e-324", "1.7976931348623157e308",
+                            "9007199254740993", "1e23", "0.1", ".5", "+2.", "1e-400", "2e400"};
+  const unsigned Num_Doubles = sizeof(Doubles)/sizeof(Doubles[0]);
+
+  for(unsigned i = 0; i < Num_Doubles; i++) {
+    const char * Start = Doubles[i];
+    const char * End = Start + strlen(Start);
+    const char * p = Start;
+    double Value;
+    const bool Scanned = IO::Scan::Scan_Double(p, End, Value);
+
+    char * strtod_End;
+    const double Expected = strtod(Start, &strtod_End);
+
+    if(Scanned == true && memcmp(&Value, &Expected, sizeof(double)) == 0 && p == strtod_End) { Tests_Passed++; }
+    else {
+      printf("Scan_Double(\"%s\") = %.17g, strtod gives %.17g\n", Start, Value, Expected);
+      Tests_Failed++;
+    } // else {
+  } // for(unsigned i = 0; i < Num_Doubles; i++) {
+
+  const char Numbers[] = " 12, 345,\t6\n7";
+  const char * p = Numbers;
+  const char * End = Numbers + strlen(Numbers);
+  unsigned a, b, c, d;
+  double x;
+  if(IO::Scan::Scan_Unsigned(p, End, a) && IO::Scan::Scan_Unsigned(p, End, b) && IO::Scan::Scan_Unsigned(p, End, c) &&
+     a == 12 && b == 345 && c == 6) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  // Neither scanner moves past the end of a line.
+  if(IO::Scan::Scan_Unsigned(p, End, d) == false && IO::Scan::Scan_Double(p, End, x) == false && *p == '\n') { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Now, read a small inp file. It has a wedge, comments, a "*Node Output"
+  section (which isn't a node section), set boundary lines (one of which
+  names an instance's node set), a generate node set without an increment,
+  and a node set without a trailing comma in its header. */
+  FILE * File = fopen("./IO/Reader_Test.inp", "w");
+  if(File == nullptr) {
+    printf("Could not create ./IO/Reader_Test.inp\n");
+    return;
+  } // if(File == nullptr) {
+  fprintf(File,
+          "*Heading\n"
+          "** A comment\n"
+          "*NODE\n"
+          "1, 0., 0., 0.\r\n"
+          "2, 1., 0., 0.\n"
+          "** Another comment\n"
+          "3, 0., 1.5e-1, 0.\n"
+          "4, 0., 0., 1.\n"
+          "5, 1., 0., 1.\n"
+          "6, 0., 1., 1.\n"
+          "*Element, type=C3D6\n"
+          "1, 1, 2, 3, 4, 5, 6\n"
+          "*Nset, nset=Left, generate\n"
+          "  2, 6\n"
+          "*Nset, nset=Top\n"
+          "4, 5,\n"
+          "6\n"
+          "*Boundary\n"
+          "Left, 1, 3\n"
+          "3, 2, 2, 0.25\n"
+          "Part-1-1.Top, ZSYMM\n"
+          "*Node Output\n"
+          "U, RF\n");
+  fclose(File);
+
+  std::vector<Array<double, 3>> Node_Positions;
+  std::vector<Array<unsigned, 8>> Element_Node_Lists;
+  std::vector<IO::Read::inp_boundary_data> Boundary_List;
+  std::vector<unsigned> Left, Top, All;
+  IO::Read::inp_mesh Mesh;
+  try {
+    IO::Read::inp("Reader_Test.inp", Node_Positions, Element_Node_Lists, Boundary_List);
+    IO::Read::inp("Reader_Test.inp", Mesh);
+    IO::Read::node_set("Reader_Test.inp", Left, "Left");
+    IO::Read::node_set("Reader_Test.inp", Top, "Top");
+    IO::Read::node_set("Reader_Test.inp", All);
+  } // try {
+  catch (const IO_Exception & Er) {
+    printf("%s\n", Er.what());
+    remove("./IO/Reader_Test.inp");
+    return;
+  } // catch (const IO_Exception & Er) {
+
+  if(Node_Positions.size() == 6 && Node_Positions[2][1] == 0.15 && Node_Positions[5][2] == 1.) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  const unsigned Expected_Nodes[8] = {0, 1, 2, 2, 3, 4, 5, 5};
+  bool Element_Match = (Element_Node_Lists.size() == 1);
+  for(unsigned i = 0; i < 8 && Element_Match == true; i++) { Element_Match = (Element_Node_Lists[0][i] == Expected_Nodes[i]); }
+  if(Element_Match == true) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  if(Boundary_List.size() == 1 && Boundary_List[0].Node_Number == 2 && Boundary_List[0].Start_DOF == 2 &&
+     Boundary_List[0].End_DOF == 2 && Boundary_List[0].displacement == 0.25) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  if(Left.size() == 5 && Left[0] == 1 && Left[4] == 5) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  if(Top.size() == 3 && Top[0] == 3 && Top[1] == 4 && Top[2] == 5) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  if(All.size() == 8) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  /* The mesh should have the same nodes, elements, and boundary data, plus
+  both node sets and both set boundary lines. */
+  if(Mesh.Node_Positions.size() == 6 && Mesh.Element_Node_Lists.size() == 1 && Mesh.Boundary_List.size() == 1) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  if(Mesh.Node_Sets.size() == 2 && Mesh.Node_Sets[0].Name == "Left" && Mesh.Node_Sets[0].Nodes == Left &&
+     Mesh.Node_Sets[1].Name == "Top" && Mesh.Node_Sets[1].Nodes == Top) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  if(Mesh.Set_Boundary_List.size() == 2 &&
+     Mesh.Set_Boundary_List[0].Node_Set_Name == "Left" && Mesh.Set_Boundary_List[0].Start_DOF == 1 &&
+     Mesh.Set_Boundary_List[0].End_DOF == 3 && Mesh.Set_Boundary_List[0].displacement == 0. &&
+     Mesh.Set_Boundary_List[1].Node_Set_Name == "Part-1-1.Top" && Mesh.Set_Boundary_List[1].Start_DOF == 3 &&
+     Mesh.Set_Boundary_List[1].End_DOF == 3) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  // "Part-1-1.Top" should find Top. There's no Right node set.
+  if(Mesh.Find_Node_Set("Part-1-1.Top") == &Mesh.Node_Sets[1] && Mesh.Find_Node_Set("Right") == nullptr) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  remove("./IO/Reader_Test.inp");
+
+  printf("inp reader test:\n");
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+} // void Test::inp_Reader_Test(void) {
+
+
+
+void Test::inp_Benchmark(void) {
+  /* In this test, we measure how quickly IO::Read::inp (with different
+  numbers of threads) and IO::Read::node_set read a large inp file, and
+  compare them to a getline/sscanf reader (which is how the inp reader used
+  to work). The file holds an N by N by N brick mesh
+  whose node coordinates are jittered (so that they have plenty of digits).
+  Both readers must give exactly the same nodes, elements, and node set. */
+  const unsigned N = 80;
+  const unsigned Num_Nodes = (N+1)*(N+1)*(N+1);
+  const unsigned Num_Elements = N*N*N;
+  const std::string File_Name = "Benchmark.inp";
+  const std::string File_Path = "./IO/" + File_Name;
+
+  FILE * File = fopen(File_Path.c_str(), "w");
+  if(File == nullptr) {
+    printf("Could not create %s\n", File_Path.c_str());
+    return;
+  } // if(File == nullptr) {
+
+  srand(1);
+  fprintf(File, "*Heading\n** Benchmark mesh\n*Part, name=Part-1\n*Node\n");
+  for(unsigned i = 0; i <= N; i++) {
+    for(unsigned j = 0; j <= N; j++) {
+      for(unsigned k = 0; k <= N; k++) {
+        const unsigned Node_Index = (N+1)*(N+1)*i + (N+1)*j + k;
+        double Position[3] = {(double)i, (double)j, (double)k};
+        for(unsigned Comp = 0; Comp < 3; Comp++) { Position[Comp] = (Position[Comp] + .2*((double)rand()/RAND_MAX - .5))/(double)N; }
+        fprintf(File, "%7u, %14.9g, %14.9g, %14.9g\n", Node_Index + 1, Position[0], Position[1], Position[2]);
+      } // for(unsigned k = 0; k <= N; k++) {
+    } // for(unsigned j = 0; j <= N; j++) {
+  } // for(unsigned i = 0; i <= N; i++) {
+
+  fprintf(File, "*Element, type=C3D8\n");
+  for(unsigned i = 0; i < N; i++) {
+    for(unsigned j = 0; j < N; j++) {
+      for(unsigned k = 0; k < N; k++) {
+        unsigned Node_List[8];
+        for(unsigned Level = 0; Level < 2; Level++) {
+          const unsigned kk = k + Level;
+          Node_List[4*Level + 0] = (N+1)*(N+1)*(i  ) + (N+1)*(j  ) + kk + 1;
+          Node_List[4*Level + 1] = (N+1)*(N+1)*(i+1) + (N+1)*(j  ) + kk + 1;
+          Node_List[4*Level + 2] = (N+1)*(N+1)*(i+1) + (N+1)*(j+1) + kk + 1;
+          Node_List[4*Level + 3] = (N+1)*(N+1)*(i  ) + (N+1)*(j+1) + kk + 1;
+        } // for(unsigned Level = 0; Level < 2; Level++) {
+        fprintf(File, "%7u, %7u, %7u, %7u, %7u, %7u, %7u, %7u, %7u\n", N*N*i + N*j + k + 1,
+                Node_List[0], Node_List[1], Node_List[2], Node_List[3], Node_List[4], Node_List[5], Node_List[6], Node_List[7]);
+      } // for(unsigned k = 0; k < N; k++) {
+    } // for(unsigned j = 0; j < N; j++) {
+  } // for(unsigned i = 0; i < N; i++) {
+
+  // The bottom face (k = 0) is a list node set.
+  fprintf(File, "*Nset, nset=Bottom\n");
+  for(unsigned ij = 0; ij < (N+1)*(N+1); ij++) {
+    fprintf(File, "%7u%s", (N+1)*ij + 1, (ij % 16 == 15 || ij + 1 == (N+1)*(N+1)) ? "\n" : ", ");
+  } // for(unsigned ij = 0; ij < (N+1)*(N+1); ij++) {
+  fprintf(File, "*End Part\n");
+  fclose(File);
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // First, read the file with getline and sscanf.
+  std::vector<Array<double, 3>> Reference_Nodes;
+  std::vector<Array<unsigned, 8>> Reference_Elements;
+  std::vector<unsigned> Reference_Set;
+
+  double Start = omp_get_wtime();
+  {
+    std::ifstream In{File_Path.c_str()};
+    char buffer[256];
+    enum { NONE, NODES, ELEMENTS, NSET } Section = NONE;
+    while(In.getline(buffer, 256)) {
+      if(buffer[0] == '*') {
+        if(String_Ops::Contains(buffer, "*Node")) { Section = NODES; }
+        else if(String_Ops::Contains(buffer, "*Element")) { Section = ELEMENTS; }
+        else if(String_Ops::Contains(buffer, "*Nset")) { Section = NSET; }
+        else { Section = NONE; }
+        continue;
+      } // if(buffer[0] == '*') {
+
+      if(Section == NODES) {
+        Array<double, 3> Position;
+        sscanf(buffer, "%*d, %lf, %lf, %lf", &Position[0], &Position[1], &Position[2]);
+        Reference_Nodes.push_back(Position);
+      } // if(Section == NODES) {
+      else if(Section == ELEMENTS) {
+        Array<unsigned, 8> Node_List;
+        sscanf(buffer, "%*d, %u, %u, %u, %u, %u, %u, %u, %u",
+               &Node_List[0], &Node_List[1], &Node_List[2], &Node_List[3], &Node_List[4], &Node_List[5], &Node_List[6], &Node_List[7]);
+        for(unsigned a = 0; a < 8; a++) { Node_List[a]--; }
+        Reference_Elements.push_back(Node_List);
+      } // else if(Section == ELEMENTS) {
+      else if(Section == NSET) {
+        std::vector<std::string> Sub_Strs = String_Ops::Split(buffer);
+        for(unsigned i = 0; i < Sub_Strs.size(); i++) {
+          unsigned Node_Number;
+          if(sscanf(Sub_Strs[i].c_str(), " %u", &Node_Number) == 1) { Reference_Set.push_back(Node_Number - 1); }
+        } // for(unsigned i = 0; i < Sub_Strs.size(); i++) {
+      } // else if(Section == NSET) {
+    } // while(In.getline(buffer, 256)) {
+  }
+  const double Reference_Time = omp_get_wtime() - Start;
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Now, read it with IO::Read::node_set, and then with IO::Read::inp using
+  1, 2, 4, ... threads (and the maximum number of threads). Each read must
+  give exactly the same nodes, elements, and node set as sscanf. */
+  std::ifstream Size_Check{File_Path.c_str(), std::ifstream::ate | std::ifstream::binary};
+  const double MB = (double)Size_Check.tellg()/(1024.*1024.);
+  Size_Check.close();
+
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+  std::vector<unsigned> Node_Set;
+  Start = omp_get_wtime();
+  IO::Read::node_set(File_Name, Node_Set, "Bottom");
+  const double node_set_Time = omp_get_wtime() - Start;
+
+  if(Node_Set == Reference_Set && Node_Set.size() == (N+1)*(N+1)) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  printf("inp reader throughput (%u nodes, %u elements, %.1lf MB):\n", Num_Nodes, Num_Elements, MB);
+  printf("Reader               | Threads |   Time (s) |       MB/s | Speedup\n");
+  printf("getline + sscanf     | %7d | %10.4lf | %10.1lf | %7.2lf\n", 1, Reference_Time, MB/Reference_Time, 1.);
+  printf("IO::Read::node_set   | %7d | %10.4lf | %10.1lf | %7.2lf\n", 1, node_set_Time, MB/node_set_Time, Reference_Time/node_set_Time);
+
+  const int Max_Threads = omp_get_max_threads();
+  int Num_Threads = 1;
+  while(true) {
+    std::vector<Array<double, 3>> Node_Positions;
+    std::vector<Array<unsigned, 8>> Element_Node_Lists;
+    std::vector<IO::Read::inp_boundary_data> Boundary_List;
+
+    omp_set_num_threads(Num_Threads);
+    Start = omp_get_wtime();
+    IO::Read::inp(File_Name, Node_Positions, Element_Node_Lists, Boundary_List);
+    const double inp_Time = omp_get_wtime() - Start;
+
+    printf("IO::Read::inp        | %7d | %10.4lf | %10.1lf | %7.2lf\n", Num_Threads, inp_Time, MB/inp_Time, Reference_Time/inp_Time);
+
+    bool Match = (Node_Positions.size() == Num_Nodes && Reference_Nodes.size() == Num_Nodes);
+    for(unsigned n = 0; n < Num_Nodes && Match == true; n++) {
+      for(unsigned Comp = 0; Comp < 3; Comp++) {
+        if(memcmp(&Node_Positions[n][Comp], &Reference_Nodes[n][Comp], sizeof(double)) != 0) { Match = false; }
+      } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+    } // for(unsigned n = 0; n < Num_Nodes && Match == true; n++) {
+    if(Match == true) { Tests_Passed++; }
+    else { Tests_Failed++; }
+
+    Match = (Element_Node_Lists.size() == Num_Elements && Reference_Elements.size() == Num_Elements);
+    for(unsigned e = 0; e < Num_Elements && Match == true; e++) {
+      for(unsigned a = 0; a < 8; a++) {
+        if(Element_Node_Lists[e][a] != Reference_Elements[e][a]) { Match = false; }
+      } // for(unsigned a = 0; a < 8; a++) {
+    } // for(unsigned e = 0; e < Num_Elements && Match == true; e++) {
+    if(Match == true) { Tests_Passed++; }
+    else { Tests_Failed++; }
+
+    // Double the number of threads (but make sure that we also test the maximum)
+    if(Num_Threads == Max_Threads) { break; }
+    else if(2*Num_Threads < Max_Threads) { Num_Threads *= 2; }
+    else { Num_Threads = Max_Threads; }
+  } // while(true) {
+  omp_set_num_threads(Max_Threads);
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Finally, cache the mesh (see Mesh_Cache.h), and then load it from the
+  cache. The cached mesh must match sscanf too. */
+  IO::Read::inp_mesh Mesh;
+  IO::Read::inp(File_Name, Mesh);
+  remove(IO::Mesh_Cache_Path(File_Name).c_str());
+
+  Start = omp_get_wtime();
+  IO::Write::mesh_cache(File_Name, Mesh);
+  const double Write_Time = omp_get_wtime() - Start;
+
+  IO::Read::inp_mesh Cached_Mesh;
+  Start = omp_get_wtime();
+  const bool Loaded = IO::Read::mesh_cache(File_Name, Cached_Mesh);
+  const double Load_Time = omp_get_wtime() - Start;
+
+  printf("IO::Write::mesh_cache| %7d | %10.4lf | %10.1lf | %7.2lf\n", Max_Threads, Write_Time, MB/Write_Time, Reference_Time/Write_Time);
+  printf("IO::Read::mesh_cache | %7d | %10.4lf | %10.1lf | %7.2lf\n", Max_Threads, Load_Time, MB/Load_Time, Reference_Time/Load_Time);
+
+  bool Match = (Loaded == true && Cached_Mesh.Node_Positions.size() == Num_Nodes && Cached_Mesh.Element_Node_Lists.size() == Num_Elements);
+  if(Match == true) {
+    Match = (memcmp(Cached_Mesh.Node_Positions.data(), Reference_Nodes.data(), Num_Nodes*sizeof(Array<double, 3>)) == 0);
+    for(unsigned e = 0; e < Num_Elements && Match == true; e++) {
+      for(unsigned a = 0; a < 8; a++) {
+        if(Cached_Mesh.Element_Node_Lists[e][a] != Reference_Elements[e][a]) { Match = false; }
+      } // for(unsigned a = 0; a < 8; a++) {
+    } // for(unsigned e = 0; e < Num_Elements && Match == true; e++) {
+  } // if(Match == true) {
+  if(Match == true && Cached_Mesh.Node_Sets.size() == 1 && Cached_Mesh.Node_Sets[0].Nodes == Reference_Set) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  remove(IO::Mesh_Cache_Path(File_Name).c_str());
+  remove(File_Path.c_str());
+
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+} // void Test::inp_Benchmark(void) {
+
+
+
+static bool Same_Mesh(const IO::Read::inp_mesh & A, const IO::Read::inp_mesh & B) {
+  /* Check if two meshes hold exactly the same data (positions are compared
+  bit for bit). */
+  if(A.Node_Positions.size() != B.Node_Positions.size() || A.Element_Node_Lists.size() != B.Element_Node_Lists.size() ||
+     A.Boundary_List.size() != B.Boundary_List.size() || A.Set_Boundary_List.size() != B.Set_Boundary_List.size() ||
+     A.Node_Sets.size() != B.Node_Sets.size()) { return false; }
+
+  if(memcmp(A.Node_Positions.data(), B.Node_Positions.data(), A.Node_Positions.size()*sizeof(Array<double, 3>)) != 0) { return false; }
+
+  for(unsigned e = 0; e < A.Element_Node_Lists.size(); e++) {
+    for(unsigned a = 0; a < 8; a++) {
+      if(A.Element_Node_Lists[e][a] != B.Element_Node_Lists[e][a]) { return false; }
+    } // for(unsigned a = 0; a < 8; a++) {
+  } // for(unsigned e = 0; e < A.Element_Node_Lists.size(); e++) {
+
+  for(unsigned i = 0; i < A.Boundary_List.size(); i++) {
+    if(A.Boundary_List[i].Node_Number != B.Boundary_List[i].Node_Number || A.Boundary_List[i].Start_DOF != B.Boundary_List[i].Start_DOF ||
+       A.Boundary_List[i].End_DOF != B.Boundary_List[i].End_DOF || A.Boundary_List[i].displacement != B.Boundary_List[i].displacement) { return false; }
+  } // for(unsigned i = 0; i < A.Boundary_List.size(); i++) {
+
+  for(unsigned i = 0; i < A.Set_Boundary_List.size(); i++) {
+    if(A.Set_Boundary_List[i].Node_Set_Name != B.Set_Boundary_List[i].Node_Set_Name || A.Set_Boundary_List[i].Start_DOF != B.Set_Boundary_List[i].Start_DOF ||
+       A.Set_Boundary_List[i].End_DOF != B.Set_Boundary_List[i].End_DOF || A.Set_Boundary_List[i].displacement != B.Set_Boundary_List[i].displacement) { return false; }
+  } // for(unsigned i = 0; i < A.Set_Boundary_List.size(); i++) {
+
+  for(unsigned i = 0; i < A.Node_Sets.size(); i++) {
+    if(A.Node_Sets[i].Name != B.Node_Sets[i].Name || A.Node_Sets[i].Nodes != B.Node_Sets[i].Nodes) { return false; }
+  } // for(unsigned i = 0; i < A.Node_Sets.size(); i++) {
+
+  return true;
+} // static bool Same_Mesh(const IO::Read::inp_mesh & A, const IO::Read::inp_mesh & B) {
+
+
+
+void Test::Mesh_Cache_Test(void) {
+  /* In this test, we check the binary mesh cache (see Mesh_Cache.h). A cached
+  mesh should match the mesh read from the inp file exactly. The cache should
+  still be used if the inp file is touched (only its modification time
+  changes), but not if the inp file changes (even if its size doesn't), or if
+  the cache is corrupted or truncated. */
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+  const std::string File_Name = "Cache_Test.inp";
+  const std::string File_Path = "./IO/" + File_Name;
+  const std::string Cache_Path = IO::Mesh_Cache_Path(File_Name);
+  const char * Deck =
+    "*Node\n"
+    "1, 0., 0., 0.\n"
+    "2, 1., 0., 0.\n"
+    "3, 0., 1., 0.\n"
+    "4, 0., 0., 1.\n"
+    "5, 1., 0., 1.\n"
+    "6, 0., 1., 1.\n"
+    "7, 1., 1., 0.\n"
+    "8, 1., 1., 1.\n"
+    "*Element, type=C3D6\n"
+    "1, 1, 2, 3, 4, 5, 6\n"
+    "*Element, type=C3D8\n"
+    "2, 1, 2, 7, 3, 4, 5, 8, 6\n"
+    "*Nset, nset=Bottom, generate\n"
+    "1, 3\n"
+    "*Nset, nset=Corner\n"
+    "8\n"
+    "*Boundary\n"
+    "Bottom, ENCASTRE\n"
+    "8, 3, 3, 0.125\n";
+
+  FILE * File = fopen(File_Path.c_str(), "w");
+  if(File == nullptr) {
+    printf("Could not create %s\n", File_Path.c_str());
+    return;
+  } // if(File == nullptr) {
+  fprintf(File, "%s", Deck);
+  fclose(File);
+  remove(Cache_Path.c_str());
+
+  IO::Read::inp_mesh Mesh;
+  IO::Read::inp(File_Name, Mesh);
+
+  // There's no cache yet.
+  IO::Read::inp_mesh Cached_Mesh;
+  if(IO::Read::mesh_cache(File_Name, Cached_Mesh) == false && Cached_Mesh.Node_Positions.size() == 0) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  // Now there is.
+  IO::Write::mesh_cache(File_Name, Mesh);
+  if(IO::Read::mesh_cache(File_Name, Cached_Mesh) == true && Same_Mesh(Mesh, Cached_Mesh) == true) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  // Touch the inp file (give it an older modification time).
+  struct stat Status;
+  stat(File_Path.c_str(), &Status);
+  struct utimbuf Times;
+  Times.actime = Status.st_atime;
+  Times.modtime = Status.st_mtime - 1000;
+  utime(File_Path.c_str(), &Times);
+
+  IO::Read::inp_mesh Touched_Mesh;
+  if(IO::Read::mesh_cache(File_Name, Touched_Mesh) == true && Same_Mesh(Mesh, Touched_Mesh) == true) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  // Change a coordinate (keeping the file's size and modification time).
+  std::string Changed_Deck{Deck};
+  Changed_Deck[Changed_Deck.find("2, 1., 0., 0.") + 3] = '2';
+  File = fopen(File_Path.c_str(), "w");
+  fprintf(File, "%s", Changed_Deck.c_str());
+  fclose(File);
+  utime(File_Path.c_str(), &Times);
+
+  IO::Read::inp_mesh Stale_Mesh;
+  if(IO::Read::mesh_cache(File_Name, Stale_Mesh) == false) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  // Put the inp file back, rewrite the cache, and then corrupt a coordinate.
+  File = fopen(File_Path.c_str(), "w");
+  fprintf(File, "%s", Deck);
+  fclose(File);
+  IO::Write::mesh_cache(File_Name, Mesh);
+
+  File = fopen(Cache_Path.c_str(), "r+b");
+  fseek(File, (long)sizeof(IO::Mesh_Cache_Header) + 3, SEEK_SET);
+  fputc(0x7F, File);
+  fclose(File);
+
+  IO::Read::inp_mesh Corrupt_Mesh;
+  if(IO::Read::mesh_cache(File_Name, Corrupt_Mesh) == false) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  // Finally, truncate the cache.
+  IO::Write::mesh_cache(File_Name, Mesh);
+  stat(Cache_Path.c_str(), &Status);
+  truncate(Cache_Path.c_str(), Status.st_size - 8);
+
+  IO::Read::inp_mesh Truncated_Mesh;
+  if(IO::Read::mesh_cache(File_Name, Truncated_Mesh) == false) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  remove(Cache_Path.c_str());
+  remove(File_Path.c_str());
+
+  printf("Mesh cache test:\n");
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+} // void Test::Mesh_Cache_Test(void) {
@@ -3,6 +3,10 @@
 
 #include "IO/inp_Reader.h"
 #include "IO/String_Ops.h"
+#include "IO/Number_Scan.h"
+#include "IO/Mesh_Cache.h"
+#include <omp.h>
+#include <stdlib.h>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -10,6 +14,9 @@
 namespace Test {
   void Contains();                               // Tests String_Ops::Contains
   void Split();                                  // Tests String_Ops::Split
+  void inp_Reader_Test();                        // Tests IO::Scan and the inp readers
+  void inp_Benchmark();                          // Measures inp reader (and mesh cache) throughput
+  void Mesh_Cache_Test();                        // Tests the binary mesh cache
 } // namespace Test {
 
 #endif
@@ -173,6 +173,158 @@ void Test::Matrix_Correctness_Tests(void) {
 
 
 
+void Test::Sparse_Matrix_Tests(void) {
+  /* In this test, we build a symmetric sparse matrix and check that it agrees
+  with the equivalent dense matrix. To make this easier to understand, I first
+  initialize an array that holds the (dense) matrix. */
+  const unsigned n = 8;
+  double M_Array[64] = { 7, 0, 1, 0, 0, 2, 7, 0,
+                         0,-4, 8, 0, 2, 0, 0, 0,
+                         1, 8, 1, 0, 0, 0, 0, 5,
+                         0, 0, 0, 7, 0, 0, 9, 0,
+                         0, 2, 0, 0, 5,-1, 5, 0,
+                         2, 0, 0, 0,-1, 0, 0, 5,
+                         7, 0, 0, 9, 5, 0,11, 0,
+                         0, 0, 5, 0, 0, 5, 0, 5};
+
+  /* Set the pattern. We deliberately include both triangles, a duplicate, and
+  one component ((0,3)) that will stay zero. */
+  std::vector<std::vector<unsigned>> Row_Columns(n);
+  for(unsigned i = 0; i < n; i++) {
+    for(unsigned j = 0; j < n; j++) {
+      if(M_Array[i*n + j] != 0) { Row_Columns[i].push_back(j); }
+    } // for(unsigned j = 0; j < n; j++) {
+  } // for(unsigned i = 0; i < n; i++) {
+  Row_Columns[0].push_back(6);
+  Row_Columns[0].push_back(3);
+
+  Sparse_Matrix M{};
+  M.Set_Pattern(n, Row_Columns);
+
+  /* Add the upper triangle (Add_To also sets the lower triangle) */
+  for(unsigned i = 0; i < n; i++) {
+    for(unsigned j = i; j < n; j++) {
+      if(M_Array[i*n + j] != 0) { M.Add_To(i, j, M_Array[i*n + j]); }
+    } // for(unsigned j = i; j < n; j++) {
+  } // for(unsigned i = 0; i < n; i++) {
+
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+  // Check every component (in both triangles)
+  for(unsigned i = 0; i < n; i++) {
+    for(unsigned j = 0; j < n; j++) {
+      if(M(i,j) == M_Array[i*n + j]) { Tests_Passed++; }
+      else { Tests_Failed++; }
+    } // for(unsigned j = 0; j < n; j++) {
+  } // for(unsigned i = 0; i < n; i++) {
+
+  // Check the matrix-vector product.
+  double x[n], y[n];
+  for(unsigned i = 0; i < n; i++) { x[i] = (double)i + 1; }
+  M.Multiply(x, y);
+  for(unsigned i = 0; i < n; i++) {
+    double y_i = 0;
+    for(unsigned j = 0; j < n; j++) { y_i += M_Array[i*n + j]*x[j]; }
+
+    if(y[i] == y_i) { Tests_Passed++; }
+    else { Tests_Failed++; }
+  } // for(unsigned i = 0; i < n; i++) {
+
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+
+
+  // Finally, check that the errors are handled correctly.
+  printf("\nAdding a component that is not in the pattern:\n");
+  try { M.Add_To(1, 7, 1.); }
+  catch(const Matrix_Not_In_Pattern & Er) { printf("%s\n", Er.what()); }
+
+  printf("Setting the pattern a second time:\n");
+  try { M.Set_Pattern(n, Row_Columns); }
+  catch(const Matrix_Not_Set_Up & Er) { printf("%s\n", Er.what()); }
+
+  printf("Adding to a matrix without a pattern:\n");
+  Sparse_Matrix M2{};
+  try { M2.Add_To(0, 0, 1.); }
+  catch(const Matrix_Not_Set_Up & Er) { printf("%s\n", Er.what()); }
+} // void Test::Sparse_Matrix_Tests(void) {
+
+
+
+void Test::Fixed_Matrix_Tests(void) {
+  /* In this test, we check that the Fixed_Matrix operators give exactly the
+  same results as the Matrix operators. We use the shapes from Compute_Ke: a
+  6x6 row major D and a 6x24 column major B. We also multiply D by a row major
+  B (so that we check both product layouts). */
+  Matrix<double> D{6, 6, Memory::ROW_MAJOR};
+  Matrix<double> B{6, 24, Memory::COLUMN_MAJOR};
+  Matrix<double> B_Row{6, 24, Memory::ROW_MAJOR};
+  Fixed_Matrix<6, 6, Memory::ROW_MAJOR> D_Fixed;
+  Fixed_Matrix<6, 24, Memory::COLUMN_MAJOR> B_Fixed;
+  Fixed_Matrix<6, 24, Memory::ROW_MAJOR> B_Row_Fixed;
+
+  for(unsigned i = 0; i < 6; i++) {
+    for(unsigned j = 0; j < 6; j++) {
+      D(i,j) = 1./(1. + i + 2*j);
+      D_Fixed(i,j) = D(i,j);
+    } // for(unsigned j = 0; j < 6; j++) {
+
+    for(unsigned j = 0; j < 24; j++) {
+      B(i,j) = (double)((7*i + 3*j) % 11) - 5.;
+      B_Row(i,j) = B(i,j);
+      B_Fixed(i,j) = B(i,j);
+      B_Row_Fixed(i,j) = B(i,j);
+    } // for(unsigned j = 0; j < 24; j++) {
+  } // for(unsigned i = 0; i < 6; i++) {
+
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+  // Row major times column major (JD*B in Compute_Ke)
+  const double J = 0.3;
+  Matrix<double> JD_B = (J*D)*B;
+  Fixed_Matrix<6, 24, Memory::COLUMN_MAJOR> JD_B_Fixed = (J*D_Fixed)*B_Fixed;
+
+  // Row major times row major (the product is row major)
+  Matrix<double> D_B_Row = D*B_Row;
+  Fixed_Matrix<6, 24, Memory::ROW_MAJOR> D_B_Row_Fixed = D_Fixed*B_Row_Fixed;
+
+  // Mixed layout addition
+  Fixed_Matrix<6, 24, Memory::COLUMN_MAJOR> Sum_Fixed = JD_B_Fixed;
+  Sum_Fixed += D_B_Row_Fixed;
+
+  for(unsigned i = 0; i < 6; i++) {
+    for(unsigned j = 0; j < 24; j++) {
+      if(JD_B_Fixed(i,j) == JD_B(i,j)) { Tests_Passed++; }
+      else { Tests_Failed++; }
+
+      if(D_B_Row_Fixed(i,j) == D_B_Row(i,j)) { Tests_Passed++; }
+      else { Tests_Failed++; }
+
+      if(Sum_Fixed(i,j) == JD_B(i,j) + D_B_Row(i,j)) { Tests_Passed++; }
+      else { Tests_Failed++; }
+    } // for(unsigned j = 0; j < 24; j++) {
+  } // for(unsigned i = 0; i < 6; i++) {
+
+  // Finally, check Fill and the dimensions.
+  Sum_Fixed.Fill(2);
+  bool Filled = true;
+  for(unsigned i = 0; i < 6; i++)
+    for(unsigned j = 0; j < 24; j++)
+      if(Sum_Fixed(i,j) != 2) { Filled = false; }
+  if(Filled == true) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  if(Sum_Fixed.Get_Num_Rows() == 6 && Sum_Fixed.Get_Num_Cols() == 24) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+} // void Test::Fixed_Matrix_Tests(void) {
+
+
+
 void Test::Print(const Matrix<double> & M) {
   // Loop through the rows of M, printing out each one.
   for(unsigned i = 0; i < M.Get_Num_Rows(); i++) {
@@ -3,10 +3,14 @@
 
 #include "Errors.h"
 #include "Matrix.h"
+#include "Fixed_Matrix.h"
+#include "Sparse/Sparse_Matrix.h"
 
 namespace Test {
   void Matrix_Error_Tests(void);
   void Matrix_Correctness_Tests(void);
+  void Sparse_Matrix_Tests(void);
+  void Fixed_Matrix_Tests(void);
   void Print(const Matrix<double> & M);          // Used to print out matricies
 } // namespace Test {
 
@@ -1,4 +1,6 @@
 #include "Pardiso_Tests.h"
+#include <math.h>
+#include <vector>
 
 void Test::Compress_Matrix(void) {
   /* In this test, we are going to see that the Compress_K function compresses
@@ -28,3 +30,100 @@ void Test::Compress_Matrix(void) {
   /* Now that we have defined M, let's compress it. */
   Compressed_Matrix M_Compressed{M_Matrix};
 } // void Test::Compress_Matrix(void) {
+
+
+
+void Test::Pardiso_Solver_Tests(void) {
+  /* In this test, we check that a Pardiso_Solver can be reused. We solve
+  Mx = F, then (without re-doing the symbolic factorization) solve with a new
+  F, and then re-factor using 2*M (which should halve the solution). M is
+  symmetric and diagonally dominant (and thus positive definite). */
+  const unsigned n = 6;
+  double M_Array[36] = { 9, 1, 0, 2, 0, 0,
+                         1, 8, 1, 0, 0, 1,
+                         0, 1, 7, 0, 3, 0,
+                         2, 0, 0, 9, 1, 0,
+                         0, 0, 3, 1, 8, 2,
+                         0, 1, 0, 0, 2, 6};
+
+  std::vector<std::vector<unsigned>> Row_Columns(n);
+  for(unsigned i = 0; i < n; i++) {
+    for(unsigned j = 0; j < n; j++) {
+      if(M_Array[i*n + j] != 0) { Row_Columns[i].push_back(j); }
+    } // for(unsigned j = 0; j < n; j++) {
+  } // for(unsigned i = 0; i < n; i++) {
+
+  Sparse_Matrix M{};
+  M.Set_Pattern(n, Row_Columns);
+  for(unsigned i = 0; i < n; i++) {
+    for(unsigned j = i; j < n; j++) {
+      if(M_Array[i*n + j] != 0) { M.Add_To(i, j, M_Array[i*n + j]); }
+    } // for(unsigned j = i; j < n; j++) {
+  } // for(unsigned i = 0; i < n; i++) {
+
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+  /* Pick x, compute F = Mx, solve, and check that we get x back. */
+  double x_True[n], F[n], x[n];
+  for(unsigned i = 0; i < n; i++) { x_True[i] = (double)i - 2.; }
+  M.Multiply(x_True, F);
+
+  try {
+    Pardiso_Solver Solver{M};
+
+    // Solving before factoring should throw.
+    try {
+      Solver.Solve(x, F);
+      Tests_Failed++;
+    } // try {
+    catch(const Solver_Not_Set_Up & Er) { Tests_Passed++; }
+
+    Solver.Factor(M);
+    Solver.Solve(x, F);
+    for(unsigned i = 0; i < n; i++) {
+      if(fabs(x[i] - x_True[i]) < 1e-10) { Tests_Passed++; }
+      else { Tests_Failed++; }
+    } // for(unsigned i = 0; i < n; i++) {
+
+    /* New F, same factorization (phase 33 only) */
+    for(unsigned i = 0; i < n; i++) { x_True[i] = 1./((double)i + 1.); }
+    M.Multiply(x_True, F);
+    Solver.Solve(x, F);
+    for(unsigned i = 0; i < n; i++) {
+      if(fabs(x[i] - x_True[i]) < 1e-10) { Tests_Passed++; }
+      else { Tests_Failed++; }
+    } // for(unsigned i = 0; i < n; i++) {
+
+    /* New values, same pattern (phases 22 and 33 only). Doubling M should
+    halve x. */
+    for(unsigned i = 0; i < n; i++) {
+      for(unsigned j = i; j < n; j++) {
+        if(M_Array[i*n + j] != 0) { M.Add_To(i, j, M_Array[i*n + j]); }
+      } // for(unsigned j = i; j < n; j++) {
+    } // for(unsigned i = 0; i < n; i++) {
+    Solver.Factor(M);
+    Solver.Solve(x, F);
+    for(unsigned i = 0; i < n; i++) {
+      if(fabs(x[i] - .5*x_True[i]) < 1e-10) { Tests_Passed++; }
+      else { Tests_Failed++; }
+    } // for(unsigned i = 0; i < n; i++) {
+
+    // Factoring a matrix with a different pattern should throw.
+    Sparse_Matrix M2{};
+    std::vector<std::vector<unsigned>> Diagonal(n);
+    M2.Set_Pattern(n, Diagonal);
+    try {
+      Solver.Factor(M2);
+      Tests_Failed++;
+    } // try {
+    catch(const Solver_Not_Set_Up & Er) { Tests_Passed++; }
+  } // try {
+  catch(const Solver_Exception & Er) {
+    printf("%s\n", Er.what());
+    Tests_Failed++;
+  } // catch(const Solver_Exception & Er) {
+
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+} // void Test::Pardiso_Solver_Tests(void) {
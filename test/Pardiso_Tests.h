@@ -3,9 +3,12 @@
 
 #include "Matrix.h"
 #include "Pardiso/Compress_K.h"
+#include "Pardiso/Pardiso_Solver.h"
+#include "Sparse/Sparse_Matrix.h"
 
 namespace Test {
   void Compress_Matrix(void);
+  void Pardiso_Solver_Tests(void);
 } // namespace Test {
 
 #endif
@@ -2,6 +2,11 @@
 #define SIMULATION_TESTS_SOURCE
 
 #include "Simulation_Tests.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <algorithm>
 
 void Test::Mrudang_Test(void) {
   /* First, read in the inp file. */
@@ -143,13 +148,14 @@ void Test::Mrudang_Test(void) {
 
 
   //////////////////////////////////////////////////////////////////////////////
-  /* With this information, we can now allocate K F, and x */
-  class Matrix<double> K{Num_Global_Eq, Num_Global_Eq, Memory::COLUMN_MAJOR};
+  /* With this information, we can now allocate K F, and x.
+  K is sparse. Its sparsity pattern depends on the element connectivity, so we
+  can't set it up until the elements have been set up (see below). */
+  class Sparse_Matrix K{};
   double* F = new double[Num_Global_Eq];
   double* x = new double[Num_Global_Eq];
 
-  // Zero initialize K and F
-  K.Fill(0);
+  // Zero initialize F
   for(unsigned i = 0; i < Num_Global_Eq; i++) { F[i] = 0; }
 
 
@@ -169,12 +175,23 @@ void Test::Mrudang_Test(void) {
 
   //////////////////////////////////////////////////////////////////////////////
   /* Allocate the elements Array.
-  Note: This will populate Ke and Fe for each element */
+  Note: This will populate Ke for each element */
 
   const unsigned Num_Elements = (unsigned)Element_Node_Lists.size();
   class Element* Elements = Simulation::Process_Element_List(Element_Node_Lists, Num_Elements);
 
 
+  //////////////////////////////////////////////////////////////////////////////
+  /* Now that the elements have been set up, we can set up K's sparsity
+  pattern (K is zero once its pattern has been set) */
+
+  try { Set_K_Sparsity_Pattern(Elements, Num_Elements, Num_Global_Eq); }
+  catch (const Element_Exception & Er) {
+    printf("%s\n",Er.what());
+    throw;
+  } // catch (const Element_Exception & Er) {
+
+
   //////////////////////////////////////////////////////////////////////////////
   /* Now, find F and K
   Note: we could have done this when we processed the Element's list. I choose
@@ -183,6 +200,7 @@ void Test::Mrudang_Test(void) {
   try {
     for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
       Elements[Element_Index].Move_Ke_To_K();
+      Elements[Element_Index].Populate_Fe();
       Elements[Element_Index].Move_Fe_To_F();
     } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
   } // try {
@@ -225,4 +243,1520 @@ void Test::Mrudang_Test(void) {
   return;
 } // void Test::Mrudang_Test(void) {
 
+
+
+
+static std::string Read_Whole_File(const std::string & File_Path) {
+  std::string Contents;
+  FILE * File = fopen(File_Path.c_str(), "rb");
+  if(File == nullptr) { return Contents; }
+
+  char Buffer[1 << 16];
+  size_t Num_Read;
+  while((Num_Read = fread(Buffer, 1, sizeof(Buffer), File)) != 0) { Contents.append(Buffer, Num_Read); }
+  fclose(File);
+  return Contents;
+} // static std::string Read_Whole_File(const std::string & File_Path) {
+
+
+
+/* Read the displacements (3 per node) back from a legacy binary VTK file (see
+vtk_binary). This returns false if the file doesn't have them. */
+static bool Read_Displacements(const std::string & File_Path, const unsigned Num_Nodes, std::vector<double> & Displacements) {
+  const std::string Contents = Read_Whole_File(File_Path);
+  const char * Header = "VECTORS Displacement double\n";
+  const size_t Start = Contents.find(Header);
+  if(Start == std::string::npos || Contents.size() < Start + strlen(Header) + 24*(size_t)Num_Nodes) { return false; }
+
+  Displacements.resize(3*(size_t)Num_Nodes);
+  const unsigned char * p = (const unsigned char *)Contents.data() + Start + strlen(Header);
+  for(size_t i = 0; i < Displacements.size(); i++) {
+    uint64_t Bits = 0;
+    for(unsigned b = 0; b < 8; b++) { Bits = (Bits << 8) | *p++; }
+    memcpy(&Displacements[i], &Bits, 8);
+  } // for(size_t i = 0; i < Displacements.size(); i++) {
+
+  return true;
+} // static bool Read_Displacements(const std::string & File_Path, const unsigned Num_Nodes, std::vector<double> & Displacements) {
+
+
+
+void Test::Load_Case_Test(void) {
+  /* In this test, we solve several load cases on the same mesh. Every load
+  case uses the same K, so K is factored once and every case is solved at the
+  same time. The first case is the problem exactly as the inp file sets it up.
+  The other two apply a nodal force (in the z direction) to the last node. The
+  problem is linear, so the displacements in Force_2 minus those in Base should
+  be twice the displacements in Force_1 minus those in Base. We write the
+  results in binary (so that we read back every digit) and check this. */
+  std::string File_Name = "Cylinder.inp";
+
+  std::list<Array<double, 3>> Node_Positions;
+  std::list<Array<unsigned, 8>> Element_Node_Lists;
+  std::list<IO::Read::inp_boundary_data> Boundary_List;
+  IO::Read::inp(File_Name, Node_Positions, Element_Node_Lists, Boundary_List);
+  const unsigned Num_Nodes = (unsigned)Node_Positions.size();
+  const unsigned Last_Node = Num_Nodes - 1;
+
+  std::vector<Simulation::Load_Case> Load_Cases(3);
+  Load_Cases[0].Name = "Base";
+
+  Load_Cases[1].Name = "Force_1";
+  Load_Cases[1].Forces.push_back(Simulation::Nodal_Value{Last_Node, 2, 1.});
+
+  Load_Cases[2].Name = "Force_2";
+  Load_Cases[2].Forces.push_back(Simulation::Nodal_Value{Last_Node, 2, 2.});
+
+  Simulation::Settings Sim_Settings;
+  Sim_Settings.Output_Format = IO::Write::VTK_Format::LEGACY_BINARY;
+  Sim_Settings.Recover_Stresses = false;
+  Simulation::From_File(File_Name, Load_Cases, Sim_Settings);
+
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+  std::vector<double> Base, Force_1, Force_2;
+  if(Read_Displacements("./IO/Base.vtk", Num_Nodes, Base) == true &&
+     Read_Displacements("./IO/Force_1.vtk", Num_Nodes, Force_1) == true &&
+     Read_Displacements("./IO/Force_2.vtk", Num_Nodes, Force_2) == true) {
+    double Max_Response = 0, Max_Error = 0;
+    for(size_t i = 0; i < Base.size(); i++) {
+      const double Response = Force_1[i] - Base[i];
+      Max_Response = fmax(Max_Response, fabs(Response));
+      Max_Error = fmax(Max_Error, fabs((Force_2[i] - Base[i]) - 2*Response));
+    } // for(size_t i = 0; i < Base.size(); i++) {
+    printf("Max |Force_1 - Base| = %.3e, max |(Force_2 - Base) - 2(Force_1 - Base)| = %.3e\n", Max_Response, Max_Error);
+
+    // The force must move the mesh, and the response must be linear.
+    if(Max_Response > 0 && Max_Error <= 1e-8*Max_Response) { Tests_Passed++; }
+    else { Tests_Failed++; }
+  } // if(Read_Displacements("./IO/Base.vtk", Num_Nodes, Base) == true &&...
+  else {
+    printf("Couldn't read the displacements back from the load case files\n");
+    Tests_Failed++;
+  } // else {
+
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+} // void Test::Load_Case_Test(void) {
+
+
+
+
+static class Node* Cube_Mesh(const unsigned N, std::list<Array<unsigned, 8>> & Element_Node_Lists) {
+  /* This function builds a structured N by N by N brick mesh of a unit cube
+  whose bottom face (z = 0) is fixed. It returns the Nodes array and fills
+  Element_Node_Lists.
+
+  Node (i,j,k) is at (i/N, j/N, k/N) and has index (N+1)*(N+1)*i + (N+1)*j + k.
+  Each element's nodes are ordered as in the figure on page 123 of Hughes'
+  book (counter-clockwise around the bottom face, then the top face). */
+  const unsigned Num_Nodes = (N+1)*(N+1)*(N+1);
+
+  class Node* Nodes = new Node[Num_Nodes];
+  for(unsigned i = 0; i <= N; i++) {
+    for(unsigned j = 0; j <= N; j++) {
+      for(unsigned k = 0; k <= N; k++) {
+        const unsigned Node_Index = (N+1)*(N+1)*i + (N+1)*j + k;
+        Nodes[Node_Index].Set_Position_Component(0, (double)i/(double)N);
+        Nodes[Node_Index].Set_Position_Component(1, (double)j/(double)N);
+        Nodes[Node_Index].Set_Position_Component(2, (double)k/(double)N);
+
+        if(k == 0) {
+          for(unsigned Comp = 0; Comp < 3; Comp++) { Nodes[Node_Index].Set_BC_Component(Comp, 0); }
+        } // if(k == 0) {
+      } // for(unsigned k = 0; k <= N; k++) {
+    } // for(unsigned j = 0; j <= N; j++) {
+  } // for(unsigned i = 0; i <= N; i++) {
+
+  for(unsigned i = 0; i < N; i++) {
+    for(unsigned j = 0; j < N; j++) {
+      for(unsigned k = 0; k < N; k++) {
+        Array<unsigned, 8> Node_List;
+        for(unsigned Level = 0; Level < 2; Level++) {
+          const unsigned kk = k + Level;
+          Node_List[4*Level + 0] = (N+1)*(N+1)*(i  ) + (N+1)*(j  ) + kk;
+          Node_List[4*Level + 1] = (N+1)*(N+1)*(i+1) + (N+1)*(j  ) + kk;
+          Node_List[4*Level + 2] = (N+1)*(N+1)*(i+1) + (N+1)*(j+1) + kk;
+          Node_List[4*Level + 3] = (N+1)*(N+1)*(i  ) + (N+1)*(j+1) + kk;
+        } // for(unsigned Level = 0; Level < 2; Level++) {
+        Element_Node_Lists.push_back(Node_List);
+      } // for(unsigned k = 0; k < N; k++) {
+    } // for(unsigned j = 0; j < N; j++) {
+  } // for(unsigned i = 0; i < N; i++) {
+
+  return Nodes;
+} // static class Node* Cube_Mesh(const unsigned N, std::list<Array<unsigned, 8>> & Element_Node_Lists) {
+
+
+
+static void Jitter_Nodes(const unsigned N, class Node* Nodes) {
+  /* This function moves each interior node of a Cube_Mesh by up to 1/4 of the
+  mesh spacing (in each direction), which makes the mesh unstructured. */
+  srand(1);
+  for(unsigned i = 1; i < N; i++) {
+    for(unsigned j = 1; j < N; j++) {
+      for(unsigned k = 1; k < N; k++) {
+        const unsigned Node_Index = (N+1)*(N+1)*i + (N+1)*j + k;
+        for(unsigned Comp = 0; Comp < 3; Comp++) {
+          const double Shift = (0.5*(double)rand()/(double)RAND_MAX - 0.25)/(double)N;
+          Nodes[Node_Index].Set_Position_Component(Comp, Nodes[Node_Index].Get_Position_Component(Comp) + Shift);
+        } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+      } // for(unsigned k = 1; k < N; k++) {
+    } // for(unsigned j = 1; j < N; j++) {
+  } // for(unsigned i = 1; i < N; i++) {
+} // static void Jitter_Nodes(const unsigned N, class Node* Nodes) {
+
+
+
+/* Cube mesh fixture class.
+This holds what most of the tests below start with: a Cube_Mesh (jittered, if
+Jitter is true), its ID matrix, and an empty K and F. The fixture owns Nodes
+and F. Set_Up_Elements points the Element class's static members at the
+fixture's ID, K, F, and Nodes, which can only be done once per process (see
+Set_Element_Static_Members), so each test should make one fixture. */
+class Cube_Fixture {
+  public:
+    const unsigned N;
+    const unsigned Num_Nodes;
+    const unsigned Num_Elements;
+
+    std::vector<Array<unsigned, 8>> Element_Node_Lists;
+    class Node* Nodes;
+    class Matrix<int> ID;
+    unsigned Num_Global_Eq;
+    class Sparse_Matrix K{};
+    double* F;
+
+    Cube_Fixture(const unsigned N_In, const bool Jitter = false);
+    ~Cube_Fixture(void);
+
+    /* The fixture owns Nodes and F, so it can't be copied. */
+    Cube_Fixture(const Cube_Fixture & Other) = delete;
+    Cube_Fixture & operator=(const Cube_Fixture & Other) = delete;
+
+    /* Set the Element class's static members and material (this can throw an
+    Element_Exception). Only the first call does anything. */
+    void Set_Up_Elements(void);
+
+    /* Set up the mesh's elements (see Process_Element_List). This calls
+    Set_Up_Elements. The node lists aren't used up, so this can be called more
+    than once. */
+    class Element* Make_Elements(class Ke_Cache* Cache = nullptr,                // Intent: Read/Write
+                                 const bool Store_Ke = true);                    // Intent: Read
+
+  private:
+    bool Elements_Set_Up = false;
+}; // class Cube_Fixture {
+
+
+
+Cube_Fixture::Cube_Fixture(const unsigned N_In, const bool Jitter) :
+    N(N_In),
+    Num_Nodes((N_In+1)*(N_In+1)*(N_In+1)),
+    Num_Elements(N_In*N_In*N_In),
+    ID{(N_In+1)*(N_In+1)*(N_In+1), 3, Memory::ROW_MAJOR} {
+  std::list<Array<unsigned, 8>> Node_Lists;
+  Nodes = Cube_Mesh(N, Node_Lists);
+  if(Jitter == true) { Jitter_Nodes(N, Nodes); }
+  Element_Node_Lists.assign(Node_Lists.begin(), Node_Lists.end());
+
+  Num_Global_Eq = Simulation::SetUp_ID_Num_Global_Eq(ID, Nodes, Num_Nodes);
+
+  F = new double[Num_Global_Eq];
+  for(unsigned i = 0; i < Num_Global_Eq; i++) { F[i] = 0; }
+} // Cube_Fixture::Cube_Fixture(const unsigned N_In, const bool Jitter) :
+
+
+
+Cube_Fixture::~Cube_Fixture(void) {
+  delete [] F;
+  delete [] Nodes;
+} // Cube_Fixture::~Cube_Fixture(void) {
+
+
+
+void Cube_Fixture::Set_Up_Elements(void) {
+  if(Elements_Set_Up == true) { return; }
+
+  Set_Element_Static_Members(&ID, &K, F, Nodes);
+  Set_Element_Material(Simulation::E, Simulation::v);
+  Elements_Set_Up = true;
+} // void Cube_Fixture::Set_Up_Elements(void) {
+
+
+
+class Element* Cube_Fixture::Make_Elements(class Ke_Cache* Cache, const bool Store_Ke) {
+  Set_Up_Elements();
+  return Simulation::Process_Element_List(Element_Node_Lists, Num_Elements, Cache, Store_Ke);
+} // class Element* Cube_Fixture::Make_Elements(class Ke_Cache* Cache, const bool Store_Ke) {
+
+
+
+void Test::Element_Throughput_Benchmark(void) {
+  /* In this test, we measure how quickly Process_Element_List sets up
+  elements (Set_Nodes, Populate_Ke) with different numbers of
+  threads. We use the N by N by N brick mesh from Cube_Mesh. */
+  const unsigned N = 20;
+  const unsigned Num_Elements = N*N*N;
+
+  Cube_Fixture Cube{N};
+
+  try {
+    Cube.Set_Up_Elements();
+  } // try {
+  catch (const Element_Exception & Er) {
+    printf("%s\n",Er.what());
+    return;
+  } // catch ((const Element_Exception & Er) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Now, set up the elements with 1, 2, 4, ... threads (and the maximum number
+  of threads). */
+  const int Max_Threads = omp_get_max_threads();
+  double Serial_Time = 0;
+
+  printf("Element set up throughput (%u elements):\n", Num_Elements);
+  printf("Threads |   Time (s) | Elements/s | Elements/s/thread | Speedup\n");
+
+  int Num_Threads = 1;
+  while(true) {
+    omp_set_num_threads(Num_Threads);
+    const double Start = omp_get_wtime();
+    class Element* Elements = Cube.Make_Elements();
+    const double Time = omp_get_wtime() - Start;
+    delete [] Elements;
+
+    if(Num_Threads == 1) { Serial_Time = Time; }
+    printf("%7d | %10.4lf | %10.0lf | %17.0lf | %7.2lf\n",
+           Num_Threads,
+           Time,
+           Num_Elements/Time,
+           Num_Elements/(Time*Num_Threads),
+           Serial_Time/Time);
+
+    // Double the number of threads (but make sure that we also test the maximum)
+    if(Num_Threads == Max_Threads) { break; }
+    else if(2*Num_Threads < Max_Threads) { Num_Threads *= 2; }
+    else { Num_Threads = Max_Threads; }
+  } // while(true) {
+  omp_set_num_threads(Max_Threads);
+
+} // void Test::Element_Throughput_Benchmark(void) {
+
+
+
+void Test::Colored_Assembly_Test(void) {
+  /* In this test, we check the colored (parallel) assembly of K. We first
+  check that no two elements of the same color share a node. We then assemble
+  K with the colored and serial methods and check that we get the same K. We
+  use a Cube_Mesh. */
+  const unsigned N = 12;
+  const unsigned Num_Nodes = (N+1)*(N+1)*(N+1);
+  const unsigned Num_Elements = N*N*N;
+
+  Cube_Fixture Cube{N};
+
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+  try {
+
+    class Element* Elements = Cube.Make_Elements();
+    Set_K_Sparsity_Pattern(Elements, Num_Elements, Cube.Num_Global_Eq);
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    /* Color the elements. Every element should get exactly one color, and no
+    two elements of the same color should share a node. Node_Color[n] is the
+    last color that used node n. */
+    class Simulation::Element_Coloring Coloring;
+    Simulation::Color_Elements(Elements, Num_Elements, Num_Nodes, Coloring);
+    printf("Colored %u elements with %u colors\n", Num_Elements, Coloring.Num_Colors);
+
+    if(Coloring.Elements.size() == Num_Elements && Coloring.Color_Start[Coloring.Num_Colors] == Num_Elements) { Tests_Passed++; }
+    else { Tests_Failed++; }
+
+    std::vector<unsigned> Node_Color(Num_Nodes, (unsigned)-1);
+    bool Conflict = false;
+    for(unsigned c = 0; c < Coloring.Num_Colors; c++) {
+      for(unsigned k = Coloring.Color_Start[c]; k < Coloring.Color_Start[c+1]; k++) {
+        const unsigned e = Coloring.Elements[k];
+        for(unsigned a = 0; a < 8; a++) {
+          const unsigned n = Elements[e].Get_Node_ID(a);
+          if(Node_Color[n] == c) { Conflict = true; }
+          Node_Color[n] = c;
+        } // for(unsigned a = 0; a < 8; a++) {
+      } // for(unsigned k = Coloring.Color_Start[c]; k < Coloring.Color_Start[c+1]; k++) {
+    } // for(unsigned c = 0; c < Coloring.Num_Colors; c++) {
+
+    if(Conflict == false) { Tests_Passed++; }
+    else { Tests_Failed++; }
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    /* Now, assemble K both ways and compare. The two methods add the same
+    numbers to each component of K, but possibly in a different order, so we
+    allow for some round off error. */
+    class Simulation::Settings Colored_Settings;
+    Colored_Settings.Assembly = Simulation::Assembly_Mode::COLORED;
+    class Simulation::Settings Serial_Settings;
+    Serial_Settings.Assembly = Simulation::Assembly_Mode::SERIAL;
+
+    double Start = omp_get_wtime();
+    Simulation::Assemble_K(Elements, Num_Elements, Coloring, Colored_Settings);
+    const double Colored_Time = omp_get_wtime() - Start;
+
+    const unsigned Num_Non_Zero = Cube.K.Get_Num_Non_Zero();
+    std::vector<double> Colored_A(Cube.K.Get_A(), Cube.K.Get_A() + Num_Non_Zero);
+
+    Cube.K.Fill(0);
+    Start = omp_get_wtime();
+    Simulation::Assemble_K(Elements, Num_Elements, Coloring, Serial_Settings);
+    const double Serial_Time = omp_get_wtime() - Start;
+
+    const double* Serial_A = Cube.K.Get_A();
+    double Max_Difference = 0;
+    for(unsigned i = 0; i < Num_Non_Zero; i++) {
+      const double Difference = fabs(Colored_A[i] - Serial_A[i]) / (fabs(Serial_A[i]) + 1.);
+      if(Difference > Max_Difference) { Max_Difference = Difference; }
+    } // for(unsigned i = 0; i < Num_Non_Zero; i++) {
+
+    if(Max_Difference < 1e-10) { Tests_Passed++; }
+    else { Tests_Failed++; }
+
+    printf("Serial assembly:  %lf s\n", Serial_Time);
+    printf("Colored assembly: %lf s (%d threads)\n", Colored_Time, omp_get_max_threads());
+
+    delete [] Elements;
+  } // try {
+  catch (const Element_Exception & Er) {
+    printf("%s\n",Er.what());
+    Tests_Failed++;
+  } // catch (const Element_Exception & Er) {
+
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+
+} // void Test::Colored_Assembly_Test(void) {
+
+
+
+void Test::Matrix_Free_Test(void) {
+  /* In this test, we check the matrix-free Element_Operator against the
+  assembled K. For some x, K*x, the diagonal of K, and the (per node) diagonal
+  blocks of K should be the same whether we use K or the elements directly
+  (with or without a coloring, and whether or not Ke is recomputed). Elements
+  that never stored Ke (see Settings::Recompute_Ke) should give the same K*x
+  and the same force due to a set of prescribed displacements. Both should
+  throw if asked for a diagonal block with more than 3 rows. Finally, we solve
+  with PCG using both and check that the solutions agree. */
+  const unsigned N = 6;
+  const unsigned Num_Nodes = (N+1)*(N+1)*(N+1);
+  const unsigned Num_Elements = N*N*N;
+
+  Cube_Fixture Cube{N};
+
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+  try {
+    class Element* Elements = Cube.Make_Elements();
+    Set_K_Sparsity_Pattern(Elements, Num_Elements, Cube.Num_Global_Eq);
+
+    class Simulation::Element_Coloring Coloring;
+    Simulation::Color_Elements(Elements, Num_Elements, Num_Nodes, Coloring);
+    Simulation::Assemble_K(Elements, Num_Elements, Coloring, Simulation::Settings{});
+
+    // One block per node (every node on the bottom face is fixed, so every block has 3 equations).
+    std::vector<unsigned> Block_Start;
+    for(unsigned I = 0; I <= Cube.Num_Global_Eq; I += 3) { Block_Start.push_back(I); }
+
+    std::vector<double> x(Cube.Num_Global_Eq), y_K(Cube.Num_Global_Eq), y_E(Cube.Num_Global_Eq);
+    for(unsigned i = 0; i < Cube.Num_Global_Eq; i++) { x[i] = sin((double)i); }
+
+    std::vector<double> D_K(Cube.Num_Global_Eq), D_E(Cube.Num_Global_Eq);
+    std::vector<double> B_K(3*Cube.Num_Global_Eq), B_E(3*Cube.Num_Global_Eq);
+    Cube.K.Multiply(x.data(), y_K.data());
+    Cube.K.Get_Diagonal(D_K.data());
+    Cube.K.Get_Diagonal_Blocks(Block_Start, B_K.data());
+
+    /* Relative difference between two vectors. */
+    auto Difference = [](const std::vector<double> & a, const std::vector<double> & b) {
+      double Max_Difference = 0, Max_b = 0;
+      for(unsigned i = 0; i < a.size(); i++) {
+        if(fabs(a[i] - b[i]) > Max_Difference) { Max_Difference = fabs(a[i] - b[i]); }
+        if(fabs(b[i]) > Max_b) { Max_b = fabs(b[i]); }
+      } // for(unsigned i = 0; i < a.size(); i++) {
+      return Max_Difference/Max_b;
+    };
+
+    class Simulation::Element_Coloring No_Coloring;
+    const class Simulation::Element_Coloring* Colorings[2] = { &No_Coloring, &Coloring };
+
+    for(unsigned c = 0; c < 2; c++) {
+      for(unsigned Recompute = 0; Recompute < 2; Recompute++) {
+        Element_Operator K_Elements{Elements, Num_Elements, Cube.Num_Global_Eq, *Colorings[c], Recompute == 1};
+
+        K_Elements.Multiply(x.data(), y_E.data());
+        K_Elements.Get_Diagonal(D_E.data());
+        K_Elements.Get_Diagonal_Blocks(Block_Start, B_E.data());
+
+        if(Difference(y_E, y_K) < 1e-12) { Tests_Passed++; }
+        else { Tests_Failed++; }
+
+        if(Difference(D_E, D_K) < 1e-12) { Tests_Passed++; }
+        else { Tests_Failed++; }
+
+        if(Difference(B_E, B_K) < 1e-12) { Tests_Passed++; }
+        else { Tests_Failed++; }
+      } // for(unsigned Recompute = 0; Recompute < 2; Recompute++) {
+    } // for(unsigned c = 0; c < 2; c++) {
+
+    /* Blocks only have room for 3 rows, so both should throw if a block has
+    more (here, two nodes). */
+    const std::vector<unsigned> Big_Block_Start{0, 6};
+    Element_Operator K_Blocks{Elements, Num_Elements, Cube.Num_Global_Eq, Coloring};
+    const class Linear_Operator* Operators[2] = { &Cube.K, &K_Blocks };
+    for(unsigned k = 0; k < 2; k++) {
+      try {
+        Operators[k]->Get_Diagonal_Blocks(Big_Block_Start, B_E.data());
+        Tests_Failed++;
+      } // try {
+      catch (const Matrix_Dimension_Mismatch &) { Tests_Passed++; }
+    } // for(unsigned k = 0; k < 2; k++) {
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    /* Elements that don't store Ke. */
+    class Element* Elements_No_Ke = Cube.Make_Elements(nullptr, false);
+
+    Element_Operator K_No_Ke{Elements_No_Ke, Num_Elements, Cube.Num_Global_Eq, Coloring, true};
+    K_No_Ke.Multiply(x.data(), y_E.data());
+    if(Difference(y_E, y_K) < 1e-12) { Tests_Passed++; }
+    else { Tests_Failed++; }
+
+    std::vector<double> U(3*Num_Nodes), F_Stored(Cube.Num_Global_Eq, 0), F_No_Ke(Cube.Num_Global_Eq, 0);
+    for(unsigned i = 0; i < 3*Num_Nodes; i++) { U[i] = cos((double)i); }
+    for(unsigned e = 0; e < Num_Elements; e++) {
+      Elements[e].Move_Prescribed_Force_To_F(U.data(), F_Stored.data());
+      Elements_No_Ke[e].Move_Prescribed_Force_To_F(U.data(), F_No_Ke.data());
+    } // for(unsigned e = 0; e < Num_Elements; e++) {
+    if(Difference(F_No_Ke, F_Stored) < 1e-12) { Tests_Passed++; }
+    else { Tests_Failed++; }
+
+    delete [] Elements_No_Ke;
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    /* Now, solve K x = y_K using PCG with both K and the elements. */
+    Element_Operator K_Elements{Elements, Num_Elements, Cube.Num_Global_Eq, Coloring};
+    PCG_Solver Solver{Preconditioner::BLOCK_JACOBI, 1e-10, 10000, Block_Start};
+    std::vector<double> x_K(Cube.Num_Global_Eq), x_E(Cube.Num_Global_Eq);
+
+    Solver.Factor(Cube.K);
+    Solver.Solve(x_K.data(), y_K.data());
+    const unsigned Iterations_K = Solver.Get_Iterations();
+
+    Solver.Factor(K_Elements);
+    Solver.Solve(x_E.data(), y_K.data());
+    const unsigned Iterations_E = Solver.Get_Iterations();
+
+    printf("PCG iterations: %u (assembled K), %u (matrix-free)\n", Iterations_K, Iterations_E);
+    if(Difference(x_E, x_K) < 1e-8 && Difference(x_E, x) < 1e-8) { Tests_Passed++; }
+    else { Tests_Failed++; }
+
+    delete [] Elements;
+  } // try {
+  catch (const Element_Exception & Er) {
+    printf("%s\n",Er.what());
+    Tests_Failed++;
+  } // catch (const Element_Exception & Er) {
+  catch (const Solver_Exception & Er) {
+    printf("%s\n",Er.what());
+    Tests_Failed++;
+  } // catch (const Solver_Exception & Er) {
+
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+
+} // void Test::Matrix_Free_Test(void) {
+
+
+
+void Test::AMG_Test(void) {
+  /* In this test, we check the algebraic multigrid preconditioner on an
+  unstructured mesh (a cube mesh whose interior nodes have been moved
+  randomly). First, K should (almost) map the rigid body modes to zero away
+  from the fixed face. Then, AMG preconditioned CG should solve K x = F in far
+  fewer iterations than block Jacobi does, and get the same solution. */
+  const unsigned N = 12;
+  const unsigned Num_Nodes = (N+1)*(N+1)*(N+1);
+  const unsigned Num_Elements = N*N*N;
+
+  Cube_Fixture Cube{N, true};
+
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+  try {
+
+    class Element* Elements = Cube.Make_Elements();
+    Set_K_Sparsity_Pattern(Elements, Num_Elements, Cube.Num_Global_Eq);
+
+    class Simulation::Element_Coloring Coloring;
+    Simulation::Color_Elements(Elements, Num_Elements, Num_Nodes, Coloring);
+    Simulation::Assemble_K(Elements, Num_Elements, Coloring, Simulation::Settings{});
+
+    // The mesh is no longer structured.
+    Structured_Grid Grid;
+    if(Simulation::Find_Structured_Grid(Cube.Nodes, Num_Nodes, Elements, Num_Elements, Cube.ID, Grid) == false) { Tests_Passed++; }
+    else { Tests_Failed++; }
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    /* K times each rigid body mode should vanish at every node that doesn't
+    share an element with a fixed node (k >= 2). */
+    std::vector<double> Modes;
+    Simulation::Rigid_Body_Modes(Cube.Nodes, Num_Nodes, Cube.ID, Cube.Num_Global_Eq, Modes);
+
+    std::vector<double> K_Mode(Cube.Num_Global_Eq), Diag(Cube.Num_Global_Eq);
+    Cube.K.Get_Diagonal(Diag.data());
+    for(unsigned Mode = 0; Mode < 6; Mode++) {
+      Cube.K.Multiply(&Modes[(size_t)Cube.Num_Global_Eq*Mode], K_Mode.data());
+
+      double Max_Interior = 0, Max_Diag = 0;
+      for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+        if(Node_Index % (N+1) < 2) { continue; }
+        for(unsigned Comp = 0; Comp < 3; Comp++) {
+          const int I = Cube.ID(Node_Index, Comp);
+          if(fabs(K_Mode[I]) > Max_Interior) { Max_Interior = fabs(K_Mode[I]); }
+          if(Diag[I] > Max_Diag) { Max_Diag = Diag[I]; }
+        } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+      } // for(unsigned Node_Index = 0; Node_Index < Num_Nodes; Node_Index++) {
+
+      if(Max_Interior < 1e-10*Max_Diag) { Tests_Passed++; }
+      else { Tests_Failed++; }
+    } // for(unsigned Mode = 0; Mode < 6; Mode++) {
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    /* Now, solve K x = F with AMG and block Jacobi. */
+    std::vector<unsigned> Block_Start;
+    for(unsigned I = 0; I <= Cube.Num_Global_Eq; I += 3) { Block_Start.push_back(I); }
+
+    std::vector<double> x_True(Cube.Num_Global_Eq), F_True(Cube.Num_Global_Eq), x_AMG(Cube.Num_Global_Eq), x_BJ(Cube.Num_Global_Eq);
+    for(unsigned i = 0; i < Cube.Num_Global_Eq; i++) { x_True[i] = sin((double)i); }
+    Cube.K.Multiply(x_True.data(), F_True.data());
+
+    PCG_Solver AMG_Solver{Preconditioner::AMG, 1e-10, 10000, Block_Start, Modes};
+    AMG_Solver.Factor(Cube.K);
+    AMG_Solver.Solve(x_AMG.data(), F_True.data());
+
+    PCG_Solver BJ_Solver{Preconditioner::BLOCK_JACOBI, 1e-10, 10000, Block_Start};
+    BJ_Solver.Factor(Cube.K);
+    BJ_Solver.Solve(x_BJ.data(), F_True.data());
+
+    printf("PCG iterations: %u (AMG), %u (block Jacobi)\n", AMG_Solver.Get_Iterations(), BJ_Solver.Get_Iterations());
+    if(3*AMG_Solver.Get_Iterations() < BJ_Solver.Get_Iterations()) { Tests_Passed++; }
+    else { Tests_Failed++; }
+
+    double Max_Difference = 0;
+    for(unsigned i = 0; i < Cube.Num_Global_Eq; i++) {
+      if(fabs(x_AMG[i] - x_True[i]) > Max_Difference) { Max_Difference = fabs(x_AMG[i] - x_True[i]); }
+    } // for(unsigned i = 0; i < Num_Global_Eq; i++) {
+    if(Max_Difference < 1e-6) { Tests_Passed++; }
+    else { Tests_Failed++; }
+
+    // AMG needs the near null space.
+    try {
+      PCG_Solver Solver{Preconditioner::AMG, 1e-10, 100, Block_Start};
+      Tests_Failed++;
+    } // try {
+    catch(const Solver_Not_Set_Up & Er) { Tests_Passed++; }
+
+    delete [] Elements;
+  } // try {
+  catch (const Element_Exception & Er) {
+    printf("%s\n",Er.what());
+    Tests_Failed++;
+  } // catch (const Element_Exception & Er) {
+  catch (const Solver_Exception & Er) {
+    printf("%s\n",Er.what());
+    Tests_Failed++;
+  } // catch (const Solver_Exception & Er) {
+
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+
+} // void Test::AMG_Test(void) {
+
+
+
+void Test::Ke_Batch_Benchmark(void) {
+  /* In this test, we compare the batched Ke kernel (Populate_Ke_Batch) with
+  Populate_Ke on an unstructured brick mesh. Both should give the same Ke's,
+  which we check by applying them (with Element_Operator) to a vector. We
+  also report how many Ke's per second each one computes (on one thread). */
+  const unsigned N = 16;
+  const unsigned Num_Elements = N*N*N;
+  const unsigned Num_Runs = 3;
+
+  Cube_Fixture Cube{N, true};
+
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+  try {
+    Cube.Set_Up_Elements();
+
+    /* Run each kernel Num_Runs times (on new elements each time, since Ke
+    can only be set once) and keep the fastest time. */
+    class Element* Elements[2] = { nullptr, nullptr };
+    double Best_Time[2] = { 1e30, 1e30 };
+
+    for(unsigned Run = 0; Run < Num_Runs; Run++) {
+      for(unsigned Kernel = 0; Kernel < 2; Kernel++) {
+        delete [] Elements[Kernel];
+        Elements[Kernel] = new Element[Num_Elements];
+        for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+          const Array<unsigned, 8> & Node_List = Cube.Element_Node_Lists[Element_Index];
+          Elements[Kernel][Element_Index].Set_Nodes(Node_List[0], Node_List[1], Node_List[2], Node_List[3],
+                                                    Node_List[4], Node_List[5], Node_List[6], Node_List[7]);
+        } // for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) {
+
+        const double Start = omp_get_wtime();
+        if(Kernel == 0) {
+          for(unsigned Element_Index = 0; Element_Index < Num_Elements; Element_Index++) { Elements[0][Element_Index].Populate_Ke(); }
+        } // if(Kernel == 0) {
+        else { Populate_Ke_Batch(Elements[1], Num_Elements); }
+        const double Time = omp_get_wtime() - Start;
+
+        if(Time < Best_Time[Kernel]) { Best_Time[Kernel] = Time; }
+      } // for(unsigned Kernel = 0; Kernel < 2; Kernel++) {
+    } // for(unsigned Run = 0; Run < Num_Runs; Run++) {
+
+    printf("Ke throughput (%u elements, batch width %u):\n", Num_Elements, Ke_Batch_Width());
+    printf("Populate_Ke:       %10.0lf Ke/s\n", Num_Elements/Best_Time[0]);
+    printf("Populate_Ke_Batch: %10.0lf Ke/s (%.2lfx)\n", Num_Elements/Best_Time[1], Best_Time[0]/Best_Time[1]);
+
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Both kernels should give the same K*x.
+    class Simulation::Element_Coloring No_Coloring;
+    Element_Operator K_Single{Elements[0], Num_Elements, Cube.Num_Global_Eq, No_Coloring};
+    Element_Operator K_Batch{Elements[1], Num_Elements, Cube.Num_Global_Eq, No_Coloring};
+
+    std::vector<double> x(Cube.Num_Global_Eq), y_Single(Cube.Num_Global_Eq), y_Batch(Cube.Num_Global_Eq);
+    for(unsigned i = 0; i < Cube.Num_Global_Eq; i++) { x[i] = sin((double)i); }
+    K_Single.Multiply(x.data(), y_Single.data());
+    K_Batch.Multiply(x.data(), y_Batch.data());
+
+    double Max_Difference = 0, Max_y = 0;
+    for(unsigned i = 0; i < Cube.Num_Global_Eq; i++) {
+      if(fabs(y_Batch[i] - y_Single[i]) > Max_Difference) { Max_Difference = fabs(y_Batch[i] - y_Single[i]); }
+      if(fabs(y_Single[i]) > Max_y) { Max_y = fabs(y_Single[i]); }
+    } // for(unsigned i = 0; i < Num_Global_Eq; i++) {
+
+    if(Max_Difference < 1e-12*Max_y) { Tests_Passed++; }
+    else { Tests_Failed++; }
+
+    // Ke can't be computed twice.
+    try {
+      Populate_Ke_Batch(Elements[1], 1);
+      Tests_Failed++;
+    } // try {
+    catch(const Element_Already_Set_Up & Er) { Tests_Passed++; }
+
+    delete [] Elements[0];
+    delete [] Elements[1];
+  } // try {
+  catch (const Element_Exception & Er) {
+    printf("%s\n",Er.what());
+    Tests_Failed++;
+  } // catch (const Element_Exception & Er) {
+
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+
+} // void Test::Ke_Batch_Benchmark(void) {
+
+
+
+void Test::Ke_Cache_Test(void) {
+  /* In this test, we check the Ke cache (see Ke_Cache.h). We set up the
+  elements of a structured brick mesh with and without the cache. Every element
+  of a structured mesh is a translation of every other, so the cache should
+  only hold one Ke. Both sets of elements should give the same K*x. We then
+  jitter the mesh (so that no two elements are congruent) and do the same
+  thing; this time, every element should get its own Ke. Finally, a cache that
+  doesn't share Ke's should store one Ke per element (and give the same K*x). */
+  const unsigned N = 10;
+  const unsigned Num_Elements = N*N*N;
+
+  Cube_Fixture Cube{N};
+
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+  try {
+    std::vector<double> x(Cube.Num_Global_Eq), y_Cache(Cube.Num_Global_Eq), y_No_Cache(Cube.Num_Global_Eq);
+    for(unsigned i = 0; i < Cube.Num_Global_Eq; i++) { x[i] = sin((double)i); }
+    class Simulation::Element_Coloring No_Coloring;
+
+    for(unsigned Jitter = 0; Jitter < 2; Jitter++) {
+      if(Jitter == 1) { Jitter_Nodes(N, Cube.Nodes); }
+
+      class Ke_Cache Cache;
+      double Start = omp_get_wtime();
+      class Element* Cache_Elements = Cube.Make_Elements(&Cache);
+      const double Cache_Time = omp_get_wtime() - Start;
+
+      Start = omp_get_wtime();
+      class Element* Elements = Cube.Make_Elements();
+      const double No_Cache_Time = omp_get_wtime() - Start;
+
+      class Ke_Cache Slab{false};
+      Start = omp_get_wtime();
+      class Element* Slab_Elements = Cube.Make_Elements(&Slab);
+      const double Slab_Time = omp_get_wtime() - Start;
+
+      printf("%s mesh: %u elements, %u distinct Ke's\n", (Jitter == 0) ? "Structured" : "Jittered", Num_Elements, Cache.Get_Num_Ke());
+      printf("Process_Element_List: %lf s (cache), %lf s (no cache), %lf s (slab)\n", Cache_Time, No_Cache_Time, Slab_Time);
+
+      const unsigned Expected_Num_Ke = (Jitter == 0) ? 1 : Num_Elements;
+      if(Cache.Get_Num_Ke() == Expected_Num_Ke && Slab.Get_Num_Ke() == Num_Elements) { Tests_Passed++; }
+      else { Tests_Failed++; }
+
+      // Every set of elements should give the same K*x.
+      Element_Operator K_No_Cache{Elements, Num_Elements, Cube.Num_Global_Eq, No_Coloring};
+      K_No_Cache.Multiply(x.data(), y_No_Cache.data());
+
+      const class Element* Other_Elements[2] = { Cache_Elements, Slab_Elements };
+      for(unsigned k = 0; k < 2; k++) {
+        Element_Operator K_Other{Other_Elements[k], Num_Elements, Cube.Num_Global_Eq, No_Coloring};
+        K_Other.Multiply(x.data(), y_Cache.data());
+
+        double Max_Difference = 0, Max_y = 0;
+        for(unsigned i = 0; i < Cube.Num_Global_Eq; i++) {
+          if(fabs(y_Cache[i] - y_No_Cache[i]) > Max_Difference) { Max_Difference = fabs(y_Cache[i] - y_No_Cache[i]); }
+          if(fabs(y_No_Cache[i]) > Max_y) { Max_y = fabs(y_No_Cache[i]); }
+        } // for(unsigned i = 0; i < Num_Global_Eq; i++) {
+
+        if(Max_Difference < 1e-12*Max_y) { Tests_Passed++; }
+        else { Tests_Failed++; }
+      } // for(unsigned k = 0; k < 2; k++) {
+
+      // A cache can only be populated once.
+      try {
+        Cache.Populate_Ke(Elements, Num_Elements);
+        Tests_Failed++;
+      } // try {
+      catch(const Element_Already_Set_Up & Er) { Tests_Passed++; }
+
+      delete [] Cache_Elements;
+      delete [] Slab_Elements;
+      delete [] Elements;
+    } // for(unsigned Jitter = 0; Jitter < 2; Jitter++) {
+  } // try {
+  catch (const Element_Exception & Er) {
+    printf("%s\n",Er.what());
+    Tests_Failed++;
+  } // catch (const Element_Exception & Er) {
+
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+
+} // void Test::Ke_Cache_Test(void) {
+
+
+
+void Test::Renumbering_Test(void) {
+  /* In this test, we check the equation renumbering (see Renumber.cc). We
+  number the equations of a brick mesh in a random node order, then renumber
+  them with RCM and with nested dissection. Each renumbering should be a
+  permutation of the equations that keeps each node's equations together. RCM
+  should give a much smaller bandwidth and profile than the random order. (The
+  natural order of a structured brick mesh is already about as good as it
+  gets, so we just print it for comparison.) Finally, RCM should never make the
+  bandwidth or profile of a real mesh's numbering (the cylinder's) worse. */
+  const unsigned N = 12;
+  const unsigned Num_Nodes = (N+1)*(N+1)*(N+1);
+
+  std::list<Array<unsigned, 8>> Cube_Node_Lists;
+  class Node* Nodes = Cube_Mesh(N, Cube_Node_Lists);
+  const std::vector<Array<unsigned, 8>> Element_Node_Lists(Cube_Node_Lists.begin(), Cube_Node_Lists.end());
+
+  class Matrix<int> Natural_ID{Num_Nodes, 3, Memory::ROW_MAJOR};
+  const unsigned Num_Global_Eq = Simulation::SetUp_ID_Num_Global_Eq(Natural_ID, Nodes, Num_Nodes);
+
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+  /* Number the nodes in a random order (a Fisher-Yates shuffle). */
+  std::vector<unsigned> Random_Order(Num_Nodes);
+  for(unsigned n = 0; n < Num_Nodes; n++) { Random_Order[n] = n; }
+  srand(2);
+  for(unsigned n = Num_Nodes - 1; n > 0; n--) { std::swap(Random_Order[n], Random_Order[rand() % (n + 1)]); }
+
+  class Matrix<int> Random_ID{Num_Nodes, 3, Memory::ROW_MAJOR};
+  int Eq = 0;
+  for(unsigned n : Random_Order) {
+    for(unsigned Comp = 0; Comp < 3; Comp++) { Random_ID(n, Comp) = (Natural_ID(n, Comp) == -1) ? -1 : Eq++; }
+  } // for(unsigned n : Random_Order) {
+
+  unsigned Natural_Bandwidth, Random_Bandwidth;
+  unsigned long long Natural_Profile, Random_Profile;
+  Simulation::Bandwidth_Profile(Natural_ID, Num_Nodes, Element_Node_Lists, Natural_Bandwidth, Natural_Profile);
+  Simulation::Bandwidth_Profile(Random_ID, Num_Nodes, Element_Node_Lists, Random_Bandwidth, Random_Profile);
+  printf("Natural order:      bandwidth %6u, profile %10llu\n", Natural_Bandwidth, Natural_Profile);
+  printf("Random order:       bandwidth %6u, profile %10llu\n", Random_Bandwidth, Random_Profile);
+
+  const Simulation::Renumbering Methods[2] = { Simulation::Renumbering::RCM, Simulation::Renumbering::NESTED_DISSECTION };
+  for(unsigned k = 0; k < 2; k++) {
+    class Matrix<int> ID{Num_Nodes, 3, Memory::ROW_MAJOR};
+    for(unsigned n = 0; n < Num_Nodes; n++) {
+      for(unsigned Comp = 0; Comp < 3; Comp++) { ID(n, Comp) = Random_ID(n, Comp); }
+    } // for(unsigned n = 0; n < Num_Nodes; n++) {
+
+    Simulation::Renumber_Equations(ID, Num_Nodes, Element_Node_Lists, Methods[k]);
+
+    /* Every equation should be used exactly once, fixed components should stay
+    fixed, and each node's equations should be consecutive. */
+    std::vector<unsigned> Times_Used(Num_Global_Eq, 0);
+    bool Valid = true;
+    for(unsigned n = 0; n < Num_Nodes; n++) {
+      int Last_Eq = -1;
+      for(unsigned Comp = 0; Comp < 3; Comp++) {
+        const int I = ID(n, Comp);
+        if((I == -1) != (Natural_ID(n, Comp) == -1)) { Valid = false; }
+        if(I == -1) { continue; }
+        if(I >= (int)Num_Global_Eq || (Last_Eq != -1 && I != Last_Eq + 1)) { Valid = false; continue; }
+
+        Times_Used[I]++;
+        Last_Eq = I;
+      } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+    } // for(unsigned n = 0; n < Num_Nodes; n++) {
+    for(unsigned I = 0; I < Num_Global_Eq; I++) {
+      if(Times_Used[I] != 1) { Valid = false; }
+    } // for(unsigned I = 0; I < Num_Global_Eq; I++) {
+
+    if(Valid == true) { Tests_Passed++; }
+    else { Tests_Failed++; }
+
+    unsigned Bandwidth;
+    unsigned long long Profile;
+    Simulation::Bandwidth_Profile(ID, Num_Nodes, Element_Node_Lists, Bandwidth, Profile);
+    printf("%-19s bandwidth %6u, profile %10llu\n", (k == 0) ? "RCM:" : "Nested dissection:", Bandwidth, Profile);
+
+    if(k == 0) {
+      if(4*Bandwidth < Random_Bandwidth && 4*Profile < Random_Profile) { Tests_Passed++; }
+      else { Tests_Failed++; }
+    } // if(k == 0) {
+  } // for(unsigned k = 0; k < 2; k++) {
+
+  delete [] Nodes;
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  // The cylinder mesh, numbered the way that Simulation::From_File numbers it.
+  try {
+    IO::Read::inp_mesh Mesh;
+    IO::Read::inp("Cylinder.inp", Mesh);
+    const unsigned Cylinder_Num_Nodes = (unsigned)Mesh.Node_Positions.size();
+    Nodes = Simulation::Process_Node_Lists(Mesh.Node_Positions, Mesh.Boundary_List, Cylinder_Num_Nodes);
+
+    if(Mesh.Set_Boundary_List.size() != 0) { Simulation::Set_Set_Boundary_BCs(Nodes, Cylinder_Num_Nodes, Mesh); }
+    else {
+      class IO::Read::nset_BC node_set_BCs;
+      node_set_BCs.Set_x_BC(0);
+      node_set_BCs.Set_y_BC(0);
+      node_set_BCs.Set_z_BC(0);
+      for(unsigned i = 0; i < Mesh.Node_Sets.size(); i++) { Simulation::Set_nset_BCs(Nodes, Mesh.Node_Sets[i].Nodes, node_set_BCs); }
+    } // else {
+
+    class Matrix<int> ID{Cylinder_Num_Nodes, 3, Memory::ROW_MAJOR};
+    Simulation::SetUp_ID_Num_Global_Eq(ID, Nodes, Cylinder_Num_Nodes);
+
+    unsigned Old_Bandwidth, New_Bandwidth;
+    unsigned long long Old_Profile, New_Profile;
+    Simulation::Bandwidth_Profile(ID, Cylinder_Num_Nodes, Mesh.Element_Node_Lists, Old_Bandwidth, Old_Profile);
+    Simulation::Renumber_Equations(ID, Cylinder_Num_Nodes, Mesh.Element_Node_Lists, Simulation::Renumbering::RCM);
+    Simulation::Bandwidth_Profile(ID, Cylinder_Num_Nodes, Mesh.Element_Node_Lists, New_Bandwidth, New_Profile);
+    printf("Cylinder:           bandwidth %6u -> %u, profile %10llu -> %llu\n", Old_Bandwidth, New_Bandwidth, Old_Profile, New_Profile);
+
+    if(New_Bandwidth <= Old_Bandwidth && New_Profile <= Old_Profile) { Tests_Passed++; }
+    else { Tests_Failed++; }
+
+    delete [] Nodes;
+  } // try {
+  catch (const IO_Exception & Er) {
+    printf("%s\n",Er.what());
+    Tests_Failed++;
+  } // catch (const IO_Exception & Er) {
+
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+} // void Test::Renumbering_Test(void) {
+
+
+
+static std::string Decode_Base64(const char * Data, const size_t Size) {
+  /* A simple (serial) base64 decoder, to check IO::Write::Encode_Base64. */
+  std::string Bytes;
+  uint32_t Bits = 0;
+  unsigned Num_Bits = 0;
+  for(size_t i = 0; i < Size && Data[i] != '='; i++) {
+    const char c = Data[i];
+    uint32_t Value;
+    if(c >= 'A' && c <= 'Z')      { Value = (uint32_t)(c - 'A'); }
+    else if(c >= 'a' && c <= 'z') { Value = (uint32_t)(c - 'a') + 26; }
+    else if(c >= '0' && c <= '9') { Value = (uint32_t)(c - '0') + 52; }
+    else if(c == '+')             { Value = 62; }
+    else                          { Value = 63; }
+
+    Bits = (Bits << 6) | Value;
+    Num_Bits += 6;
+    if(Num_Bits >= 8) {
+      Num_Bits -= 8;
+      Bytes.push_back((char)((Bits >> Num_Bits) & 0xFF));
+    } // if(Num_Bits >= 8) {
+  } // for(size_t i = 0; i < Size && Data[i] != '='; i++) {
+
+  return Bytes;
+} // static std::string Decode_Base64(const char * Data, const size_t Size) {
+
+
+
+void Test::vtk_Writer_Benchmark(void) {
+  /* In this test, we write the same (deformed) mesh in each of the output
+  formats (see vtk_Writer.h), and compare their write times and file sizes.
+  We then read the binary files back: the legacy binary file's big endian
+  points and cells, and the VTU file's appended arrays, must match the mesh
+  exactly, and the base64 VTU file must decode to the raw VTU file's arrays.
+  The compressed VTU files' blocks must decompress (and decode) to the raw
+  VTU file's arrays too. */
+  const unsigned N = 40;
+  const unsigned Num_Nodes = (N+1)*(N+1)*(N+1);
+  const unsigned Num_Elements = N*N*N;
+
+  Cube_Fixture Cube{N, true};
+
+  class Element* Elements;
+  class Ke_Cache Cache;
+  try {
+    Elements = Cube.Make_Elements(&Cache);
+  } // try {
+  catch (const Element_Exception & Er) {
+    printf("%s\n",Er.what());
+    return;
+  } // catch (const Element_Exception & Er) {
+
+  // Give the free components a displacement (with plenty of digits).
+  for(unsigned n = 0; n < Num_Nodes; n++) {
+    for(unsigned Comp = 0; Comp < 3; Comp++) {
+      if(Cube.ID(n, Comp) != -1) { Cube.Nodes[n].Set_Displacement_Component(Comp, 1e-3*sin(1.7*n + Comp)); }
+    } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+  } // for(unsigned n = 0; n < Num_Nodes; n++) {
+
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Write the mesh in each format. */
+  const unsigned NUM_FORMATS = 6;
+  const IO::Write::VTK_Format Formats[NUM_FORMATS] = {IO::Write::VTK_Format::LEGACY_ASCII, IO::Write::VTK_Format::LEGACY_BINARY,
+                                                      IO::Write::VTK_Format::VTU_RAW, IO::Write::VTK_Format::VTU_BASE64,
+                                                      IO::Write::VTK_Format::VTU_ZLIB, IO::Write::VTK_Format::VTU_ZLIB_BASE64};
+  const char * Format_Names[NUM_FORMATS] = {"LEGACY_ASCII", "LEGACY_BINARY", "VTU_RAW", "VTU_BASE64", "VTU_ZLIB", "VTU_ZLIB_BASE64"};
+  std::string Contents[NUM_FORMATS];
+  double ASCII_Time = 0;
+  double ASCII_MB = 0;
+
+  printf("vtk writer (%u nodes, %u elements):\n", Num_Nodes, Num_Elements);
+  printf("Format          |   Time (s) | Size (MB) | Speedup | Size ratio\n");
+  for(unsigned f = 0; f < NUM_FORMATS; f++) {
+    const std::string File_Path = std::string("./IO/Writer_Benchmark_") + Format_Names[f] + IO::Write::vtk_Extension(Formats[f]);
+
+    const double Start = omp_get_wtime();
+    IO::Write::vtk(Cube.Nodes, Num_Nodes, Elements, Num_Elements, File_Path, Formats[f]);
+    const double Time = omp_get_wtime() - Start;
+
+    Contents[f] = Read_Whole_File(File_Path);
+    remove(File_Path.c_str());
+
+    const double MB = (double)Contents[f].size()/(1024.*1024.);
+    if(f == 0) { ASCII_Time = Time; ASCII_MB = MB; }
+    printf("%-15s | %10.4lf | %9.2lf | %7.2lf | %10.3lf\n", Format_Names[f], Time, MB, ASCII_Time/Time, MB/ASCII_MB);
+  } // for(unsigned f = 0; f < NUM_FORMATS; f++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Check the legacy binary file. */
+  {
+    const std::string & Binary = Contents[1];
+    char Points_Line[64];
+    sprintf(Points_Line, "POINTS %u double\n", Num_Nodes);
+    const size_t Points_Start = Binary.find(Points_Line);
+
+    bool Match = (Binary.compare(0, 50, "# vtk DataFile Version 3.0\nFEM output file\nBINARY\n") == 0 && Points_Start != std::string::npos);
+    const unsigned char * p = (Match == true) ? (const unsigned char *)Binary.data() + Points_Start + strlen(Points_Line) : nullptr;
+    for(unsigned n = 0; n < Num_Nodes && Match == true; n++) {
+      for(unsigned Comp = 0; Comp < 3; Comp++) {
+        uint64_t Bits = 0;
+        for(unsigned b = 0; b < 8; b++) { Bits = (Bits << 8) | *p++; }
+        double Value;
+        memcpy(&Value, &Bits, 8);
+        if(Value != Cube.Nodes[n].Get_Position_Component(Comp) + Cube.Nodes[n].Get_Displacement_Component(Comp)) { Match = false; }
+      } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+    } // for(unsigned n = 0; n < Num_Nodes && Match == true; n++) {
+
+    char Cells_Line[64];
+    sprintf(Cells_Line, "\nCELLS %u %u\n", Num_Elements, 9*Num_Elements);
+    Match = Match && (memcmp(p, Cells_Line, strlen(Cells_Line)) == 0);
+    if(Match == true) { p += strlen(Cells_Line); }
+    for(unsigned e = 0; e < Num_Elements && Match == true; e++) {
+      for(unsigned a = 0; a < 9; a++) {
+        const uint32_t Value = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+        p += 4;
+        if(Value != ((a == 0) ? 8 : Elements[e].Get_Node_ID(a - 1))) { Match = false; }
+      } // for(unsigned a = 0; a < 9; a++) {
+    } // for(unsigned e = 0; e < Num_Elements && Match == true; e++) {
+
+    if(Match == true) { Tests_Passed++; }
+    else { Tests_Failed++; }
+  }
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Check the raw VTU file's arrays (points, connectivity, offsets, types,
+  then the result fields), and that the base64 file's arrays decode to the same bytes. */
+  {
+    const std::string & Raw = Contents[2];
+    const std::string & Encoded = Contents[3];
+    const size_t Raw_Start = Raw.find("encoding=\"raw\">\n_");
+    const size_t Encoded_Start = Encoded.find("encoding=\"base64\">\n_");
+
+    bool Match = (Raw_Start != std::string::npos && Encoded_Start != std::string::npos);
+    size_t Raw_Position = Raw_Start + strlen("encoding=\"raw\">\n_");
+    size_t Encoded_Position = Encoded_Start + strlen("encoding=\"base64\">\n_");
+
+    for(unsigned a = 0; a < 8 && Match == true; a++) {
+      uint64_t Size;
+      memcpy(&Size, Raw.data() + Raw_Position, 8);
+
+      std::string Expected;
+      if(a == 0) {
+        for(unsigned n = 0; n < Num_Nodes; n++) {
+          for(unsigned Comp = 0; Comp < 3; Comp++) {
+            const double Value = Cube.Nodes[n].Get_Position_Component(Comp) + Cube.Nodes[n].Get_Displacement_Component(Comp);
+            Expected.append((const char *)&Value, 8);
+          } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+        } // for(unsigned n = 0; n < Num_Nodes; n++) {
+      } // if(a == 0) {
+      for(unsigned e = 0; e < Num_Elements; e++) {
+        if(a == 1) {
+          for(unsigned j = 0; j < 8; j++) {
+            const int32_t Value = (int32_t)Elements[e].Get_Node_ID(j);
+            Expected.append((const char *)&Value, 4);
+          } // for(unsigned j = 0; j < 8; j++) {
+        } // if(a == 1) {
+        else if(a == 2) {
+          const int32_t Value = 8*(int32_t)(e + 1);
+          Expected.append((const char *)&Value, 4);
+        } // else if(a == 2) {
+        else if(a == 3) { Expected.push_back((char)12); }
+      } // for(unsigned e = 0; e < Num_Elements; e++) {
+
+      if(a == 4) {
+        for(unsigned n = 0; n < Num_Nodes; n++) {
+          for(unsigned Comp = 0; Comp < 3; Comp++) {
+            const double Value = Cube.Nodes[n].Get_Displacement_Component(Comp);
+            Expected.append((const char *)&Value, 8);
+          } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+        } // for(unsigned n = 0; n < Num_Nodes; n++) {
+      } // if(a == 4) {
+
+      /* The strain, stress, and von Mises arrays are checked by
+      Stress_Recovery_Test, so we only check their sizes here. */
+      if(a <= 4) { Match = (Size == Expected.size() && Raw.compare(Raw_Position + 8, Expected.size(), Expected) == 0); }
+      else { Match = (Size == 8*(uint64_t)Num_Elements*((a == 7) ? 1 : 9)); }
+
+      const size_t Num_Chars = 4*((8 + Size + 2)/3);
+      const std::string Decoded = Decode_Base64(Encoded.data() + Encoded_Position, Num_Chars);
+      Match = Match && (Decoded.size() == 8 + Size && Raw.compare(Raw_Position, 8 + Size, Decoded) == 0);
+
+      Raw_Position += 8 + Size;
+      Encoded_Position += Num_Chars;
+    } // for(unsigned a = 0; a < 8 && Match == true; a++) {
+
+    if(Match == true) { Tests_Passed++; }
+    else { Tests_Failed++; }
+  }
+
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Check the compressed VTU files. Each array is a header (number of blocks,
+  block size, last block size, compressed block sizes), then the blocks. In
+  the base64 file, the header and the blocks are encoded separately. */
+  {
+    const std::string & Raw = Contents[2];
+    const std::string & Zlib = Contents[4];
+    const std::string & Encoded = Contents[5];
+    const size_t Raw_Start = Raw.find("encoding=\"raw\">\n_");
+    const size_t Zlib_Start = Zlib.find("encoding=\"raw\">\n_");
+    const size_t Encoded_Start = Encoded.find("encoding=\"base64\">\n_");
+
+    bool Match = (Raw_Start != std::string::npos && Zlib_Start != std::string::npos && Encoded_Start != std::string::npos &&
+                  Zlib.find("compressor=\"vtkZLibDataCompressor\"") != std::string::npos);
+    size_t Raw_Position = Raw_Start + strlen("encoding=\"raw\">\n_");
+    size_t Zlib_Position = Zlib_Start + strlen("encoding=\"raw\">\n_");
+    size_t Encoded_Position = Encoded_Start + strlen("encoding=\"base64\">\n_");
+
+    for(unsigned a = 0; a < 8 && Match == true; a++) {
+      uint64_t Size;
+      memcpy(&Size, Raw.data() + Raw_Position, 8);
+
+      uint64_t Block_Header[3];
+      memcpy(Block_Header, Zlib.data() + Zlib_Position, 24);
+      const uint64_t Num_Blocks = Block_Header[0];
+      const uint64_t Block_Size = Block_Header[1];
+      const uint64_t Last_Block_Size = Block_Header[2];
+      Match = (Block_Size == IO::Write::VTU_BLOCK_SIZE && Num_Blocks == (Size + Block_Size - 1)/Block_Size &&
+               Last_Block_Size == Size % Block_Size);
+      if(Match == false) { break; }
+
+      const size_t Header_Size = 8*(3 + Num_Blocks);
+      std::vector<uint64_t> Compressed_Size(Num_Blocks);
+      memcpy(Compressed_Size.data(), Zlib.data() + Zlib_Position + 24, 8*Num_Blocks);
+
+      // Decompress each block, and compare it to the raw array.
+      size_t Block_Position = Zlib_Position + Header_Size;
+      size_t Body_Size = 0;
+      std::vector<unsigned char> Block(Block_Size);
+      for(uint64_t k = 0; k < Num_Blocks && Match == true; k++) {
+        const uint64_t Expected_Size = (k + 1 == Num_Blocks && Last_Block_Size != 0) ? Last_Block_Size : Block_Size;
+        uLongf Out_Size = (uLongf)Block_Size;
+        Match = (uncompress(Block.data(), &Out_Size, (const Bytef *)Zlib.data() + Block_Position, (uLong)Compressed_Size[k]) == Z_OK &&
+                 Out_Size == Expected_Size &&
+                 memcmp(Block.data(), Raw.data() + Raw_Position + 8 + k*Block_Size, Out_Size) == 0);
+        Block_Position += Compressed_Size[k];
+        Body_Size += Compressed_Size[k];
+      } // for(uint64_t k = 0; k < Num_Blocks && Match == true; k++) {
+
+      // The base64 file should decode to the same header and blocks.
+      const size_t Header_Chars = 4*((Header_Size + 2)/3);
+      const size_t Body_Chars = 4*((Body_Size + 2)/3);
+      Match = Match && (Decode_Base64(Encoded.data() + Encoded_Position, Header_Chars) == Zlib.substr(Zlib_Position, Header_Size));
+      Match = Match && (Decode_Base64(Encoded.data() + Encoded_Position + Header_Chars, Body_Chars) == Zlib.substr(Zlib_Position + Header_Size, Body_Size));
+
+      Raw_Position += 8 + Size;
+      Zlib_Position += Header_Size + Body_Size;
+      Encoded_Position += Header_Chars + Body_Chars;
+    } // for(unsigned a = 0; a < 8 && Match == true; a++) {
+
+    if(Match == true) { Tests_Passed++; }
+    else { Tests_Failed++; }
+  }
+
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+
+  delete [] Elements;
+} // void Test::vtk_Writer_Benchmark(void) {
+
+
+
+void Test::Stress_Recovery_Test(void) {
+  /* In this test, we give every node of an unstructured (jittered) cube mesh
+  the displacement u = G*x, for a fixed matrix G. Trilinear elements can
+  represent a linear displacement exactly, so every element's strain should
+  be the symmetric part of G (with engineering shear strains), and its stress
+  should be D times that. The stress recovered at the nodes should be exact
+  too. Next, we give the nodes a non-linear displacement and check that the
+  serial and colored (parallel) nodal recovery agree. Finally, we write the
+  results to a legacy VTK file and check that it has the result fields. */
+  const unsigned N = 6;
+  const unsigned Num_Nodes = (N+1)*(N+1)*(N+1);
+  const unsigned Num_Elements = N*N*N;
+
+  Cube_Fixture Cube{N, true};
+
+  const double G[3][3] = {{ 1.0e-3, -2.0e-4,  5.0e-4},
+                          { 3.0e-4, -4.0e-4,  1.0e-4},
+                          {-6.0e-4,  7.0e-4,  2.0e-4}};
+  for(unsigned n = 0; n < Num_Nodes; n++) {
+    for(unsigned Row = 0; Row < 3; Row++) {
+      double u = 0;
+      for(unsigned Col = 0; Col < 3; Col++) { u += G[Row][Col]*Cube.Nodes[n].Get_Position_Component(Col); }
+
+      if(Cube.Nodes[n].Get_Has_BC(Row) == true) { Cube.Nodes[n].Set_BC_Component(Row, u); }
+      else { Cube.Nodes[n].Set_Displacement_Component(Row, u); }
+    } // for(unsigned Row = 0; Row < 3; Row++) {
+  } // for(unsigned n = 0; n < Num_Nodes; n++) {
+
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+  class Element* Elements;
+  std::vector<double> Strain(6*Num_Elements), Stress(6*Num_Elements), Von_Mises(Num_Elements);
+  try {
+    Elements = Cube.Make_Elements();
+    Find_Element_Stresses(Cube.Nodes, Elements, Num_Elements, Strain.data(), Stress.data(), Von_Mises.data());
+  } // try {
+  catch (const Element_Exception & Er) {
+    printf("%s\n",Er.what());
+    return;
+  } // catch (const Element_Exception & Er) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Find the exact strain and stress (see Set_Element_Material for D). */
+  const double Exact_Strain[6] = {G[0][0], G[1][1], G[2][2], G[1][2] + G[2][1], G[0][2] + G[2][0], G[0][1] + G[1][0]};
+
+  const double l = (Simulation::v*Simulation::E)/((1. + Simulation::v)*(1. - 2.*Simulation::v));
+  const double m = Simulation::E/(2.*(1. + Simulation::v));
+  const double Trace = Exact_Strain[0] + Exact_Strain[1] + Exact_Strain[2];
+  double Exact_Stress[6];
+  for(unsigned k = 0; k < 3; k++) { Exact_Stress[k] = l*Trace + 2*m*Exact_Strain[k]; }
+  for(unsigned k = 3; k < 6; k++) { Exact_Stress[k] = m*Exact_Strain[k]; }
+  const double Exact_Von_Mises = Von_Mises_Stress(Exact_Stress);
+
+  double Max_Strain_Error = 0, Max_Stress_Error = 0, Max_Von_Mises_Error = 0;
+  for(unsigned i = 0; i < Num_Elements; i++) {
+    for(unsigned k = 0; k < 6; k++) {
+      Max_Strain_Error = fmax(Max_Strain_Error, fabs(Strain[6*i + k] - Exact_Strain[k]));
+      Max_Stress_Error = fmax(Max_Stress_Error, fabs(Stress[6*i + k] - Exact_Stress[k]));
+    } // for(unsigned k = 0; k < 6; k++) {
+    Max_Von_Mises_Error = fmax(Max_Von_Mises_Error, fabs(Von_Mises[i] - Exact_Von_Mises));
+  } // for(unsigned i = 0; i < Num_Elements; i++) {
+
+  printf("Max strain error    = %.3e\n", Max_Strain_Error);
+  printf("Max stress error    = %.3e (|stress| ~ %.3e)\n", Max_Stress_Error, fabs(Exact_Stress[0]));
+  printf("Max von Mises error = %.3e (von Mises = %.3e)\n", Max_Von_Mises_Error, Exact_Von_Mises);
+
+  if(Max_Strain_Error < 1e-12) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  if(Max_Stress_Error < 1e-10 && Max_Von_Mises_Error < 1e-10) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  // The hand calculation of a uniaxial stress's von Mises stress.
+  const double Uniaxial[6] = {2., 0, 0, 0, 0, 0};
+  if(fabs(Von_Mises_Stress(Uniaxial) - 2.) < 1e-14) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  Simulation::Settings Serial_Settings, Colored_Settings;
+  Serial_Settings.Assembly = Simulation::Assembly_Mode::SERIAL;
+  Colored_Settings.Assembly = Simulation::Assembly_Mode::COLORED;
+  class Simulation::Element_Coloring Coloring;
+  Simulation::Color_Elements(Elements, Num_Elements, Num_Nodes, Coloring);
+
+  std::vector<double> Serial_Stress, Colored_Stress;
+  Simulation::Recover_Nodal_Stresses(Cube.Nodes, Num_Nodes, Elements, Num_Elements, Coloring, Serial_Settings, Serial_Stress);
+
+  double Max_Nodal_Error = 0;
+  for(unsigned n = 0; n < Num_Nodes; n++) {
+    for(unsigned k = 0; k < 6; k++) { Max_Nodal_Error = fmax(Max_Nodal_Error, fabs(Serial_Stress[6*n + k] - Exact_Stress[k])); }
+  } // for(unsigned n = 0; n < Num_Nodes; n++) {
+  printf("Max nodal stress error (linear displacement) = %.3e\n", Max_Nodal_Error);
+
+  if(Max_Nodal_Error < 1e-10) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Now give the free components a non-linear displacement. */
+  for(unsigned n = 0; n < Num_Nodes; n++) {
+    const double x = Cube.Nodes[n].Get_Position_Component(0);
+    const double y = Cube.Nodes[n].Get_Position_Component(1);
+    const double z = Cube.Nodes[n].Get_Position_Component(2);
+    const double u[3] = {1e-3*x*z*z, 1e-3*sin(3*x)*z, -2e-3*y*y*z};
+    for(unsigned Comp = 0; Comp < 3; Comp++) {
+      if(Cube.Nodes[n].Get_Has_BC(Comp) == false) { Cube.Nodes[n].Set_Displacement_Component(Comp, u[Comp]); }
+    } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+  } // for(unsigned n = 0; n < Num_Nodes; n++) {
+
+  double Start = omp_get_wtime();
+  Simulation::Recover_Nodal_Stresses(Cube.Nodes, Num_Nodes, Elements, Num_Elements, Coloring, Serial_Settings, Serial_Stress);
+  const double Serial_Time = omp_get_wtime() - Start;
+
+  Start = omp_get_wtime();
+  Simulation::Recover_Nodal_Stresses(Cube.Nodes, Num_Nodes, Elements, Num_Elements, Coloring, Colored_Settings, Colored_Stress);
+  const double Colored_Time = omp_get_wtime() - Start;
+
+  // The two add each node's contributions in a different order.
+  double Max_Difference = 0, Max_Stress = 0;
+  for(size_t i = 0; i < Serial_Stress.size(); i++) {
+    Max_Difference = fmax(Max_Difference, fabs(Serial_Stress[i] - Colored_Stress[i]));
+    Max_Stress = fmax(Max_Stress, fabs(Serial_Stress[i]));
+  } // for(size_t i = 0; i < Serial_Stress.size(); i++) {
+  printf("Nodal stress recovery: serial %.4lf s, colored %.4lf s (%u colors, %d threads), max difference = %.3e (max |stress| = %.3e)\n",
+         Serial_Time, Colored_Time, Coloring.Num_Colors, omp_get_max_threads(), Max_Difference, Max_Stress);
+
+  if(Max_Stress > 0 && Max_Difference <= 1e-12*Max_Stress) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Finally, write the results and check that the file has the fields. */
+  IO::Write::vtk(Cube.Nodes, Num_Nodes, Elements, Num_Elements, "./IO/Stress_Recovery.vtk", IO::Write::VTK_Format::LEGACY_ASCII, Colored_Stress.data());
+  const std::string Contents = Read_Whole_File("./IO/Stress_Recovery.vtk");
+  remove("./IO/Stress_Recovery.vtk");
+
+  char Point_Data_Line[64], Cell_Data_Line[64];
+  sprintf(Point_Data_Line, "POINT_DATA %u\nVECTORS Displacement double\n", Num_Nodes);
+  sprintf(Cell_Data_Line, "CELL_DATA %u\nTENSORS Strain double\n", Num_Elements);
+  if(Contents.find(Point_Data_Line) != std::string::npos && Contents.find(Cell_Data_Line) != std::string::npos &&
+     Contents.find("TENSORS Stress double\n") != std::string::npos &&
+     Contents.find("TENSORS Nodal_Stress double\n") != std::string::npos &&
+     Contents.find("SCALARS Nodal_Von_Mises double 1\n") != std::string::npos &&
+     Contents.find("SCALARS Von_Mises double 1\nLOOKUP_TABLE default\n") != std::string::npos) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+
+  delete [] Elements;
+} // void Test::Stress_Recovery_Test(void) {
+
+
+
+
+void Test::vtk_Stream_Test(void) {
+  /* In this test, we stream a (deformed) mesh and its result fields through
+  a vtk_Stream in small chunks, with the smallest output buffer, in both
+  binary and ASCII. Given the same fields in the same order, the files must
+  be identical to the ones that vtk_binary and vtk write (which feed the
+  stream bigger chunks, with the default buffer). We then check that
+  the stream throws if it's given its data out of order, too much data, or
+  the wrong number of wedges. */
+  const unsigned N = 12;
+  const unsigned Num_Nodes = (N+1)*(N+1)*(N+1);
+  const unsigned Num_Elements = N*N*N;
+  const unsigned Chunk = 37;
+
+  Cube_Fixture Cube{N, true};
+
+  class Element* Elements;
+  try {
+    Elements = Cube.Make_Elements();
+  } // try {
+  catch (const Element_Exception & Er) {
+    printf("%s\n",Er.what());
+    return;
+  } // catch (const Element_Exception & Er) {
+
+  for(unsigned n = 0; n < Num_Nodes; n++) {
+    for(unsigned Comp = 0; Comp < 3; Comp++) {
+      if(Cube.ID(n, Comp) != -1) { Cube.Nodes[n].Set_Displacement_Component(Comp, 1e-3*sin(1.7*n + Comp)); }
+    } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+  } // for(unsigned n = 0; n < Num_Nodes; n++) {
+
+  // Find the fields the way that the writers do (see Find_Fields in vtk_Writer.cc).
+  std::vector<double> Displacement(3*Num_Nodes);
+  for(unsigned n = 0; n < Num_Nodes; n++) {
+    for(unsigned Comp = 0; Comp < 3; Comp++) { Displacement[3*n + Comp] = Cube.Nodes[n].Get_Displacement_Component(Comp); }
+  } // for(unsigned n = 0; n < Num_Nodes; n++) {
+
+  std::vector<double> Voigt_Strain(6*Num_Elements), Voigt_Stress(6*Num_Elements), Von_Mises(Num_Elements);
+  Find_Element_Stresses(Cube.Nodes, Elements, Num_Elements, Voigt_Strain.data(), Voigt_Stress.data(), Von_Mises.data());
+
+  static const unsigned Voigt_Index[9] = {0, 5, 4,
+                                          5, 1, 3,
+                                          4, 3, 2};
+  std::vector<double> Strain(9*Num_Elements), Stress(9*Num_Elements);
+  for(unsigned i = 0; i < Num_Elements; i++) {
+    for(unsigned k = 0; k < 9; k++) {
+      const unsigned Voigt = 6*i + Voigt_Index[k];
+      Strain[9*i + k] = (Voigt_Index[k] < 3) ? Voigt_Strain[Voigt] : 0.5*Voigt_Strain[Voigt];
+      Stress[9*i + k] = Voigt_Stress[Voigt];
+    } // for(unsigned k = 0; k < 9; k++) {
+  } // for(unsigned i = 0; i < Num_Elements; i++) {
+
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Stream the mesh and fields, and compare with vtk_binary and vtk. */
+  const bool Binary[2] = {true, false};
+  const IO::Write::VTK_Format Formats[2] = {IO::Write::VTK_Format::LEGACY_BINARY, IO::Write::VTK_Format::LEGACY_ASCII};
+  for(unsigned f = 0; f < 2; f++) {
+    double Start = omp_get_wtime();
+    IO::Write::vtk(Cube.Nodes, Num_Nodes, Elements, Num_Elements, "./IO/Stream_Reference.vtk", Formats[f]);
+    const double Reference_Time = omp_get_wtime() - Start;
+
+    Start = omp_get_wtime();
+    try {
+      IO::Write::vtk_Stream Stream{"./IO/Stream.vtk", Num_Nodes, Num_Elements, 0, Binary[f], 0};
+      for(unsigned i = 0; i < Num_Nodes; i += Chunk) { Stream.Add_Nodes(&Cube.Nodes[i], std::min(Chunk, Num_Nodes - i)); }
+      for(unsigned i = 0; i < Num_Elements; i += Chunk) { Stream.Add_Elements(&Elements[i], std::min(Chunk, Num_Elements - i)); }
+      for(unsigned i = 0; i < Num_Nodes; i += Chunk) {
+        Stream.Add_Point_Data(IO::Write::VTK_Attribute::VECTORS, "Displacement", &Displacement[3*i], std::min(Chunk, Num_Nodes - i));
+      } // for(unsigned i = 0; i < Num_Nodes; i += Chunk) {
+      for(unsigned i = 0; i < Num_Elements; i += Chunk) {
+        Stream.Add_Cell_Data(IO::Write::VTK_Attribute::TENSORS, "Strain", &Strain[9*i], std::min(Chunk, Num_Elements - i));
+      } // for(unsigned i = 0; i < Num_Elements; i += Chunk) {
+      Stream.Add_Cell_Data(IO::Write::VTK_Attribute::TENSORS, "Stress", Stress.data(), Num_Elements);
+      for(unsigned i = 0; i < Num_Elements; i += Chunk) {
+        Stream.Add_Cell_Data(IO::Write::VTK_Attribute::SCALARS, "Von_Mises", &Von_Mises[i], std::min(Chunk, Num_Elements - i));
+      } // for(unsigned i = 0; i < Num_Elements; i += Chunk) {
+      Stream.Finish();
+    } // try {
+    catch (const IO_Exception & Er) { printf("%s\n", Er.what()); }
+    const double Stream_Time = omp_get_wtime() - Start;
+
+    const std::string Reference = Read_Whole_File("./IO/Stream_Reference.vtk");
+    const std::string Streamed = Read_Whole_File("./IO/Stream.vtk");
+    remove("./IO/Stream_Reference.vtk");
+    remove("./IO/Stream.vtk");
+
+    printf("%s: vtk %.4lf s, vtk_Stream %.4lf s (%lu bytes)\n", Binary[f] ? "Binary" : "ASCII", Reference_Time, Stream_Time, (unsigned long)Streamed.size());
+
+    if(Reference.size() != 0 && Streamed == Reference) { Tests_Passed++; }
+    else { Tests_Failed++; }
+  } // for(unsigned f = 0; f < 2; f++) {
+
+
+  //////////////////////////////////////////////////////////////////////////////
+  /* Now, misuse the stream. Each of these should throw. */
+  const unsigned NUM_MISUSES = 5;
+  unsigned Num_Thrown = 0;
+  for(unsigned m = 0; m < NUM_MISUSES; m++) {
+    try {
+      IO::Write::vtk_Stream Stream{"./IO/Stream.vtk", Num_Nodes, Num_Elements, (m == 4) ? 1u : 0u};
+      if(m == 0) { Stream.Add_Elements(Elements, 1); }                                  // Elements before all of the nodes
+      if(m == 1) { Stream.Add_Nodes(Cube.Nodes, Num_Nodes); Stream.Add_Nodes(Cube.Nodes, 1); }   // Too many nodes
+
+      if(m >= 2) {
+        Stream.Add_Nodes(Cube.Nodes, Num_Nodes);
+        Stream.Add_Elements(Elements, Num_Elements);
+      } // if(m >= 2) {
+      if(m == 2) {                                                                     // Points after the cells
+        Stream.Add_Nodes(Cube.Nodes, 1);
+      } // if(m == 2) {
+      if(m == 3) {                                                                     // An incomplete array
+        Stream.Add_Point_Data(IO::Write::VTK_Attribute::VECTORS, "Displacement", Displacement.data(), 1);
+        Stream.Finish();
+      } // if(m == 3) {
+      if(m == 4) { Stream.Finish(); }                                                  // A declared wedge that never came
+    } // try {
+    catch (const Bad_Stream_Use &) { Num_Thrown++; }
+  } // for(unsigned m = 0; m < NUM_MISUSES; m++) {
+  remove("./IO/Stream.vtk");
+
+  printf("%u of %u misuses threw\n", Num_Thrown, NUM_MISUSES);
+  if(Num_Thrown == NUM_MISUSES) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+
+  delete [] Elements;
+} // void Test::vtk_Stream_Test(void) {
+
 #endif
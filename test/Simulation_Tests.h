@@ -2,9 +2,21 @@
 #define SIMULATION_TESTS_HEADER
 
 #include "Simulation/Simulation.h"
+#include <omp.h>
 
 namespace Test {
   void Mrudang_Test(void);
+  void Load_Case_Test(void);
+  void Element_Throughput_Benchmark(void);
+  void Colored_Assembly_Test(void);
+  void Matrix_Free_Test(void);
+  void AMG_Test(void);
+  void Ke_Batch_Benchmark(void);
+  void Ke_Cache_Test(void);
+  void Renumbering_Test(void);
+  void vtk_Writer_Benchmark(void);
+  void Stress_Recovery_Test(void);
+  void vtk_Stream_Test(void);
 } // namespace Test {
 
 #endif
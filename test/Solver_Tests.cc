@@ -0,0 +1,211 @@
+#include "Solver_Tests.h"
+#include <math.h>
+#include <vector>
+
+void Test::PCG_Solver_Tests(void) {
+  /* In this test, we check that the PCG solver can solve Mx = F with both
+  preconditioners. M is the n by n matrix with 4 on the diagonal, -1 on the
+  first off diagonals, and 1 (inside each 3x3 block) on the second off
+  diagonals. M is symmetric and diagonally dominant (and thus positive
+  definite). We pick x, compute F = Mx, solve, and check that we get x back. */
+  const unsigned n = 30;
+
+  std::vector<std::vector<unsigned>> Row_Columns(n);
+  for(unsigned i = 0; i < n; i++) {
+    if(i + 1 < n) { Row_Columns[i].push_back(i + 1); }
+    if(i + 2 < n && (i % 3) == 0) { Row_Columns[i].push_back(i + 2); }
+  } // for(unsigned i = 0; i < n; i++) {
+
+  Sparse_Matrix M{};
+  M.Set_Pattern(n, Row_Columns);
+  for(unsigned i = 0; i < n; i++) {
+    M.Add_To(i, i, 4);
+    if(i + 1 < n) { M.Add_To(i, i + 1, -1); }
+    if(i + 2 < n && (i % 3) == 0) { M.Add_To(i, i + 2, 1); }
+  } // for(unsigned i = 0; i < n; i++) {
+
+  std::vector<unsigned> Block_Start;
+  for(unsigned i = 0; i <= n; i += 3) { Block_Start.push_back(i); }
+
+  double x_True[2*n], F[2*n], x[2*n];
+  for(unsigned i = 0; i < n; i++) {
+    x_True[i] = (double)i - 10.;
+    x_True[n + i] = 1./((double)i + 1.);
+  } // for(unsigned i = 0; i < n; i++) {
+  M.Multiply(x_True, F);
+  M.Multiply(x_True + n, F + n);
+
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+
+  const Preconditioner Preconditioners[2] = { Preconditioner::JACOBI, Preconditioner::BLOCK_JACOBI };
+  const char* Names[2] = { "Jacobi", "Block Jacobi" };
+
+  for(unsigned k = 0; k < 2; k++) {
+    try {
+      PCG_Solver Solver{Preconditioners[k], 1e-12, 1000, Block_Start};
+
+      // Solving before factoring should throw.
+      try {
+        Solver.Solve(x, F);
+        Tests_Failed++;
+      } // try {
+      catch(const Solver_Not_Set_Up & Er) { Tests_Passed++; }
+
+      // Solve both right hand sides at once.
+      Solver.Factor(M);
+      Solver.Solve(x, F, 2);
+      printf("%s: %u iterations, relative residual = %e\n", Names[k], Solver.Get_Iterations(), Solver.Get_Relative_Residual());
+
+      for(unsigned i = 0; i < 2*n; i++) {
+        if(fabs(x[i] - x_True[i]) < 1e-9) { Tests_Passed++; }
+        else { Tests_Failed++; }
+      } // for(unsigned i = 0; i < 2*n; i++) {
+    } // try {
+    catch(const Solver_Exception & Er) {
+      printf("%s\n", Er.what());
+      Tests_Failed++;
+    } // catch(const Solver_Exception & Er) {
+  } // for(unsigned k = 0; k < 2; k++) {
+
+  // If PCG can't converge in the allowed number of iterations, Solve should throw.
+  try {
+    PCG_Solver Solver{Preconditioner::JACOBI, 1e-12, 2};
+    Solver.Factor(M);
+    Solver.Solve(x, F);
+    Tests_Failed++;
+  } // try {
+  catch(const Solver_Failed & Er) { Tests_Passed++; }
+
+  // Block Jacobi needs blocks.
+  try {
+    PCG_Solver Solver{Preconditioner::BLOCK_JACOBI, 1e-12, 100};
+    Tests_Failed++;
+  } // try {
+  catch(const Solver_Not_Set_Up & Er) { Tests_Passed++; }
+
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+} // void Test::PCG_Solver_Tests(void) {
+
+
+
+
+void Test::Multigrid_Tests(void) {
+  /* In this test, we check that multigrid preconditioned CG converges in a
+  number of iterations that (roughly) doesn't depend on the mesh size, unlike
+  block Jacobi. K is the graph Laplacian of an N by N by N lattice of bricks
+  (one copy for each of the 3 displacement components). Lattice point (i,j,k)
+  is coupled to its (up to) 6 neighbors, and K's diagonal holds the number of
+  neighbors. The k = 0 face is fixed, which makes K positive definite. */
+  unsigned Tests_Passed = 0;
+  unsigned Tests_Failed = 0;
+  unsigned MG_Iterations[3] = {0, 0, 0};
+  const unsigned Mesh_Sizes[3] = {8, 16, 32};
+
+  for(unsigned m = 0; m < 3; m++) {
+    const unsigned N = Mesh_Sizes[m];
+    const unsigned Np = N + 1;
+
+    // Number the free components point by point.
+    Structured_Grid Grid;
+    Grid.Nx = Grid.Ny = Grid.Nz = N;
+    Grid.Eq.assign(3*Np*Np*Np, -1);
+    unsigned n = 0;
+    for(unsigned Point = 0; Point < Np*Np*Np; Point++) {
+      if(Point % Np == 0) { continue; }           // k = 0
+      for(unsigned Comp = 0; Comp < 3; Comp++) { Grid.Eq[3*Point + Comp] = (int)n++; }
+    } // for(unsigned Point = 0; Point < Np*Np*Np; Point++) {
+
+    // Set up K. Neighbors with larger indices (and thus larger equation numbers) go in the upper triangle.
+    std::vector<std::vector<unsigned>> Row_Columns(n);
+    std::vector<double> Diag(n, 0);
+    for(unsigned i = 0; i < Np; i++) {
+      for(unsigned j = 0; j < Np; j++) {
+        for(unsigned k = 0; k < Np; k++) {
+          const unsigned Point = Np*Np*i + Np*j + k;
+          const unsigned Neighbors[3] = {Point + 1, Point + Np, Point + Np*Np};
+          const bool Has_Neighbor[3] = {k + 1 < Np, j + 1 < Np, i + 1 < Np};
+
+          for(unsigned d = 0; d < 3; d++) {
+            if(Has_Neighbor[d] == false) { continue; }
+            for(unsigned Comp = 0; Comp < 3; Comp++) {
+              const int I = Grid.Eq[3*Point + Comp];
+              const int J = Grid.Eq[3*Neighbors[d] + Comp];
+              if(I != -1) { Diag[I] += 1; }
+              if(J != -1) { Diag[J] += 1; }
+              if(I != -1 && J != -1) { Row_Columns[I].push_back((unsigned)J); }
+            } // for(unsigned Comp = 0; Comp < 3; Comp++) {
+          } // for(unsigned d = 0; d < 3; d++) {
+        } // for(unsigned k = 0; k < Np; k++) {
+      } // for(unsigned j = 0; j < Np; j++) {
+    } // for(unsigned i = 0; i < Np; i++) {
+
+    Sparse_Matrix K{};
+    K.Set_Pattern(n, Row_Columns);
+    for(unsigned I = 0; I < n; I++) {
+      K.Add_To(I, I, Diag[I]);
+      for(unsigned J : Row_Columns[I]) { K.Add_To(I, J, -1); }
+    } // for(unsigned I = 0; I < n; I++) {
+
+    std::vector<double> x_True(n), F(n), x(n);
+    for(unsigned I = 0; I < n; I++) { x_True[I] = sin(.37*I) + 1.; }
+    K.Multiply(x_True.data(), F.data());
+
+    try {
+      PCG_Solver MG_Solver{Preconditioner::MULTIGRID, 1e-10, 1000, Grid};
+      MG_Solver.Factor(K);
+      MG_Solver.Solve(x.data(), F.data());
+      MG_Iterations[m] = MG_Solver.Get_Iterations();
+
+      double Error = 0, Norm = 0;
+      for(unsigned I = 0; I < n; I++) {
+        Error += (x[I] - x_True[I])*(x[I] - x_True[I]);
+        Norm += x_True[I]*x_True[I];
+      } // for(unsigned I = 0; I < n; I++) {
+      if(sqrt(Error/Norm) < 1e-6) { Tests_Passed++; }
+      else { Tests_Failed++; }
+
+      // Block Jacobi (one block per lattice point).
+      std::vector<unsigned> Block_Start;
+      for(unsigned I = 0; I <= n; I += 3) { Block_Start.push_back(I); }
+      PCG_Solver BJ_Solver{Preconditioner::BLOCK_JACOBI, 1e-10, 10000, Block_Start};
+      BJ_Solver.Factor(K);
+      BJ_Solver.Solve(x.data(), F.data());
+
+      printf("N = %2u (%6u equations): multigrid %3u iterations, block Jacobi %4u iterations\n",
+             N, n, MG_Iterations[m], BJ_Solver.Get_Iterations());
+
+      if(MG_Iterations[m] < BJ_Solver.Get_Iterations()) { Tests_Passed++; }
+      else { Tests_Failed++; }
+    } // try {
+    catch(const Solver_Exception & Er) {
+      printf("%s\n", Er.what());
+      Tests_Failed++;
+    } // catch(const Solver_Exception & Er) {
+
+    // A grid that doesn't match K should be rejected.
+    try {
+      Structured_Grid Bad_Grid = Grid;
+      Bad_Grid.Nz = N - 1;
+      PCG_Solver Solver{Preconditioner::MULTIGRID, 1e-10, 1000, Bad_Grid};
+      Solver.Factor(K);
+      Tests_Failed++;
+    } // try {
+    catch(const Solver_Not_Set_Up & Er) { Tests_Passed++; }
+  } // for(unsigned m = 0; m < 3; m++) {
+
+  // Refining the mesh (by a factor of 4) should barely change the number of multigrid iterations.
+  if(MG_Iterations[2] != 0 && MG_Iterations[2] <= MG_Iterations[0] + 5) { Tests_Passed++; }
+  else { Tests_Failed++; }
+
+  // Multigrid needs a grid.
+  try {
+    PCG_Solver Solver{Preconditioner::MULTIGRID, 1e-10, 100};
+    Tests_Failed++;
+  } // try {
+  catch(const Solver_Not_Set_Up & Er) { Tests_Passed++; }
+
+  printf("Tests Passed: %u\n", Tests_Passed);
+  printf("Tests Failed: %u\n", Tests_Failed);
+} // void Test::Multigrid_Tests(void) {
@@ -0,0 +1,13 @@
+#if !defined(SOLVER_TESTS_HEADER)
+#define SOLVER_TESTS_HEADER
+
+#include "Solver/PCG_Solver.h"
+#include "Solver/Multigrid.h"
+#include "Sparse/Sparse_Matrix.h"
+
+namespace Test {
+  void PCG_Solver_Tests(void);
+  void Multigrid_Tests(void);
+} // namespace Test {
+
+#endif